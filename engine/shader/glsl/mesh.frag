@@ -33,7 +33,7 @@ layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
     uint             _padding_point_light_num_3;
     PointLight       scene_point_lights[m_max_point_light_count];
     DirectionalLight scene_directional_light;
-    highp mat4       directional_light_proj_view;
+    highp mat4       directional_light_proj_view[m_directional_light_cascade_count];
 };
 
 layout(set = 0, binding = 3) uniform sampler2D brdfLUT_sampler;
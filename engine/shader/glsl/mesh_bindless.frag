@@ -0,0 +1,96 @@
+#version 450
+
+#extension GL_GOOGLE_include_directive : enable
+#extension GL_EXT_nonuniform_qualifier : enable
+
+#include "constants.h"
+#include "structures.h"
+
+struct DirectionalLight
+{
+    highp vec3 direction;
+    lowp float _padding_direction;
+    highp vec3 color;
+    lowp float _padding_color;
+};
+
+struct PointLight
+{
+    highp vec3  position;
+    highp float radius;
+    highp vec3  intensity;
+    lowp float  _padding_intensity;
+};
+
+layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
+{
+    highp mat4       proj_view_matrix;
+    highp vec3       camera_position;
+    lowp float       _padding_camera_position;
+    highp vec3       ambient_light;
+    lowp float       _padding_ambient_light;
+    highp uint       point_light_num;
+    uint             _padding_point_light_num_1;
+    uint             _padding_point_light_num_2;
+    uint             _padding_point_light_num_3;
+    PointLight       scene_point_lights[m_max_point_light_count];
+    DirectionalLight scene_directional_light;
+    highp mat4       directional_light_proj_view[m_directional_light_cascade_count];
+};
+
+layout(set = 0, binding = 3) uniform sampler2D brdfLUT_sampler;
+layout(set = 0, binding = 4) uniform samplerCube irradiance_sampler;
+layout(set = 0, binding = 5) uniform samplerCube specular_sampler;
+layout(set = 0, binding = 6) uniform highp sampler2DArray point_lights_shadow;
+layout(set = 0, binding = 7) uniform highp sampler2D directional_light_shadow;
+
+#include "mesh_bindless.h"
+
+// read in fragnormal (from vertex shader)
+layout(location = 0) in highp vec3 in_world_position;
+layout(location = 1) in highp vec3 in_normal;
+layout(location = 2) in highp vec3 in_tangent;
+layout(location = 3) in highp vec2 in_texcoord;
+layout(location = 4) flat in highp uint in_material_index;
+
+layout(location = 0) out highp vec4 out_scene_color;
+
+highp vec3 getBasecolor()
+{
+    highp vec3 basecolor = sampleBindlessTexture(in_material_index, BINDLESS_BASE_COLOR_TEXTURE, in_texcoord).xyz *
+                           bindless_materials[in_material_index].baseColorFactor.xyz;
+    return basecolor;
+}
+
+highp vec3 calculateNormal()
+{
+    highp vec3 tangent_normal =
+        sampleBindlessTexture(in_material_index, BINDLESS_NORMAL_TEXTURE, in_texcoord).xyz * 2.0 - 1.0;
+
+    highp vec3 N = normalize(in_normal);
+    highp vec3 T = normalize(in_tangent.xyz);
+    highp vec3 B = normalize(cross(N, T));
+
+    highp mat3 TBN = mat3(T, B, N);
+    return normalize(TBN * tangent_normal);
+}
+
+#include "mesh_lighting.h"
+
+void main()
+{
+    highp vec4 metallic_roughness =
+        sampleBindlessTexture(in_material_index, BINDLESS_METALLIC_ROUGHNESS_TEXTURE, in_texcoord);
+
+    highp vec3  N                   = calculateNormal();
+    highp vec3  basecolor           = getBasecolor();
+    highp float metallic            = metallic_roughness.z * bindless_materials[in_material_index].metallicFactor;
+    highp float dielectric_specular = 0.04;
+    highp float roughness           = metallic_roughness.y * bindless_materials[in_material_index].roughnessFactor;
+
+    highp vec3 result_color;
+
+#include "mesh_lighting.inl"
+
+    out_scene_color = vec4(result_color, 1.0);
+}
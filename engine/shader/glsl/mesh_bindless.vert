@@ -0,0 +1,133 @@
+#version 450
+
+#extension GL_GOOGLE_include_directive : enable
+#extension GL_EXT_nonuniform_qualifier : enable
+
+#include "constants.h"
+#include "structures.h"
+
+struct DirectionalLight
+{
+    vec3  direction;
+    float _padding_direction;
+    vec3  color;
+    float _padding_color;
+};
+
+struct PointLight
+{
+    vec3  position;
+    float radius;
+    vec3  intensity;
+    float _padding_intensity;
+};
+
+layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
+{
+    mat4             proj_view_matrix;
+    vec3             camera_position;
+    float            _padding_camera_position;
+    vec3             ambient_light;
+    float            _padding_ambient_light;
+    uint             point_light_num;
+    uint             _padding_point_light_num_1;
+    uint             _padding_point_light_num_2;
+    uint             _padding_point_light_num_3;
+    PointLight       scene_point_lights[m_max_point_light_count];
+    DirectionalLight scene_directional_light;
+    highp mat4       directional_light_proj_view[m_directional_light_cascade_count];
+};
+
+layout(set = 0, binding = 1) readonly buffer _unused_name_per_drawcall
+{
+    VulkanMeshInstance mesh_instances[m_mesh_per_drawcall_max_instance_count];
+};
+
+layout(set = 0, binding = 2) readonly buffer _unused_name_per_drawcall_vertex_blending
+{
+    highp mat4 joint_matrices[];
+};
+layout(set = 1, binding = 2) readonly buffer _unused_name_bindless_joint_binding
+{
+    VulkanMeshVertexJointBinding indices_and_weights[];
+}
+bindless_joint_bindings[];
+
+layout(location = 0) in vec3 in_position; // for some types as dvec3 takes 2 locations
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec3 in_tangent;
+layout(location = 3) in vec2 in_texcoord;
+
+layout(location = 0) out vec3 out_world_position; // output in framebuffer 0 for fragment shader
+layout(location = 1) out vec3 out_normal;
+layout(location = 2) out vec3 out_tangent;
+layout(location = 3) out vec2 out_texcoord;
+layout(location = 4) flat out uint out_material_index;
+
+void main()
+{
+    highp mat4  model_matrix           = mesh_instances[gl_InstanceIndex].model_matrix;
+    highp float enable_vertex_blending = mesh_instances[gl_InstanceIndex].enable_vertex_blending;
+    highp int   joint_matrix_offset    = int(mesh_instances[gl_InstanceIndex].joint_matrix_offset);
+    // all instances of a drawcall share the mesh, so the index is dynamically uniform
+    highp uint mesh_index = mesh_instances[gl_InstanceIndex].mesh_index;
+
+    highp vec3 model_position;
+    highp vec3 model_normal;
+    highp vec3 model_tangent;
+    if (enable_vertex_blending > 0.0)
+    {
+        highp ivec4 in_indices = bindless_joint_bindings[mesh_index].indices_and_weights[gl_VertexIndex].indices;
+        highp vec4  in_weights = bindless_joint_bindings[mesh_index].indices_and_weights[gl_VertexIndex].weights;
+
+        highp mat4 vertex_blending_matrix = mat4x4(
+            vec4(0.0, 0.0, 0.0, 0.0), vec4(0.0, 0.0, 0.0, 0.0), vec4(0.0, 0.0, 0.0, 0.0), vec4(0.0, 0.0, 0.0, 0.0));
+
+        if (in_weights.x > 0.0 && in_indices.x > 0)
+        {
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.x] * in_weights.x;
+        }
+
+        if (in_weights.y > 0.0 && in_indices.y > 0)
+        {
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.y] * in_weights.y;
+        }
+
+        if (in_weights.z > 0.0 && in_indices.z > 0)
+        {
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.z] * in_weights.z;
+        }
+
+        if (in_weights.w > 0.0 && in_indices.w > 0)
+        {
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.w] * in_weights.w;
+        }
+
+        model_position = (vertex_blending_matrix * vec4(in_position, 1.0)).xyz;
+
+        highp mat3x3 vertex_blending_tangent_matrix =
+            mat3x3(vertex_blending_matrix[0].xyz, vertex_blending_matrix[1].xyz, vertex_blending_matrix[2].xyz);
+
+        model_normal  = normalize(vertex_blending_tangent_matrix * in_normal);
+        model_tangent = normalize(vertex_blending_tangent_matrix * in_tangent);
+    }
+    else
+    {
+        model_position = in_position;
+        model_normal   = in_normal;
+        model_tangent  = in_tangent;
+    }
+
+    out_world_position = (model_matrix * vec4(model_position, 1.0)).xyz;
+
+    gl_Position = proj_view_matrix * vec4(out_world_position, 1.0f);
+
+    // TODO: normal matrix
+    mat3x3 tangent_matrix = mat3x3(model_matrix[0].xyz, model_matrix[1].xyz, model_matrix[2].xyz);
+    out_normal            = normalize(tangent_matrix * model_normal);
+    out_tangent           = normalize(tangent_matrix * model_tangent);
+
+    out_texcoord = in_texcoord;
+
+    out_material_index = mesh_instances[gl_InstanceIndex].material_index;
+}
@@ -17,11 +17,12 @@ layout(set = 0, binding = 1) readonly buffer _unused_name_perdrawcall
     mat4 model_matrices[m_mesh_per_drawcall_max_instance_count];
     uint node_ids[m_mesh_per_drawcall_max_instance_count];
     float enable_vertex_blendings[m_mesh_per_drawcall_max_instance_count];
+    uint joint_matrix_offsets[m_mesh_per_drawcall_max_instance_count];
 };
 
 layout(set = 0, binding = 2) readonly buffer _unused_name_per_drawcall_vertex_blending
 {
-    mat4 joint_matrices[m_mesh_vertex_blending_max_joint_count * m_mesh_per_drawcall_max_instance_count];
+    mat4 joint_matrices[];
 };
 
 layout(set = 1, binding = 0) readonly buffer _unused_name_per_mesh_joint_binding
@@ -37,6 +38,7 @@ void main()
 {
     highp mat4 model_matrix = model_matrices[gl_InstanceIndex];
     highp float enable_vertex_blending = enable_vertex_blendings[gl_InstanceIndex];
+    highp int joint_matrix_offset = int(joint_matrix_offsets[gl_InstanceIndex]);
 
     highp vec3 model_position;
     if (enable_vertex_blending > 0.0)
@@ -52,22 +54,22 @@ void main()
 
         if (in_weights.x > 0.0 && in_indices.x > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.x] * in_weights.x;
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.x] * in_weights.x;
         }
 
         if (in_weights.y > 0.0 && in_indices.y > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.y] * in_weights.y;
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.y] * in_weights.y;
         }
 
         if (in_weights.z > 0.0 && in_indices.z > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.z] * in_weights.z;
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.z] * in_weights.z;
         }
 
         if (in_weights.w > 0.0 && in_indices.w > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.w] * in_weights.w;
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.w] * in_weights.w;
         }
 
         model_position = (vertex_blending_matrix * vec4(in_position, 1.0)).xyz;
@@ -77,7 +79,7 @@ void main()
         model_position = in_position;
     }
 
-    gl_Position = proj_view_matrix * model_matrix * vec4(in_position, 1.0);
+    gl_Position = proj_view_matrix * model_matrix * vec4(model_position, 1.0);
 
     out_nodeid = node_ids[gl_InstanceIndex];
 }
\ No newline at end of file
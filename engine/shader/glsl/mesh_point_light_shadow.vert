@@ -12,7 +12,7 @@ layout(set = 0, binding = 1) readonly buffer _unused_name_per_drawcall
 
 layout(set = 0, binding = 2) readonly buffer _unused_name_per_drawcall_vertex_blending
 {
-    mat4 joint_matrices[m_mesh_vertex_blending_max_joint_count * m_mesh_per_drawcall_max_instance_count];
+    mat4 joint_matrices[];
 };
 
 layout(set = 1, binding = 0) readonly buffer _unused_name_per_mesh_joint_binding
@@ -28,6 +28,7 @@ void main()
 {
     highp mat4 model_matrix = mesh_instances[gl_InstanceIndex].model_matrix;
     highp float enable_vertex_blending = mesh_instances[gl_InstanceIndex].enable_vertex_blending;
+    highp int joint_matrix_offset = int(mesh_instances[gl_InstanceIndex].joint_matrix_offset);
 
     highp vec3 model_position;
     if (enable_vertex_blending > 0.0)
@@ -43,22 +44,22 @@ void main()
 
         if (in_weights.x > 0.0 && in_indices.x > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.x] * in_weights.x;
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.x] * in_weights.x;
         }
 
         if (in_weights.y > 0.0 && in_indices.y > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.y] * in_weights.y;
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.y] * in_weights.y;
         }
 
         if (in_weights.z > 0.0 && in_indices.z > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.z] * in_weights.z;
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.z] * in_weights.z;
         }
 
         if (in_weights.w > 0.0 && in_indices.w > 0)
         {
-            vertex_blending_matrix += joint_matrices[m_mesh_vertex_blending_max_joint_count * gl_InstanceIndex + in_indices.w] * in_weights.w;
+            vertex_blending_matrix += joint_matrices[joint_matrix_offset + in_indices.w] * in_weights.w;
         }
 
         model_position = (vertex_blending_matrix * vec4(in_position, 1.0)).xyz;
@@ -2,6 +2,9 @@
 #define m_max_point_light_geom_vertices 90 // 90 = 2 * 3 * m_max_point_light_count
 #define m_mesh_per_drawcall_max_instance_count 64
 #define m_mesh_vertex_blending_max_joint_count 1024
+#define m_bindless_material_texture_count 5
+#define m_directional_light_cascade_count 4
+#define m_directional_light_cascade_dimension 2048
 #define CHAOS_LAYOUT_MAJOR row_major
 layout(CHAOS_LAYOUT_MAJOR) buffer;
 layout(CHAOS_LAYOUT_MAJOR) uniform;
\ No newline at end of file
@@ -0,0 +1,21 @@
+// material factors and textures of the bindless mesh pipelines, the material
+// index comes from the per instance data and may diverge inside a drawcall
+
+layout(set = 1, binding = 0) readonly buffer _unused_name_bindless_material
+{
+    VulkanBindlessMaterial bindless_materials[];
+};
+
+layout(set = 1, binding = 1) uniform sampler2D bindless_textures[];
+
+#define BINDLESS_BASE_COLOR_TEXTURE 0
+#define BINDLESS_METALLIC_ROUGHNESS_TEXTURE 1
+#define BINDLESS_NORMAL_TEXTURE 2
+#define BINDLESS_OCCLUSION_TEXTURE 3
+#define BINDLESS_EMISSIVE_TEXTURE 4
+
+highp vec4 sampleBindlessTexture(highp uint material_index, highp uint texture_slot, highp vec2 texcoord)
+{
+    highp uint texture_index = material_index * uint(m_bindless_material_texture_count) + texture_slot;
+    return texture(bindless_textures[nonuniformEXT(texture_index)], texcoord);
+}
@@ -95,17 +95,31 @@ highp vec3 Libl = (kD * diffuse + specular);
 
     if (NoL > 0.0)
     {
-        highp float shadow;
+        // the first cascade that contains the point, the border texel is left out so the samples stay in the tile
+        highp float shadow = 1.0f;
+        for (int cascade_index = 0; cascade_index < m_directional_light_cascade_count; ++cascade_index)
         {
-            highp vec4 position_clip = directional_light_proj_view * vec4(in_world_position, 1.0);
+            highp vec4 position_clip = directional_light_proj_view[cascade_index] * vec4(in_world_position, 1.0);
             highp vec3 position_ndc  = position_clip.xyz / position_clip.w;
 
-            highp vec2 uv = ndcxy_to_uv(position_ndc.xy);
+            highp float border = 1.0 - 2.0 / float(m_directional_light_cascade_dimension);
+            if (any(greaterThan(abs(position_ndc.xy), vec2(border))) || position_ndc.z > 1.0)
+            {
+                continue;
+            }
+
+            // the static casters are cached in the top row of the atlas, the dynamic casters are in the bottom row
+            highp vec2 atlas_size = vec2(float(m_directional_light_cascade_count), 2.0);
+            highp vec2 static_uv  = (ndcxy_to_uv(position_ndc.xy) + vec2(float(cascade_index), 0.0)) / atlas_size;
+            highp vec2 dynamic_uv = static_uv + vec2(0.0, 0.5);
 
-            highp float closest_depth = texture(directional_light_shadow, uv).r + 0.000075;
+            highp float closest_depth =
+                min(texture(directional_light_shadow, static_uv).r, texture(directional_light_shadow, dynamic_uv).r) +
+                0.000075;
             highp float current_depth = position_ndc.z;
 
             shadow = (closest_depth >= current_depth) ? 1.0f : -1.0f;
+            break;
         }
 
         if (shadow > 0.0f)
@@ -1,9 +1,9 @@
 struct VulkanMeshInstance
 {
     highp float enable_vertex_blending;
-    highp float _padding_enable_vertex_blending_1;
-    highp float _padding_enable_vertex_blending_2;
-    highp float _padding_enable_vertex_blending_3;
+    highp uint  material_index;
+    highp uint  mesh_index;
+    highp uint  joint_matrix_offset;
     highp mat4  model_matrix;
 };
 
@@ -12,3 +12,18 @@ struct VulkanMeshVertexJointBinding
     highp ivec4 indices;
     highp vec4  weights;
 };
+
+struct VulkanBindlessMaterial
+{
+    highp vec4  baseColorFactor;
+    highp float metallicFactor;
+    highp float roughnessFactor;
+    highp float normalScale;
+    highp float occlusionStrength;
+    highp vec3  emissiveFactor;
+    highp uint  is_blend;
+    highp uint  is_double_sided;
+    highp uint  _padding_is_double_sided_1;
+    highp uint  _padding_is_double_sided_2;
+    highp uint  _padding_is_double_sided_3;
+};
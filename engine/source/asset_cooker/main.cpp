@@ -0,0 +1,39 @@
+#include <filesystem>
+#include <memory>
+
+#include "runtime/core/log/log_system.h"
+#include "runtime/core/meta/reflection/reflection_register.h"
+
+#include "runtime/resource/asset_cooker/asset_cooker.h"
+#include "runtime/resource/asset_manager/asset_manager.h"
+#include "runtime/resource/config_manager/config_manager.h"
+
+#include "runtime/function/global/global_context.h"
+
+// cooks the assets of the config given as argument, the PiccoloEditor.ini next to the cooker by default
+int main(int argc, char** argv)
+{
+    std::filesystem::path executable_path(argv[0]);
+    std::filesystem::path config_file_path =
+        argc > 1 ? std::filesystem::path(argv[1]) : executable_path.parent_path() / "PiccoloEditor.ini";
+
+    Piccolo::Reflection::TypeMetaRegister::Register();
+
+    // only the systems the assets are loaded with are started, the cooker needs no window or device
+    Piccolo::RuntimeGlobalContext& global_context = Piccolo::g_runtime_global_context;
+    global_context.m_config_manager               = std::make_shared<Piccolo::ConfigManager>();
+    global_context.m_config_manager->initialize(config_file_path);
+    global_context.m_logger_system = std::make_shared<Piccolo::LogSystem>();
+    global_context.m_asset_manager = std::make_shared<Piccolo::AssetManager>();
+
+    Piccolo::AssetCooker asset_cooker;
+    const bool           is_cooked = asset_cooker.cook();
+
+    global_context.m_asset_manager.reset();
+    global_context.m_logger_system.reset();
+    global_context.m_config_manager.reset();
+
+    Piccolo::Reflection::TypeMetaRegister::Unregister();
+
+    return is_cooked ? 0 : 1;
+}
@@ -5,6 +5,7 @@
 #include "runtime/function/framework/object/object.h"
 #include "runtime/function/render/render_object.h"
 
+#include <functional>
 #include <memory>
 
 namespace Piccolo
@@ -47,7 +48,8 @@ namespace Piccolo
 
         void setEditorCamera(std::shared_ptr<RenderCamera> camera) { m_camera = camera; }
         void uploadAxisResource();
-        size_t getGuidOfPickedMesh(const Vector2& picked_uv) const;
+        // the callback receives the picked mesh id a few frames later
+        void requestGuidOfPickedMesh(const Vector2& picked_uv, std::function<void(uint32_t)> callback) const;
 
     public:
         std::shared_ptr<RenderCamera> getEditorCamera() { return m_camera; };
@@ -283,10 +283,14 @@ namespace Piccolo
             {
                 Vector2 picked_uv((m_mouse_x - m_engine_window_pos.x) / m_engine_window_size.x,
                                   (m_mouse_y - m_engine_window_pos.y) / m_engine_window_size.y);
-                size_t  select_mesh_id = g_editor_global_context.m_scene_manager->getGuidOfPickedMesh(picked_uv);
 
-                size_t gobject_id = g_editor_global_context.m_render_system->getGObjectIDByMeshID(select_mesh_id);
-                g_editor_global_context.m_scene_manager->onGObjectSelected(gobject_id);
+                // the selection is applied a few frames later when the picked id was read back
+                g_editor_global_context.m_scene_manager->requestGuidOfPickedMesh(
+                    picked_uv, [](uint32_t select_mesh_id) {
+                        GObjectID gobject_id =
+                            g_editor_global_context.m_render_system->getGObjectIDByMeshID(select_mesh_id);
+                        g_editor_global_context.m_scene_manager->onGObjectSelected(gobject_id);
+                    });
             }
         }
     }
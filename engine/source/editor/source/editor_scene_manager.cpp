@@ -290,10 +290,8 @@ namespace Piccolo
             if (current_active_level == nullptr)
                 return;
 
+            // the level removes the object from the render scene as well
             current_active_level->deleteGObjectByID(m_selected_gobject_id);
-
-            RenderSwapContext& swap_context = g_editor_global_context.m_render_system->getSwapContext();
-            swap_context.getLogicSwapData().addDeleteGameObject(GameObjectDesc {selected_object->getID(), {}});
         }
         onGObjectSelected(k_invalid_gobject_id);
     }
@@ -571,8 +569,9 @@ namespace Piccolo
             {m_translation_axis.m_mesh_data, m_rotation_axis.m_mesh_data, m_scale_aixs.m_mesh_data});
     }
 
-    size_t EditorSceneManager::getGuidOfPickedMesh(const Vector2& picked_uv) const
+    void EditorSceneManager::requestGuidOfPickedMesh(const Vector2&                picked_uv,
+                                                     std::function<void(uint32_t)> callback) const
     {
-        return g_editor_global_context.m_render_system->getGuidOfPickedMesh(picked_uv);
+        g_editor_global_context.m_render_system->requestGuidOfPickedMesh(picked_uv, std::move(callback));
     }
 } // namespace Piccolo
@@ -419,8 +419,8 @@ namespace Piccolo
 
     void EditorUI::createLeafNodeUI(Reflection::ReflectionInstance& instance)
     {
-        Reflection::FieldAccessor* fields;
-        int                        fields_count = instance.m_meta.getFieldsList(fields);
+        const Reflection::FieldAccessor* fields;
+        int                              fields_count = instance.m_meta.getFieldsList(fields);
 
         for (size_t index = 0; index < fields_count; index++)
         {
@@ -490,7 +490,6 @@ namespace Piccolo
                                                                      field.get(instance.m_instance));
             }
         }
-        delete[] fields;
     }
 
     void EditorUI::showEditorDetailWindow(bool* p_open)
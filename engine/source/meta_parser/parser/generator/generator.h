@@ -14,7 +14,10 @@ namespace Generator
             m_out_path(out_path),
             m_root_path(root_path), m_get_include_func(get_include_func)
         {}
-        virtual int  generate(std::string path, SchemaMoudle schema) = 0;
+        // called once with the number of schemas before they are generated
+        virtual void prepare(size_t module_count) {};
+        // the schemas are generated concurrently, each call may only touch the state of its module index
+        virtual int  generate(size_t module_index, std::string path, SchemaMoudle schema) = 0;
         virtual void finish() {};
 
         virtual ~GeneratorInterface() {};
@@ -29,7 +29,12 @@ namespace Generator
         auto relativeDir = fs::path(path).filename().replace_extension("reflection.gen.h").string();
         return m_out_path + "/" + relativeDir;
     }
-    int ReflectionGenerator::generate(std::string path, SchemaMoudle schema)
+    void ReflectionGenerator::prepare(size_t module_count)
+    {
+        m_head_file_list.assign(module_count, std::string());
+        m_type_list.assign(module_count, std::vector<std::string>());
+    }
+    int ReflectionGenerator::generate(size_t module_index, std::string path, SchemaMoudle schema)
     {
         static const std::string vector_prefix = "std::vector<";
 
@@ -107,10 +112,10 @@ namespace Generator
 
         for (auto class_item : class_names)
         {
-            m_type_list.emplace_back(class_item.first);
+            m_type_list[module_index].emplace_back(class_item.first);
         }
 
-        m_head_file_list.emplace_back(Utils::makeRelativePath(m_root_path, file_path).string());
+        m_head_file_list[module_index] = Utils::makeRelativePath(m_root_path, file_path).string();
         return 0;
     }
     void ReflectionGenerator::finish()
@@ -123,9 +128,12 @@ namespace Generator
         {
             include_headfiles.push_back(Mustache::data("headfile_name", head_file));
         }
-        for (auto& class_name : m_type_list)
+        for (auto& module_type_list : m_type_list)
         {
-            class_defines.push_back(Mustache::data("class_name", class_name));
+            for (auto& class_name : module_type_list)
+            {
+                class_defines.push_back(Mustache::data("class_name", class_name));
+            }
         }
         mustache_data.set("include_headfiles", include_headfiles);
         mustache_data.set("class_defines", class_defines);
@@ -7,7 +7,8 @@ namespace Generator
     public:
         ReflectionGenerator() = delete;
         ReflectionGenerator(std::string source_directory, std::function<std::string(std::string)> get_include_function);
-        virtual int  generate(std::string path, SchemaMoudle schema) override;
+        virtual void prepare(size_t module_count) override;
+        virtual int  generate(size_t module_index, std::string path, SchemaMoudle schema) override;
         virtual void finish() override;
         virtual ~ReflectionGenerator() override;
 
@@ -16,7 +17,8 @@ namespace Generator
         virtual std::string processFileName(std::string path) override;
 
     private:
-        std::vector<std::string> m_head_file_list;
-        std::vector<std::string> m_type_list;
+        // one slot per schema, finish() walks them in schema order
+        std::vector<std::string>              m_head_file_list;
+        std::vector<std::vector<std::string>> m_type_list;
     };
 } // namespace Generator
@@ -25,7 +25,16 @@ namespace Generator
         auto relativeDir = fs::path(path).filename().replace_extension("serializer.gen.h").string();
         return m_out_path + "/" + relativeDir;
     }
-    int SerializerGenerator::generate(std::string path, SchemaMoudle schema)
+    void SerializerGenerator::prepare(size_t module_count)
+    {
+        // the mustache data can't be assigned, only constructed
+        m_class_defines.clear();
+        m_class_defines.resize(module_count);
+        m_include_headfiles.assign(module_count, std::string());
+        m_schema_description.assign(module_count, std::string());
+    }
+
+    int SerializerGenerator::generate(size_t module_index, std::string path, SchemaMoudle schema)
     {
         std::string file_path = processFileName(path);
 
@@ -43,6 +52,21 @@ namespace Generator
             Mustache::data class_def;
             genClassRenderData(class_temp, class_def);
 
+            std::string& schema_description = m_schema_description[module_index];
+            schema_description += class_temp->getClassName() + ":";
+            for (auto& base_class : class_temp->m_base_classes)
+            {
+                schema_description += base_class->name + ",";
+            }
+            schema_description += "{";
+            for (auto& field : class_temp->m_fields)
+            {
+                if (!field->shouldCompile())
+                    continue;
+                schema_description += field->m_type + " " + field->m_name + ";";
+            }
+            schema_description += "}";
+
             // deal base class
             for (int index = 0; index < class_temp->m_base_classes.size(); ++index)
             {
@@ -78,7 +102,7 @@ namespace Generator
                 // deal normal
             }
             class_defines.push_back(class_def);
-            m_class_defines.push_back(class_def);
+            m_class_defines[module_index].push_back(class_def);
         }
 
         muatache_data.set("class_defines", class_defines);
@@ -87,16 +111,42 @@ namespace Generator
             TemplateManager::getInstance()->renderByTemplate("commonSerializerGenFile", muatache_data);
         Utils::saveFile(render_string, file_path);
 
-        m_include_headfiles.push_back(
-            Mustache::data("headfile_name", Utils::makeRelativePath(m_root_path, file_path).string()));
+        m_include_headfiles[module_index] = Utils::makeRelativePath(m_root_path, file_path).string();
         return 0;
     }
 
     void SerializerGenerator::finish()
     {
         Mustache::data mustache_data;
-        mustache_data.set("class_defines", m_class_defines);
-        mustache_data.set("include_headfiles", m_include_headfiles);
+        Mustache::data class_defines(Mustache::data::type::list);
+        Mustache::data include_headfiles(Mustache::data::type::list);
+        for (auto& module_class_defines : m_class_defines)
+        {
+            for (auto& class_def : module_class_defines)
+            {
+                class_defines.push_back(class_def);
+            }
+        }
+        for (auto& head_file : m_include_headfiles)
+        {
+            include_headfiles.push_back(Mustache::data("headfile_name", head_file));
+        }
+        mustache_data.set("class_defines", class_defines);
+        mustache_data.set("include_headfiles", include_headfiles);
+
+        // fnv-1a, only has to change whenever a serialized layout changes
+        uint64_t schema_hash = 14695981039346656037ull;
+        for (auto& schema_description : m_schema_description)
+        {
+            for (unsigned char c : schema_description)
+            {
+                schema_hash ^= c;
+                schema_hash *= 1099511628211ull;
+            }
+        }
+        std::ostringstream schema_hash_stream;
+        schema_hash_stream << "0x" << std::hex << schema_hash;
+        mustache_data.set("schema_hash", schema_hash_stream.str());
 
         std::string render_string = TemplateManager::getInstance()->renderByTemplate("allSerializer.h", mustache_data);
         Utils::saveFile(render_string, m_out_path + "/all_serializer.h");
@@ -8,7 +8,9 @@ namespace Generator
         SerializerGenerator() = delete;
         SerializerGenerator(std::string source_directory, std::function<std::string(std::string)> get_include_function);
 
-        virtual int generate(std::string path, SchemaMoudle schema) override;
+        virtual void prepare(size_t module_count) override;
+
+        virtual int generate(size_t module_index, std::string path, SchemaMoudle schema) override;
 
         virtual void finish() override;
 
@@ -20,7 +22,10 @@ namespace Generator
         virtual std::string processFileName(std::string path) override;
 
     private:
-        Mustache::data m_class_defines {Mustache::data::type::list};
-        Mustache::data m_include_headfiles {Mustache::data::type::list};
+        // one slot per schema, finish() walks them in schema order
+        std::vector<std::vector<Mustache::data>> m_class_defines;
+        std::vector<std::string>                 m_include_headfiles;
+        // layout of every serialized class, hashed into the header of binary assets
+        std::vector<std::string> m_schema_description;
     };
 } // namespace Generator
@@ -4,6 +4,8 @@
 
 BaseClass::BaseClass(const Cursor& cursor) : name(Utils::getTypeNameWithoutNamespace(cursor.getType())) {}
 
+BaseClass::BaseClass(const std::string& base_class_name) : name(base_class_name) {}
+
 Class::Class(const Cursor& cursor, const Namespace& current_namespace) :
     TypeInfo(cursor, current_namespace), m_name(cursor.getDisplayName()),
     m_qualified_name(Utils::getTypeNameWithoutNamespace(cursor.getType())),
@@ -32,6 +34,15 @@ Class::Class(const Cursor& cursor, const Namespace& current_namespace) :
     }
 }
 
+Class::Class(const MetaInfo&    meta_data,
+             const Namespace&   current_namespace,
+             const std::string& source_file,
+             const std::string& name,
+             const std::string& qualified_name) :
+    TypeInfo(meta_data, current_namespace, source_file),
+    m_name(name), m_qualified_name(qualified_name), m_display_name(Utils::getNameWithoutFirstM(m_qualified_name))
+{}
+
 bool Class::shouldCompile(void) const { return shouldCompileFilds(); }
 
 bool Class::shouldCompileFilds(void) const
@@ -7,6 +7,7 @@
 struct BaseClass
 {
     BaseClass(const Cursor& cursor);
+    BaseClass(const std::string& base_class_name);
 
     std::string name;
 };
@@ -19,6 +20,12 @@ class Class : public TypeInfo
 
 public:
     Class(const Cursor& cursor, const Namespace& current_namespace);
+    // restores a class from the parser cache, the base classes and fields are added by the cache
+    Class(const MetaInfo&    meta_data,
+          const Namespace&   current_namespace,
+          const std::string& source_file,
+          const std::string& name,
+          const std::string& qualified_name);
 
     virtual bool shouldCompile(void) const;
 
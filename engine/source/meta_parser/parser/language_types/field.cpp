@@ -15,6 +15,18 @@ Field::Field(const Cursor& cursor, const Namespace& current_namespace, Class* pa
     m_default       = ret_string;
 }
 
+Field::Field(const MetaInfo&    meta_data,
+             const Namespace&   current_namespace,
+             Class*             parent,
+             const std::string& name,
+             const std::string& type,
+             const std::string& default_value,
+             bool               is_const) :
+    TypeInfo(meta_data, current_namespace, parent->getSourceFile()),
+    m_is_const(is_const), m_parent(parent), m_name(name), m_display_name(Utils::getNameWithoutFirstM(m_name)),
+    m_type(type), m_default(default_value)
+{}
+
 bool Field::shouldCompile(void) const { return isAccessible(); }
 
 bool Field::isAccessible(void) const
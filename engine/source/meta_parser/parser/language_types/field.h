@@ -9,6 +9,14 @@ class Field : public TypeInfo
 
 public:
     Field(const Cursor& cursor, const Namespace& current_namespace, Class* parent = nullptr);
+    // restores a field from the parser cache
+    Field(const MetaInfo&    meta_data,
+          const Namespace&   current_namespace,
+          Class*             parent,
+          const std::string& name,
+          const std::string& type,
+          const std::string& default_value,
+          bool               is_const);
 
     virtual ~Field(void) {}
 
@@ -10,6 +10,8 @@ class TypeInfo
 {
 public:
     TypeInfo(const Cursor& cursor, const Namespace& current_namespace);
+    // restores a type from the parser cache, it has no cursor to look at
+    TypeInfo(const MetaInfo& meta_data, const Namespace& current_namespace, const std::string& source_file);
     virtual ~TypeInfo(void) {}
 
     const MetaInfo& getMetaData(void) const;
@@ -29,6 +31,8 @@ protected:
 
     Namespace m_namespace;
 
+    std::string m_source_file;
+
 private:
     // cursor that represents the root of this language type
     Cursor m_root_cursor;
@@ -63,6 +63,7 @@ int parse(std::string project_input_file_name,
     }
 
     parser.generateFiles();
+    parser.printStageTimes();
 
     return 0;
 }
@@ -17,6 +17,8 @@ MetaInfo::MetaInfo(const Cursor& cursor)
     }
 }
 
+MetaInfo::MetaInfo(const std::unordered_map<std::string, std::string>& properties) : m_properties(properties) {}
+
 std::string MetaInfo::getProperty(const std::string& key) const
 {
     auto search = m_properties.find(key);
@@ -27,6 +29,8 @@ std::string MetaInfo::getProperty(const std::string& key) const
 
 bool MetaInfo::getFlag(const std::string& key) const { return m_properties.find(key) != m_properties.end(); }
 
+const std::unordered_map<std::string, std::string>& MetaInfo::getProperties(void) const { return m_properties; }
+
 std::vector<MetaInfo::Property> MetaInfo::extractProperties(const Cursor& cursor) const
 {
     std::vector<Property> ret_list;
@@ -6,11 +6,14 @@ class MetaInfo
 {
 public:
     MetaInfo(const Cursor& cursor);
+    MetaInfo(const std::unordered_map<std::string, std::string>& properties);
 
     std::string getProperty(const std::string& key) const;
 
     bool getFlag(const std::string& key) const;
 
+    const std::unordered_map<std::string, std::string>& getProperties(void) const;
+
 private:
     typedef std::pair<std::string, std::string> Property;
 
@@ -271,6 +271,20 @@ namespace Utils
         {
             fs::create_directories(out_path.parent_path());
         }
+
+        // an unchanged file keeps its timestamp, so that the files including it are not rebuilt
+        std::ifstream existing_file_stream(output_file);
+        if (existing_file_stream.is_open())
+        {
+            std::stringstream existing_buffer;
+            existing_buffer << existing_file_stream.rdbuf();
+            existing_file_stream.close();
+            if (existing_buffer.str() == outpu_string + "\n")
+            {
+                return;
+            }
+        }
+
         std::fstream output_file_stream(output_file, std::ios_base::out);
 
         output_file_stream << outpu_string << std::endl;
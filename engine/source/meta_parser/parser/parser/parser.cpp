@@ -7,7 +7,11 @@
 
 #include "parser.h"
 
-#define RECURSE_NAMESPACES(kind, cursor, method, namespaces) \
+#include <atomic>
+#include <future>
+#include <thread>
+
+#define RECURSE_NAMESPACES(kind, cursor, method, namespaces, schema_modules) \
     { \
         if (kind == CXCursor_Namespace) \
         { \
@@ -15,19 +19,18 @@
             if (!display_name.empty()) \
             { \
                 namespaces.emplace_back(display_name); \
-                method(cursor, namespaces); \
+                method(cursor, namespaces, schema_modules); \
                 namespaces.pop_back(); \
             } \
         } \
     }
 
-#define TRY_ADD_LANGUAGE_TYPE(handle, container) \
+#define TRY_ADD_LANGUAGE_TYPE(handle, container, schema_modules) \
     { \
         if (handle->shouldCompile()) \
         { \
-            auto file = handle->getSourceFile(); \
-            m_schema_modules[file].container.emplace_back(handle); \
-            m_type_table[handle->m_display_name] = file; \
+            auto file = ParserCache::normalizePath(handle->getSourceFile()); \
+            schema_modules[file].container.emplace_back(handle); \
         } \
     }
 
@@ -46,8 +49,8 @@ MetaParser::MetaParser(const std::string project_input_file,
                        const std::string module_name,
                        bool              is_show_errors) :
     m_project_input_file(project_input_file),
-    m_source_include_file_name(include_file_path), m_index(nullptr), m_translation_unit(nullptr),
-    m_sys_include(sys_include), m_module_name(module_name), m_is_show_errors(is_show_errors)
+    m_source_include_file_name(include_file_path), m_sys_include(sys_include), m_module_name(module_name),
+    m_is_show_errors(is_show_errors)
 {
     m_work_paths = Utils::split(include_path, ";");
 
@@ -65,11 +68,17 @@ MetaParser::~MetaParser(void)
     }
     m_generators.clear();
 
-    if (m_translation_unit)
-        clang_disposeTranslationUnit(m_translation_unit);
+    for (auto translation_unit : m_translation_units)
+    {
+        if (translation_unit)
+            clang_disposeTranslationUnit(translation_unit);
+    }
 
-    if (m_index)
-        clang_disposeIndex(m_index);
+    for (auto index : m_indices)
+    {
+        if (index)
+            clang_disposeIndex(index);
+    }
 }
 
 void MetaParser::finish(void)
@@ -82,7 +91,6 @@ void MetaParser::finish(void)
 
 bool MetaParser::parseProject()
 {
-    bool result = true;
     std::cout << "Parsing project file: " << m_project_input_file << std::endl;
 
     std::fstream include_txt_file(m_project_input_file, std::ios::in);
@@ -98,19 +106,25 @@ bool MetaParser::parseProject()
 
     std::string context = buffer.str();
 
-    auto         inlcude_files = Utils::split(context, ";");
-    std::fstream include_file;
-
-    include_file.open(m_source_include_file_name, std::ios::out);
-    if (!include_file.is_open())
+    m_header_files.clear();
+    // the runtime and editor header lists are joined with a comma in precompile.json
+    for (auto& include_list : Utils::split(context, ";"))
     {
-        std::cout << "Could not open the Source Include file: " << m_source_include_file_name << std::endl;
-        return false;
+        for (auto include_item : Utils::split(include_list, ","))
+        {
+            Utils::trim(include_item, " \t\r\n");
+            if (include_item.empty())
+                continue;
+            Utils::replace(include_item, '\\', '/');
+            m_header_files.emplace_back(include_item);
+        }
     }
+    return true;
+}
 
-    std::cout << "Generating the Source Include file: " << m_source_include_file_name << std::endl;
-
-    std::string output_filename = Utils::getFileName(m_source_include_file_name);
+bool MetaParser::writeSourceIncludeFile(const std::string& file_name, const std::vector<std::string>& header_files)
+{
+    std::string output_filename = Utils::getFileName(file_name);
 
     if (output_filename.empty())
     {
@@ -122,23 +136,26 @@ bool MetaParser::parseProject()
         Utils::replace(output_filename, " ", "_");
         Utils::toUpper(output_filename);
     }
+
+    std::ostringstream include_file;
     include_file << "#ifndef __" << output_filename << "__" << std::endl;
     include_file << "#define __" << output_filename << "__" << std::endl;
 
-    for (auto include_item : inlcude_files)
+    for (auto& include_item : header_files)
     {
-        std::string temp_string(include_item);
-        Utils::replace(temp_string, '\\', '/');
-        include_file << "#include  \"" << temp_string << "\"" << std::endl;
+        include_file << "#include  \"" << include_item << "\"" << std::endl;
     }
 
-    include_file << "#endif" << std::endl;
-    include_file.close();
-    return result;
+    include_file << "#endif";
+
+    Utils::saveFile(include_file.str(), file_name);
+    return fs::exists(file_name);
 }
 
 int MetaParser::parse(void)
 {
+    auto start_time = std::chrono::steady_clock::now();
+
     bool parse_include_ = parseProject();
     if (!parse_include_)
     {
@@ -146,9 +163,6 @@ int MetaParser::parse(void)
         return -1;
     }
 
-    std::cerr << "Parsing the whole project..." << std::endl;
-    int is_show_errors      = m_is_show_errors ? 1 : 0;
-    m_index                 = clang_createIndex(true, is_show_errors);
     std::string pre_include = "-I";
     std::string sys_include_temp;
     if (!(m_sys_include == "*"))
@@ -165,41 +179,292 @@ int MetaParser::parse(void)
         arguments.emplace_back(paths[index].c_str());
     }
 
-    fs::path input_path(m_source_include_file_name);
-    if (!fs::exists(input_path))
+    // a cache written with other arguments may have seen other classes
+    std::string cache_salt;
+    for (auto argument : arguments)
+    {
+        cache_salt += std::string(argument) + " ";
+    }
+    fs::path cache_file = fs::path(m_source_include_file_name).parent_path() / "parser_cache.txt";
+    m_cache = std::make_unique<ParserCache>(
+        cache_file.string(), m_work_paths, m_work_paths[0] + "/_generated", cache_salt);
+    m_cache->load();
+
+    // the cached headers that are not listed are the ones included by the listed headers
+    std::set<std::string> header_file_set;
+    for (auto& header_file : m_header_files)
     {
-        std::cerr << input_path << " is not exist" << std::endl;
-        return -2;
+        header_file_set.insert(ParserCache::normalizePath(header_file));
+    }
+    for (auto& header_file : m_cache->getHeaderFiles())
+    {
+        if (fs::exists(header_file))
+            header_file_set.insert(header_file);
+        else
+            m_cache->remove(header_file);
     }
 
-    m_translation_unit = clang_createTranslationUnitFromSourceFile(
-        m_index, m_source_include_file_name.c_str(), static_cast<int>(arguments.size()), arguments.data(), 0, nullptr);
-    auto cursor = clang_getTranslationUnitCursor(m_translation_unit);
+    std::vector<std::string> outdated_header_files;
+    for (auto& header_file : header_file_set)
+    {
+        if (!m_cache->isUpToDate(header_file))
+        {
+            outdated_header_files.emplace_back(header_file);
+        }
+    }
+    addStageTime("check headers", start_time);
+
+    if (outdated_header_files.empty())
+    {
+        std::cout << "All " << header_file_set.size() << " headers are up to date" << std::endl;
+    }
+    else
+    {
+        std::cout << "Parsing " << outdated_header_files.size() << " of " << header_file_set.size()
+                  << " headers..." << std::endl;
+        if (!parseHeaders(outdated_header_files))
+        {
+            return -2;
+        }
+    }
+
+    start_time = std::chrono::steady_clock::now();
+
+    // the generators always see every class, the unchanged ones come from the cache
+    m_schema_modules.clear();
+    m_type_table.clear();
+    for (auto& header_file : m_cache->getHeaderFiles())
+    {
+        auto& classes = m_cache->getClasses(header_file);
+        if (classes.empty())
+        {
+            if (header_file_set.find(header_file) == header_file_set.end())
+                m_cache->remove(header_file);
+            continue;
+        }
+        m_schema_modules[header_file].classes = classes;
+        for (auto& class_temp : classes)
+        {
+            m_type_table[class_temp->m_display_name] = header_file;
+        }
+    }
+
+    m_cache->save();
+    addStageTime("update cache", start_time);
+    return 0;
+}
+
+bool MetaParser::parseHeaders(const std::vector<std::string>& header_files)
+{
+    auto start_time = std::chrono::steady_clock::now();
+
+    // neighbouring headers share most of their includes, so every unit gets a contiguous range of them
+    size_t unit_count = std::min(getWorkerCount(),
+                                 (header_files.size() + s_min_headers_per_unit - 1) / s_min_headers_per_unit);
+    unit_count        = std::max<size_t>(unit_count, 1);
+
+    std::vector<ParsedUnit> units(unit_count);
+    fs::path                source_include_path(m_source_include_file_name);
+    for (size_t unit_index = 0; unit_index < unit_count; ++unit_index)
+    {
+        ParsedUnit& unit = units[unit_index];
+        size_t      begin = header_files.size() * unit_index / unit_count;
+        size_t      end   = header_files.size() * (unit_index + 1) / unit_count;
+        unit.m_header_files.assign(header_files.begin() + begin, header_files.begin() + end);
+
+        // the first unit keeps the name the build passes in, the others are numbered next to it
+        fs::path unit_include_path = source_include_path;
+        if (unit_index > 0)
+        {
+            unit_include_path.replace_filename(source_include_path.stem().string() + "_" +
+                                               std::to_string(unit_index) +
+                                               source_include_path.extension().string());
+        }
+        unit.m_source_include_file_name = unit_include_path.string();
+    }
+
+    m_indices.assign(unit_count, nullptr);
+    m_translation_units.assign(unit_count, nullptr);
+
+    std::vector<std::future<void>> unit_workers;
+    for (size_t unit_index = 1; unit_index < unit_count; ++unit_index)
+    {
+        unit_workers.emplace_back(
+            std::async(std::launch::async, &MetaParser::parseUnit, this, unit_index, std::ref(units[unit_index])));
+    }
+    parseUnit(0, units[0]);
+    for (auto& unit_worker : unit_workers)
+    {
+        unit_worker.get();
+    }
+    addStageTime("parse " + std::to_string(unit_count) + " translation units", start_time);
+
+    bool is_valid = true;
+    for (size_t unit_index = 0; unit_index < unit_count; ++unit_index)
+    {
+        const ParsedUnit& unit = units[unit_index];
+        m_stage_times.emplace_back("  unit " + std::to_string(unit_index) + " (" +
+                                       std::to_string(unit.m_header_files.size()) + " headers)",
+                                   unit.m_parse_time_ms);
+        if (!unit.m_is_valid)
+        {
+            std::cerr << "Parsing " << unit.m_source_include_file_name << " failed" << std::endl;
+            is_valid = false;
+        }
+    }
+    if (!is_valid)
+    {
+        return false;
+    }
+
+    // a header included by several units has been parsed by each of them, the results are the same
+    std::map<std::string, SchemaMoudle> schema_modules;
+    std::set<std::string>               parsed_files;
+    for (auto& unit : units)
+    {
+        for (auto& schema : unit.m_schema_modules)
+        {
+            schema_modules.insert(schema);
+            parsed_files.insert(schema.first);
+        }
+        parsed_files.insert(unit.m_parsed_files.begin(), unit.m_parsed_files.end());
+        parsed_files.insert(unit.m_header_files.begin(), unit.m_header_files.end());
+    }
+
+    std::set<std::string> cached_files;
+    for (auto& header_file : m_cache->getHeaderFiles())
+    {
+        cached_files.insert(header_file);
+    }
+
+    // every file seen by libclang is up to date now, including the ones it reached through the outdated headers
+    static const std::vector<std::shared_ptr<Class>> empty_classes;
+    for (auto& parsed_file : parsed_files)
+    {
+        auto schema_iter = schema_modules.find(parsed_file);
+        bool has_classes = schema_iter != schema_modules.end();
+        // system and third party headers are only remembered once they declare reflected classes
+        if (!has_classes && cached_files.find(parsed_file) == cached_files.end() &&
+            std::find(header_files.begin(), header_files.end(), parsed_file) == header_files.end())
+            continue;
+
+        m_cache->update(parsed_file, has_classes ? schema_iter->second.classes : empty_classes);
+    }
+    return true;
+}
+
+void MetaParser::parseUnit(size_t unit_index, ParsedUnit& unit)
+{
+    auto start_time = std::chrono::steady_clock::now();
+
+    if (!writeSourceIncludeFile(unit.m_source_include_file_name, unit.m_header_files))
+    {
+        return;
+    }
+
+    int is_show_errors    = m_is_show_errors ? 1 : 0;
+    m_indices[unit_index] = clang_createIndex(true, is_show_errors);
+
+    CXTranslationUnit translation_unit =
+        clang_createTranslationUnitFromSourceFile(m_indices[unit_index],
+                                                  unit.m_source_include_file_name.c_str(),
+                                                  static_cast<int>(arguments.size()),
+                                                  arguments.data(),
+                                                  0,
+                                                  nullptr);
+    m_translation_units[unit_index] = translation_unit;
+    if (translation_unit == nullptr)
+    {
+        return;
+    }
+    auto cursor = clang_getTranslationUnitCursor(translation_unit);
 
     Namespace temp_namespace;
 
-    buildClassAST(cursor, temp_namespace);
+    buildClassAST(cursor, temp_namespace, unit.m_schema_modules);
 
     temp_namespace.clear();
 
-    return 0;
+    auto visitor = [](CXFile included_file, CXSourceLocation*, unsigned, CXClientData client_data) {
+        std::string file_name;
+        Utils::toString(clang_getFileName(included_file), file_name);
+        static_cast<std::set<std::string>*>(client_data)->insert(ParserCache::normalizePath(file_name));
+    };
+    clang_getInclusions(translation_unit, visitor, &unit.m_parsed_files);
+
+    unit.m_is_valid = true;
+    unit.m_parse_time_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
 }
 
 void MetaParser::generateFiles(void)
 {
+    auto start_time = std::chrono::steady_clock::now();
+
     std::cerr << "Start generate runtime schemas(" << m_schema_modules.size() << ")..." << std::endl;
+    std::vector<std::pair<const std::string*, const SchemaMoudle*>> schemas;
     for (auto& schema : m_schema_modules)
     {
-        for (auto& generator_iter : m_generators)
+        schemas.emplace_back(&schema.first, &schema.second);
+    }
+    for (auto& generator_iter : m_generators)
+    {
+        generator_iter->prepare(schemas.size());
+    }
+
+    // every schema and generator pair is rendered and written on its own, the workers take the next free one
+    size_t              task_count = schemas.size() * m_generators.size();
+    std::atomic<size_t> next_task {0};
+    auto                generate_worker = [this, &schemas, &next_task, task_count]() {
+        for (size_t task = next_task++; task < task_count; task = next_task++)
         {
-            generator_iter->generate(schema.first, schema.second);
+            auto& schema = schemas[task / m_generators.size()];
+            m_generators[task % m_generators.size()]->generate(
+                task / m_generators.size(), *schema.first, *schema.second);
         }
+    };
+
+    size_t                         worker_count = std::min(getWorkerCount(), std::max<size_t>(task_count, 1));
+    std::vector<std::future<void>> generate_workers;
+    for (size_t worker_index = 1; worker_index < worker_count; ++worker_index)
+    {
+        generate_workers.emplace_back(std::async(std::launch::async, generate_worker));
+    }
+    generate_worker();
+    for (auto& generate_worker_future : generate_workers)
+    {
+        generate_worker_future.get();
     }
+    addStageTime("generate " + std::to_string(task_count) + " files on " + std::to_string(worker_count) +
+                     " threads",
+                 start_time);
 
+    start_time = std::chrono::steady_clock::now();
     finish();
+    addStageTime("generate aggregate files", start_time);
 }
 
-void MetaParser::buildClassAST(const Cursor& cursor, Namespace& current_namespace)
+void MetaParser::printStageTimes(void) const
+{
+    std::cout << "Precompile stages:" << std::endl;
+    for (auto& stage_time : m_stage_times)
+    {
+        std::cout << "    " << stage_time.first << ": " << stage_time.second << "ms" << std::endl;
+    }
+}
+
+void MetaParser::addStageTime(const std::string& stage, std::chrono::steady_clock::time_point start_time)
+{
+    m_stage_times.emplace_back(
+        stage,
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count());
+}
+
+size_t MetaParser::getWorkerCount(void) { return std::max(std::thread::hardware_concurrency(), 1u); }
+
+void MetaParser::buildClassAST(const Cursor&                        cursor,
+                               Namespace&                           current_namespace,
+                               std::map<std::string, SchemaMoudle>& schema_modules)
 {
     for (auto& child : cursor.getChildren())
     {
@@ -210,11 +475,11 @@ void MetaParser::buildClassAST(const Cursor& cursor, Namespace& current_namespac
         {
             auto class_ptr = std::make_shared<Class>(child, current_namespace);
 
-            TRY_ADD_LANGUAGE_TYPE(class_ptr, classes);
+            TRY_ADD_LANGUAGE_TYPE(class_ptr, classes, schema_modules);
         }
         else
         {
-            RECURSE_NAMESPACES(kind, child, buildClassAST, current_namespace);
+            RECURSE_NAMESPACES(kind, child, buildClassAST, current_namespace, schema_modules);
         }
     }
 }
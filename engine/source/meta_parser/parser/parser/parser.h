@@ -8,6 +8,7 @@
 #include "cursor/cursor.h"
 
 #include "generator/generator.h"
+#include "parser/parser_cache.h"
 #include "template_manager/template_manager.h"
 
 class Class;
@@ -27,6 +28,7 @@ public:
     void finish(void);
     int  parse(void);
     void generateFiles(void);
+    void printStageTimes(void) const;
 
 private:
     std::string m_project_input_file;
@@ -35,12 +37,18 @@ private:
     std::string              m_module_name;
     std::string              m_sys_include;
     std::string              m_source_include_file_name;
+    // the headers listed in the project file
+    std::vector<std::string> m_header_files;
 
-    CXIndex           m_index;
-    CXTranslationUnit m_translation_unit;
+    // one index per translation unit, so that the units can be parsed on different threads
+    std::vector<CXIndex>           m_indices;
+    std::vector<CXTranslationUnit> m_translation_units;
 
-    std::unordered_map<std::string, std::string>  m_type_table;
-    std::unordered_map<std::string, SchemaMoudle> m_schema_modules;
+    std::unordered_map<std::string, std::string> m_type_table;
+    // ordered by file, so that the generated files don't change with the hash order
+    std::map<std::string, SchemaMoudle> m_schema_modules;
+
+    std::unique_ptr<ParserCache> m_cache;
 
     std::vector<const char*>                    arguments = {{"-x",
                                            "c++",
@@ -57,8 +65,32 @@ private:
 
     bool m_is_show_errors;
 
+    // a unit repeats the parsing of the common includes, so it should have enough headers to be worth it
+    static constexpr size_t s_min_headers_per_unit {32};
+
+    struct ParsedUnit
+    {
+        std::string                         m_source_include_file_name;
+        std::vector<std::string>            m_header_files;
+        std::map<std::string, SchemaMoudle> m_schema_modules;
+        // every file libclang went through, the outdated headers and their includes
+        std::set<std::string> m_parsed_files;
+        long long             m_parse_time_ms {0};
+        bool                  m_is_valid {false};
+    };
+
+    // wall time of each stage in milliseconds, in the order they ran
+    std::vector<std::pair<std::string, long long>> m_stage_times;
+
 private:
     bool        parseProject(void);
-    void        buildClassAST(const Cursor& cursor, Namespace& current_namespace);
+    bool        writeSourceIncludeFile(const std::string& file_name, const std::vector<std::string>& header_files);
+    bool        parseHeaders(const std::vector<std::string>& header_files);
+    void        parseUnit(size_t unit_index, ParsedUnit& unit);
+    void        buildClassAST(const Cursor&                        cursor,
+                              Namespace&                           current_namespace,
+                              std::map<std::string, SchemaMoudle>& schema_modules);
+    void        addStageTime(const std::string& stage, std::chrono::steady_clock::time_point start_time);
+    static size_t getWorkerCount(void);
     std::string getIncludeFile(std::string name);
 };
@@ -0,0 +1,414 @@
+#include "common/precompiled.h"
+
+#include "language_types/class.h"
+
+#include "parser_cache.h"
+
+namespace
+{
+    // bump whenever the parser extracts something different from the same header
+    const std::string k_cache_format = "PiccoloParserCache 1";
+
+    const uint64_t k_fnv_offset_basis = 14695981039346656037ull;
+    const uint64_t k_fnv_prime        = 1099511628211ull;
+
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+    {
+        auto bytes = static_cast<const unsigned char*>(data);
+        for (size_t index = 0; index < size; ++index)
+        {
+            hash ^= bytes[index];
+            hash *= k_fnv_prime;
+        }
+        return hash;
+    }
+
+    // strings are stored with their length in front, so that the meta properties may contain anything
+    void writeString(std::ostream& stream, const std::string& value)
+    {
+        stream << value.size() << ':' << value << '\n';
+    }
+
+    bool readString(std::istream& stream, std::string& out_value)
+    {
+        size_t size      = 0;
+        char   separator = 0;
+        if (!(stream >> size) || !stream.get(separator) || separator != ':')
+        {
+            return false;
+        }
+        out_value.resize(size);
+        if (size > 0 && !stream.read(&out_value[0], size))
+        {
+            return false;
+        }
+        return static_cast<bool>(stream.ignore(1));
+    }
+
+    void writeNumber(std::ostream& stream, uint64_t value) { stream << value << '\n'; }
+
+    bool readNumber(std::istream& stream, uint64_t& out_value) { return static_cast<bool>(stream >> out_value); }
+
+    void writeNamespace(std::ostream& stream, const Namespace& current_namespace)
+    {
+        writeNumber(stream, current_namespace.size());
+        for (auto& name : current_namespace)
+        {
+            writeString(stream, name);
+        }
+    }
+
+    bool readNamespace(std::istream& stream, Namespace& out_namespace)
+    {
+        uint64_t count = 0;
+        if (!readNumber(stream, count))
+        {
+            return false;
+        }
+        out_namespace.resize(count);
+        for (auto& name : out_namespace)
+        {
+            if (!readString(stream, name))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void writeMetaInfo(std::ostream& stream, const MetaInfo& meta_data)
+    {
+        // sorted, so that the same classes always produce the same cache file
+        std::map<std::string, std::string> properties(meta_data.getProperties().begin(),
+                                                      meta_data.getProperties().end());
+        writeNumber(stream, properties.size());
+        for (auto& property : properties)
+        {
+            writeString(stream, property.first);
+            writeString(stream, property.second);
+        }
+    }
+
+    bool readMetaInfo(std::istream& stream, std::unordered_map<std::string, std::string>& out_properties)
+    {
+        uint64_t count = 0;
+        if (!readNumber(stream, count))
+        {
+            return false;
+        }
+        for (uint64_t index = 0; index < count; ++index)
+        {
+            std::string key;
+            std::string value;
+            if (!readString(stream, key) || !readString(stream, value))
+            {
+                return false;
+            }
+            out_properties[key] = value;
+        }
+        return true;
+    }
+
+    void writeClass(std::ostream& stream, const std::shared_ptr<Class>& class_temp)
+    {
+        writeString(stream, class_temp->m_name);
+        writeString(stream, class_temp->m_qualified_name);
+        writeNamespace(stream, class_temp->getCurrentNamespace());
+        writeMetaInfo(stream, class_temp->getMetaData());
+
+        writeNumber(stream, class_temp->m_base_classes.size());
+        for (auto& base_class : class_temp->m_base_classes)
+        {
+            writeString(stream, base_class->name);
+        }
+
+        writeNumber(stream, class_temp->m_fields.size());
+        for (auto& field : class_temp->m_fields)
+        {
+            writeString(stream, field->m_name);
+            writeString(stream, field->m_type);
+            writeString(stream, field->m_default);
+            writeNumber(stream, field->m_is_const ? 1 : 0);
+            writeMetaInfo(stream, field->getMetaData());
+        }
+    }
+
+    std::shared_ptr<Class> readClass(std::istream& stream, const std::string& source_file)
+    {
+        std::string                                  name;
+        std::string                                  qualified_name;
+        Namespace                                    current_namespace;
+        std::unordered_map<std::string, std::string> properties;
+        if (!readString(stream, name) || !readString(stream, qualified_name) ||
+            !readNamespace(stream, current_namespace) || !readMetaInfo(stream, properties))
+        {
+            return nullptr;
+        }
+        auto class_temp =
+            std::make_shared<Class>(MetaInfo(properties), current_namespace, source_file, name, qualified_name);
+
+        uint64_t base_class_count = 0;
+        if (!readNumber(stream, base_class_count))
+        {
+            return nullptr;
+        }
+        for (uint64_t index = 0; index < base_class_count; ++index)
+        {
+            std::string base_class_name;
+            if (!readString(stream, base_class_name))
+            {
+                return nullptr;
+            }
+            class_temp->m_base_classes.emplace_back(new BaseClass(base_class_name));
+        }
+
+        uint64_t field_count = 0;
+        if (!readNumber(stream, field_count))
+        {
+            return nullptr;
+        }
+        for (uint64_t index = 0; index < field_count; ++index)
+        {
+            std::string                                  field_name;
+            std::string                                  field_type;
+            std::string                                  field_default;
+            uint64_t                                     is_const = 0;
+            std::unordered_map<std::string, std::string> field_properties;
+            if (!readString(stream, field_name) || !readString(stream, field_type) ||
+                !readString(stream, field_default) || !readNumber(stream, is_const) ||
+                !readMetaInfo(stream, field_properties))
+            {
+                return nullptr;
+            }
+            class_temp->m_fields.emplace_back(new Field(MetaInfo(field_properties),
+                                                        current_namespace,
+                                                        class_temp.get(),
+                                                        field_name,
+                                                        field_type,
+                                                        field_default,
+                                                        is_const != 0));
+        }
+        return class_temp;
+    }
+} // namespace
+
+ParserCache::ParserCache(const std::string&              cache_file,
+                         const std::vector<std::string>& include_paths,
+                         const std::string&              generated_directory,
+                         const std::string&              salt) :
+    m_cache_file(cache_file),
+    m_include_paths(include_paths), m_generated_directory(normalizePath(generated_directory)), m_salt(salt)
+{}
+
+std::string ParserCache::normalizePath(const std::string& path)
+{
+    return fs::path(path).lexically_normal().generic_string();
+}
+
+void ParserCache::load(void)
+{
+    m_entries.clear();
+
+    std::ifstream cache_stream(m_cache_file, std::ios::in | std::ios::binary);
+    if (!cache_stream.is_open())
+    {
+        return;
+    }
+
+    std::string format;
+    std::string salt;
+    uint64_t    entry_count = 0;
+    if (!readString(cache_stream, format) || format != k_cache_format || !readString(cache_stream, salt) ||
+        salt != m_salt || !readNumber(cache_stream, entry_count))
+    {
+        std::cout << "Parser cache is outdated, parsing every header" << std::endl;
+        return;
+    }
+
+    for (uint64_t entry_index = 0; entry_index < entry_count; ++entry_index)
+    {
+        std::string header_file;
+        HeaderEntry entry;
+        uint64_t    class_count = 0;
+        if (!readString(cache_stream, header_file) || !readNumber(cache_stream, entry.m_fingerprint) ||
+            !readNumber(cache_stream, class_count))
+        {
+            break;
+        }
+
+        bool is_valid = true;
+        for (uint64_t class_index = 0; class_index < class_count && is_valid; ++class_index)
+        {
+            auto class_temp = readClass(cache_stream, header_file);
+            is_valid        = class_temp != nullptr;
+            entry.m_classes.emplace_back(class_temp);
+        }
+        if (!is_valid)
+        {
+            break;
+        }
+        m_entries[header_file] = std::move(entry);
+    }
+
+    if (m_entries.size() != entry_count)
+    {
+        std::cout << "Parser cache is corrupted, parsing every header" << std::endl;
+        m_entries.clear();
+    }
+}
+
+void ParserCache::save(void) const
+{
+    std::ostringstream cache_stream;
+    writeString(cache_stream, k_cache_format);
+    writeString(cache_stream, m_salt);
+    writeNumber(cache_stream, m_entries.size());
+    for (auto& entry : m_entries)
+    {
+        writeString(cache_stream, entry.first);
+        writeNumber(cache_stream, entry.second.m_fingerprint);
+        writeNumber(cache_stream, entry.second.m_classes.size());
+        for (auto& class_temp : entry.second.m_classes)
+        {
+            writeClass(cache_stream, class_temp);
+        }
+    }
+
+    std::ofstream output_stream(m_cache_file, std::ios::out | std::ios::binary | std::ios::trunc);
+    output_stream << cache_stream.str();
+}
+
+const ParserCache::FileInfo& ParserCache::getFileInfo(const std::string& file)
+{
+    auto iter = m_file_infos.find(file);
+    if (iter != m_file_infos.end())
+    {
+        return iter->second;
+    }
+
+    FileInfo&     file_info = m_file_infos[file];
+    std::ifstream file_stream(file, std::ios::in | std::ios::binary);
+    if (!file_stream.is_open())
+    {
+        // a missing header keeps the hash at 0, it changes again once the header shows up
+        return file_info;
+    }
+
+    std::stringstream buffer;
+    buffer << file_stream.rdbuf();
+    std::string content = buffer.str();
+
+    file_info.m_content_hash = hashBytes(k_fnv_offset_basis, content.data(), content.size());
+
+    std::istringstream content_stream(content);
+    std::string        line;
+    while (std::getline(content_stream, line))
+    {
+        size_t pos = line.find_first_not_of(" \t");
+        if (pos == std::string::npos || line[pos] != '#')
+            continue;
+        pos = line.find_first_not_of(" \t", pos + 1);
+        if (pos == std::string::npos || line.compare(pos, 7, "include") != 0)
+            continue;
+        pos = line.find_first_not_of(" \t", pos + 7);
+        if (pos == std::string::npos || line[pos] != '"')
+            continue;
+        size_t end = line.find('"', pos + 1);
+        if (end == std::string::npos)
+            continue;
+
+        std::string include_file = resolveInclude(file, line.substr(pos + 1, end - pos - 1));
+        if (!include_file.empty())
+        {
+            file_info.m_includes.emplace_back(include_file);
+        }
+    }
+    return file_info;
+}
+
+std::string ParserCache::resolveInclude(const std::string& including_file, const std::string& include_name) const
+{
+    std::vector<fs::path> candidates {fs::path(including_file).parent_path() / include_name};
+    for (auto& include_path : m_include_paths)
+    {
+        candidates.emplace_back(fs::path(include_path) / include_name);
+    }
+
+    for (auto& candidate : candidates)
+    {
+        std::error_code error_code;
+        if (!fs::is_regular_file(candidate, error_code))
+            continue;
+
+        std::string include_file = normalizePath(candidate.string());
+        if (!m_generated_directory.empty() &&
+            include_file.compare(0, m_generated_directory.size(), m_generated_directory) == 0)
+        {
+            return std::string();
+        }
+        return include_file;
+    }
+    // includes that can't be found, like the system headers, are left to libclang
+    return std::string();
+}
+
+uint64_t ParserCache::getFingerprint(const std::string& header_file)
+{
+    // the closure is hashed in path order, so the order of the includes does not matter
+    std::set<std::string>    visited_files;
+    std::vector<std::string> pending_files {normalizePath(header_file)};
+    while (!pending_files.empty())
+    {
+        std::string file = pending_files.back();
+        pending_files.pop_back();
+        if (!visited_files.insert(file).second)
+            continue;
+
+        for (auto& include_file : getFileInfo(file).m_includes)
+        {
+            pending_files.emplace_back(include_file);
+        }
+    }
+
+    uint64_t fingerprint = k_fnv_offset_basis;
+    for (auto& file : visited_files)
+    {
+        uint64_t content_hash = getFileInfo(file).m_content_hash;
+        fingerprint           = hashBytes(fingerprint, file.data(), file.size());
+        fingerprint           = hashBytes(fingerprint, &content_hash, sizeof(content_hash));
+    }
+    return fingerprint;
+}
+
+bool ParserCache::isUpToDate(const std::string& header_file)
+{
+    auto iter = m_entries.find(normalizePath(header_file));
+    return iter != m_entries.end() && iter->second.m_fingerprint == getFingerprint(header_file);
+}
+
+void ParserCache::update(const std::string& header_file, const std::vector<std::shared_ptr<Class>>& classes)
+{
+    HeaderEntry& entry  = m_entries[normalizePath(header_file)];
+    entry.m_fingerprint = getFingerprint(header_file);
+    entry.m_classes     = classes;
+}
+
+void ParserCache::remove(const std::string& header_file) { m_entries.erase(normalizePath(header_file)); }
+
+std::vector<std::string> ParserCache::getHeaderFiles(void) const
+{
+    std::vector<std::string> header_files;
+    for (auto& entry : m_entries)
+    {
+        header_files.emplace_back(entry.first);
+    }
+    return header_files;
+}
+
+const std::vector<std::shared_ptr<Class>>& ParserCache::getClasses(const std::string& header_file) const
+{
+    static const std::vector<std::shared_ptr<Class>> empty_classes;
+
+    auto iter = m_entries.find(normalizePath(header_file));
+    return iter == m_entries.end() ? empty_classes : iter->second.m_classes;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "common/precompiled.h"
+
+#include "common/schema_module.h"
+
+// remembers the classes parsed out of every header, so that only the headers whose text or includes changed since
+// the last run have to go through libclang again
+class ParserCache
+{
+public:
+    ParserCache(const std::string&              cache_file,
+                const std::vector<std::string>& include_paths,
+                const std::string&              generated_directory,
+                const std::string&              salt);
+
+    // a missing or outdated cache file leaves the cache empty, every header is parsed then
+    void load(void);
+    void save(void) const;
+
+    // hash of the header and every header it includes with quotes, the includes with angle brackets and the generated
+    // files are not followed
+    uint64_t getFingerprint(const std::string& header_file);
+
+    bool isUpToDate(const std::string& header_file);
+
+    // stores the freshly parsed classes of a header together with its current fingerprint
+    void update(const std::string& header_file, const std::vector<std::shared_ptr<Class>>& classes);
+    void remove(const std::string& header_file);
+
+    std::vector<std::string> getHeaderFiles(void) const;
+
+    const std::vector<std::shared_ptr<Class>>& getClasses(const std::string& header_file) const;
+
+    static std::string normalizePath(const std::string& path);
+
+private:
+    struct HeaderEntry
+    {
+        uint64_t                            m_fingerprint {0};
+        std::vector<std::shared_ptr<Class>> m_classes;
+    };
+
+    struct FileInfo
+    {
+        uint64_t                 m_content_hash {0};
+        std::vector<std::string> m_includes;
+    };
+
+    const FileInfo& getFileInfo(const std::string& file);
+    std::string     resolveInclude(const std::string& including_file, const std::string& include_name) const;
+
+    std::string              m_cache_file;
+    std::vector<std::string> m_include_paths;
+    // the generated files change after each parse, following them would make their includers always outdated
+    std::string m_generated_directory;
+    std::string m_salt;
+
+    std::map<std::string, HeaderEntry> m_entries;
+    // every file is read and scanned for includes once per run
+    std::unordered_map<std::string, FileInfo> m_file_infos;
+};
@@ -9,10 +9,12 @@ void TemplateManager::loadTemplates(std::string path, std::string template_name)
 
 std::string TemplateManager::renderByTemplate(std::string template_name, Mustache::data& template_data)
 {
-    if (m_template_pool.end() == m_template_pool.find(template_name))
+    // called from the generation workers, the pool is only read here
+    auto iter = m_template_pool.find(template_name);
+    if (m_template_pool.end() == iter)
     {
         return "";
     }
-    Mustache::mustache tmpl(m_template_pool[template_name]);
+    Mustache::mustache tmpl(iter->second);
     return tmpl.render(template_data);
 }
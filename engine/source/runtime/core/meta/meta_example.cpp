@@ -52,8 +52,8 @@ namespace Piccolo
 
         // reflection
         auto                       meta = TypeMetaDef(Test2, &test2_out);
-        Reflection::FieldAccessor* fields;
-        int                        fields_count = meta.m_meta.getFieldsList(fields);
+        const Reflection::FieldAccessor* fields;
+        int                              fields_count = meta.m_meta.getFieldsList(fields);
         for (int i = 0; i < fields_count; ++i)
         {
             auto filed_accesser = fields[i];
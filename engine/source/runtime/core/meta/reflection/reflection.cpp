@@ -1,6 +1,11 @@
 #include "reflection.h"
+#include "runtime/core/meta/serializer/binary_serializer.h"
+#include "runtime/core/meta/serializer/json_stream_reader.h"
+
 #include <cstring>
-#include <map>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
 
 namespace Piccolo
 {
@@ -9,83 +14,106 @@ namespace Piccolo
         const char* k_unknown_type = "UnknownType";
         const char* k_unknown      = "Unknown";
 
-        static std::map<std::string, ClassFunctionTuple*>      m_class_map;
-        static std::multimap<std::string, FieldFunctionTuple*> m_field_map;
-        static std::map<std::string, ArrayFunctionTuple*>      m_array_map;
+        struct TypeDescriptor
+        {
+            TypeId                    m_type_id {k_invalid_type_id};
+            std::string               m_type_name;
+            const ClassFunctionTuple* m_class_functions {nullptr};
+
+            // in declaration order, the names point to the string literals of the generated code
+            std::vector<FieldAccessor>                   m_fields;
+            std::unordered_map<std::string_view, size_t> m_field_indices;
+        };
 
-        void TypeMetaRegisterinterface::registerToFieldMap(const char* name, FieldFunctionTuple* value)
+        // a deque keeps the descriptors in place while types are registered
+        static std::deque<TypeDescriptor>                                 m_type_descriptors;
+        static std::unordered_map<std::string, TypeDescriptor*>           m_type_descriptor_map;
+        static std::unordered_map<std::string, const ArrayFunctionTuple*> m_array_map;
+
+        static TypeDescriptor* findTypeDescriptor(const std::string& type_name)
         {
-            m_field_map.insert(std::make_pair(name, value));
+            auto iter = m_type_descriptor_map.find(type_name);
+            return iter != m_type_descriptor_map.end() ? iter->second : nullptr;
         }
 
-        void TypeMetaRegisterinterface::registerToArrayMap(const char* name, ArrayFunctionTuple* value)
+        static TypeDescriptor& findOrAddTypeDescriptor(const char* type_name)
         {
-            if (m_array_map.find(name) == m_array_map.end())
+            auto iter = m_type_descriptor_map.find(type_name);
+            if (iter != m_type_descriptor_map.end())
             {
-                m_array_map.insert(std::make_pair(name, value));
-            }
-            else
-            {
-                delete value;
+                return *iter->second;
             }
+
+            TypeDescriptor& descriptor = m_type_descriptors.emplace_back();
+            descriptor.m_type_id       = static_cast<TypeId>(m_type_descriptors.size() - 1);
+            descriptor.m_type_name     = type_name;
+            m_type_descriptor_map.emplace(descriptor.m_type_name, &descriptor);
+            return descriptor;
         }
 
-        void TypeMetaRegisterinterface::registerToClassMap(const char* name, ClassFunctionTuple* value)
+        void TypeMetaRegisterinterface::registerToFieldMap(const char* name, const FieldFunctionTuple* value)
         {
-            if (m_class_map.find(name) == m_class_map.end())
-            {
-                m_class_map.insert(std::make_pair(name, value));
-            }
-            else
+            TypeDescriptor& descriptor = findOrAddTypeDescriptor(name);
+
+            FieldAccessor field(value);
+            descriptor.m_field_indices.emplace(field.getFieldName(), descriptor.m_fields.size());
+            descriptor.m_fields.push_back(field);
+        }
+
+        void TypeMetaRegisterinterface::registerToArrayMap(const char* name, const ArrayFunctionTuple* value)
+        {
+            // every file using a vector type registers it, the first one wins
+            m_array_map.emplace(name, value);
+        }
+
+        void TypeMetaRegisterinterface::registerToClassMap(const char* name, const ClassFunctionTuple* value)
+        {
+            TypeDescriptor& descriptor = findOrAddTypeDescriptor(name);
+            if (descriptor.m_class_functions == nullptr)
             {
-                delete value;
+                descriptor.m_class_functions = value;
             }
         }
 
         void TypeMetaRegisterinterface::unregisterAll()
         {
-            for (const auto& itr : m_field_map)
-            {
-                delete itr.second;
-            }
-            m_field_map.clear();
-            for (const auto& itr : m_class_map)
-            {
-                delete itr.second;
-            }
-            m_class_map.clear();
-            for (const auto& itr : m_array_map)
-            {
-                delete itr.second;
-            }
+            m_type_descriptor_map.clear();
+            m_type_descriptors.clear();
             m_array_map.clear();
         }
 
-        TypeMeta::TypeMeta(std::string type_name) : m_type_name(type_name)
+        TypeMeta::TypeMeta(const std::string& type_name) : TypeMeta(findTypeDescriptor(type_name))
         {
-            m_is_valid = false;
-            m_fields.clear();
-
-            auto fileds_iter = m_field_map.equal_range(type_name);
-            while (fileds_iter.first != fileds_iter.second)
+            if (m_descriptor == nullptr)
             {
-                FieldAccessor f_field(fileds_iter.first->second);
-                m_fields.emplace_back(f_field);
-                m_is_valid = true;
-
-                ++fileds_iter.first;
+                m_type_name = type_name;
             }
         }
 
-        TypeMeta::TypeMeta() : m_type_name(k_unknown_type), m_is_valid(false) { m_fields.clear(); }
+        TypeMeta::TypeMeta(const TypeDescriptor* descriptor) : m_descriptor(descriptor)
+        {
+            // a type without fields has never been valid
+            m_is_valid = m_descriptor != nullptr && !m_descriptor->m_fields.empty();
+        }
+
+        TypeMeta::TypeMeta() : m_type_name(k_unknown_type), m_is_valid(false) {}
 
-        TypeMeta TypeMeta::newMetaFromName(std::string type_name)
+        TypeMeta TypeMeta::newMetaFromName(const std::string& type_name)
         {
             TypeMeta f_type(type_name);
             return f_type;
         }
 
-        bool TypeMeta::newArrayAccessorFromName(std::string array_type_name, ArrayAccessor& accessor)
+        TypeMeta TypeMeta::newMetaFromId(TypeId type_id)
+        {
+            if (type_id >= m_type_descriptors.size())
+            {
+                return TypeMeta();
+            }
+            return TypeMeta(&m_type_descriptors[type_id]);
+        }
+
+        bool TypeMeta::newArrayAccessorFromName(const std::string& array_type_name, ArrayAccessor& accessor)
         {
             auto iter = m_array_map.find(array_type_name);
 
@@ -99,60 +127,125 @@ namespace Piccolo
             return false;
         }
 
-        ReflectionInstance TypeMeta::newFromNameAndPJson(std::string type_name, const PJson& json_context)
+        ReflectionInstance TypeMeta::newFromNameAndPJson(const std::string& type_name, const PJson& json_context)
         {
-            auto iter = m_class_map.find(type_name);
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
 
-            if (iter != m_class_map.end())
+            if (descriptor != nullptr && descriptor->m_class_functions != nullptr)
             {
-                return ReflectionInstance(TypeMeta(type_name), (std::get<1>(*iter->second)(json_context)));
+                return ReflectionInstance(TypeMeta(descriptor),
+                                          (std::get<1>(*descriptor->m_class_functions)(json_context)));
             }
             return ReflectionInstance();
         }
 
-        PJson TypeMeta::writeByName(std::string type_name, void* instance)
+        PJson TypeMeta::writeByName(const std::string& type_name, void* instance)
         {
-            auto iter = m_class_map.find(type_name);
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
 
-            if (iter != m_class_map.end())
+            if (descriptor != nullptr && descriptor->m_class_functions != nullptr)
             {
-                return std::get<2>(*iter->second)(instance);
+                return std::get<2>(*descriptor->m_class_functions)(instance);
             }
             return PJson();
         }
 
-        std::string TypeMeta::getTypeName() { return m_type_name; }
+        ReflectionInstance TypeMeta::newFromNameAndBinary(const std::string& type_name, PBinaryReader& reader)
+        {
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
 
-        int TypeMeta::getFieldsList(FieldAccessor*& out_list)
+            if (descriptor != nullptr && descriptor->m_class_functions != nullptr)
+            {
+                return ReflectionInstance(TypeMeta(descriptor), (std::get<3>(*descriptor->m_class_functions)(reader)));
+            }
+            // the size of an unknown type is unknown as well, nothing after it can be read
+            reader.invalidate();
+            return ReflectionInstance();
+        }
+
+        void TypeMeta::writeBinaryByName(const std::string& type_name, PBinaryWriter& writer, void* instance)
         {
-            int count = m_fields.size();
-            out_list  = new FieldAccessor[count];
-            for (int i = 0; i < count; ++i)
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
+
+            if (descriptor != nullptr && descriptor->m_class_functions != nullptr)
+            {
+                std::get<4>(*descriptor->m_class_functions)(writer, instance);
+            }
+        }
+
+        ReflectionInstance TypeMeta::newFromNameAndJsonStream(const std::string& type_name, PJsonStreamReader& reader)
+        {
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
+
+            if (descriptor != nullptr && descriptor->m_class_functions != nullptr)
             {
-                out_list[i] = m_fields[i];
+                return ReflectionInstance(TypeMeta(descriptor), (std::get<5>(*descriptor->m_class_functions)(reader)));
             }
-            return count;
+            return ReflectionInstance();
+        }
+
+        ReflectionInstance TypeMeta::cloneByName(const std::string& type_name, void* instance)
+        {
+            // a binary round trip copies the reflection pointers inside the instance as well
+            PBinaryWriter writer;
+            writeBinaryByName(type_name, writer, instance);
+
+            PBinaryReader reader(writer.getBuffer().data(), writer.getBuffer().size());
+            return newFromNameAndBinary(type_name, reader);
         }
 
-        int TypeMeta::getBaseClassReflectionInstanceList(ReflectionInstance*& out_list, void* instance)
+        bool TypeMeta::deleteByName(const std::string& type_name, void* instance)
         {
-            auto iter = m_class_map.find(m_type_name);
+            const TypeDescriptor* descriptor = findTypeDescriptor(type_name);
 
-            if (iter != m_class_map.end())
+            if (descriptor != nullptr && descriptor->m_class_functions != nullptr)
             {
-                return (std::get<0>(*iter->second))(out_list, instance);
+                std::get<6>(*descriptor->m_class_functions)(instance);
+                return true;
+            }
+            // the pool of an unknown type can't be found, the instance is leaked rather than freed into a wrong one
+            return false;
+        }
+
+        std::string TypeMeta::getTypeName() const
+        {
+            return m_descriptor != nullptr ? m_descriptor->m_type_name : m_type_name;
+        }
+
+        TypeId TypeMeta::getTypeId() const
+        {
+            return m_descriptor != nullptr ? m_descriptor->m_type_id : k_invalid_type_id;
+        }
+
+        int TypeMeta::getFieldsList(const FieldAccessor*& out_list) const
+        {
+            if (m_descriptor == nullptr)
+            {
+                out_list = nullptr;
+                return 0;
+            }
+            out_list = m_descriptor->m_fields.data();
+            return static_cast<int>(m_descriptor->m_fields.size());
+        }
+
+        int TypeMeta::getBaseClassReflectionInstanceList(ReflectionInstance*& out_list, void* instance) const
+        {
+            if (m_descriptor != nullptr && m_descriptor->m_class_functions != nullptr)
+            {
+                return (std::get<0>(*m_descriptor->m_class_functions))(out_list, instance);
             }
 
             return 0;
         }
 
-        FieldAccessor TypeMeta::getFieldByName(const char* name)
+        FieldAccessor TypeMeta::getFieldByName(const char* name) const
         {
-            const auto it = std::find_if(m_fields.begin(), m_fields.end(), [&](const auto& i) {
-                return std::strcmp(i.getFieldName(), name) == 0;
-            });
-            if (it != m_fields.end())
-                return *it;
+            if (m_descriptor != nullptr)
+            {
+                auto iter = m_descriptor->m_field_indices.find(name);
+                if (iter != m_descriptor->m_field_indices.end())
+                    return m_descriptor->m_fields[iter->second];
+            }
             return FieldAccessor(nullptr);
         }
 
@@ -162,11 +255,9 @@ namespace Piccolo
             {
                 return *this;
             }
-            m_fields.clear();
-            m_fields = dest.m_fields;
-
-            m_type_name = dest.m_type_name;
-            m_is_valid  = dest.m_is_valid;
+            m_descriptor = dest.m_descriptor;
+            m_type_name  = dest.m_type_name;
+            m_is_valid   = dest.m_is_valid;
 
             return *this;
         }
@@ -177,7 +268,7 @@ namespace Piccolo
             m_functions       = nullptr;
         }
 
-        FieldAccessor::FieldAccessor(FieldFunctionTuple* functions) : m_functions(functions)
+        FieldAccessor::FieldAccessor(const FieldFunctionTuple* functions) : m_functions(functions)
         {
             m_field_type_name = k_unknown_type;
             m_field_name      = k_unknown;
@@ -190,26 +281,26 @@ namespace Piccolo
             m_field_name      = (std::get<3>(*m_functions))();
         }
 
-        void* FieldAccessor::get(void* instance)
+        void* FieldAccessor::get(void* instance) const
         {
             // todo: should check validation
             return static_cast<void*>((std::get<1>(*m_functions))(instance));
         }
 
-        void FieldAccessor::set(void* instance, void* value)
+        void FieldAccessor::set(void* instance, void* value) const
         {
             // todo: should check validation
             (std::get<0>(*m_functions))(instance, value);
         }
 
-        TypeMeta FieldAccessor::getOwnerTypeMeta()
+        TypeMeta FieldAccessor::getOwnerTypeMeta() const
         {
             // todo: should check validation
             TypeMeta f_type((std::get<2>(*m_functions))());
             return f_type;
         }
 
-        bool FieldAccessor::getTypeMeta(TypeMeta& field_type)
+        bool FieldAccessor::getTypeMeta(TypeMeta& field_type) const
         {
             TypeMeta f_type(m_field_type_name);
             field_type = f_type;
@@ -217,9 +308,9 @@ namespace Piccolo
         }
 
         const char* FieldAccessor::getFieldName() const { return m_field_name; }
-        const char* FieldAccessor::getFieldTypeName() { return m_field_type_name; }
+        const char* FieldAccessor::getFieldTypeName() const { return m_field_type_name; }
 
-        bool FieldAccessor::isArrayType()
+        bool FieldAccessor::isArrayType() const
         {
             // todo: should check validation
             return (std::get<5>(*m_functions))();
@@ -241,7 +332,7 @@ namespace Piccolo
             m_func(nullptr), m_array_type_name("UnKnownType"), m_element_type_name("UnKnownType")
         {}
 
-        ArrayAccessor::ArrayAccessor(ArrayFunctionTuple* array_func) : m_func(array_func)
+        ArrayAccessor::ArrayAccessor(const ArrayFunctionTuple* array_func) : m_func(array_func)
         {
             m_array_type_name   = k_unknown_type;
             m_element_type_name = k_unknown_type;
@@ -1,7 +1,10 @@
 #pragma once
 #include "runtime/core/meta/json.h"
+#include "runtime/core/meta/reflection/reflection_pool.h"
 
+#include <cstdint>
 #include <functional>
+#include <limits>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -24,7 +27,10 @@ namespace Piccolo
 
 #define REFLECTION_BODY(class_name) \
     friend class Reflection::TypeFieldReflectionOparator::Type##class_name##Operator; \
-    friend class PSerializer;
+    friend class PSerializer; \
+    friend class PBinarySerializer; \
+    friend class PJsonStreamSerializer; \
+    friend class Reflection::ReflectionPool<class_name>;
     // public: virtual std::string getTypeName() override {return #class_name;}
 
 #define REFLECTION_TYPE(class_name) \
@@ -41,11 +47,12 @@ namespace Piccolo
 #define REGISTER_ARRAY_TO_MAP(name, value) TypeMetaRegisterinterface::registerToArrayMap(name, value);
 #define UNREGISTER_ALL TypeMetaRegisterinterface::unregisterAll();
 
-#define PICCOLO_REFLECTION_NEW(name, ...) Reflection::ReflectionPtr(#name, new name(__VA_ARGS__));
+#define PICCOLO_REFLECTION_NEW(name, ...) \
+    Reflection::ReflectionPtr(#name, Reflection::ReflectionPool<name>::create(__VA_ARGS__));
 #define PICCOLO_REFLECTION_DELETE(value) \
     if (value) \
     { \
-        delete value.operator->(); \
+        Reflection::TypeMeta::deleteByName(value.getTypeName(), Reflection::getMostDerivedAddress(value.getPtr())); \
         value.getPtrReference() = nullptr; \
     }
 #define PICCOLO_REFLECTION_DEEP_COPY(type, dst_ptr, src_ptr) \
@@ -72,23 +79,44 @@ namespace Piccolo
         class FieldAccessor;
         class ArrayAccessor;
         class ReflectionInstance;
+        struct TypeDescriptor;
+
+        // index of a reflected class in the registry, stable until the types are unregistered
+        using TypeId = uint32_t;
+
+        constexpr TypeId k_invalid_type_id = std::numeric_limits<TypeId>::max();
     } // namespace Reflection
-    typedef std::function<void(void*, void*)>      SetFuncion;
-    typedef std::function<void*(void*)>            GetFuncion;
-    typedef std::function<const char*()>           GetNameFuncion;
-    typedef std::function<void(int, void*, void*)> SetArrayFunc;
-    typedef std::function<void*(int, void*)>       GetArrayFunc;
-    typedef std::function<int(void*)>              GetSizeFunc;
-    typedef std::function<bool()>                  GetBoolFunc;
-
-    typedef std::function<void*(const PJson&)>                          ConstructorWithPJson;
-    typedef std::function<PJson(void*)>                                 WritePJsonByName;
-    typedef std::function<int(Reflection::ReflectionInstance*&, void*)> GetBaseClassReflectionInstanceListFunc;
+    class PBinaryReader;
+    class PBinaryWriter;
+    class PJsonStreamReader;
+
+    // plain function pointers, so that the generated tables are constant data
+    typedef void (*SetFuncion)(void*, void*);
+    typedef void* (*GetFuncion)(void*);
+    typedef const char* (*GetNameFuncion)();
+    typedef void (*SetArrayFunc)(int, void*, void*);
+    typedef void* (*GetArrayFunc)(int, void*);
+    typedef int (*GetSizeFunc)(void*);
+    typedef bool (*GetBoolFunc)();
+
+    typedef void* (*ConstructorWithPJson)(const PJson&);
+    typedef PJson (*WritePJsonByName)(void*);
+    typedef void* (*ConstructorWithBinary)(PBinaryReader&);
+    typedef void (*WriteBinaryByName)(PBinaryWriter&, void*);
+    typedef void* (*ConstructorWithJsonStream)(PJsonStreamReader&);
+    typedef void (*DeleteInstance)(void*);
+    typedef int (*GetBaseClassReflectionInstanceListFunc)(Reflection::ReflectionInstance*&, void*);
 
     typedef std::tuple<SetFuncion, GetFuncion, GetNameFuncion, GetNameFuncion, GetNameFuncion, GetBoolFunc>
         FieldFunctionTuple;
-    typedef std::tuple<GetBaseClassReflectionInstanceListFunc, ConstructorWithPJson, WritePJsonByName>
-                                                                                                ClassFunctionTuple;
+    typedef std::tuple<GetBaseClassReflectionInstanceListFunc,
+                       ConstructorWithPJson,
+                       WritePJsonByName,
+                       ConstructorWithBinary,
+                       WriteBinaryByName,
+                       ConstructorWithJsonStream,
+                       DeleteInstance>
+        ClassFunctionTuple;
     typedef std::tuple<SetArrayFunc, GetArrayFunc, GetSizeFunc, GetNameFuncion, GetNameFuncion> ArrayFunctionTuple;
 
     namespace Reflection
@@ -96,9 +124,10 @@ namespace Piccolo
         class TypeMetaRegisterinterface
         {
         public:
-            static void registerToClassMap(const char* name, ClassFunctionTuple* value);
-            static void registerToFieldMap(const char* name, FieldFunctionTuple* value);
-            static void registerToArrayMap(const char* name, ArrayFunctionTuple* value);
+            // the tuples are static data emitted by the meta parser, the registry only points to them
+            static void registerToClassMap(const char* name, const ClassFunctionTuple* value);
+            static void registerToFieldMap(const char* name, const FieldFunctionTuple* value);
+            static void registerToArrayMap(const char* name, const ArrayFunctionTuple* value);
 
             static void unregisterAll();
         };
@@ -113,30 +142,41 @@ namespace Piccolo
 
             // static void Register();
 
-            static TypeMeta newMetaFromName(std::string type_name);
+            static TypeMeta newMetaFromName(const std::string& type_name);
+            static TypeMeta newMetaFromId(TypeId type_id);
 
-            static bool               newArrayAccessorFromName(std::string array_type_name, ArrayAccessor& accessor);
-            static ReflectionInstance newFromNameAndPJson(std::string type_name, const PJson& json_context);
-            static PJson              writeByName(std::string type_name, void* instance);
+            static bool newArrayAccessorFromName(const std::string& array_type_name, ArrayAccessor& accessor);
+            static ReflectionInstance newFromNameAndPJson(const std::string& type_name, const PJson& json_context);
+            static PJson              writeByName(const std::string& type_name, void* instance);
+            static ReflectionInstance newFromNameAndBinary(const std::string& type_name, PBinaryReader& reader);
+            static void writeBinaryByName(const std::string& type_name, PBinaryWriter& writer, void* instance);
+            static ReflectionInstance newFromNameAndJsonStream(const std::string& type_name, PJsonStreamReader& reader);
+            static ReflectionInstance cloneByName(const std::string& type_name, void* instance);
+            // returns the instance to the pool of its type, it has to be the most derived address
+            static bool deleteByName(const std::string& type_name, void* instance);
 
-            std::string getTypeName();
+            std::string getTypeName() const;
+            TypeId      getTypeId() const;
 
-            int getFieldsList(FieldAccessor*& out_list);
+            // points into the field table of the type, nothing to free
+            int getFieldsList(const FieldAccessor*& out_list) const;
 
-            int getBaseClassReflectionInstanceList(ReflectionInstance*& out_list, void* instance);
+            int getBaseClassReflectionInstanceList(ReflectionInstance*& out_list, void* instance) const;
 
-            FieldAccessor getFieldByName(const char* name);
+            FieldAccessor getFieldByName(const char* name) const;
 
-            bool isValid() { return m_is_valid; }
+            bool isValid() const { return m_is_valid; }
 
             TypeMeta& operator=(const TypeMeta& dest);
 
         private:
-            TypeMeta(std::string type_name);
+            TypeMeta(const std::string& type_name);
+            TypeMeta(const TypeDescriptor* descriptor);
 
         private:
-            std::vector<FieldAccessor, std::allocator<FieldAccessor>> m_fields;
+            const TypeDescriptor* m_descriptor {nullptr};
 
+            // only kept for the names that are not reflected
             std::string m_type_name;
 
             bool m_is_valid;
@@ -145,14 +185,15 @@ namespace Piccolo
         class FieldAccessor
         {
             friend class TypeMeta;
+            friend class TypeMetaRegisterinterface;
 
         public:
             FieldAccessor();
 
-            void* get(void* instance);
-            void  set(void* instance, void* value);
+            void* get(void* instance) const;
+            void  set(void* instance, void* value) const;
 
-            TypeMeta getOwnerTypeMeta();
+            TypeMeta getOwnerTypeMeta() const;
 
             /**
              * param: TypeMeta out_type
@@ -162,20 +203,20 @@ namespace Piccolo
              *        true: it's a reflection type
              *        false: it's not a reflection type
              */
-            bool        getTypeMeta(TypeMeta& field_type);
+            bool        getTypeMeta(TypeMeta& field_type) const;
             const char* getFieldName() const;
-            const char* getFieldTypeName();
-            bool        isArrayType();
+            const char* getFieldTypeName() const;
+            bool        isArrayType() const;
 
             FieldAccessor& operator=(const FieldAccessor& dest);
 
         private:
-            FieldAccessor(FieldFunctionTuple* functions);
+            FieldAccessor(const FieldFunctionTuple* functions);
 
         private:
-            FieldFunctionTuple* m_functions;
-            const char*         m_field_name;
-            const char*         m_field_type_name;
+            const FieldFunctionTuple* m_functions;
+            const char*               m_field_name;
+            const char*               m_field_type_name;
         };
 
         /**
@@ -197,12 +238,12 @@ namespace Piccolo
             ArrayAccessor& operator=(ArrayAccessor& dest);
 
         private:
-            ArrayAccessor(ArrayFunctionTuple* array_func);
+            ArrayAccessor(const ArrayFunctionTuple* array_func);
 
         private:
-            ArrayFunctionTuple* m_func;
-            const char*         m_array_type_name;
-            const char*         m_element_type_name;
+            const ArrayFunctionTuple* m_func;
+            const char*               m_array_type_name;
+            const char*               m_element_type_name;
         };
 
         class ReflectionInstance
@@ -0,0 +1,130 @@
+#include "reflection_pool.h"
+
+#include <cassert>
+
+namespace Piccolo
+{
+    namespace Reflection
+    {
+        // the list is created before the first pool, so it also outlives all of them
+        static std::mutex& getPoolListMutex()
+        {
+            static std::mutex pool_list_mutex;
+            return pool_list_mutex;
+        }
+
+        static std::vector<ReflectionPoolBase*>& getPoolList()
+        {
+            static std::vector<ReflectionPoolBase*> pool_list;
+            return pool_list;
+        }
+
+        ReflectionPoolBase::ReflectionPoolBase(size_t slot_size, size_t slot_alignment) :
+            m_slot_size((slot_size + slot_alignment - 1) / slot_alignment * slot_alignment),
+            m_slot_alignment(slot_alignment)
+        {
+            std::lock_guard<std::mutex> lock_guard(getPoolListMutex());
+            getPoolList().push_back(this);
+        }
+
+        ReflectionPoolBase::~ReflectionPoolBase()
+        {
+            {
+                std::lock_guard<std::mutex> lock_guard(getPoolListMutex());
+                std::vector<ReflectionPoolBase*>& pool_list = getPoolList();
+                for (auto iter = pool_list.begin(); iter != pool_list.end(); ++iter)
+                {
+                    if (*iter == this)
+                    {
+                        pool_list.erase(iter);
+                        break;
+                    }
+                }
+            }
+
+            for (void* chunk : m_chunks)
+            {
+                ::operator delete(chunk, std::align_val_t(m_slot_alignment));
+            }
+            m_chunks.clear();
+        }
+
+        void* ReflectionPoolBase::allocateChunk()
+        {
+            return ::operator new(m_slot_size * s_slots_per_chunk, std::align_val_t(m_slot_alignment));
+        }
+
+        void* ReflectionPoolBase::allocate()
+        {
+            std::lock_guard<std::mutex> lock_guard(m_mutex);
+            ++m_live_count;
+
+            if (m_free_slots != nullptr)
+            {
+                FreeSlot* slot = m_free_slots;
+                m_free_slots   = slot->m_next;
+                return slot;
+            }
+
+            if (m_next_slot_in_chunk == s_slots_per_chunk)
+            {
+                // chunks kept by a reset are used again before new ones are allocated
+                if (!m_chunks.empty() && m_current_chunk + 1 < m_chunks.size())
+                {
+                    ++m_current_chunk;
+                }
+                else
+                {
+                    m_chunks.push_back(allocateChunk());
+                    m_current_chunk = m_chunks.size() - 1;
+                }
+                m_next_slot_in_chunk = 0;
+            }
+
+            void* slot = static_cast<std::byte*>(m_chunks[m_current_chunk]) + m_slot_size * m_next_slot_in_chunk;
+            ++m_next_slot_in_chunk;
+            return slot;
+        }
+
+        void ReflectionPoolBase::deallocate(void* slot)
+        {
+            std::lock_guard<std::mutex> lock_guard(m_mutex);
+            assert(m_live_count > 0);
+            --m_live_count;
+
+            FreeSlot* free_slot = static_cast<FreeSlot*>(slot);
+            free_slot->m_next   = m_free_slots;
+            m_free_slots        = free_slot;
+        }
+
+        bool ReflectionPoolBase::reset()
+        {
+            std::lock_guard<std::mutex> lock_guard(m_mutex);
+            if (m_live_count > 0)
+            {
+                return false;
+            }
+
+            // dropping the free list and rewinding hands the slots out in address order again
+            m_free_slots         = nullptr;
+            m_current_chunk      = 0;
+            m_next_slot_in_chunk = m_chunks.empty() ? s_slots_per_chunk : 0;
+            return true;
+        }
+
+        size_t ReflectionPoolBase::getLiveCount()
+        {
+            std::lock_guard<std::mutex> lock_guard(m_mutex);
+            return m_live_count;
+        }
+
+        void ReflectionPoolBase::resetUnusedPools()
+        {
+            std::lock_guard<std::mutex> lock_guard(getPoolListMutex());
+            for (ReflectionPoolBase* pool : getPoolList())
+            {
+                pool->reset();
+            }
+        }
+    } // namespace Reflection
+} // namespace Piccolo
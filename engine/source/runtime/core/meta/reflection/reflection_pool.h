@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Piccolo
+{
+    namespace Reflection
+    {
+        // fixed size slots carved out of chunks, freed slots are reused before the pool grows
+        class ReflectionPoolBase
+        {
+        public:
+            ReflectionPoolBase(size_t slot_size, size_t slot_alignment);
+            virtual ~ReflectionPoolBase();
+
+            ReflectionPoolBase(const ReflectionPoolBase&) = delete;
+            ReflectionPoolBase& operator=(const ReflectionPoolBase&) = delete;
+
+            void* allocate();
+            void  deallocate(void* slot);
+
+            // rewinds the pool if nothing lives in it anymore, the chunks are kept for the next level
+            bool   reset();
+            size_t getLiveCount();
+
+            // resets every pool without live instances, called once a level is unloaded
+            static void resetUnusedPools();
+
+        private:
+            static constexpr size_t s_slots_per_chunk {64};
+
+            struct FreeSlot
+            {
+                FreeSlot* m_next;
+            };
+
+            void* allocateChunk();
+
+            std::mutex m_mutex;
+            size_t     m_slot_size;
+            size_t     m_slot_alignment;
+
+            std::vector<void*> m_chunks;
+            // the chunk and slot the bump allocation continues from
+            size_t    m_current_chunk {0};
+            size_t    m_next_slot_in_chunk {s_slots_per_chunk};
+            FreeSlot* m_free_slots {nullptr};
+            size_t    m_live_count {0};
+        };
+
+        template<typename T>
+        class ReflectionPool : public ReflectionPoolBase
+        {
+        public:
+            static ReflectionPool& getInstance()
+            {
+                static ReflectionPool pool;
+                return pool;
+            }
+
+            template<typename... Args>
+            static T* create(Args&&... args)
+            {
+                ReflectionPool& pool = getInstance();
+                void*           slot = pool.allocate();
+                try
+                {
+                    return new (slot) T(std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    pool.deallocate(slot);
+                    throw;
+                }
+            }
+
+            static void destroy(T* instance)
+            {
+                if (instance == nullptr)
+                {
+                    return;
+                }
+                instance->~T();
+                getInstance().deallocate(instance);
+            }
+
+        private:
+            ReflectionPool() :
+                ReflectionPoolBase(std::max(sizeof(T), sizeof(void*)), std::max(alignof(T), alignof(void*)))
+            {}
+        };
+
+        // the pool of a polymorphic instance is the one of its dynamic type, which starts at the most derived address
+        template<typename T>
+        void* getMostDerivedAddress(T* instance)
+        {
+            if constexpr (std::is_polymorphic<T>::value)
+            {
+                return dynamic_cast<void*>(instance);
+            }
+            else
+            {
+                return static_cast<void*>(instance);
+            }
+        }
+    } // namespace Reflection
+} // namespace Piccolo
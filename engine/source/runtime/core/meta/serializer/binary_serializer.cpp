@@ -0,0 +1,144 @@
+#include "binary_serializer.h"
+
+#include <cstring>
+
+namespace Piccolo
+{
+    void PBinaryWriter::writeBytes(const void* data, size_t size)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+    }
+
+    void PBinaryWriter::writeSize(size_t size) { writeValue(static_cast<uint32_t>(size)); }
+
+    void PBinaryWriter::writeString(std::string_view value)
+    {
+        writeSize(value.size());
+        writeBytes(value.data(), value.size());
+    }
+
+    PBinaryReader::PBinaryReader(const void* data, size_t size) :
+        m_cursor(static_cast<const uint8_t*>(data)), m_end(static_cast<const uint8_t*>(data) + size)
+    {}
+
+    bool PBinaryReader::readBytes(void* data, size_t size)
+    {
+        if (!m_is_valid || static_cast<size_t>(m_end - m_cursor) < size)
+        {
+            m_is_valid = false;
+            return false;
+        }
+        if (size > 0)
+        {
+            std::memcpy(data, m_cursor, size);
+            m_cursor += size;
+        }
+        return true;
+    }
+
+    size_t PBinaryReader::readSize()
+    {
+        size_t size = readValue<uint32_t>();
+        // every element takes at least one byte, a larger count can only come from a corrupted file
+        if (size > static_cast<size_t>(m_end - m_cursor))
+        {
+            m_is_valid = false;
+            return 0;
+        }
+        return size;
+    }
+
+    std::string_view PBinaryReader::readStringView()
+    {
+        size_t size = readSize();
+        if (!m_is_valid)
+        {
+            return std::string_view();
+        }
+        std::string_view value(reinterpret_cast<const char*>(m_cursor), size);
+        m_cursor += size;
+        return value;
+    }
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const char& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    char& PBinarySerializer::read(PBinaryReader& reader, char& instance)
+    {
+        return instance = reader.readValue<char>();
+    }
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const int& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    int& PBinarySerializer::read(PBinaryReader& reader, int& instance)
+    {
+        return instance = reader.readValue<int>();
+    }
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const unsigned int& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    unsigned int& PBinarySerializer::read(PBinaryReader& reader, unsigned int& instance)
+    {
+        return instance = reader.readValue<unsigned int>();
+    }
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const float& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    float& PBinarySerializer::read(PBinaryReader& reader, float& instance)
+    {
+        return instance = reader.readValue<float>();
+    }
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const double& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    double& PBinarySerializer::read(PBinaryReader& reader, double& instance)
+    {
+        return instance = reader.readValue<double>();
+    }
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const bool& instance)
+    {
+        writer.writeValue(static_cast<uint8_t>(instance ? 1 : 0));
+    }
+    template<>
+    bool& PBinarySerializer::read(PBinaryReader& reader, bool& instance)
+    {
+        return instance = reader.readValue<uint8_t>() != 0;
+    }
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const std::string& instance)
+    {
+        writer.writeString(instance);
+    }
+    template<>
+    std::string& PBinarySerializer::read(PBinaryReader& reader, std::string& instance)
+    {
+        return instance = reader.readStringView();
+    }
+} // namespace Piccolo
@@ -0,0 +1,224 @@
+#pragma once
+#include "runtime/core/meta/reflection/reflection.h"
+#include "runtime/core/meta/serializer/serializer.h"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace Piccolo
+{
+    // "PBIN" in a little endian file
+    static constexpr uint32_t k_binary_magic          = 0x4E494250;
+    static constexpr uint32_t k_binary_format_version = 1;
+
+    // every binary asset starts with this header, the schema hash covers all reflected classes
+    struct PBinaryHeader
+    {
+        uint32_t magic {k_binary_magic};
+        uint32_t version {k_binary_format_version};
+        uint64_t schema_hash {0};
+    };
+
+    // values are written in native byte order, fields in declaration order without their names
+    class PBinaryWriter
+    {
+    public:
+        void writeBytes(const void* data, size_t size);
+        void writeSize(size_t size);
+        void writeString(std::string_view value);
+
+        template<typename T>
+        void writeValue(const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values are written as bytes");
+            writeBytes(&value, sizeof(T));
+        }
+
+        const std::vector<uint8_t>& getBuffer() const { return m_buffer; }
+
+    private:
+        std::vector<uint8_t> m_buffer;
+    };
+
+    // reads in place from a buffer it does not own, e.g. a mapped file, reading past the end invalidates the reader
+    class PBinaryReader
+    {
+    public:
+        PBinaryReader(const void* data, size_t size);
+
+        bool             readBytes(void* data, size_t size);
+        size_t           readSize();
+        std::string_view readStringView();
+
+        template<typename T>
+        T readValue()
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values are read as bytes");
+            T value {};
+            readBytes(&value, sizeof(T));
+            return value;
+        }
+
+        void invalidate() { m_is_valid = false; }
+        bool isValid() const { return m_is_valid; }
+        bool isAtEnd() const { return m_cursor == m_end; }
+
+    private:
+        const uint8_t* m_cursor {nullptr};
+        const uint8_t* m_end {nullptr};
+        bool           m_is_valid {true};
+    };
+
+    // compact counterpart of PSerializer, the reflected classes get their read and write from the meta parser
+    class PBinarySerializer
+    {
+    public:
+        template<typename T>
+        static void writePointer(PBinaryWriter& writer, T* instance)
+        {
+            writer.writeString("*");
+            PBinarySerializer::write(writer, *instance);
+        }
+
+        template<typename T>
+        static T*& readPointer(PBinaryReader& reader, T*& instance)
+        {
+            assert(instance == nullptr);
+            std::string type_name(reader.readStringView());
+            if (type_name == "*")
+            {
+                instance = new T;
+                read(reader, *instance);
+            }
+            else
+            {
+                instance = static_cast<T*>(Reflection::TypeMeta::newFromNameAndBinary(type_name, reader).m_instance);
+            }
+            return instance;
+        }
+
+        template<typename T>
+        static void write(PBinaryWriter& writer, const Reflection::ReflectionPtr<T>& instance)
+        {
+            T*          instance_ptr = static_cast<T*>(instance.operator->());
+            std::string type_name    = instance.getTypeName();
+            writer.writeString(type_name);
+            Reflection::TypeMeta::writeBinaryByName(type_name, writer, instance_ptr);
+        }
+
+        template<typename T>
+        static T*& read(PBinaryReader& reader, Reflection::ReflectionPtr<T>& instance)
+        {
+            std::string type_name(reader.readStringView());
+            instance.setTypeName(type_name);
+
+            T*& instance_ptr = instance.getPtrReference();
+            assert(instance_ptr == nullptr);
+            instance_ptr = static_cast<T*>(Reflection::TypeMeta::newFromNameAndBinary(type_name, reader).m_instance);
+            return instance_ptr;
+        }
+
+        // arrays of numbers are copied as one block
+        template<typename T>
+        static void writeArray(PBinaryWriter& writer, const std::vector<T>& instance)
+        {
+            writer.writeSize(instance.size());
+            if constexpr (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value)
+            {
+                writer.writeBytes(instance.data(), instance.size() * sizeof(T));
+            }
+            else
+            {
+                for (const auto& item : instance)
+                {
+                    PBinarySerializer::write(writer, item);
+                }
+            }
+        }
+
+        template<typename T>
+        static std::vector<T>& readArray(PBinaryReader& reader, std::vector<T>& instance)
+        {
+            instance.resize(reader.readSize());
+            if constexpr (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value)
+            {
+                reader.readBytes(instance.data(), instance.size() * sizeof(T));
+            }
+            else
+            {
+                for (size_t index = 0; index < instance.size() && reader.isValid(); ++index)
+                {
+                    PBinarySerializer::read(reader, instance[index]);
+                }
+            }
+            return instance;
+        }
+
+        template<typename T>
+        static void write(PBinaryWriter& writer, const T& instance)
+        {
+            if constexpr (std::is_pointer<T>::value)
+            {
+                writePointer(writer, (T)instance);
+            }
+            else
+            {
+                static_assert(always_false<T>, "PBinarySerializer::write<T> has not been implemented yet!");
+            }
+        }
+
+        template<typename T>
+        static T& read(PBinaryReader& reader, T& instance)
+        {
+            if constexpr (std::is_pointer<T>::value)
+            {
+                return readPointer(reader, instance);
+            }
+            else
+            {
+                static_assert(always_false<T>, "PBinarySerializer::read<T> has not been implemented yet!");
+                return instance;
+            }
+        }
+    };
+
+    // implementation of base types
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const char& instance);
+    template<>
+    char& PBinarySerializer::read(PBinaryReader& reader, char& instance);
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const int& instance);
+    template<>
+    int& PBinarySerializer::read(PBinaryReader& reader, int& instance);
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const unsigned int& instance);
+    template<>
+    unsigned int& PBinarySerializer::read(PBinaryReader& reader, unsigned int& instance);
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const float& instance);
+    template<>
+    float& PBinarySerializer::read(PBinaryReader& reader, float& instance);
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const double& instance);
+    template<>
+    double& PBinarySerializer::read(PBinaryReader& reader, double& instance);
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const bool& instance);
+    template<>
+    bool& PBinarySerializer::read(PBinaryReader& reader, bool& instance);
+
+    template<>
+    void PBinarySerializer::write(PBinaryWriter& writer, const std::string& instance);
+    template<>
+    std::string& PBinarySerializer::read(PBinaryReader& reader, std::string& instance);
+} // namespace Piccolo
@@ -0,0 +1,451 @@
+#include "json_stream_reader.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace Piccolo
+{
+    PJsonStreamReader::PJsonStreamReader(std::string_view text) : m_text(text) {}
+
+    void PJsonStreamReader::skipWhitespace()
+    {
+        while (m_cursor < m_text.size())
+        {
+            char c = m_text[m_cursor];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+            {
+                break;
+            }
+            ++m_cursor;
+        }
+    }
+
+    char PJsonStreamReader::peek()
+    {
+        skipWhitespace();
+        if (!m_is_valid || m_cursor >= m_text.size())
+        {
+            return 0;
+        }
+        return m_text[m_cursor];
+    }
+
+    bool PJsonStreamReader::expect(char c)
+    {
+        if (peek() != c)
+        {
+            m_is_valid = false;
+            return false;
+        }
+        ++m_cursor;
+        return true;
+    }
+
+    bool PJsonStreamReader::beginObject()
+    {
+        m_is_first_in_container = true;
+        return expect('{');
+    }
+
+    bool PJsonStreamReader::nextMember(std::string_view& out_key)
+    {
+        char c = peek();
+        if (!m_is_valid)
+        {
+            return false;
+        }
+        if (c == '}')
+        {
+            ++m_cursor;
+            m_is_first_in_container = false;
+            return false;
+        }
+        if (!m_is_first_in_container && !expect(','))
+        {
+            return false;
+        }
+        m_is_first_in_container = false;
+
+        if (peek() != '"')
+        {
+            m_is_valid = false;
+            return false;
+        }
+
+        // keys without escapes point straight into the text
+        size_t begin = m_cursor + 1;
+        size_t end   = begin;
+        while (end < m_text.size() && m_text[end] != '"' && m_text[end] != '\\')
+        {
+            ++end;
+        }
+        if (end < m_text.size() && m_text[end] == '"')
+        {
+            out_key  = m_text.substr(begin, end - begin);
+            m_cursor = end + 1;
+        }
+        else
+        {
+            if (!readStringInto(m_key_buffer))
+            {
+                return false;
+            }
+            out_key = m_key_buffer;
+        }
+        return expect(':');
+    }
+
+    bool PJsonStreamReader::beginArray()
+    {
+        m_is_first_in_container = true;
+        return expect('[');
+    }
+
+    bool PJsonStreamReader::nextElement()
+    {
+        char c = peek();
+        if (!m_is_valid)
+        {
+            return false;
+        }
+        if (c == ']')
+        {
+            ++m_cursor;
+            m_is_first_in_container = false;
+            return false;
+        }
+        if (!m_is_first_in_container && !expect(','))
+        {
+            return false;
+        }
+        m_is_first_in_container = false;
+        return true;
+    }
+
+    bool PJsonStreamReader::skipNull()
+    {
+        if (peek() != 'n')
+        {
+            return false;
+        }
+        skipLiteral("null");
+        return m_is_valid;
+    }
+
+    void PJsonStreamReader::skipLiteral(std::string_view literal)
+    {
+        if (m_text.compare(m_cursor, literal.size(), literal) != 0)
+        {
+            m_is_valid = false;
+            return;
+        }
+        m_cursor += literal.size();
+    }
+
+    void PJsonStreamReader::skipNumber()
+    {
+        while (m_cursor < m_text.size() && std::strchr("+-0123456789.eE", m_text[m_cursor]) != nullptr)
+        {
+            ++m_cursor;
+        }
+    }
+
+    double PJsonStreamReader::readNumber()
+    {
+        peek();
+        size_t begin = m_cursor;
+        skipNumber();
+
+        // the text is not null terminated at the end of the number, strtod needs a copy
+        char   number_text[64];
+        size_t length = m_cursor - begin;
+        if (!m_is_valid || length == 0 || length >= sizeof(number_text))
+        {
+            m_is_valid = false;
+            return 0.0;
+        }
+        std::memcpy(number_text, m_text.data() + begin, length);
+        number_text[length] = 0;
+
+        char*  number_end = nullptr;
+        double value      = std::strtod(number_text, &number_end);
+        if (number_end != number_text + length)
+        {
+            m_is_valid = false;
+            return 0.0;
+        }
+        return value;
+    }
+
+    bool PJsonStreamReader::readBool()
+    {
+        char c = peek();
+        if (c == 't')
+        {
+            skipLiteral("true");
+            return m_is_valid;
+        }
+        if (c == 'f')
+        {
+            skipLiteral("false");
+            return false;
+        }
+        m_is_valid = false;
+        return false;
+    }
+
+    void PJsonStreamReader::readString(std::string& out_value)
+    {
+        if (peek() != '"')
+        {
+            m_is_valid = false;
+            return;
+        }
+        readStringInto(out_value);
+    }
+
+    static void encodeUtf8(uint32_t code_point, std::string& out_value)
+    {
+        if (code_point < 0x80)
+        {
+            out_value += static_cast<char>(code_point);
+        }
+        else if (code_point < 0x800)
+        {
+            out_value += static_cast<char>(0xC0 | (code_point >> 6));
+            out_value += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+        else if (code_point < 0x10000)
+        {
+            out_value += static_cast<char>(0xE0 | (code_point >> 12));
+            out_value += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            out_value += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+        else
+        {
+            out_value += static_cast<char>(0xF0 | (code_point >> 18));
+            out_value += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+            out_value += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            out_value += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+    }
+
+    bool PJsonStreamReader::readStringInto(std::string& out_value)
+    {
+        // the cursor is on the opening quote
+        ++m_cursor;
+        out_value.clear();
+
+        auto read_hex4 = [this](uint32_t& out_code) {
+            if (m_cursor + 4 > m_text.size())
+            {
+                return false;
+            }
+            out_code = 0;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                char c = m_text[m_cursor++];
+                out_code <<= 4;
+                if (c >= '0' && c <= '9')
+                    out_code |= c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    out_code |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F')
+                    out_code |= c - 'A' + 10;
+                else
+                    return false;
+            }
+            return true;
+        };
+
+        while (m_cursor < m_text.size())
+        {
+            // copy the runs between escapes in one go
+            size_t run_begin = m_cursor;
+            while (m_cursor < m_text.size() && m_text[m_cursor] != '"' && m_text[m_cursor] != '\\')
+            {
+                ++m_cursor;
+            }
+            out_value.append(m_text.data() + run_begin, m_cursor - run_begin);
+            if (m_cursor >= m_text.size())
+            {
+                break;
+            }
+
+            char c = m_text[m_cursor++];
+            if (c == '"')
+            {
+                return true;
+            }
+            if (m_cursor >= m_text.size())
+            {
+                break;
+            }
+
+            char escape = m_text[m_cursor++];
+            switch (escape)
+            {
+                case 'b':
+                    out_value += '\b';
+                    break;
+                case 'f':
+                    out_value += '\f';
+                    break;
+                case 'n':
+                    out_value += '\n';
+                    break;
+                case 'r':
+                    out_value += '\r';
+                    break;
+                case 't':
+                    out_value += '\t';
+                    break;
+                case 'u':
+                {
+                    uint32_t code_point = 0;
+                    if (!read_hex4(code_point))
+                    {
+                        m_is_valid = false;
+                        return false;
+                    }
+                    // a high surrogate is followed by the escaped low surrogate
+                    if (code_point >= 0xD800 && code_point <= 0xDBFF &&
+                        m_text.compare(m_cursor, 2, "\\u") == 0)
+                    {
+                        m_cursor += 2;
+                        uint32_t low_surrogate = 0;
+                        if (!read_hex4(low_surrogate))
+                        {
+                            m_is_valid = false;
+                            return false;
+                        }
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low_surrogate - 0xDC00);
+                    }
+                    encodeUtf8(code_point, out_value);
+                    break;
+                }
+                default:
+                    // \" \\ and \/
+                    out_value += escape;
+                    break;
+            }
+        }
+
+        m_is_valid = false;
+        return false;
+    }
+
+    std::string_view PJsonStreamReader::skipValue()
+    {
+        char   c     = peek();
+        size_t begin = m_cursor;
+        if (!m_is_valid)
+        {
+            return std::string_view();
+        }
+
+        if (c == '{' || c == '[')
+        {
+            // containers are skipped by counting brackets outside of strings
+            size_t depth = 0;
+            while (m_cursor < m_text.size())
+            {
+                char current = m_text[m_cursor++];
+                if (current == '"')
+                {
+                    while (m_cursor < m_text.size() && m_text[m_cursor] != '"')
+                    {
+                        m_cursor += m_text[m_cursor] == '\\' ? 2 : 1;
+                    }
+                    ++m_cursor;
+                }
+                else if (current == '{' || current == '[')
+                {
+                    ++depth;
+                }
+                else if (current == '}' || current == ']')
+                {
+                    if (--depth == 0)
+                    {
+                        return m_text.substr(begin, m_cursor - begin);
+                    }
+                }
+            }
+            m_is_valid = false;
+            return std::string_view();
+        }
+
+        if (c == '"')
+        {
+            std::string skipped;
+            readStringInto(skipped);
+        }
+        else if (c == 't')
+        {
+            skipLiteral("true");
+        }
+        else if (c == 'f')
+        {
+            skipLiteral("false");
+        }
+        else if (c == 'n')
+        {
+            skipLiteral("null");
+        }
+        else
+        {
+            skipNumber();
+            m_is_valid = m_is_valid && m_cursor > begin;
+        }
+
+        if (!m_is_valid || m_cursor > m_text.size())
+        {
+            m_is_valid = false;
+            return std::string_view();
+        }
+        return m_text.substr(begin, m_cursor - begin);
+    }
+
+    template<>
+    char& PJsonStreamSerializer::read(PJsonStreamReader& reader, char& instance)
+    {
+        return instance = static_cast<char>(reader.readNumber());
+    }
+
+    template<>
+    int& PJsonStreamSerializer::read(PJsonStreamReader& reader, int& instance)
+    {
+        return instance = static_cast<int>(reader.readNumber());
+    }
+
+    template<>
+    unsigned int& PJsonStreamSerializer::read(PJsonStreamReader& reader, unsigned int& instance)
+    {
+        return instance = static_cast<unsigned int>(reader.readNumber());
+    }
+
+    template<>
+    float& PJsonStreamSerializer::read(PJsonStreamReader& reader, float& instance)
+    {
+        return instance = static_cast<float>(reader.readNumber());
+    }
+
+    template<>
+    double& PJsonStreamSerializer::read(PJsonStreamReader& reader, double& instance)
+    {
+        return instance = reader.readNumber();
+    }
+
+    template<>
+    bool& PJsonStreamSerializer::read(PJsonStreamReader& reader, bool& instance)
+    {
+        return instance = reader.readBool();
+    }
+
+    template<>
+    std::string& PJsonStreamSerializer::read(PJsonStreamReader& reader, std::string& instance)
+    {
+        reader.readString(instance);
+        return instance;
+    }
+} // namespace Piccolo
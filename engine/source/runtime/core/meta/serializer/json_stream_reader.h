@@ -0,0 +1,206 @@
+#pragma once
+#include "runtime/core/meta/reflection/reflection.h"
+#include "runtime/core/meta/serializer/serializer.h"
+
+#include <cassert>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace Piccolo
+{
+    // pull parser over a json text it does not own, values are consumed in document order without building a dom
+    class PJsonStreamReader
+    {
+    public:
+        explicit PJsonStreamReader(std::string_view text);
+
+        // enter an object or array, the next* functions return false once it is closed
+        bool beginObject();
+        bool nextMember(std::string_view& out_key);
+        bool beginArray();
+        bool nextElement();
+
+        // consumes a null value, so that absent and null fields are treated alike
+        bool skipNull();
+
+        double readNumber();
+        bool   readBool();
+        void   readString(std::string& out_value);
+
+        // returns the raw text of the skipped value, it can be parsed later by another reader
+        std::string_view skipValue();
+
+        void   invalidate() { m_is_valid = false; }
+        bool   isValid() const { return m_is_valid; }
+        size_t getOffset() const { return m_cursor; }
+
+    private:
+        void skipWhitespace();
+        char peek();
+        bool expect(char c);
+        bool readStringInto(std::string& out_value);
+        void skipLiteral(std::string_view literal);
+        void skipNumber();
+
+        std::string_view m_text;
+        size_t           m_cursor {0};
+        bool             m_is_valid {true};
+        // the first member or element of a container is not preceded by a comma
+        bool m_is_first_in_container {false};
+        // keys with escape sequences are decoded here, a returned key stays valid until the next key is read
+        std::string m_key_buffer;
+    };
+
+    // counterpart of PSerializer::read on top of PJsonStreamReader, the reflected classes get their fields from the
+    // meta parser
+    class PJsonStreamSerializer
+    {
+    public:
+        template<typename T>
+        static T*& readPointer(PJsonStreamReader& reader, T*& instance)
+        {
+            assert(instance == nullptr);
+            std::string type_name;
+            readTypedObject(reader, type_name, instance);
+            return instance;
+        }
+
+        template<typename T>
+        static T*& read(PJsonStreamReader& reader, Reflection::ReflectionPtr<T>& instance)
+        {
+            std::string type_name;
+            T*&         instance_ptr = instance.getPtrReference();
+            assert(instance_ptr == nullptr);
+            readTypedObject(reader, type_name, instance_ptr);
+            instance.setTypeName(type_name);
+            return instance_ptr;
+        }
+
+        template<typename T>
+        static std::vector<T>& readArray(PJsonStreamReader& reader, std::vector<T>& instance)
+        {
+            instance.clear();
+            if (!reader.beginArray())
+            {
+                return instance;
+            }
+            while (reader.nextElement())
+            {
+                instance.emplace_back();
+                read(reader, instance.back());
+            }
+            return instance;
+        }
+
+        // fills the members of a reflected class, unknown keys are skipped like the dom reader ignores them
+        template<typename T>
+        static T& readObject(PJsonStreamReader& reader, T& instance)
+        {
+            if (!reader.beginObject())
+            {
+                return instance;
+            }
+            std::string_view key;
+            while (reader.nextMember(key))
+            {
+                if (reader.skipNull())
+                {
+                    continue;
+                }
+                if (!readField(reader, instance, key))
+                {
+                    reader.skipValue();
+                }
+            }
+            return instance;
+        }
+
+        template<typename T>
+        static bool readField(PJsonStreamReader& reader, T& instance, std::string_view key)
+        {
+            static_assert(always_false<T>, "PJsonStreamSerializer::readField<T> has not been implemented yet!");
+            return false;
+        }
+
+        template<typename T>
+        static T& read(PJsonStreamReader& reader, T& instance)
+        {
+            if constexpr (std::is_pointer<T>::value)
+            {
+                return readPointer(reader, instance);
+            }
+            else
+            {
+                static_assert(always_false<T>, "PJsonStreamSerializer::read<T> has not been implemented yet!");
+                return instance;
+            }
+        }
+
+    private:
+        // {"$typeName": ..., "$context": ...} may come in any order, the context is parsed once its type is known
+        template<typename T>
+        static void readTypedObject(PJsonStreamReader& reader, std::string& out_type_name, T*& instance)
+        {
+            std::string_view context_text;
+            if (!reader.beginObject())
+            {
+                return;
+            }
+            std::string_view key;
+            while (reader.nextMember(key))
+            {
+                if (key == "$typeName")
+                {
+                    reader.readString(out_type_name);
+                }
+                else if (key == "$context")
+                {
+                    context_text = reader.skipValue();
+                }
+                else
+                {
+                    reader.skipValue();
+                }
+            }
+            if (!reader.isValid() || out_type_name.empty() || context_text.empty())
+            {
+                reader.invalidate();
+                return;
+            }
+
+            PJsonStreamReader context_reader(context_text);
+            if ('*' == out_type_name[0])
+            {
+                instance = new T;
+                read(context_reader, *instance);
+            }
+            else
+            {
+                instance = static_cast<T*>(
+                    Reflection::TypeMeta::newFromNameAndJsonStream(out_type_name, context_reader).m_instance);
+            }
+            if (!context_reader.isValid())
+            {
+                reader.invalidate();
+            }
+        }
+    };
+
+    // implementation of base types
+    template<>
+    char& PJsonStreamSerializer::read(PJsonStreamReader& reader, char& instance);
+    template<>
+    int& PJsonStreamSerializer::read(PJsonStreamReader& reader, int& instance);
+    template<>
+    unsigned int& PJsonStreamSerializer::read(PJsonStreamReader& reader, unsigned int& instance);
+    template<>
+    float& PJsonStreamSerializer::read(PJsonStreamReader& reader, float& instance);
+    template<>
+    double& PJsonStreamSerializer::read(PJsonStreamReader& reader, double& instance);
+    template<>
+    bool& PJsonStreamSerializer::read(PJsonStreamReader& reader, bool& instance);
+    template<>
+    std::string& PJsonStreamSerializer::read(PJsonStreamReader& reader, std::string& instance);
+} // namespace Piccolo
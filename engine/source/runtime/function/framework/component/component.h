@@ -18,6 +18,10 @@ namespace Piccolo
         Component() = default;
         virtual ~Component() {}
 
+        // Loading the resources of the component, may run on a level loading worker, so only thread safe systems such
+        // as the asset cache can be used here
+        virtual void preloadResource() {}
+
         // Instantiating the component after definition loaded
         virtual void postLoadResource(std::weak_ptr<GObject> parent_object) { m_parent_object = parent_object; }
 
@@ -13,10 +13,8 @@
 
 namespace Piccolo
 {
-    void MeshComponent::postLoadResource(std::weak_ptr<GObject> parent_object)
+    void MeshComponent::preloadResource()
     {
-        m_parent_object = parent_object;
-
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
         ASSERT(asset_manager);
 
@@ -33,8 +31,10 @@ namespace Piccolo
 
             if (meshComponent.m_material_desc.m_with_texture)
             {
-                MaterialRes material_res;
-                asset_manager->loadAsset(sub_mesh.m_material, material_res);
+                std::shared_ptr<const MaterialRes> shared_material_res =
+                    asset_manager->loadSharedAsset<MaterialRes>(sub_mesh.m_material);
+                static const MaterialRes empty_material_res;
+                const MaterialRes&       material_res = shared_material_res ? *shared_material_res : empty_material_res;
 
                 meshComponent.m_material_desc.m_base_color_texture_file =
                     asset_manager->getFullPath(material_res.m_base_colour_texture_file).generic_string();
@@ -56,6 +56,8 @@ namespace Piccolo
         }
     }
 
+    void MeshComponent::postLoadResource(std::weak_ptr<GObject> parent_object) { m_parent_object = parent_object; }
+
     void MeshComponent::tick(float delta_time)
     {
         if (!m_parent_object.lock())
@@ -65,41 +67,87 @@ namespace Piccolo
         const AnimationComponent* animation_component =
             m_parent_object.lock()->tryGetComponentConst(AnimationComponent);
 
-        if (transform_component->isDirty())
+        RenderSwapContext&  render_swap_context = g_runtime_global_context.m_render_system->getSwapContext();
+        RenderCommandQueue& command_queue       = render_swap_context.getCommandQueue();
+        GObjectID           go_id               = m_parent_object.lock()->getID();
+
+        // the skeleton changes every frame an animation plays, even while the object stands still
+        std::vector<Matrix4x4> joint_matrices;
+        if (animation_component != nullptr)
         {
-            std::vector<GameObjectPartDesc> dirty_mesh_parts;
-            SkeletonAnimationResult         animation_result;
-            animation_result.m_transforms.push_back({Matrix4x4::IDENTITY});
-            if (animation_component != nullptr)
+            joint_matrices.push_back(Matrix4x4::IDENTITY);
+            for (auto& node : animation_component->getResult().node)
             {
-                for (auto& node : animation_component->getResult().node)
-                {
-                    animation_result.m_transforms.push_back({Matrix4x4(node.transform)});
-                }
+                joint_matrices.push_back(Matrix4x4(node.transform));
             }
-            for (GameObjectPartDesc& mesh_part : m_raw_meshes)
+        }
+
+        if (!m_is_added_to_render_scene)
+        {
+            for (size_t part_index = 0; part_index < m_raw_meshes.size(); ++part_index)
             {
+                const GameObjectPartDesc& mesh_part = m_raw_meshes[part_index];
+
+                RenderCommand command;
+                command.m_type       = RenderCommandType::AddGameObjectPart;
+                command.m_go_id      = go_id;
+                command.m_part_index = static_cast<uint32_t>(part_index);
+                command.m_part_desc  = std::make_unique<GameObjectPartDesc>(mesh_part);
+                command.m_part_desc->m_transform_desc.m_transform_matrix =
+                    transform_component->getMatrix() * mesh_part.m_transform_desc.m_transform_matrix;
                 if (animation_component)
                 {
-                    mesh_part.m_with_animation                                = true;
-                    mesh_part.m_skeleton_animation_result                     = animation_result;
-                    mesh_part.m_skeleton_binding_desc.m_skeleton_binding_file = mesh_part.m_mesh_desc.m_mesh_file;
+                    command.m_part_desc->m_with_animation = true;
+                    command.m_part_desc->m_skeleton_binding_desc.m_skeleton_binding_file =
+                        mesh_part.m_mesh_desc.m_mesh_file;
+                    for (const Matrix4x4& joint_matrix : joint_matrices)
+                    {
+                        command.m_part_desc->m_skeleton_animation_result.m_transforms.push_back({joint_matrix});
+                    }
                 }
-                Matrix4x4 object_transform_matrix = mesh_part.m_transform_desc.m_transform_matrix;
-
-                mesh_part.m_transform_desc.m_transform_matrix =
-                    transform_component->getMatrix() * object_transform_matrix;
-                dirty_mesh_parts.push_back(mesh_part);
-
-                mesh_part.m_transform_desc.m_transform_matrix = object_transform_matrix;
+                command_queue.push(std::move(command));
             }
 
-            RenderSwapContext& render_swap_context = g_runtime_global_context.m_render_system->getSwapContext();
-            RenderSwapData&    logic_swap_data     = render_swap_context.getLogicSwapData();
-
-            logic_swap_data.addDirtyGameObject(GameObjectDesc {m_parent_object.lock()->getID(), dirty_mesh_parts});
+            m_is_added_to_render_scene = true;
+            transform_component->setDirtyFlag(false);
+            return;
+        }
 
+        // only the matrices travel to the render scene, the entity itself is not rebuilt
+        if (transform_component->isDirty())
+        {
+            for (size_t part_index = 0; part_index < m_raw_meshes.size(); ++part_index)
+            {
+                RenderCommand command;
+                command.m_type       = RenderCommandType::UpdateTransform;
+                command.m_go_id      = go_id;
+                command.m_part_index = static_cast<uint32_t>(part_index);
+                command.m_transform_matrix =
+                    transform_component->getMatrix() * m_raw_meshes[part_index].m_transform_desc.m_transform_matrix;
+                command_queue.push(std::move(command));
+            }
             transform_component->setDirtyFlag(false);
         }
+
+        if (animation_component)
+        {
+            for (size_t part_index = 0; part_index < m_raw_meshes.size(); ++part_index)
+            {
+                RenderCommand command;
+                command.m_type       = RenderCommandType::UpdateSkeleton;
+                command.m_go_id      = go_id;
+                command.m_part_index = static_cast<uint32_t>(part_index);
+                // the last part takes the palette over instead of copying it
+                if (part_index + 1 == m_raw_meshes.size())
+                {
+                    command.m_joint_matrices = std::move(joint_matrices);
+                }
+                else
+                {
+                    command.m_joint_matrices = joint_matrices;
+                }
+                command_queue.push(std::move(command));
+            }
+        }
     }
 } // namespace Piccolo
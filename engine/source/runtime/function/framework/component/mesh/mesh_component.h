@@ -19,9 +19,11 @@ namespace Piccolo
     public:
         MeshComponent() {};
 
+        void preloadResource() override;
         void postLoadResource(std::weak_ptr<GObject> parent_object) override;
 
         const std::vector<GameObjectPartDesc>& getRawMeshes() const { return m_raw_meshes; }
+        const MeshComponentRes&                getMeshRes() const { return m_mesh_res; }
 
         void tick(float delta_time) override;
 
@@ -30,5 +32,8 @@ namespace Piccolo
         MeshComponentRes m_mesh_res;
 
         std::vector<GameObjectPartDesc> m_raw_meshes;
+
+        // the parts with their asset paths are published once, later updates only carry transforms and skeletons
+        bool m_is_added_to_render_scene {false};
     };
 } // namespace Piccolo
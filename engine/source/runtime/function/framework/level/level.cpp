@@ -11,13 +11,24 @@
 #include "runtime/function/particle/particle_manager.h"
 #include "runtime/function/physics/physics_manager.h"
 #include "runtime/function/physics/physics_scene.h"
+#include "runtime/function/render/render_camera.h"
+#include "runtime/function/render/render_system.h"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <limits>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 namespace Piccolo
 {
     void Level::clear()
     {
         m_current_active_character.reset();
+        // waits for the cells still loading on workers
+        m_cells.clear();
         m_gobjects.clear();
 
         ASSERT(g_runtime_global_context.m_physics_manager);
@@ -68,11 +79,70 @@ namespace Piccolo
         ASSERT(g_runtime_global_context.m_physics_manager);
         m_physics_scene = g_runtime_global_context.m_physics_manager->createPhysicsScene(level_res.m_gravity);
 
-        for (const ObjectInstanceRes& object_instance_res : level_res.m_objects)
+        const size_t object_count = level_res.m_objects.size();
+        m_load_progress.store(0.0f, std::memory_order_relaxed);
+
+        // ids are taken in level order, so that they do not depend on the scheduling of the workers
+        std::vector<std::shared_ptr<GObject>> gobjects(object_count);
+        for (size_t index = 0; index < object_count; ++index)
+        {
+            GObjectID object_id = ObjectIDAllocator::alloc();
+            ASSERT(object_id != k_invalid_gobject_id);
+            gobjects[index] = std::make_shared<GObject>(object_id);
+        }
+
+        // parse and prepare the objects on workers, the definitions and materials are shared through the asset cache
+        std::vector<char>   is_object_prepared(object_count, false);
+        std::atomic<size_t> next_object_index {0};
+        std::atomic<size_t> prepared_object_count {0};
+
+        auto prepare_objects = [&]() {
+            for (size_t index = next_object_index++; index < object_count; index = next_object_index++)
+            {
+                is_object_prepared[index] = gobjects[index]->loadComponents(level_res.m_objects[index]);
+                size_t prepared_count     = ++prepared_object_count;
+                m_load_progress.store(0.5f * prepared_count / object_count, std::memory_order_relaxed);
+            }
+        };
+
+        const size_t hardware_thread_count = std::max(1u, std::thread::hardware_concurrency());
+        const size_t worker_count =
+            std::min(hardware_thread_count - 1, object_count / s_min_objects_per_loading_worker);
+
+        std::vector<std::future<void>> loading_workers;
+        for (size_t worker_index = 0; worker_index < worker_count; ++worker_index)
         {
-            createObject(object_instance_res);
+            loading_workers.push_back(std::async(std::launch::async, prepare_objects));
+        }
+        prepare_objects();
+        for (std::future<void>& loading_worker : loading_workers)
+        {
+            while (loading_worker.wait_for(std::chrono::milliseconds(500)) != std::future_status::ready)
+            {
+                LOG_INFO("loading level: {}, {}/{} objects prepared",
+                         level_res_url,
+                         prepared_object_count.load(),
+                         object_count);
+            }
+            loading_worker.get();
         }
 
+        // postLoadResource reaches physics, particles and rendering, so the objects are committed on this thread
+        for (size_t index = 0; index < object_count; ++index)
+        {
+            if (is_object_prepared[index])
+            {
+                gobjects[index]->postLoadComponents();
+                m_gobjects.emplace(gobjects[index]->getID(), gobjects[index]);
+            }
+            else
+            {
+                LOG_ERROR("loading object " + level_res.m_objects[index].m_name + " failed");
+            }
+            m_load_progress.store(0.5f + 0.5f * (index + 1) / object_count, std::memory_order_relaxed);
+        }
+        m_load_progress.store(1.0f, std::memory_order_relaxed);
+
         // create active character
         for (const auto& object_pair : m_gobjects)
         {
@@ -87,6 +157,16 @@ namespace Piccolo
             }
         }
 
+        // cells are streamed in from tick once the focus comes close
+        m_cell_stream_in_distance  = level_res.m_cell_stream_in_distance;
+        m_cell_stream_out_distance = std::max(level_res.m_cell_stream_out_distance, m_cell_stream_in_distance);
+        m_cells.clear();
+        m_cells.resize(level_res.m_cells.size());
+        for (size_t index = 0; index < level_res.m_cells.size(); ++index)
+        {
+            m_cells[index].m_res = level_res.m_cells[index];
+        }
+
         m_is_loaded = true;
 
         LOG_INFO("level load succeed");
@@ -97,6 +177,9 @@ namespace Piccolo
     void Level::unload()
     {
         clear();
+        g_runtime_global_context.m_asset_manager->releaseUnusedAssets();
+        // every component of the level is gone now, its pools start over from their first chunk
+        Reflection::ReflectionPoolBase::resetUnusedPools();
         LOG_INFO("unload level: {}", m_level_res_url);
     }
 
@@ -105,6 +188,16 @@ namespace Piccolo
         LOG_INFO("saving level: {}", m_level_res_url);
         LevelRes output_level_res;
 
+        // streamed objects are saved to their cell files below
+        std::unordered_set<GObjectID> cell_object_ids;
+        output_level_res.m_cell_stream_in_distance  = m_cell_stream_in_distance;
+        output_level_res.m_cell_stream_out_distance = m_cell_stream_out_distance;
+        for (const LevelCell& cell : m_cells)
+        {
+            output_level_res.m_cells.push_back(cell.m_res);
+            cell_object_ids.insert(cell.m_object_ids.begin(), cell.m_object_ids.end());
+        }
+
         const size_t                    object_cout    = m_gobjects.size();
         std::vector<ObjectInstanceRes>& output_objects = output_level_res.m_objects;
         output_objects.resize(object_cout);
@@ -112,21 +205,53 @@ namespace Piccolo
         size_t object_index = 0;
         for (const auto& id_object_pair : m_gobjects)
         {
-            if (id_object_pair.second)
+            if (id_object_pair.second && cell_object_ids.find(id_object_pair.first) == cell_object_ids.end())
             {
                 id_object_pair.second->save(output_objects[object_index]);
                 ++object_index;
             }
         }
+        output_objects.resize(object_index);
 
-        const bool is_save_success =
-            g_runtime_global_context.m_asset_manager->saveAsset(output_level_res, m_level_res_url);
-
+        bool is_save_success = g_runtime_global_context.m_asset_manager->saveAsset(output_level_res, m_level_res_url);
         if (is_save_success == false)
         {
             LOG_ERROR("failed to save {}", m_level_res_url);
         }
-        else
+
+        // the objects of a loaded cell go back to its own file, the files of the other cells are left as they are
+        for (const LevelCell& cell : m_cells)
+        {
+            if (cell.m_state != LevelCellState::loaded)
+            {
+                if (cell.m_state != LevelCellState::unloaded)
+                {
+                    LOG_WARN("level cell {} is streaming, its objects are not saved", cell.m_res.m_objects_url);
+                }
+                continue;
+            }
+
+            LevelCellObjectsRes output_cell_objects_res;
+            for (GObjectID object_id : cell.m_object_ids)
+            {
+                // objects deleted from the level are dropped from the cell as well
+                auto iter = m_gobjects.find(object_id);
+                if (iter != m_gobjects.end() && iter->second)
+                {
+                    output_cell_objects_res.m_objects.emplace_back();
+                    iter->second->save(output_cell_objects_res.m_objects.back());
+                }
+            }
+
+            if (!g_runtime_global_context.m_asset_manager->saveAsset(output_cell_objects_res,
+                                                                     cell.m_res.m_objects_url))
+            {
+                LOG_ERROR("failed to save {}", cell.m_res.m_objects_url);
+                is_save_success = false;
+            }
+        }
+
+        if (is_save_success)
         {
             LOG_INFO("level save succeed");
         }
@@ -141,6 +266,8 @@ namespace Piccolo
             return;
         }
 
+        tickCellStreaming();
+
         for (const auto& id_object_pair : m_gobjects)
         {
             assert(id_object_pair.second);
@@ -161,6 +288,162 @@ namespace Piccolo
         }
     }
 
+    static float distanceToCell(const LevelCellRes& cell_res, const Vector3& position)
+    {
+        Vector3 closest_position(Math::clamp(position.x, cell_res.m_bounding_box_min.x, cell_res.m_bounding_box_max.x),
+                                 Math::clamp(position.y, cell_res.m_bounding_box_min.y, cell_res.m_bounding_box_max.y),
+                                 Math::clamp(position.z, cell_res.m_bounding_box_min.z, cell_res.m_bounding_box_max.z));
+        return position.distance(closest_position);
+    }
+
+    void Level::tickCellStreaming()
+    {
+        if (m_cells.empty())
+        {
+            return;
+        }
+
+        // the editor moves the camera instead of the character
+        Vector3 focus_position;
+        if (m_current_active_character && !g_is_editor_mode)
+        {
+            focus_position = m_current_active_character->getPosition();
+        }
+        else
+        {
+            focus_position = g_runtime_global_context.m_render_system->getRenderCamera()->position();
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                  std::chrono::duration<float, std::milli>(s_cell_streaming_budget_ms));
+
+        bool has_budget = true;
+        for (LevelCell& cell : m_cells)
+        {
+            const float distance        = distanceToCell(cell.m_res, focus_position);
+            const bool  is_in_range     = distance <= m_cell_stream_in_distance;
+            const bool  is_out_of_range = distance > m_cell_stream_out_distance;
+
+            switch (cell.m_state)
+            {
+                case LevelCellState::unloaded:
+                    if (is_in_range)
+                    {
+                        startLoadingCell(cell);
+                    }
+                    break;
+                case LevelCellState::loading:
+                    if (cell.m_loading_objects.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                    {
+                        cell.m_pending_objects   = cell.m_loading_objects.get();
+                        cell.m_next_commit_index = 0;
+                        cell.m_state             = LevelCellState::committing;
+                    }
+                    break;
+                case LevelCellState::committing:
+                    if (is_out_of_range)
+                    {
+                        // the objects not committed yet have no side effects outside of themselves
+                        cell.m_pending_objects.clear();
+                        cell.m_state = LevelCellState::unloading;
+                    }
+                    else if (has_budget)
+                    {
+                        has_budget = commitCellObjects(cell, deadline);
+                    }
+                    break;
+                case LevelCellState::loaded:
+                    if (is_out_of_range)
+                    {
+                        cell.m_state = LevelCellState::unloading;
+                    }
+                    break;
+                case LevelCellState::unloading:
+                    if (has_budget)
+                    {
+                        has_budget = releaseCellObjects(cell, deadline);
+                    }
+                    break;
+            }
+        }
+    }
+
+    void Level::startLoadingCell(LevelCell& cell)
+    {
+        cell.m_state = LevelCellState::loading;
+
+        const std::string objects_url = cell.m_res.m_objects_url;
+        cell.m_loading_objects        = std::async(std::launch::async, [objects_url]() {
+            std::vector<std::shared_ptr<GObject>> gobjects;
+
+            LevelCellObjectsRes cell_objects_res;
+            if (!g_runtime_global_context.m_asset_manager->loadAsset(objects_url, cell_objects_res))
+            {
+                LOG_ERROR("loading level cell {} failed", objects_url);
+                return gobjects;
+            }
+
+            gobjects.reserve(cell_objects_res.m_objects.size());
+            for (const ObjectInstanceRes& object_instance_res : cell_objects_res.m_objects)
+            {
+                GObjectID object_id = ObjectIDAllocator::alloc();
+                ASSERT(object_id != k_invalid_gobject_id);
+
+                std::shared_ptr<GObject> gobject = std::make_shared<GObject>(object_id);
+                if (gobject->loadComponents(object_instance_res))
+                {
+                    gobjects.push_back(gobject);
+                }
+                else
+                {
+                    LOG_ERROR("loading object " + object_instance_res.m_name + " failed");
+                }
+            }
+            return gobjects;
+        });
+    }
+
+    bool Level::commitCellObjects(LevelCell& cell, const std::chrono::steady_clock::time_point& deadline)
+    {
+        while (cell.m_next_commit_index < cell.m_pending_objects.size())
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+
+            std::shared_ptr<GObject>& gobject = cell.m_pending_objects[cell.m_next_commit_index++];
+            gobject->postLoadComponents();
+            m_gobjects.emplace(gobject->getID(), gobject);
+            cell.m_object_ids.push_back(gobject->getID());
+            gobject.reset();
+        }
+
+        cell.m_pending_objects.clear();
+        cell.m_state = LevelCellState::loaded;
+        return true;
+    }
+
+    bool Level::releaseCellObjects(LevelCell& cell, const std::chrono::steady_clock::time_point& deadline)
+    {
+        while (!cell.m_object_ids.empty())
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+
+            deleteGObjectByID(cell.m_object_ids.back());
+            cell.m_object_ids.pop_back();
+        }
+
+        cell.m_state = LevelCellState::unloaded;
+        // the definitions only used by this cell can go as well
+        g_runtime_global_context.m_asset_manager->releaseUnusedAssets();
+        return true;
+    }
+
     std::weak_ptr<GObject> Level::getGObjectByID(GObjectID go_id) const
     {
         auto iter = m_gobjects.find(go_id);
@@ -185,6 +468,12 @@ namespace Piccolo
                     m_current_active_character->setObject(nullptr);
                 }
             }
+
+            // the render scene drops every part of the object together with its mesh and material references
+            RenderCommand command;
+            command.m_type  = RenderCommandType::RemoveGameObject;
+            command.m_go_id = go_id;
+            g_runtime_global_context.m_render_system->getSwapContext().getCommandQueue().push(std::move(command));
         }
 
         m_gobjects.erase(go_id);
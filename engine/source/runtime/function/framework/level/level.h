@@ -2,19 +2,46 @@
 
 #include "runtime/function/framework/object/object_id_allocator.h"
 
+#include "runtime/resource/res_type/common/level.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace Piccolo
 {
     class Character;
     class GObject;
-    class ObjectInstanceRes;
     class PhysicsScene;
 
     using LevelObjectsMap = std::unordered_map<GObjectID, std::shared_ptr<GObject>>;
 
+    enum class LevelCellState : uint8_t
+    {
+        unloaded,
+        loading,
+        committing,
+        loaded,
+        unloading
+    };
+
+    struct LevelCell
+    {
+        LevelCellRes   m_res;
+        LevelCellState m_state {LevelCellState::unloaded};
+
+        // objects parsed and prepared on a worker, then committed a few per frame
+        std::future<std::vector<std::shared_ptr<GObject>>> m_loading_objects;
+        std::vector<std::shared_ptr<GObject>>              m_pending_objects;
+        size_t                                             m_next_commit_index {0};
+
+        std::vector<GObjectID> m_object_ids;
+    };
+
     /// The main class to manage all game objects
     class Level
     {
@@ -30,6 +57,9 @@ namespace Piccolo
 
         const std::string& getLevelResUrl() const { return m_level_res_url; }
 
+        // fraction of the objects loaded so far, can be polled from other threads while load runs
+        float getLoadProgress() const { return m_load_progress.load(std::memory_order_relaxed); }
+
         const LevelObjectsMap& getAllGObjects() const { return m_gobjects; }
 
         std::weak_ptr<GObject>   getGObjectByID(GObjectID go_id) const;
@@ -43,8 +73,20 @@ namespace Piccolo
     protected:
         void clear();
 
-        bool        m_is_loaded {false};
-        std::string m_level_res_url;
+        void tickCellStreaming();
+        void startLoadingCell(LevelCell& cell);
+        // both return false once the frame budget is spent
+        bool commitCellObjects(LevelCell& cell, const std::chrono::steady_clock::time_point& deadline);
+        bool releaseCellObjects(LevelCell& cell, const std::chrono::steady_clock::time_point& deadline);
+
+        // objects handed to each loading worker at least, smaller levels are not worth the threads
+        static constexpr size_t s_min_objects_per_loading_worker {16};
+        // time the logic thread spends per frame on creating and destroying the objects of streamed cells
+        static constexpr float s_cell_streaming_budget_ms {2.0f};
+
+        bool               m_is_loaded {false};
+        std::atomic<float> m_load_progress {0.0f};
+        std::string        m_level_res_url;
 
         // all game objects in this level, key: object id, value: object instance
         LevelObjectsMap m_gobjects;
@@ -52,5 +94,9 @@ namespace Piccolo
         std::shared_ptr<Character> m_current_active_character;
 
         std::weak_ptr<PhysicsScene> m_physics_scene;
+
+        std::vector<LevelCell> m_cells;
+        float                  m_cell_stream_in_distance {0.f};
+        float                  m_cell_stream_out_distance {0.f};
     };
 } // namespace Piccolo
@@ -61,6 +61,15 @@ namespace Piccolo
     }
 
     bool GObject::load(const ObjectInstanceRes& object_instance_res)
+    {
+        if (!loadComponents(object_instance_res))
+            return false;
+
+        postLoadComponents();
+        return true;
+    }
+
+    bool GObject::loadComponents(const ObjectInstanceRes& object_instance_res)
     {
         // clear old components
         m_components.clear();
@@ -69,38 +78,55 @@ namespace Piccolo
 
         // load object instanced components
         m_components = object_instance_res.m_instanced_components;
-        for (auto component : m_components)
-        {
-            if (component)
-            {
-                component->postLoadResource(weak_from_this());
-            }
-        }
 
         // load object definition components
         m_definition_url = object_instance_res.m_definition;
 
-        ObjectDefinitionRes definition_res;
-
-        const bool is_loaded_success = g_runtime_global_context.m_asset_manager->loadAsset(m_definition_url, definition_res);
-        if (!is_loaded_success)
+        std::shared_ptr<const ObjectDefinitionRes> definition_res =
+            g_runtime_global_context.m_asset_manager->loadSharedAsset<ObjectDefinitionRes>(m_definition_url);
+        if (!definition_res)
             return false;
 
-        for (auto loaded_component : definition_res.m_components)
+        for (const auto& definition_component : definition_res->m_components)
         {
-            const std::string type_name = loaded_component.getTypeName();
+            const std::string type_name = definition_component.getTypeName();
             // don't create component if it has been instanced
             if (hasComponent(type_name))
                 continue;
 
-            loaded_component->postLoadResource(weak_from_this());
+            // the definition is shared by all of its instances, each object owns a copy of the components
+            Reflection::ReflectionPtr<Component> loaded_component(
+                type_name,
+                static_cast<Component*>(
+                    Reflection::TypeMeta::cloneByName(type_name, definition_component.getPtr()).m_instance));
+            if (!loaded_component)
+                continue;
 
             m_components.push_back(loaded_component);
         }
 
+        for (auto component : m_components)
+        {
+            if (component)
+            {
+                component->preloadResource();
+            }
+        }
+
         return true;
     }
 
+    void GObject::postLoadComponents()
+    {
+        for (auto component : m_components)
+        {
+            if (component)
+            {
+                component->postLoadResource(weak_from_this());
+            }
+        }
+    }
+
     void GObject::save(ObjectInstanceRes& out_object_instance_res)
     {
         out_object_instance_res.m_name       = m_name;
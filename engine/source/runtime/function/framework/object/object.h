@@ -24,6 +24,9 @@ namespace Piccolo
         virtual void tick(float delta_time);
 
         bool load(const ObjectInstanceRes& object_instance_res);
+        // the two halves of load, loadComponents only uses thread safe systems and can run on a loading worker
+        bool loadComponents(const ObjectInstanceRes& object_instance_res);
+        void postLoadComponents();
         void save(ObjectInstanceRes& out_object_instance_res);
 
         GObjectID getID() const { return m_id; }
@@ -8,8 +8,8 @@ namespace Piccolo
 
     GObjectID ObjectIDAllocator::alloc()
     {
-        std::atomic<GObjectID> new_object_ret = m_next_id.load();
-        m_next_id++;
+        // cells allocate ids from their loading workers
+        GObjectID new_object_ret = m_next_id++;
         if (m_next_id >= k_invalid_gobject_id)
         {
             LOG_FATAL("gobject id overflow");
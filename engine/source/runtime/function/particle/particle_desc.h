@@ -29,6 +29,8 @@ namespace Piccolo
         Vector2   m_life;
         Vector2   m_padding;
         Vector4   m_color;
+        // spawn, size and time scale of the emitter's level of detail, rewritten every frame
+        Vector4 m_lod_scale {1.0f, 1.0f, 1.0f, 0.0f};
 
         ParticleEmitterDesc() = default;
 
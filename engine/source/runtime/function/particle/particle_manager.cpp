@@ -8,6 +8,9 @@
 #include "runtime/resource/asset_manager/asset_manager.h"
 #include "runtime/resource/config_manager/config_manager.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace Piccolo
 {
     void ParticleManager::initialize()
@@ -50,10 +53,50 @@ namespace Piccolo
         RenderSwapData&    swap_data    = swap_context.getLogicSwapData();
 
         ParticleEmitterDesc desc(particle_res, transform_desc);
-        swap_data.addNewParticleEmitter(desc);
+        swap_data.addNewParticleEmitter(desc, getMaxParticleCount(particle_res), getBoundsRadius(particle_res));
 
         transform_desc.m_id = ParticleEmitterIDAllocator::alloc();
     }
 
     const GlobalParticleRes& ParticleManager::getGlobalParticleRes() { return m_global_particle_res; }
+
+    uint32_t ParticleManager::getMaxParticleCount(const ParticleComponentRes& particle_res) const
+    {
+        int max_particle_count = particle_res.m_max_particle_count;
+        if (max_particle_count <= 0)
+        {
+            // enough for every burst emitted during the longest particle life
+            float max_life     = particle_res.m_life.x + particle_res.m_life.y;
+            float emit_period  = m_global_particle_res.m_emit_gap * m_global_particle_res.m_time_step;
+            int   burst_count  = static_cast<int>(std::ceil(max_life / std::max(emit_period, 1e-6f))) + 1;
+            max_particle_count = static_cast<int>(
+                std::min<int64_t>(static_cast<int64_t>(burst_count) * m_global_particle_res.m_emit_count,
+                                  s_max_particles));
+        }
+        return static_cast<uint32_t>(std::clamp(max_particle_count, 1, s_max_particles));
+    }
+
+    float ParticleManager::getBoundsRadius(const ParticleComponentRes& particle_res) const
+    {
+        if (particle_res.m_bounds_radius > 0.0f)
+        {
+            return particle_res.m_bounds_radius;
+        }
+
+        // the farthest a particle can get within its life, ignoring collisions which only shorten the path
+        float max_life  = particle_res.m_life.x + particle_res.m_life.y;
+        float max_speed = Vector3(particle_res.m_velocity.x, particle_res.m_velocity.y, particle_res.m_velocity.z)
+                              .length() +
+                          2.0f * std::fabs(particle_res.m_velocity.w);
+        float max_acceleration =
+            Vector3(particle_res.m_acceleration.x, particle_res.m_acceleration.y, particle_res.m_acceleration.z)
+                .length() +
+            m_global_particle_res.m_gravity.length();
+        float max_size = std::max(particle_res.m_size.x, particle_res.m_size.y) *
+                         std::max(m_global_particle_res.m_lod_max_size_scale, 1.0f);
+        // mesh emitters spawn on a unit quad around the emitter
+        float spawn_extent = 1.5f;
+
+        return spawn_extent + max_speed * max_life + 0.5f * max_acceleration * max_life * max_life + max_size;
+    }
 } // namespace Piccolo
\ No newline at end of file
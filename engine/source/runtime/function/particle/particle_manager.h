@@ -31,6 +31,9 @@ namespace Piccolo
                                    ParticleEmitterTransformDesc& transform_desc);
 
     private:
+        uint32_t getMaxParticleCount(const ParticleComponentRes& particle_res) const;
+        float    getBoundsRadius(const ParticleComponentRes& particle_res) const;
+
         GlobalParticleRes m_global_particle_res;
     };
 } // namespace Piccolo
\ No newline at end of file
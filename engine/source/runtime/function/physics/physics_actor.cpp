@@ -17,25 +17,8 @@ namespace Piccolo
 
     void PhysicsActor::createShapes(const std::vector<RigidBodyShape>& shape_defs, const Transform& global_transform)
     {
+        // copying a shape gives it its own pooled copy of the geometry, which it frees again
         m_rigidbody_shapes = shape_defs;
-        for (RigidBodyShape& shape : m_rigidbody_shapes)
-        {
-            const std::string shape_type = shape.m_geometry.getTypeName();
-            if (shape_type == "Box")
-            {
-                Box* box_shape_geom = new Box;
-
-                (*box_shape_geom) = *static_cast<Box*>(shape.m_geometry.getPtr());
-
-                shape.m_geometry.getPtrReference() = box_shape_geom;
-                shape.m_type                       = RigidBodyShapeType::box;
-            }
-            else
-            {
-                LOG_ERROR("Unsupported shape type: " + shape_type);
-                continue;
-            }
-        }
     }
 
     Vector3 PhysicsActor::getLinearVelocity() const { return m_linear_velocity; }
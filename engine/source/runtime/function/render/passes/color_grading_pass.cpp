@@ -184,9 +184,12 @@ namespace Piccolo
         pipelineInfo.basePipelineHandle  = VK_NULL_HANDLE;
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-        if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
-            VK_SUCCESS)
+        if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
+                                      m_vulkan_rhi->m_pipeline_cache,
+                                      1,
+                                      &pipelineInfo,
+                                      nullptr,
+                                      &m_render_pipelines[0].pipeline) != VK_SUCCESS)
         {
             throw std::runtime_error("create post process graphics pipeline");
         }
@@ -16,6 +16,7 @@ namespace Piccolo
 
         const CombineUIPassInitInfo* _init_info = static_cast<const CombineUIPassInitInfo*>(init_info);
         m_framebuffer.render_pass               = _init_info->render_pass;
+        m_subpass_index                         = _init_info->subpass_index;
 
         setupDescriptorSetLayout();
         setupPipelines();
@@ -181,13 +182,16 @@ namespace Piccolo
         pipelineInfo.pDepthStencilState  = &depth_stencil_create_info;
         pipelineInfo.layout              = m_render_pipelines[0].layout;
         pipelineInfo.renderPass          = m_framebuffer.render_pass;
-        pipelineInfo.subpass             = _main_camera_subpass_combine_ui;
+        pipelineInfo.subpass             = m_subpass_index;
         pipelineInfo.basePipelineHandle  = VK_NULL_HANDLE;
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-        if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
-            VK_SUCCESS)
+        if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
+                                      m_vulkan_rhi->m_pipeline_cache,
+                                      1,
+                                      &pipelineInfo,
+                                      nullptr,
+                                      &m_render_pipelines[0].pipeline) != VK_SUCCESS)
         {
             throw std::runtime_error("create post process graphics pipeline");
         }
@@ -7,6 +7,7 @@ namespace Piccolo
     struct CombineUIPassInitInfo : RenderPassInitInfo
     {
         VkRenderPass render_pass;
+        uint32_t     subpass_index {_main_camera_subpass_combine_ui};
         VkImageView  scene_input_attachment;
         VkImageView  ui_input_attachment;
     };
@@ -23,5 +24,8 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
+
+    private:
+        uint32_t m_subpass_index {_main_camera_subpass_combine_ui};
     };
 } // namespace Piccolo
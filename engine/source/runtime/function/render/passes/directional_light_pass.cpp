@@ -20,33 +20,70 @@ namespace Piccolo
         setupRenderPass();
         setupFramebuffer();
         setupDescriptorSetLayout();
+
+        // the dynamic tiles start out undefined, so they are cleared in the first frame
+        m_has_dynamic_casters.fill(true);
     }
     void DirectionalLightShadowPass::postInitialize()
     {
         setupPipelines();
         setupDescriptorSet();
     }
-    void DirectionalLightShadowPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource)
+    void DirectionalLightShadowPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource) {}
+    void DirectionalLightShadowPass::recordSecondaryCommandBuffer(uint32_t thread_index)
+    {
+        m_secondary_command_buffer = m_vulkan_rhi->beginSecondaryCommandBuffer(
+            thread_index, m_framebuffer.render_pass, 0, m_framebuffer.framebuffer);
+
+        drawModel(m_secondary_command_buffer);
+
+        m_vulkan_rhi->endSecondaryCommandBuffer(m_secondary_command_buffer);
+    }
+    void DirectionalLightShadowPass::draw()
     {
-        const RenderResource* vulkan_resource = static_cast<const RenderResource*>(render_resource.get());
-        if (vulkan_resource)
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Directional Light Shadow", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
+        }
+
+        VkRenderPassBeginInfo renderpass_begin_info {};
+        renderpass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
+        renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
+        renderpass_begin_info.renderArea.offset = {0, 0};
+        renderpass_begin_info.renderArea.extent = {s_directional_light_shadow_map_width,
+                                                   s_directional_light_shadow_map_height};
+
+        // the tiles that are drawn are cleared in drawTile
+        renderpass_begin_info.clearValueCount = 0;
+        renderpass_begin_info.pClearValues    = nullptr;
+
+        // the draws were recorded by recordSecondaryCommandBuffer, possibly on another thread
+        m_vulkan_rhi->m_vk_cmd_begin_render_pass(m_vulkan_rhi->m_current_command_buffer,
+                                                 &renderpass_begin_info,
+                                                 VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        m_vulkan_rhi->m_vk_cmd_execute_commands(m_vulkan_rhi->m_current_command_buffer, 1, &m_secondary_command_buffer);
+        m_vulkan_rhi->m_vk_cmd_end_render_pass(m_vulkan_rhi->m_current_command_buffer);
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
         {
-            m_mesh_directional_light_shadow_perframe_storage_buffer_object =
-                vulkan_resource->m_mesh_directional_light_shadow_perframe_storage_buffer_object;
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
         }
     }
-    void DirectionalLightShadowPass::draw() { drawModel(); }
     void DirectionalLightShadowPass::setupAttachments()
     {
         // color and depth
         m_framebuffer.attachments.resize(2);
 
-        // color
+        // color, an atlas with one column per cascade, the static casters in the first row and the dynamic
+        // casters in the second
         m_framebuffer.attachments[0].format = VK_FORMAT_R32_SFLOAT;
         VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
                                 m_vulkan_rhi->m_device,
-                                s_directional_light_shadow_map_dimension,
-                                s_directional_light_shadow_map_dimension,
+                                s_directional_light_shadow_map_width,
+                                s_directional_light_shadow_map_height,
                                 m_framebuffer.attachments[0].format,
                                 VK_IMAGE_TILING_OPTIMAL,
                                 VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
@@ -63,13 +100,21 @@ namespace Piccolo
                                                                         VK_IMAGE_VIEW_TYPE_2D,
                                                                         1,
                                                                         1);
+        // the tiles are loaded from the previous frame, so the atlas lives in the sampled layout between frames
+        VulkanUtil::transitionImageLayout(m_vulkan_rhi.get(),
+                                          m_framebuffer.attachments[0].image,
+                                          VK_IMAGE_LAYOUT_UNDEFINED,
+                                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                          1,
+                                          1,
+                                          VK_IMAGE_ASPECT_COLOR_BIT);
 
         // depth
         m_framebuffer.attachments[1].format = m_vulkan_rhi->m_depth_image_format;
         VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
                                 m_vulkan_rhi->m_device,
-                                s_directional_light_shadow_map_dimension,
-                                s_directional_light_shadow_map_dimension,
+                                s_directional_light_shadow_map_width,
+                                s_directional_light_shadow_map_height,
                                 m_framebuffer.attachments[1].format,
                                 VK_IMAGE_TILING_OPTIMAL,
                                 VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
@@ -94,17 +139,17 @@ namespace Piccolo
         VkAttachmentDescription& directional_light_shadow_color_attachment_description = attachments[0];
         directional_light_shadow_color_attachment_description.format         = m_framebuffer.attachments[0].format;
         directional_light_shadow_color_attachment_description.samples        = VK_SAMPLE_COUNT_1_BIT;
-        directional_light_shadow_color_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        directional_light_shadow_color_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_LOAD;
         directional_light_shadow_color_attachment_description.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
         directional_light_shadow_color_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         directional_light_shadow_color_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        directional_light_shadow_color_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
+        directional_light_shadow_color_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         directional_light_shadow_color_attachment_description.finalLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
         VkAttachmentDescription& directional_light_shadow_depth_attachment_description = attachments[1];
         directional_light_shadow_depth_attachment_description.format         = m_framebuffer.attachments[1].format;
         directional_light_shadow_depth_attachment_description.samples        = VK_SAMPLE_COUNT_1_BIT;
-        directional_light_shadow_depth_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        directional_light_shadow_depth_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         directional_light_shadow_depth_attachment_description.storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         directional_light_shadow_depth_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         directional_light_shadow_depth_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
@@ -130,9 +175,22 @@ namespace Piccolo
         shadow_pass.pColorAttachments       = &shadow_pass_color_attachment_reference;
         shadow_pass.pDepthStencilAttachment = &shadow_pass_depth_attachment_reference;
 
-        VkSubpassDependency dependencies[1] = {};
-
-        VkSubpassDependency& lighting_pass_dependency = dependencies[0];
+        VkSubpassDependency dependencies[2] = {};
+
+        // the previous frame's lighting has finished reading the tiles that are redrawn
+        VkSubpassDependency& previous_lighting_pass_dependency = dependencies[0];
+        previous_lighting_pass_dependency.srcSubpass           = VK_SUBPASS_EXTERNAL;
+        previous_lighting_pass_dependency.dstSubpass           = 0;
+        previous_lighting_pass_dependency.srcStageMask         = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        previous_lighting_pass_dependency.dstStageMask =
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        previous_lighting_pass_dependency.srcAccessMask = 0;
+        previous_lighting_pass_dependency.dstAccessMask =
+            VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        previous_lighting_pass_dependency.dependencyFlags = 0;
+
+        VkSubpassDependency& lighting_pass_dependency = dependencies[1];
         lighting_pass_dependency.srcSubpass           = 0;
         lighting_pass_dependency.dstSubpass           = VK_SUBPASS_EXTERNAL;
         lighting_pass_dependency.srcStageMask         = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -166,8 +224,8 @@ namespace Piccolo
         framebuffer_create_info.renderPass      = m_framebuffer.render_pass;
         framebuffer_create_info.attachmentCount = (sizeof(attachments) / sizeof(attachments[0]));
         framebuffer_create_info.pAttachments    = attachments;
-        framebuffer_create_info.width           = s_directional_light_shadow_map_dimension;
-        framebuffer_create_info.height          = s_directional_light_shadow_map_dimension;
+        framebuffer_create_info.width           = s_directional_light_shadow_map_width;
+        framebuffer_create_info.height          = s_directional_light_shadow_map_height;
         framebuffer_create_info.layers          = 1;
 
         if (vkCreateFramebuffer(
@@ -281,9 +339,8 @@ namespace Piccolo
         input_assembly_create_info.primitiveRestartEnable = VK_FALSE;
 
         VkViewport viewport = {
-            0, 0, s_directional_light_shadow_map_dimension, s_directional_light_shadow_map_dimension, 0.0, 1.0};
-        VkRect2D scissor = {{0, 0},
-                            {s_directional_light_shadow_map_dimension, s_directional_light_shadow_map_dimension}};
+            0, 0, s_directional_light_cascade_dimension, s_directional_light_cascade_dimension, 0.0, 1.0};
+        VkRect2D scissor = {{0, 0}, {s_directional_light_cascade_dimension, s_directional_light_cascade_dimension}};
 
         VkPipelineViewportStateCreateInfo viewport_state_create_info {};
         viewport_state_create_info.sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
@@ -340,10 +397,12 @@ namespace Piccolo
         depth_stencil_create_info.depthBoundsTestEnable = VK_FALSE;
         depth_stencil_create_info.stencilTestEnable     = VK_FALSE;
 
+        // every cascade tile sets its own viewport
+        VkDynamicState                   dynamic_states[] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
         VkPipelineDynamicStateCreateInfo dynamic_state_create_info {};
         dynamic_state_create_info.sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamic_state_create_info.dynamicStateCount = 0;
-        dynamic_state_create_info.pDynamicStates    = NULL;
+        dynamic_state_create_info.dynamicStateCount = (sizeof(dynamic_states) / sizeof(dynamic_states[0]));
+        dynamic_state_create_info.pDynamicStates    = dynamic_states;
 
         VkGraphicsPipelineCreateInfo pipelineInfo {};
         pipelineInfo.sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -362,9 +421,12 @@ namespace Piccolo
         pipelineInfo.basePipelineHandle  = VK_NULL_HANDLE;
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-        if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
-            VK_SUCCESS)
+        if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
+                                      m_vulkan_rhi->m_pipeline_cache,
+                                      1,
+                                      &pipelineInfo,
+                                      nullptr,
+                                      &m_render_pipelines[0].pipeline) != VK_SUCCESS)
         {
             throw std::runtime_error("create mesh directional light shadow graphics pipeline");
         }
@@ -411,9 +473,9 @@ namespace Piccolo
         VkDescriptorBufferInfo mesh_directional_light_shadow_per_drawcall_vertex_blending_storage_buffer_info = {};
         mesh_directional_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.offset                 = 0;
         mesh_directional_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.range =
-            sizeof(MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject);
+            sizeof(MeshJointPaletteStorageBufferObject);
         mesh_directional_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.buffer =
-            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+            m_global_render_resource->_storage_buffer._joint_palette_buffer;
         assert(mesh_directional_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.range <
                m_global_render_resource->_storage_buffer._max_storage_buffer_range);
 
@@ -468,20 +530,97 @@ namespace Piccolo
                                0,
                                NULL);
     }
-    void DirectionalLightShadowPass::drawModel()
+    void DirectionalLightShadowPass::drawModel(VkCommandBuffer command_buffer)
     {
+        if (!m_vulkan_rhi->isPointLightShadowEnabled())
+        {
+            return;
+        }
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Mesh", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
+        }
+
+        m_vulkan_rhi->m_vk_cmd_bind_pipeline(
+            command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[0].pipeline);
+
+        // a static tile keeps its casters until the cascade moves or a static caster changes, the dynamic tile
+        // is cleared as long as it had casters
+        for (uint32_t cascade_index = 0; cascade_index < s_directional_light_cascade_count; ++cascade_index)
+        {
+            RenderDirectionalLightCascade& cascade = (*m_visiable_nodes.p_directional_light_cascades)[cascade_index];
+
+            if (cascade.static_dirty)
+            {
+                drawTile(command_buffer, cascade_index, 0, cascade.proj_view, cascade.static_mesh_nodes);
+                cascade.static_dirty = false;
+            }
+
+            bool has_dynamic_casters = !cascade.dynamic_mesh_nodes.empty();
+            if (has_dynamic_casters || m_has_dynamic_casters[cascade_index])
+            {
+                drawTile(command_buffer, cascade_index, 1, cascade.proj_view, cascade.dynamic_mesh_nodes);
+            }
+            m_has_dynamic_casters[cascade_index] = has_dynamic_casters;
+        }
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
+        }
+    }
+
+    void DirectionalLightShadowPass::drawTile(VkCommandBuffer                    command_buffer,
+                                              uint32_t                           cascade_index,
+                                              uint32_t                           row,
+                                              const Matrix4x4&                   light_proj_view,
+                                              const std::vector<RenderMeshNode>& mesh_nodes_to_draw)
+    {
+        VkRect2D tile = {{static_cast<int32_t>(s_directional_light_cascade_dimension * cascade_index),
+                          static_cast<int32_t>(s_directional_light_cascade_dimension * row)},
+                         {s_directional_light_cascade_dimension, s_directional_light_cascade_dimension}};
+
+        VkViewport viewport = {static_cast<float>(tile.offset.x),
+                               static_cast<float>(tile.offset.y),
+                               static_cast<float>(tile.extent.width),
+                               static_cast<float>(tile.extent.height),
+                               0.0f,
+                               1.0f};
+        m_vulkan_rhi->m_vk_cmd_set_viewport(command_buffer, 0, 1, &viewport);
+        m_vulkan_rhi->m_vk_cmd_set_scissor(command_buffer, 0, 1, &tile);
+
+        VkClearAttachment clear_attachments[2] = {};
+        clear_attachments[0].aspectMask              = VK_IMAGE_ASPECT_COLOR_BIT;
+        clear_attachments[0].colorAttachment         = 0;
+        clear_attachments[0].clearValue.color        = {1.0f};
+        clear_attachments[1].aspectMask              = VK_IMAGE_ASPECT_DEPTH_BIT;
+        clear_attachments[1].clearValue.depthStencil = {1.0f, 0};
+
+        VkClearRect clear_rect {};
+        clear_rect.rect           = tile;
+        clear_rect.baseArrayLayer = 0;
+        clear_rect.layerCount     = 1;
+        m_vulkan_rhi->m_vk_cmd_clear_attachments(command_buffer,
+                                                 sizeof(clear_attachments) / sizeof(clear_attachments[0]),
+                                                 clear_attachments,
+                                                 1,
+                                                 &clear_rect);
+
         struct MeshNode
         {
             const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
+            uint32_t         joint_matrix_offset {0};
+            bool             enable_vertex_blending {false};
         };
 
         std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>>
             directional_light_mesh_drawcall_batch;
 
         // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_directional_light_visible_mesh_nodes))
+        for (const RenderMeshNode& node : mesh_nodes_to_draw)
         {
             auto& mesh_instanced = directional_light_mesh_drawcall_batch[node.ref_material];
             auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
@@ -490,244 +629,113 @@ namespace Piccolo
             temp.model_matrix = node.model_matrix;
             if (node.enable_vertex_blending)
             {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
+                temp.joint_matrix_offset    = node.joint_matrix_offset;
+                temp.enable_vertex_blending = node.joint_count > 0;
             }
 
             mesh_nodes.push_back(temp);
         }
 
-        // Directional Light Shadow begin pass
-        {
-            VkRenderPassBeginInfo renderpass_begin_info {};
-            renderpass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-            renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
-            renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
-            renderpass_begin_info.renderArea.offset = {0, 0};
-            renderpass_begin_info.renderArea.extent = {s_directional_light_shadow_map_dimension,
-                                                       s_directional_light_shadow_map_dimension};
-
-            VkClearValue clear_values[2];
-            clear_values[0].color                 = {1.0f};
-            clear_values[1].depthStencil          = {1.0f, 0};
-            renderpass_begin_info.clearValueCount = (sizeof(clear_values) / sizeof(clear_values[0]));
-            renderpass_begin_info.pClearValues    = clear_values;
-
-            m_vulkan_rhi->m_vk_cmd_begin_render_pass(
-                m_vulkan_rhi->m_current_command_buffer, &renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
-
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
-                                                   NULL,
-                                                   "Directional Light Shadow",
-                                                   {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
-            }
-        }
+        // perframe storage buffer
+        uint32_t perframe_dynamic_offset =
+            m_global_render_resource->_storage_buffer.allocateFromRingBuffer(
+                m_vulkan_rhi->m_current_frame_index, sizeof(MeshPerframeStorageBufferObject));
+
+        MeshDirectionalLightShadowPerframeStorageBufferObject& perframe_storage_buffer_object =
+            (*reinterpret_cast<MeshDirectionalLightShadowPerframeStorageBufferObject*>(
+                reinterpret_cast<uintptr_t>(
+                    m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
+                perframe_dynamic_offset));
+        perframe_storage_buffer_object.light_proj_view = light_proj_view;
 
-        // Mesh
-        if (m_vulkan_rhi->isPointLightShadowEnabled())
+        for (auto& [material, mesh_instanced] : directional_light_mesh_drawcall_batch)
         {
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                VkDebugUtilsLabelEXT label_info = {
-                    VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Mesh", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
-            }
+            // TODO: render from near to far
 
-            m_vulkan_rhi->m_vk_cmd_bind_pipeline(m_vulkan_rhi->m_current_command_buffer,
-                                                 VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                 m_render_pipelines[0].pipeline);
-
-            // perframe storage buffer
-            uint32_t perframe_dynamic_offset =
-                roundUp(m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-            assert(m_global_render_resource->_storage_buffer
-                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                   (m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-            MeshDirectionalLightShadowPerframeStorageBufferObject& perframe_storage_buffer_object =
-                (*reinterpret_cast<MeshDirectionalLightShadowPerframeStorageBufferObject*>(
-                    reinterpret_cast<uintptr_t>(
-                        m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
-                    perframe_dynamic_offset));
-            perframe_storage_buffer_object = m_mesh_directional_light_shadow_perframe_storage_buffer_object;
-
-            for (auto& [material, mesh_instanced] : directional_light_mesh_drawcall_batch)
+            for (auto& [mesh, mesh_nodes] : mesh_instanced)
             {
-                // TODO: render from near to far
-
-                for (auto& [mesh, mesh_nodes] : mesh_instanced)
+                uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
+                if (total_instance_count > 0)
                 {
-                    uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
-                    if (total_instance_count > 0)
+                    // bind per mesh
+                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
+                                                                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                                m_render_pipelines[0].layout,
+                                                                1,
+                                                                1,
+                                                                &mesh->mesh_vertex_blending_descriptor_set,
+                                                                0,
+                                                                NULL);
+
+                    VkBuffer     vertex_buffers[] = {mesh->mesh_vertex_position_buffer};
+                    VkDeviceSize offsets[]        = {0};
+                    m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(command_buffer, 0, 1, vertex_buffers, offsets);
+                    m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
+                        command_buffer, mesh->mesh_index_buffer, 0, VK_INDEX_TYPE_UINT16);
+
+                    uint32_t drawcall_max_instance_count =
+                        (sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
+                         sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances[0]));
+                    uint32_t drawcall_count =
+                        roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
+
+                    for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
                     {
-                        // bind per mesh
-                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
-                                                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                                                    m_render_pipelines[0].layout,
-                                                                    1,
-                                                                    1,
-                                                                    &mesh->mesh_vertex_blending_descriptor_set,
-                                                                    0,
-                                                                    NULL);
-
-                        VkBuffer     vertex_buffers[] = {mesh->mesh_vertex_position_buffer};
-                        VkDeviceSize offsets[]        = {0};
-                        m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(
-                            m_vulkan_rhi->m_current_command_buffer, 0, 1, vertex_buffers, offsets);
-                        m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
-                            m_vulkan_rhi->m_current_command_buffer, mesh->mesh_index_buffer, 0, VK_INDEX_TYPE_UINT16);
-
-                        uint32_t drawcall_max_instance_count =
-                            (sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
-                             sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject::mesh_instances[0]));
-                        uint32_t drawcall_count =
-                            roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
-
-                        for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
+                        uint32_t current_instance_count =
+                            ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                             drawcall_max_instance_count) ?
+                                (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                                drawcall_max_instance_count;
+
+                        // perdrawcall storage buffer
+                        uint32_t perdrawcall_dynamic_offset =
+                            m_global_render_resource->_storage_buffer.allocateFromRingBuffer(
+                                m_vulkan_rhi->m_current_frame_index,
+                                sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject));
+
+                        MeshDirectionalLightShadowPerdrawcallStorageBufferObject&
+                            perdrawcall_storage_buffer_object =
+                                (*reinterpret_cast<MeshDirectionalLightShadowPerdrawcallStorageBufferObject*>(
+                                    reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
+                                                                    ._global_upload_ringbuffer_memory_pointer) +
+                                    perdrawcall_dynamic_offset));
+                        for (uint32_t i = 0; i < current_instance_count; ++i)
                         {
-                            uint32_t current_instance_count =
-                                ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
-                                 drawcall_max_instance_count) ?
-                                    (total_instance_count - drawcall_max_instance_count * drawcall_index) :
-                                    drawcall_max_instance_count;
-
-                            // perdrawcall storage buffer
-                            uint32_t perdrawcall_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                perdrawcall_dynamic_offset +
-                                sizeof(MeshDirectionalLightShadowPerdrawcallStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                            MeshDirectionalLightShadowPerdrawcallStorageBufferObject&
-                                perdrawcall_storage_buffer_object =
-                                    (*reinterpret_cast<MeshDirectionalLightShadowPerdrawcallStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        perdrawcall_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                    *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                                perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                                  -1.0;
-                            }
-
-                            // per drawcall vertex blending storage buffer
-                            uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                            bool     least_one_enable_vertex_blending = true;
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    least_one_enable_vertex_blending = false;
-                                    break;
-                                }
-                            }
-                            if (least_one_enable_vertex_blending)
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = roundUp(
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                    per_drawcall_vertex_blending_dynamic_offset +
-                                    sizeof(MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject);
-                                assert(m_global_render_resource->_storage_buffer
-                                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                       (m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                        m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                                MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject&
-                                    per_drawcall_vertex_blending_storage_buffer_object =
-                                        (*reinterpret_cast<
-                                            MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject*>(
-                                            reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                            ._global_upload_ringbuffer_memory_pointer) +
-                                            per_drawcall_vertex_blending_dynamic_offset));
-                                for (uint32_t i = 0; i < current_instance_count; ++i)
-                                {
-                                    if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                    {
-                                        for (uint32_t j = 0;
-                                             j <
-                                             mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                             ++j)
-                                        {
-                                            per_drawcall_vertex_blending_storage_buffer_object
-                                                .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                    .joint_matrices[j];
-                                        }
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = 0;
-                            }
-
-                            // bind perdrawcall
-                            uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
-                                                           perdrawcall_dynamic_offset,
-                                                           per_drawcall_vertex_blending_dynamic_offset};
-                            m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                                m_vulkan_rhi->m_current_command_buffer,
-                                VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                m_render_pipelines[0].layout,
-                                0,
-                                1,
-                                &m_descriptor_infos[0].descriptor_set,
-                                (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
-                                dynamic_offsets);
-                            m_vulkan_rhi->m_vk_cmd_draw_indexed(m_vulkan_rhi->m_current_command_buffer,
-                                                                mesh->mesh_index_count,
-                                                                current_instance_count,
-                                                                0,
-                                                                0,
-                                                                0);
+                            const MeshNode& mesh_node = mesh_nodes[drawcall_max_instance_count * drawcall_index + i];
+                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix = *mesh_node.model_matrix;
+                            perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
+                                mesh_node.enable_vertex_blending ? 1.0 : -1.0;
+                            perdrawcall_storage_buffer_object.mesh_instances[i].joint_matrix_offset =
+                                mesh_node.joint_matrix_offset;
                         }
+
+                        // the joint palette of this frame was written once and is shared by every pass
+                        uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                            m_global_render_resource->_storage_buffer.getJointPaletteDynamicOffset(
+                                m_vulkan_rhi->m_current_frame_index);
+
+                        // bind perdrawcall
+                        uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
+                                                       perdrawcall_dynamic_offset,
+                                                       per_drawcall_vertex_blending_dynamic_offset};
+                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
+                            command_buffer,
+                            VK_PIPELINE_BIND_POINT_GRAPHICS,
+                            m_render_pipelines[0].layout,
+                            0,
+                            1,
+                            &m_descriptor_infos[0].descriptor_set,
+                            (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
+                            dynamic_offsets);
+                        m_vulkan_rhi->m_vk_cmd_draw_indexed(command_buffer,
+                                                            mesh->mesh_index_count,
+                                                            current_instance_count,
+                                                            0,
+                                                            0,
+                                                            0);
                     }
                 }
             }
-
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
-            }
-        }
-
-        // Directional Light Shadow end pass
-        {
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
-            }
-
-            m_vulkan_rhi->m_vk_cmd_end_render_pass(m_vulkan_rhi->m_current_command_buffer);
         }
     }
 } // namespace Piccolo
@@ -2,6 +2,8 @@
 
 #include "runtime/function/render/render_pass.h"
 
+#include <array>
+
 namespace Piccolo
 {
     class RenderResourceBase;
@@ -14,6 +16,9 @@ namespace Piccolo
         void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
         void draw() override final;
 
+        // records the shadow casters into this frame's secondary command buffer of the given recording thread
+        void recordSecondaryCommandBuffer(uint32_t thread_index);
+
         void setPerMeshLayout(const VkDescriptorSetLayout& layout) { m_per_mesh_layout = layout; }
 
     private:
@@ -23,11 +28,19 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
-        void drawModel();
+        void drawModel(VkCommandBuffer command_buffer);
+        // clears the tile of the cascade in the given atlas row and draws the casters into it
+        void drawTile(VkCommandBuffer                    command_buffer,
+                      uint32_t                           cascade_index,
+                      uint32_t                           row,
+                      const Matrix4x4&                   light_proj_view,
+                      const std::vector<RenderMeshNode>& mesh_nodes_to_draw);
 
     private:
         VkDescriptorSetLayout m_per_mesh_layout;
-        MeshDirectionalLightShadowPerframeStorageBufferObject
-            m_mesh_directional_light_shadow_perframe_storage_buffer_object;
+        VkCommandBuffer       m_secondary_command_buffer {VK_NULL_HANDLE};
+
+        // whether the dynamic tile of a cascade was drawn last frame and has to be cleared
+        std::array<bool, s_directional_light_cascade_count> m_has_dynamic_casters {};
     };
 } // namespace Piccolo
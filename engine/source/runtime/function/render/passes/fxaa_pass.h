@@ -9,6 +9,7 @@ namespace Piccolo
     struct FXAAPassInitInfo : RenderPassInitInfo
     {
         VkRenderPass render_pass;
+        uint32_t     subpass_index {_main_camera_subpass_fxaa};
         VkImageView  input_attachment;
     };
 
@@ -24,5 +25,8 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
+
+    private:
+        uint32_t m_subpass_index {_main_camera_subpass_fxaa};
     };
 } // namespace Piccolo
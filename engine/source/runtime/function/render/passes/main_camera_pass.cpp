@@ -13,7 +13,10 @@
 #include <axis_vert.h>
 #include <deferred_lighting_frag.h>
 #include <deferred_lighting_vert.h>
+#include <mesh_bindless_frag.h>
+#include <mesh_bindless_vert.h>
 #include <mesh_frag.h>
+#include <mesh_gbuffer_bindless_frag.h>
 #include <mesh_gbuffer_frag.h>
 #include <mesh_vert.h>
 #include <skybox_frag.h>
@@ -28,6 +31,7 @@ namespace Piccolo
         const MainCameraPassInitInfo* _init_info = static_cast<const MainCameraPassInitInfo*>(init_info);
         m_enable_fxaa                            = _init_info->enble_fxaa;
 
+        setupRenderGraph();
         setupAttachments();
         setupRenderPass();
         setupDescriptorSetLayout();
@@ -49,504 +53,171 @@ namespace Piccolo
         }
     }
 
+    void MainCameraPass::setupRenderGraph()
+    {
+        m_render_graph.clear();
+
+        VkClearValue clear_color_transparent {};
+        clear_color_transparent.color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+        VkClearValue clear_color_opaque {};
+        clear_color_opaque.color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+        VkClearValue clear_depth {};
+        clear_depth.depthStencil = {1.0f, 0};
+
+        RenderGraphResourceDesc gbuffer_desc {};
+        gbuffer_desc.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+                             VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        gbuffer_desc.clear_value = clear_color_transparent;
+
+        // the normal buffer is sampled in place by the particle collision after the frame
+        RenderGraphResourceDesc gbuffer_normal_desc = gbuffer_desc;
+        gbuffer_normal_desc.format                  = VK_FORMAT_R8G8B8A8_UNORM;
+        gbuffer_normal_desc.usage =
+            VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        gbuffer_normal_desc.persistent   = true;
+        gbuffer_normal_desc.final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        m_render_graph.addResource(_main_camera_pass_gbuffer_a, gbuffer_normal_desc);
+
+        gbuffer_desc.format = VK_FORMAT_R8G8B8A8_UNORM;
+        m_render_graph.addResource(_main_camera_pass_gbuffer_b, gbuffer_desc);
+        gbuffer_desc.format = VK_FORMAT_R8G8B8A8_SRGB;
+        m_render_graph.addResource(_main_camera_pass_gbuffer_c, gbuffer_desc);
+
+        RenderGraphResourceDesc backup_desc {};
+        backup_desc.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+        backup_desc.usage  = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+                            VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        backup_desc.clear_value = clear_color_opaque;
+        m_render_graph.addResource(_main_camera_pass_backup_buffer_odd, backup_desc);
+        m_render_graph.addResource(_main_camera_pass_backup_buffer_even, backup_desc);
+
+        RenderGraphResourceDesc post_process_desc {};
+        post_process_desc.format = VK_FORMAT_R16G16B16A16_SFLOAT;
+        post_process_desc.usage  = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+                                  VK_IMAGE_USAGE_SAMPLED_BIT;
+        post_process_desc.clear_value = clear_color_opaque;
+        m_render_graph.addResource(_main_camera_pass_post_process_buffer_odd, post_process_desc);
+        m_render_graph.addResource(_main_camera_pass_post_process_buffer_even, post_process_desc);
+
+        RenderGraphResourceDesc depth_desc {};
+        depth_desc.format       = m_vulkan_rhi->m_depth_image_format;
+        depth_desc.clear_value  = clear_depth;
+        depth_desc.persistent   = true;
+        depth_desc.final_layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        m_render_graph.addResource(_main_camera_pass_depth, depth_desc);
+
+        RenderGraphResourceDesc swapchain_image_desc {};
+        swapchain_image_desc.format       = m_vulkan_rhi->m_swapchain_image_format;
+        swapchain_image_desc.clear_value  = clear_color_opaque;
+        swapchain_image_desc.persistent   = true;
+        swapchain_image_desc.final_layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        m_render_graph.addResource(_main_camera_pass_swap_chain_image, swapchain_image_desc);
+
+        RenderGraphPassDesc base_pass {};
+        base_pass.colors = {_main_camera_pass_gbuffer_a, _main_camera_pass_gbuffer_b, _main_camera_pass_gbuffer_c};
+        base_pass.depth  = _main_camera_pass_depth;
+        m_render_graph.addPass(_main_camera_subpass_basepass, base_pass);
+
+        RenderGraphPassDesc deferred_lighting_pass {};
+        deferred_lighting_pass.inputs          = {_main_camera_pass_gbuffer_a,
+                                                  _main_camera_pass_gbuffer_b,
+                                                  _main_camera_pass_gbuffer_c,
+                                                  _main_camera_pass_depth};
+        deferred_lighting_pass.colors          = {_main_camera_pass_backup_buffer_odd};
+        deferred_lighting_pass.sample_external = true;
+        m_render_graph.addPass(_main_camera_subpass_deferred_lighting, deferred_lighting_pass);
+
+        RenderGraphPassDesc forward_lighting_pass {};
+        forward_lighting_pass.colors          = {_main_camera_pass_backup_buffer_odd};
+        forward_lighting_pass.depth           = _main_camera_pass_depth;
+        forward_lighting_pass.sample_external = true;
+        m_render_graph.addPass(_main_camera_subpass_forward_lighting, forward_lighting_pass);
+
+        RenderGraphPassDesc tone_mapping_pass {};
+        tone_mapping_pass.inputs = {_main_camera_pass_backup_buffer_odd};
+        tone_mapping_pass.colors = {_main_camera_pass_backup_buffer_even};
+        m_render_graph.addPass(_main_camera_subpass_tone_mapping, tone_mapping_pass);
+
+        RenderGraphPassDesc color_grading_pass {};
+        color_grading_pass.inputs = {_main_camera_pass_backup_buffer_even};
+        color_grading_pass.colors = {m_enable_fxaa ? _main_camera_pass_post_process_buffer_odd :
+                                                     _main_camera_pass_backup_buffer_odd};
+        m_render_graph.addPass(_main_camera_subpass_color_grading, color_grading_pass);
+
+        RenderGraphPassDesc fxaa_pass {};
+        fxaa_pass.inputs        = {_main_camera_pass_post_process_buffer_odd};
+        fxaa_pass.colors        = {_main_camera_pass_backup_buffer_odd};
+        fxaa_pass.sample_inputs = true;
+        fxaa_pass.enabled       = m_enable_fxaa;
+        m_render_graph.addPass(_main_camera_subpass_fxaa, fxaa_pass);
+
+        RenderGraphPassDesc ui_pass {};
+        ui_pass.colors = {_main_camera_pass_backup_buffer_even};
+        m_render_graph.addPass(_main_camera_subpass_ui, ui_pass);
+
+        RenderGraphPassDesc combine_ui_pass {};
+        combine_ui_pass.inputs = {_main_camera_pass_backup_buffer_odd, _main_camera_pass_backup_buffer_even};
+        combine_ui_pass.colors = {_main_camera_pass_swap_chain_image};
+        m_render_graph.addPass(_main_camera_subpass_combine_ui, combine_ui_pass);
+
+        m_render_graph.compile();
+    }
+
     void MainCameraPass::setupAttachments()
     {
         m_framebuffer.attachments.resize(_main_camera_pass_custom_attachment_count +
                                          _main_camera_pass_post_process_attachment_count);
 
-        m_framebuffer.attachments[_main_camera_pass_gbuffer_a].format          = VK_FORMAT_R8G8B8A8_UNORM;
-        m_framebuffer.attachments[_main_camera_pass_gbuffer_b].format          = VK_FORMAT_R8G8B8A8_UNORM;
-        m_framebuffer.attachments[_main_camera_pass_gbuffer_c].format          = VK_FORMAT_R8G8B8A8_SRGB;
-        m_framebuffer.attachments[_main_camera_pass_backup_buffer_odd].format  = VK_FORMAT_R16G16B16A16_SFLOAT;
-        m_framebuffer.attachments[_main_camera_pass_backup_buffer_even].format = VK_FORMAT_R16G16B16A16_SFLOAT;
-
-        for (int buffer_index = 0; buffer_index < _main_camera_pass_custom_attachment_count; ++buffer_index)
+        for (uint32_t attachment_index = 0; attachment_index < m_framebuffer.attachments.size(); ++attachment_index)
         {
-            if (buffer_index == _main_camera_pass_gbuffer_a)
+            FrameBufferAttachment& attachment = m_framebuffer.attachments[attachment_index];
+            attachment.format                 = m_render_graph.getResourceDesc(attachment_index).format;
+
+            // attachments of culled subpasses are not allocated, aliased ones share the image of the owner
+            uint32_t owner_index = m_render_graph.getAliasedResource(attachment_index);
+            if (owner_index == RenderGraph::s_culled)
             {
-                VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
-                                        m_vulkan_rhi->m_device,
-                                        m_vulkan_rhi->m_swapchain_extent.width,
-                                        m_vulkan_rhi->m_swapchain_extent.height,
-                                        m_framebuffer.attachments[_main_camera_pass_gbuffer_a].format,
-                                        VK_IMAGE_TILING_OPTIMAL,
-                                        VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
-                                            VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
-                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                        m_framebuffer.attachments[_main_camera_pass_gbuffer_a].image,
-                                        m_framebuffer.attachments[_main_camera_pass_gbuffer_a].mem,
-                                        0,
-                                        1,
-                                        1);
+                attachment.image = VK_NULL_HANDLE;
+                attachment.mem   = VK_NULL_HANDLE;
+                attachment.view  = VK_NULL_HANDLE;
+                continue;
             }
-            else
+            if (owner_index != attachment_index)
             {
-                VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
-                                        m_vulkan_rhi->m_device,
-                                        m_vulkan_rhi->m_swapchain_extent.width,
-                                        m_vulkan_rhi->m_swapchain_extent.height,
-                                        m_framebuffer.attachments[buffer_index].format,
-                                        VK_IMAGE_TILING_OPTIMAL,
-                                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
-                                            VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
-                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                        m_framebuffer.attachments[buffer_index].image,
-                                        m_framebuffer.attachments[buffer_index].mem,
-                                        0,
-                                        1,
-                                        1);
+                attachment.image = m_framebuffer.attachments[owner_index].image;
+                attachment.mem   = m_framebuffer.attachments[owner_index].mem;
+                attachment.view  = m_framebuffer.attachments[owner_index].view;
+                continue;
             }
 
-            m_framebuffer.attachments[buffer_index].view =
-                VulkanUtil::createImageView(m_vulkan_rhi->m_device,
-                                            m_framebuffer.attachments[buffer_index].image,
-                                            m_framebuffer.attachments[buffer_index].format,
-                                            VK_IMAGE_ASPECT_COLOR_BIT,
-                                            VK_IMAGE_VIEW_TYPE_2D,
-                                            1,
-                                            1);
-        }
-
-        m_framebuffer.attachments[_main_camera_pass_post_process_buffer_odd].format  = VK_FORMAT_R16G16B16A16_SFLOAT;
-        m_framebuffer.attachments[_main_camera_pass_post_process_buffer_even].format = VK_FORMAT_R16G16B16A16_SFLOAT;
-        for (int attachment_index = _main_camera_pass_custom_attachment_count;
-             attachment_index <
-             _main_camera_pass_custom_attachment_count + _main_camera_pass_post_process_attachment_count;
-             ++attachment_index)
-        {
-            VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
-                                    m_vulkan_rhi->m_device,
-                                    m_vulkan_rhi->m_swapchain_extent.width,
-                                    m_vulkan_rhi->m_swapchain_extent.height,
-                                    m_framebuffer.attachments[attachment_index].format,
-                                    VK_IMAGE_TILING_OPTIMAL,
-                                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
-                                        VK_IMAGE_USAGE_SAMPLED_BIT,
-                                    VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                    m_framebuffer.attachments[attachment_index].image,
-                                    m_framebuffer.attachments[attachment_index].mem,
-                                    0,
-                                    1,
-                                    1);
-
-            m_framebuffer.attachments[attachment_index].view =
-                VulkanUtil::createImageView(m_vulkan_rhi->m_device,
-                                            m_framebuffer.attachments[attachment_index].image,
-                                            m_framebuffer.attachments[attachment_index].format,
-                                            VK_IMAGE_ASPECT_COLOR_BIT,
-                                            VK_IMAGE_VIEW_TYPE_2D,
-                                            1,
-                                            1);
+            VulkanUtil::createImage(
+                m_vulkan_rhi->m_physical_device,
+                m_vulkan_rhi->m_device,
+                m_vulkan_rhi->m_swapchain_extent.width,
+                m_vulkan_rhi->m_swapchain_extent.height,
+                attachment.format,
+                VK_IMAGE_TILING_OPTIMAL,
+                m_render_graph.getAttachmentUsage(m_render_graph.getAttachmentIndex(attachment_index)),
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                attachment.image,
+                attachment.mem,
+                0,
+                1,
+                1);
+
+            attachment.view = VulkanUtil::createImageView(m_vulkan_rhi->m_device,
+                                                          attachment.image,
+                                                          attachment.format,
+                                                          VK_IMAGE_ASPECT_COLOR_BIT,
+                                                          VK_IMAGE_VIEW_TYPE_2D,
+                                                          1,
+                                                          1);
         }
     }
 
     void MainCameraPass::setupRenderPass()
     {
-        VkAttachmentDescription attachments[_main_camera_pass_attachment_count] = {};
-
-        VkAttachmentDescription& gbuffer_normal_attachment_description = attachments[_main_camera_pass_gbuffer_a];
-        gbuffer_normal_attachment_description.format  = m_framebuffer.attachments[_main_camera_pass_gbuffer_a].format;
-        gbuffer_normal_attachment_description.samples = VK_SAMPLE_COUNT_1_BIT;
-        gbuffer_normal_attachment_description.loadOp  = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        gbuffer_normal_attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-        gbuffer_normal_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        gbuffer_normal_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        gbuffer_normal_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-        gbuffer_normal_attachment_description.finalLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentDescription& gbuffer_metallic_roughness_shadingmodeid_attachment_description =
-            attachments[_main_camera_pass_gbuffer_b];
-        gbuffer_metallic_roughness_shadingmodeid_attachment_description.format =
-            m_framebuffer.attachments[_main_camera_pass_gbuffer_b].format;
-        gbuffer_metallic_roughness_shadingmodeid_attachment_description.samples = VK_SAMPLE_COUNT_1_BIT;
-        gbuffer_metallic_roughness_shadingmodeid_attachment_description.loadOp  = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        gbuffer_metallic_roughness_shadingmodeid_attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        gbuffer_metallic_roughness_shadingmodeid_attachment_description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        gbuffer_metallic_roughness_shadingmodeid_attachment_description.stencilStoreOp =
-            VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        gbuffer_metallic_roughness_shadingmodeid_attachment_description.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        gbuffer_metallic_roughness_shadingmodeid_attachment_description.finalLayout =
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentDescription& gbuffer_albedo_attachment_description = attachments[_main_camera_pass_gbuffer_c];
-        gbuffer_albedo_attachment_description.format  = m_framebuffer.attachments[_main_camera_pass_gbuffer_c].format;
-        gbuffer_albedo_attachment_description.samples = VK_SAMPLE_COUNT_1_BIT;
-        gbuffer_albedo_attachment_description.loadOp  = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        gbuffer_albedo_attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        gbuffer_albedo_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        gbuffer_albedo_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        gbuffer_albedo_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-        gbuffer_albedo_attachment_description.finalLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentDescription& backup_odd_color_attachment_description =
-            attachments[_main_camera_pass_backup_buffer_odd];
-        backup_odd_color_attachment_description.format =
-            m_framebuffer.attachments[_main_camera_pass_backup_buffer_odd].format;
-        backup_odd_color_attachment_description.samples        = VK_SAMPLE_COUNT_1_BIT;
-        backup_odd_color_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        backup_odd_color_attachment_description.storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        backup_odd_color_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        backup_odd_color_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        backup_odd_color_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-        backup_odd_color_attachment_description.finalLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentDescription& backup_even_color_attachment_description =
-            attachments[_main_camera_pass_backup_buffer_even];
-        backup_even_color_attachment_description.format =
-            m_framebuffer.attachments[_main_camera_pass_backup_buffer_even].format;
-        backup_even_color_attachment_description.samples        = VK_SAMPLE_COUNT_1_BIT;
-        backup_even_color_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        backup_even_color_attachment_description.storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        backup_even_color_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        backup_even_color_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        backup_even_color_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-        backup_even_color_attachment_description.finalLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentDescription& post_process_odd_color_attachment_description =
-            attachments[_main_camera_pass_post_process_buffer_odd];
-        post_process_odd_color_attachment_description.format =
-            m_framebuffer.attachments[_main_camera_pass_post_process_buffer_odd].format;
-        post_process_odd_color_attachment_description.samples        = VK_SAMPLE_COUNT_1_BIT;
-        post_process_odd_color_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        post_process_odd_color_attachment_description.storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        post_process_odd_color_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        post_process_odd_color_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        post_process_odd_color_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-        post_process_odd_color_attachment_description.finalLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentDescription& post_process_even_color_attachment_description =
-            attachments[_main_camera_pass_post_process_buffer_even];
-        post_process_even_color_attachment_description.format =
-            m_framebuffer.attachments[_main_camera_pass_post_process_buffer_even].format;
-        post_process_even_color_attachment_description.samples        = VK_SAMPLE_COUNT_1_BIT;
-        post_process_even_color_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        post_process_even_color_attachment_description.storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        post_process_even_color_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        post_process_even_color_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        post_process_even_color_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-        post_process_even_color_attachment_description.finalLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentDescription& depth_attachment_description = attachments[_main_camera_pass_depth];
-        depth_attachment_description.format                   = m_vulkan_rhi->m_depth_image_format;
-        depth_attachment_description.samples                  = VK_SAMPLE_COUNT_1_BIT;
-        depth_attachment_description.loadOp                   = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        depth_attachment_description.storeOp                  = VK_ATTACHMENT_STORE_OP_STORE;
-        depth_attachment_description.stencilLoadOp            = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        depth_attachment_description.stencilStoreOp           = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        depth_attachment_description.initialLayout            = VK_IMAGE_LAYOUT_UNDEFINED;
-        depth_attachment_description.finalLayout              = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-        VkAttachmentDescription& swapchain_image_attachment_description =
-            attachments[_main_camera_pass_swap_chain_image];
-        swapchain_image_attachment_description.format         = m_vulkan_rhi->m_swapchain_image_format;
-        swapchain_image_attachment_description.samples        = VK_SAMPLE_COUNT_1_BIT;
-        swapchain_image_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
-        swapchain_image_attachment_description.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
-        swapchain_image_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-        swapchain_image_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        swapchain_image_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
-        swapchain_image_attachment_description.finalLayout    = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-        VkSubpassDescription subpasses[_main_camera_subpass_count] = {};
-
-        VkAttachmentReference base_pass_color_attachments_reference[3] = {};
-        base_pass_color_attachments_reference[0].attachment = &gbuffer_normal_attachment_description - attachments;
-        base_pass_color_attachments_reference[0].layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        base_pass_color_attachments_reference[1].attachment =
-            &gbuffer_metallic_roughness_shadingmodeid_attachment_description - attachments;
-        base_pass_color_attachments_reference[1].layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-        base_pass_color_attachments_reference[2].attachment = &gbuffer_albedo_attachment_description - attachments;
-        base_pass_color_attachments_reference[2].layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkAttachmentReference base_pass_depth_attachment_reference {};
-        base_pass_depth_attachment_reference.attachment = &depth_attachment_description - attachments;
-        base_pass_depth_attachment_reference.layout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription& base_pass = subpasses[_main_camera_subpass_basepass];
-        base_pass.pipelineBindPoint     = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        base_pass.colorAttachmentCount =
-            sizeof(base_pass_color_attachments_reference) / sizeof(base_pass_color_attachments_reference[0]);
-        base_pass.pColorAttachments       = &base_pass_color_attachments_reference[0];
-        base_pass.pDepthStencilAttachment = &base_pass_depth_attachment_reference;
-        base_pass.preserveAttachmentCount = 0;
-        base_pass.pPreserveAttachments    = NULL;
-
-        VkAttachmentReference deferred_lighting_pass_input_attachments_reference[4] = {};
-        deferred_lighting_pass_input_attachments_reference[0].attachment =
-            &gbuffer_normal_attachment_description - attachments;
-        deferred_lighting_pass_input_attachments_reference[0].layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        deferred_lighting_pass_input_attachments_reference[1].attachment =
-            &gbuffer_metallic_roughness_shadingmodeid_attachment_description - attachments;
-        deferred_lighting_pass_input_attachments_reference[1].layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        deferred_lighting_pass_input_attachments_reference[2].attachment =
-            &gbuffer_albedo_attachment_description - attachments;
-        deferred_lighting_pass_input_attachments_reference[2].layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        deferred_lighting_pass_input_attachments_reference[3].attachment = &depth_attachment_description - attachments;
-        deferred_lighting_pass_input_attachments_reference[3].layout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentReference deferred_lighting_pass_color_attachment_reference[1] = {};
-        deferred_lighting_pass_color_attachment_reference[0].attachment =
-            &backup_odd_color_attachment_description - attachments;
-        deferred_lighting_pass_color_attachment_reference[0].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription& deferred_lighting_pass = subpasses[_main_camera_subpass_deferred_lighting];
-        deferred_lighting_pass.pipelineBindPoint     = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        deferred_lighting_pass.inputAttachmentCount  = sizeof(deferred_lighting_pass_input_attachments_reference) /
-                                                      sizeof(deferred_lighting_pass_input_attachments_reference[0]);
-        deferred_lighting_pass.pInputAttachments    = &deferred_lighting_pass_input_attachments_reference[0];
-        deferred_lighting_pass.colorAttachmentCount = sizeof(deferred_lighting_pass_color_attachment_reference) /
-                                                      sizeof(deferred_lighting_pass_color_attachment_reference[0]);
-        deferred_lighting_pass.pColorAttachments       = &deferred_lighting_pass_color_attachment_reference[0];
-        deferred_lighting_pass.pDepthStencilAttachment = NULL;
-        deferred_lighting_pass.preserveAttachmentCount = 0;
-        deferred_lighting_pass.pPreserveAttachments    = NULL;
-
-        VkAttachmentReference forward_lighting_pass_color_attachments_reference[1] = {};
-        forward_lighting_pass_color_attachments_reference[0].attachment =
-            &backup_odd_color_attachment_description - attachments;
-        forward_lighting_pass_color_attachments_reference[0].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkAttachmentReference forward_lighting_pass_depth_attachment_reference {};
-        forward_lighting_pass_depth_attachment_reference.attachment = &depth_attachment_description - attachments;
-        forward_lighting_pass_depth_attachment_reference.layout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription& forward_lighting_pass = subpasses[_main_camera_subpass_forward_lighting];
-        forward_lighting_pass.pipelineBindPoint     = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        forward_lighting_pass.inputAttachmentCount  = 0U;
-        forward_lighting_pass.pInputAttachments     = NULL;
-        forward_lighting_pass.colorAttachmentCount  = sizeof(forward_lighting_pass_color_attachments_reference) /
-                                                     sizeof(forward_lighting_pass_color_attachments_reference[0]);
-        forward_lighting_pass.pColorAttachments       = &forward_lighting_pass_color_attachments_reference[0];
-        forward_lighting_pass.pDepthStencilAttachment = &forward_lighting_pass_depth_attachment_reference;
-        forward_lighting_pass.preserveAttachmentCount = 0;
-        forward_lighting_pass.pPreserveAttachments    = NULL;
-
-        VkAttachmentReference tone_mapping_pass_input_attachment_reference {};
-        tone_mapping_pass_input_attachment_reference.attachment =
-            &backup_odd_color_attachment_description - attachments;
-        tone_mapping_pass_input_attachment_reference.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentReference tone_mapping_pass_color_attachment_reference {};
-        tone_mapping_pass_color_attachment_reference.attachment =
-            &backup_even_color_attachment_description - attachments;
-        tone_mapping_pass_color_attachment_reference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription& tone_mapping_pass   = subpasses[_main_camera_subpass_tone_mapping];
-        tone_mapping_pass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        tone_mapping_pass.inputAttachmentCount    = 1;
-        tone_mapping_pass.pInputAttachments       = &tone_mapping_pass_input_attachment_reference;
-        tone_mapping_pass.colorAttachmentCount    = 1;
-        tone_mapping_pass.pColorAttachments       = &tone_mapping_pass_color_attachment_reference;
-        tone_mapping_pass.pDepthStencilAttachment = NULL;
-        tone_mapping_pass.preserveAttachmentCount = 0;
-        tone_mapping_pass.pPreserveAttachments    = NULL;
-
-        VkAttachmentReference color_grading_pass_input_attachment_reference {};
-        color_grading_pass_input_attachment_reference.attachment =
-            &backup_even_color_attachment_description - attachments;
-        color_grading_pass_input_attachment_reference.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentReference color_grading_pass_color_attachment_reference {};
-        if (m_enable_fxaa)
-        {
-            color_grading_pass_color_attachment_reference.attachment =
-                &post_process_odd_color_attachment_description - attachments;
-        }
-        else
-        {
-            color_grading_pass_color_attachment_reference.attachment =
-                &backup_odd_color_attachment_description - attachments;
-        }
-        color_grading_pass_color_attachment_reference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription& color_grading_pass   = subpasses[_main_camera_subpass_color_grading];
-        color_grading_pass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        color_grading_pass.inputAttachmentCount    = 1;
-        color_grading_pass.pInputAttachments       = &color_grading_pass_input_attachment_reference;
-        color_grading_pass.colorAttachmentCount    = 1;
-        color_grading_pass.pColorAttachments       = &color_grading_pass_color_attachment_reference;
-        color_grading_pass.pDepthStencilAttachment = NULL;
-        color_grading_pass.preserveAttachmentCount = 0;
-        color_grading_pass.pPreserveAttachments    = NULL;
-
-        VkAttachmentReference fxaa_pass_input_attachment_reference {};
-        if (m_enable_fxaa)
-        {
-            fxaa_pass_input_attachment_reference.attachment =
-                &post_process_odd_color_attachment_description - attachments;
-        }
-        else
-        {
-            fxaa_pass_input_attachment_reference.attachment = &backup_even_color_attachment_description - attachments;
-        }
-        fxaa_pass_input_attachment_reference.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentReference fxaa_pass_color_attachment_reference {};
-        fxaa_pass_color_attachment_reference.attachment = &backup_odd_color_attachment_description - attachments;
-        fxaa_pass_color_attachment_reference.layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription& fxaa_pass   = subpasses[_main_camera_subpass_fxaa];
-        fxaa_pass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        fxaa_pass.inputAttachmentCount    = 1;
-        fxaa_pass.pInputAttachments       = &fxaa_pass_input_attachment_reference;
-        fxaa_pass.colorAttachmentCount    = 1;
-        fxaa_pass.pColorAttachments       = &fxaa_pass_color_attachment_reference;
-        fxaa_pass.pDepthStencilAttachment = NULL;
-        fxaa_pass.preserveAttachmentCount = 0;
-        fxaa_pass.pPreserveAttachments    = NULL;
-
-        VkAttachmentReference ui_pass_color_attachment_reference {};
-        ui_pass_color_attachment_reference.attachment = &backup_even_color_attachment_description - attachments;
-        ui_pass_color_attachment_reference.layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        uint32_t ui_pass_preserve_attachment = &backup_odd_color_attachment_description - attachments;
-
-        VkSubpassDescription& ui_pass   = subpasses[_main_camera_subpass_ui];
-        ui_pass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        ui_pass.inputAttachmentCount    = 0;
-        ui_pass.pInputAttachments       = NULL;
-        ui_pass.colorAttachmentCount    = 1;
-        ui_pass.pColorAttachments       = &ui_pass_color_attachment_reference;
-        ui_pass.pDepthStencilAttachment = NULL;
-        ui_pass.preserveAttachmentCount = 1;
-        ui_pass.pPreserveAttachments    = &ui_pass_preserve_attachment;
-
-        VkAttachmentReference combine_ui_pass_input_attachments_reference[2] = {};
-        combine_ui_pass_input_attachments_reference[0].attachment =
-            &backup_odd_color_attachment_description - attachments;
-        combine_ui_pass_input_attachments_reference[0].layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        combine_ui_pass_input_attachments_reference[1].attachment =
-            &backup_even_color_attachment_description - attachments;
-        combine_ui_pass_input_attachments_reference[1].layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-        VkAttachmentReference combine_ui_pass_color_attachment_reference {};
-        combine_ui_pass_color_attachment_reference.attachment = &swapchain_image_attachment_description - attachments;
-        combine_ui_pass_color_attachment_reference.layout     = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-        VkSubpassDescription& combine_ui_pass = subpasses[_main_camera_subpass_combine_ui];
-        combine_ui_pass.pipelineBindPoint     = VK_PIPELINE_BIND_POINT_GRAPHICS;
-        combine_ui_pass.inputAttachmentCount  = sizeof(combine_ui_pass_input_attachments_reference) /
-                                               sizeof(combine_ui_pass_input_attachments_reference[0]);
-        combine_ui_pass.pInputAttachments       = combine_ui_pass_input_attachments_reference;
-        combine_ui_pass.colorAttachmentCount    = 1;
-        combine_ui_pass.pColorAttachments       = &combine_ui_pass_color_attachment_reference;
-        combine_ui_pass.pDepthStencilAttachment = NULL;
-        combine_ui_pass.preserveAttachmentCount = 0;
-        combine_ui_pass.pPreserveAttachments    = NULL;
-
-        VkSubpassDependency dependencies[8] = {};
-
-        VkSubpassDependency& deferred_lighting_pass_depend_on_shadow_map_pass = dependencies[0];
-        deferred_lighting_pass_depend_on_shadow_map_pass.srcSubpass           = VK_SUBPASS_EXTERNAL;
-        deferred_lighting_pass_depend_on_shadow_map_pass.dstSubpass           = _main_camera_subpass_deferred_lighting;
-        deferred_lighting_pass_depend_on_shadow_map_pass.srcStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        deferred_lighting_pass_depend_on_shadow_map_pass.dstStageMask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        deferred_lighting_pass_depend_on_shadow_map_pass.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        deferred_lighting_pass_depend_on_shadow_map_pass.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        deferred_lighting_pass_depend_on_shadow_map_pass.dependencyFlags = 0; // NOT BY REGION
-
-        VkSubpassDependency& deferred_lighting_pass_depend_on_base_pass = dependencies[1];
-        deferred_lighting_pass_depend_on_base_pass.srcSubpass           = _main_camera_subpass_basepass;
-        deferred_lighting_pass_depend_on_base_pass.dstSubpass           = _main_camera_subpass_deferred_lighting;
-        deferred_lighting_pass_depend_on_base_pass.srcStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        deferred_lighting_pass_depend_on_base_pass.dstStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        deferred_lighting_pass_depend_on_base_pass.srcAccessMask =
-            VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        deferred_lighting_pass_depend_on_base_pass.dstAccessMask =
-            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-        deferred_lighting_pass_depend_on_base_pass.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-
-        VkSubpassDependency& forward_lighting_pass_depend_on_deferred_lighting_pass = dependencies[2];
-        forward_lighting_pass_depend_on_deferred_lighting_pass.srcSubpass = _main_camera_subpass_deferred_lighting;
-        forward_lighting_pass_depend_on_deferred_lighting_pass.dstSubpass = _main_camera_subpass_forward_lighting;
-        forward_lighting_pass_depend_on_deferred_lighting_pass.srcStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        forward_lighting_pass_depend_on_deferred_lighting_pass.dstStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        forward_lighting_pass_depend_on_deferred_lighting_pass.srcAccessMask =
-            VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        forward_lighting_pass_depend_on_deferred_lighting_pass.dstAccessMask =
-            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-        forward_lighting_pass_depend_on_deferred_lighting_pass.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-
-        VkSubpassDependency& tone_mapping_pass_depend_on_lighting_pass = dependencies[3];
-        tone_mapping_pass_depend_on_lighting_pass.srcSubpass           = _main_camera_subpass_forward_lighting;
-        tone_mapping_pass_depend_on_lighting_pass.dstSubpass           = _main_camera_subpass_tone_mapping;
-        tone_mapping_pass_depend_on_lighting_pass.srcStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        tone_mapping_pass_depend_on_lighting_pass.dstStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        tone_mapping_pass_depend_on_lighting_pass.srcAccessMask =
-            VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        tone_mapping_pass_depend_on_lighting_pass.dstAccessMask =
-            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-        tone_mapping_pass_depend_on_lighting_pass.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-
-        VkSubpassDependency& color_grading_pass_depend_on_tone_mapping_pass = dependencies[4];
-        color_grading_pass_depend_on_tone_mapping_pass.srcSubpass           = _main_camera_subpass_tone_mapping;
-        color_grading_pass_depend_on_tone_mapping_pass.dstSubpass           = _main_camera_subpass_color_grading;
-        color_grading_pass_depend_on_tone_mapping_pass.srcStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        color_grading_pass_depend_on_tone_mapping_pass.dstStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        color_grading_pass_depend_on_tone_mapping_pass.srcAccessMask =
-            VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        color_grading_pass_depend_on_tone_mapping_pass.dstAccessMask =
-            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-        color_grading_pass_depend_on_tone_mapping_pass.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-
-        VkSubpassDependency& fxaa_pass_depend_on_color_grading_pass = dependencies[5];
-        fxaa_pass_depend_on_color_grading_pass.srcSubpass           = _main_camera_subpass_color_grading;
-        fxaa_pass_depend_on_color_grading_pass.dstSubpass           = _main_camera_subpass_fxaa;
-        fxaa_pass_depend_on_color_grading_pass.srcStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        fxaa_pass_depend_on_color_grading_pass.dstStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        fxaa_pass_depend_on_color_grading_pass.srcAccessMask =
-            VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        fxaa_pass_depend_on_color_grading_pass.dstAccessMask =
-            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-
-        VkSubpassDependency& ui_pass_depend_on_fxaa_pass = dependencies[6];
-        ui_pass_depend_on_fxaa_pass.srcSubpass           = _main_camera_subpass_fxaa;
-        ui_pass_depend_on_fxaa_pass.dstSubpass           = _main_camera_subpass_ui;
-        ui_pass_depend_on_fxaa_pass.srcStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        ui_pass_depend_on_fxaa_pass.dstStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        ui_pass_depend_on_fxaa_pass.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        ui_pass_depend_on_fxaa_pass.dstAccessMask   = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-        ui_pass_depend_on_fxaa_pass.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-
-        VkSubpassDependency& combine_ui_pass_depend_on_ui_pass = dependencies[7];
-        combine_ui_pass_depend_on_ui_pass.srcSubpass           = _main_camera_subpass_ui;
-        combine_ui_pass_depend_on_ui_pass.dstSubpass           = _main_camera_subpass_combine_ui;
-        combine_ui_pass_depend_on_ui_pass.srcStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        combine_ui_pass_depend_on_ui_pass.dstStageMask =
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        combine_ui_pass_depend_on_ui_pass.srcAccessMask =
-            VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        combine_ui_pass_depend_on_ui_pass.dstAccessMask =
-            VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-        combine_ui_pass_depend_on_ui_pass.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
-
-        VkRenderPassCreateInfo renderpass_create_info {};
-        renderpass_create_info.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderpass_create_info.attachmentCount = (sizeof(attachments) / sizeof(attachments[0]));
-        renderpass_create_info.pAttachments    = attachments;
-        renderpass_create_info.subpassCount    = (sizeof(subpasses) / sizeof(subpasses[0]));
-        renderpass_create_info.pSubpasses      = subpasses;
-        renderpass_create_info.dependencyCount = (sizeof(dependencies) / sizeof(dependencies[0]));
-        renderpass_create_info.pDependencies   = dependencies;
-
-        if (vkCreateRenderPass(m_vulkan_rhi->m_device, &renderpass_create_info, nullptr, &m_framebuffer.render_pass) !=
-            VK_SUCCESS)
-        {
-            throw std::runtime_error("failed to create render pass");
-        }
+        m_framebuffer.render_pass = m_render_graph.createRenderPass(m_vulkan_rhi->m_device);
     }
 
     void MainCameraPass::setupDescriptorSetLayout()
@@ -824,6 +495,64 @@ namespace Piccolo
                 throw std::runtime_error("create deferred lighting global layout");
             }
         }
+
+        if (m_vulkan_rhi->isBindlessEnabled())
+        {
+            VkDescriptorSetLayoutBinding mesh_bindless_layout_bindings[3];
+
+            VkDescriptorSetLayoutBinding& mesh_bindless_layout_material_storage_buffer_binding =
+                mesh_bindless_layout_bindings[0];
+            mesh_bindless_layout_material_storage_buffer_binding.binding            = 0;
+            mesh_bindless_layout_material_storage_buffer_binding.descriptorType     = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            mesh_bindless_layout_material_storage_buffer_binding.descriptorCount    = 1;
+            mesh_bindless_layout_material_storage_buffer_binding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT;
+            mesh_bindless_layout_material_storage_buffer_binding.pImmutableSamplers = NULL;
+
+            VkDescriptorSetLayoutBinding& mesh_bindless_layout_texture_binding = mesh_bindless_layout_bindings[1];
+            mesh_bindless_layout_texture_binding.binding                       = 1;
+            mesh_bindless_layout_texture_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            mesh_bindless_layout_texture_binding.descriptorCount =
+                s_bindless_material_texture_count * s_bindless_max_material_count;
+            mesh_bindless_layout_texture_binding.stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT;
+            mesh_bindless_layout_texture_binding.pImmutableSamplers = NULL;
+
+            VkDescriptorSetLayoutBinding& mesh_bindless_layout_joint_binding_storage_buffer_binding =
+                mesh_bindless_layout_bindings[2];
+            mesh_bindless_layout_joint_binding_storage_buffer_binding.binding = 2;
+            mesh_bindless_layout_joint_binding_storage_buffer_binding.descriptorType =
+                VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            mesh_bindless_layout_joint_binding_storage_buffer_binding.descriptorCount =
+                s_bindless_max_vertex_blending_mesh_count;
+            mesh_bindless_layout_joint_binding_storage_buffer_binding.stageFlags         = VK_SHADER_STAGE_VERTEX_BIT;
+            mesh_bindless_layout_joint_binding_storage_buffer_binding.pImmutableSamplers = NULL;
+
+            // slots are filled as resources are created, while the frames in flight keep reading the other slots
+            VkDescriptorBindingFlagsEXT bindless_array_binding_flags =
+                VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+                VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+            VkDescriptorBindingFlagsEXT mesh_bindless_layout_binding_flags[3] = {
+                0, bindless_array_binding_flags, bindless_array_binding_flags};
+
+            VkDescriptorSetLayoutBindingFlagsCreateInfoEXT mesh_bindless_layout_binding_flags_create_info {};
+            mesh_bindless_layout_binding_flags_create_info.sType =
+                VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+            mesh_bindless_layout_binding_flags_create_info.bindingCount  = 3;
+            mesh_bindless_layout_binding_flags_create_info.pBindingFlags = mesh_bindless_layout_binding_flags;
+
+            VkDescriptorSetLayoutCreateInfo mesh_bindless_layout_create_info {};
+            mesh_bindless_layout_create_info.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            mesh_bindless_layout_create_info.pNext        = &mesh_bindless_layout_binding_flags_create_info;
+            mesh_bindless_layout_create_info.bindingCount = 3;
+            mesh_bindless_layout_create_info.pBindings    = mesh_bindless_layout_bindings;
+
+            if (vkCreateDescriptorSetLayout(m_vulkan_rhi->m_device,
+                                            &mesh_bindless_layout_create_info,
+                                            NULL,
+                                            &m_descriptor_infos[_mesh_bindless].layout) != VK_SUCCESS)
+            {
+                throw std::runtime_error("create mesh bindless layout");
+            }
+        }
     }
 
     void MainCameraPass::setupPipelines()
@@ -840,6 +569,15 @@ namespace Piccolo
             pipeline_layout_create_info.setLayoutCount = 3;
             pipeline_layout_create_info.pSetLayouts    = descriptorset_layouts;
 
+            // per mesh and per material sets are replaced by the bindless set
+            VkDescriptorSetLayout bindless_descriptorset_layouts[2] = {m_descriptor_infos[_mesh_global].layout,
+                                                                       m_descriptor_infos[_mesh_bindless].layout};
+            if (m_vulkan_rhi->isBindlessEnabled())
+            {
+                pipeline_layout_create_info.setLayoutCount = 2;
+                pipeline_layout_create_info.pSetLayouts    = bindless_descriptorset_layouts;
+            }
+
             if (vkCreatePipelineLayout(m_vulkan_rhi->m_device,
                                        &pipeline_layout_create_info,
                                        nullptr,
@@ -848,9 +586,11 @@ namespace Piccolo
                 throw std::runtime_error("create mesh gbuffer pipeline layout");
             }
 
-            VkShaderModule vert_shader_module = VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, MESH_VERT);
-            VkShaderModule frag_shader_module =
-                VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, MESH_GBUFFER_FRAG);
+            VkShaderModule vert_shader_module = VulkanUtil::createShaderModule(
+                m_vulkan_rhi->m_device, m_vulkan_rhi->isBindlessEnabled() ? MESH_BINDLESS_VERT : MESH_VERT);
+            VkShaderModule frag_shader_module = VulkanUtil::createShaderModule(
+                m_vulkan_rhi->m_device,
+                m_vulkan_rhi->isBindlessEnabled() ? MESH_GBUFFER_BINDLESS_FRAG : MESH_GBUFFER_FRAG);
 
             VkPipelineShaderStageCreateInfo vert_pipeline_shader_stage_create_info {};
             vert_pipeline_shader_stage_create_info.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -979,7 +719,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -1128,7 +868,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -1152,6 +892,15 @@ namespace Piccolo
             pipeline_layout_create_info.setLayoutCount = 3;
             pipeline_layout_create_info.pSetLayouts    = descriptorset_layouts;
 
+            // per mesh and per material sets are replaced by the bindless set
+            VkDescriptorSetLayout bindless_descriptorset_layouts[2] = {m_descriptor_infos[_mesh_global].layout,
+                                                                       m_descriptor_infos[_mesh_bindless].layout};
+            if (m_vulkan_rhi->isBindlessEnabled())
+            {
+                pipeline_layout_create_info.setLayoutCount = 2;
+                pipeline_layout_create_info.pSetLayouts    = bindless_descriptorset_layouts;
+            }
+
             if (vkCreatePipelineLayout(m_vulkan_rhi->m_device,
                                        &pipeline_layout_create_info,
                                        nullptr,
@@ -1160,8 +909,10 @@ namespace Piccolo
                 throw std::runtime_error("create mesh lighting pipeline layout");
             }
 
-            VkShaderModule vert_shader_module = VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, MESH_VERT);
-            VkShaderModule frag_shader_module = VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, MESH_FRAG);
+            VkShaderModule vert_shader_module = VulkanUtil::createShaderModule(
+                m_vulkan_rhi->m_device, m_vulkan_rhi->isBindlessEnabled() ? MESH_BINDLESS_VERT : MESH_VERT);
+            VkShaderModule frag_shader_module = VulkanUtil::createShaderModule(
+                m_vulkan_rhi->m_device, m_vulkan_rhi->isBindlessEnabled() ? MESH_BINDLESS_FRAG : MESH_FRAG);
 
             VkPipelineShaderStageCreateInfo vert_pipeline_shader_stage_create_info {};
             vert_pipeline_shader_stage_create_info.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -1272,7 +1023,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -1415,7 +1166,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -1556,7 +1307,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -1615,9 +1366,9 @@ namespace Piccolo
         VkDescriptorBufferInfo mesh_per_drawcall_vertex_blending_storage_buffer_info = {};
         mesh_per_drawcall_vertex_blending_storage_buffer_info.offset                 = 0;
         mesh_per_drawcall_vertex_blending_storage_buffer_info.range =
-            sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
+            sizeof(MeshJointPaletteStorageBufferObject);
         mesh_per_drawcall_vertex_blending_storage_buffer_info.buffer =
-            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+            m_global_render_resource->_storage_buffer._joint_palette_buffer;
         assert(mesh_per_drawcall_vertex_blending_storage_buffer_info.range <
                m_global_render_resource->_storage_buffer._max_storage_buffer_range);
 
@@ -1928,24 +1679,36 @@ namespace Piccolo
         // create frame buffer for every imageview
         for (size_t i = 0; i < m_vulkan_rhi->m_swapchain_imageviews.size(); i++)
         {
-            VkImageView framebuffer_attachments_for_image_view[_main_camera_pass_attachment_count] = {
-                m_framebuffer.attachments[_main_camera_pass_gbuffer_a].view,
-                m_framebuffer.attachments[_main_camera_pass_gbuffer_b].view,
-                m_framebuffer.attachments[_main_camera_pass_gbuffer_c].view,
-                m_framebuffer.attachments[_main_camera_pass_backup_buffer_odd].view,
-                m_framebuffer.attachments[_main_camera_pass_backup_buffer_even].view,
-                m_framebuffer.attachments[_main_camera_pass_post_process_buffer_odd].view,
-                m_framebuffer.attachments[_main_camera_pass_post_process_buffer_even].view,
-                m_vulkan_rhi->m_depth_image_view,
-                m_vulkan_rhi->m_swapchain_imageviews[i]};
+            std::vector<VkImageView> framebuffer_attachments_for_image_view(m_render_graph.getAttachmentCount());
+            for (uint32_t resource = 0; resource < _main_camera_pass_attachment_count; ++resource)
+            {
+                uint32_t attachment_index = m_render_graph.getAttachmentIndex(resource);
+                if (attachment_index == RenderGraph::s_culled)
+                {
+                    continue;
+                }
+
+                if (resource == _main_camera_pass_depth)
+                {
+                    framebuffer_attachments_for_image_view[attachment_index] = m_vulkan_rhi->m_depth_image_view;
+                }
+                else if (resource == _main_camera_pass_swap_chain_image)
+                {
+                    framebuffer_attachments_for_image_view[attachment_index] = m_vulkan_rhi->m_swapchain_imageviews[i];
+                }
+                else
+                {
+                    framebuffer_attachments_for_image_view[attachment_index] = m_framebuffer.attachments[resource].view;
+                }
+            }
 
             VkFramebufferCreateInfo framebuffer_create_info {};
             framebuffer_create_info.sType      = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
             framebuffer_create_info.flags      = 0U;
             framebuffer_create_info.renderPass = m_framebuffer.render_pass;
             framebuffer_create_info.attachmentCount =
-                (sizeof(framebuffer_attachments_for_image_view) / sizeof(framebuffer_attachments_for_image_view[0]));
-            framebuffer_create_info.pAttachments = framebuffer_attachments_for_image_view;
+                static_cast<uint32_t>(framebuffer_attachments_for_image_view.size());
+            framebuffer_create_info.pAttachments = framebuffer_attachments_for_image_view.data();
             framebuffer_create_info.width        = m_vulkan_rhi->m_swapchain_extent.width;
             framebuffer_create_info.height       = m_vulkan_rhi->m_swapchain_extent.height;
             framebuffer_create_info.layers       = 1;
@@ -1963,6 +1726,11 @@ namespace Piccolo
     {
         for (size_t i = 0; i < m_framebuffer.attachments.size(); i++)
         {
+            // aliased attachments are destroyed through their owner
+            if (m_render_graph.getAliasedResource(static_cast<uint32_t>(i)) != i)
+            {
+                continue;
+            }
             vkDestroyImage(m_vulkan_rhi->m_device, m_framebuffer.attachments[i].image, nullptr);
             vkDestroyImageView(m_vulkan_rhi->m_device, m_framebuffer.attachments[i].view, nullptr);
             vkFreeMemory(m_vulkan_rhi->m_device, m_framebuffer.attachments[i].mem, nullptr);
@@ -1998,18 +1766,9 @@ namespace Piccolo
             renderpass_begin_info.renderArea.offset = {0, 0};
             renderpass_begin_info.renderArea.extent = m_vulkan_rhi->m_swapchain_extent;
 
-            VkClearValue clear_values[_main_camera_pass_attachment_count];
-            clear_values[_main_camera_pass_gbuffer_a].color                = {{0.0f, 0.0f, 0.0f, 0.0f}};
-            clear_values[_main_camera_pass_gbuffer_b].color                = {{0.0f, 0.0f, 0.0f, 0.0f}};
-            clear_values[_main_camera_pass_gbuffer_c].color                = {{0.0f, 0.0f, 0.0f, 0.0f}};
-            clear_values[_main_camera_pass_backup_buffer_odd].color        = {{0.0f, 0.0f, 0.0f, 1.0f}};
-            clear_values[_main_camera_pass_backup_buffer_even].color       = {{0.0f, 0.0f, 0.0f, 1.0f}};
-            clear_values[_main_camera_pass_post_process_buffer_odd].color  = {{0.0f, 0.0f, 0.0f, 1.0f}};
-            clear_values[_main_camera_pass_post_process_buffer_even].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
-            clear_values[_main_camera_pass_depth].depthStencil             = {1.0f, 0};
-            clear_values[_main_camera_pass_swap_chain_image].color         = {{0.0f, 0.0f, 0.0f, 1.0f}};
-            renderpass_begin_info.clearValueCount = (sizeof(clear_values) / sizeof(clear_values[0]));
-            renderpass_begin_info.pClearValues    = clear_values;
+            std::vector<VkClearValue> clear_values = m_render_graph.getClearValues();
+            renderpass_begin_info.clearValueCount  = static_cast<uint32_t>(clear_values.size());
+            renderpass_begin_info.pClearValues     = clear_values.data();
 
             m_vulkan_rhi->m_vk_cmd_begin_render_pass(
                 m_vulkan_rhi->m_current_command_buffer, &renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
@@ -2071,10 +1830,12 @@ namespace Piccolo
 
         m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
 
-        if (m_enable_fxaa)
+        if (!m_render_graph.isPassCulled(_main_camera_subpass_fxaa))
+        {
             fxaa_pass.draw();
 
-        m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+            m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+        }
 
         VkClearAttachment clear_attachments[1];
         clear_attachments[0].aspectMask                  = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -2123,16 +1884,9 @@ namespace Piccolo
             renderpass_begin_info.renderArea.offset = {0, 0};
             renderpass_begin_info.renderArea.extent = m_vulkan_rhi->m_swapchain_extent;
 
-            VkClearValue clear_values[_main_camera_pass_attachment_count];
-            clear_values[_main_camera_pass_gbuffer_a].color          = {{0.0f, 0.0f, 0.0f, 0.0f}};
-            clear_values[_main_camera_pass_gbuffer_b].color          = {{0.0f, 0.0f, 0.0f, 0.0f}};
-            clear_values[_main_camera_pass_gbuffer_c].color          = {{0.0f, 0.0f, 0.0f, 0.0f}};
-            clear_values[_main_camera_pass_backup_buffer_odd].color  = {{0.0f, 0.0f, 0.0f, 1.0f}};
-            clear_values[_main_camera_pass_backup_buffer_even].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
-            clear_values[_main_camera_pass_depth].depthStencil       = {1.0f, 0};
-            clear_values[_main_camera_pass_swap_chain_image].color   = {{0.0f, 0.0f, 0.0f, 1.0f}};
-            renderpass_begin_info.clearValueCount                    = (sizeof(clear_values) / sizeof(clear_values[0]));
-            renderpass_begin_info.pClearValues                       = clear_values;
+            std::vector<VkClearValue> clear_values = m_render_graph.getClearValues();
+            renderpass_begin_info.clearValueCount  = static_cast<uint32_t>(clear_values.size());
+            renderpass_begin_info.pClearValues     = clear_values.data();
 
             m_vulkan_rhi->m_vk_cmd_begin_render_pass(
                 m_vulkan_rhi->m_current_command_buffer, &renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
@@ -2168,10 +1922,12 @@ namespace Piccolo
 
         m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
 
-        if (m_enable_fxaa)
+        if (!m_render_graph.isPassCulled(_main_camera_subpass_fxaa))
+        {
             fxaa_pass.draw();
 
-        m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+            m_vulkan_rhi->m_vk_cmd_next_subpass(m_vulkan_rhi->m_current_command_buffer, VK_SUBPASS_CONTENTS_INLINE);
+        }
 
         VkClearAttachment clear_attachments[1];
         clear_attachments[0].aspectMask                  = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -2206,11 +1962,17 @@ namespace Piccolo
 
     void MainCameraPass::drawMeshGbuffer()
     {
+        if (m_vulkan_rhi->isBindlessEnabled())
+        {
+            drawMeshBindless(_render_pipeline_type_mesh_gbuffer, "Mesh GBuffer");
+            return;
+        }
+
         struct MeshNode
         {
             const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
+            uint32_t         joint_matrix_offset {0};
+            bool             enable_vertex_blending {false};
         };
 
         std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> main_camera_mesh_drawcall_batch;
@@ -2225,8 +1987,8 @@ namespace Piccolo
             temp.model_matrix = node.model_matrix;
             if (node.enable_vertex_blending)
             {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
+                temp.joint_matrix_offset    = node.joint_matrix_offset;
+                temp.enable_vertex_blending = node.joint_count > 0;
             }
 
             mesh_nodes.push_back(temp);
@@ -2349,67 +2111,18 @@ namespace Piccolo
                                 perdrawcall_dynamic_offset));
                         for (uint32_t i = 0; i < current_instance_count; ++i)
                         {
-                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                            const MeshNode& mesh_node = mesh_nodes[drawcall_max_instance_count * drawcall_index + i];
+                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix = *mesh_node.model_matrix;
                             perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                              -1.0;
+                                mesh_node.enable_vertex_blending ? 1.0 : -1.0;
+                            perdrawcall_storage_buffer_object.mesh_instances[i].joint_matrix_offset =
+                                mesh_node.joint_matrix_offset;
                         }
 
-                        // per drawcall vertex blending storage buffer
-                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                        bool     least_one_enable_vertex_blending = true;
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                            {
-                                least_one_enable_vertex_blending = false;
-                                break;
-                            }
-                        }
-                        if (least_one_enable_vertex_blending)
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                            MeshPerdrawcallVertexBlendingStorageBufferObject&
-                                per_drawcall_vertex_blending_storage_buffer_object =
-                                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        per_drawcall_vertex_blending_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    for (uint32_t j = 0;
-                                         j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                         ++j)
-                                    {
-                                        per_drawcall_vertex_blending_storage_buffer_object
-                                            .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                .joint_matrices[j];
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset = 0;
-                        }
+                        // the joint palette of this frame was written once and is shared by every pass
+                        uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                            m_global_render_resource->_storage_buffer.getJointPaletteDynamicOffset(
+                                m_vulkan_rhi->m_current_frame_index);
 
                         // bind perdrawcall
                         uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
@@ -2488,11 +2201,17 @@ namespace Piccolo
 
     void MainCameraPass::drawMeshLighting()
     {
+        if (m_vulkan_rhi->isBindlessEnabled())
+        {
+            drawMeshBindless(_render_pipeline_type_mesh_lighting, "Model");
+            return;
+        }
+
         struct MeshNode
         {
             const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
+            uint32_t         joint_matrix_offset {0};
+            bool             enable_vertex_blending {false};
         };
 
         std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> main_camera_mesh_drawcall_batch;
@@ -2507,8 +2226,8 @@ namespace Piccolo
             temp.model_matrix = node.model_matrix;
             if (node.enable_vertex_blending)
             {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
+                temp.joint_matrix_offset    = node.joint_matrix_offset;
+                temp.enable_vertex_blending = node.joint_count > 0;
             }
 
             mesh_nodes.push_back(temp);
@@ -2631,67 +2350,18 @@ namespace Piccolo
                                 perdrawcall_dynamic_offset));
                         for (uint32_t i = 0; i < current_instance_count; ++i)
                         {
-                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                            const MeshNode& mesh_node = mesh_nodes[drawcall_max_instance_count * drawcall_index + i];
+                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix = *mesh_node.model_matrix;
                             perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                              -1.0;
+                                mesh_node.enable_vertex_blending ? 1.0 : -1.0;
+                            perdrawcall_storage_buffer_object.mesh_instances[i].joint_matrix_offset =
+                                mesh_node.joint_matrix_offset;
                         }
 
-                        // per drawcall vertex blending storage buffer
-                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                        bool     least_one_enable_vertex_blending = true;
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                            {
-                                least_one_enable_vertex_blending = false;
-                                break;
-                            }
-                        }
-                        if (least_one_enable_vertex_blending)
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                            MeshPerdrawcallVertexBlendingStorageBufferObject&
-                                per_drawcall_vertex_blending_storage_buffer_object =
-                                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        per_drawcall_vertex_blending_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    for (uint32_t j = 0;
-                                         j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                         ++j)
-                                    {
-                                        per_drawcall_vertex_blending_storage_buffer_object
-                                            .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                .joint_matrices[j];
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset = 0;
-                        }
+                        // the joint palette of this frame was written once and is shared by every pass
+                        uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                            m_global_render_resource->_storage_buffer.getJointPaletteDynamicOffset(
+                                m_vulkan_rhi->m_current_frame_index);
 
                         // bind perdrawcall
                         uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
@@ -2724,6 +2394,179 @@ namespace Piccolo
         }
     }
 
+    void MainCameraPass::drawMeshBindless(RenderPipeLineType pipeline_type, const char* label_name)
+    {
+        struct MeshNode
+        {
+            const Matrix4x4* model_matrix {nullptr};
+            uint32_t         joint_matrix_offset {0};
+            bool             enable_vertex_blending {false};
+            uint32_t         material_index {0};
+        };
+
+        // materials are fetched by index in the shaders, so instances are only batched by mesh
+        std::map<VulkanMesh*, std::vector<MeshNode>> main_camera_mesh_drawcall_batch;
+
+        // reorganize mesh
+        for (RenderMeshNode& node : *(m_visiable_nodes.p_main_camera_visible_mesh_nodes))
+        {
+            auto& mesh_nodes = main_camera_mesh_drawcall_batch[node.ref_mesh];
+
+            MeshNode temp;
+            temp.model_matrix   = node.model_matrix;
+            temp.material_index = node.ref_material->bindless_index;
+            if (node.enable_vertex_blending)
+            {
+                temp.joint_matrix_offset    = node.joint_matrix_offset;
+                temp.enable_vertex_blending = node.joint_count > 0;
+            }
+
+            mesh_nodes.push_back(temp);
+        }
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, label_name, {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
+        }
+
+        m_vulkan_rhi->m_vk_cmd_bind_pipeline(m_vulkan_rhi->m_current_command_buffer,
+                                             VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                             m_render_pipelines[pipeline_type].pipeline);
+        m_vulkan_rhi->m_vk_cmd_set_viewport(m_vulkan_rhi->m_current_command_buffer, 0, 1, &m_vulkan_rhi->m_viewport);
+        m_vulkan_rhi->m_vk_cmd_set_scissor(m_vulkan_rhi->m_current_command_buffer, 0, 1, &m_vulkan_rhi->m_scissor);
+
+        // perframe storage buffer
+        uint32_t perframe_dynamic_offset =
+            roundUp(m_global_render_resource->_storage_buffer
+                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
+                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
+
+        m_global_render_resource->_storage_buffer._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
+            perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
+        assert(m_global_render_resource->_storage_buffer
+                   ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
+               (m_global_render_resource->_storage_buffer
+                    ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
+                m_global_render_resource->_storage_buffer
+                    ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+
+        (*reinterpret_cast<MeshPerframeStorageBufferObject*>(
+            reinterpret_cast<uintptr_t>(
+                m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
+            perframe_dynamic_offset)) = m_mesh_perframe_storage_buffer_object;
+
+        // bind all materials and joint bindings once
+        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
+                                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                    m_render_pipelines[pipeline_type].layout,
+                                                    1,
+                                                    1,
+                                                    &m_global_render_resource->_bindless_resource._descriptor_set,
+                                                    0,
+                                                    NULL);
+
+        for (auto& pair1 : main_camera_mesh_drawcall_batch)
+        {
+            VulkanMesh& mesh       = (*pair1.first);
+            auto&       mesh_nodes = pair1.second;
+
+            uint32_t total_instance_count = static_cast<uint32_t>(mesh_nodes.size());
+            if (total_instance_count > 0)
+            {
+                VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
+                                             mesh.mesh_vertex_varying_enable_blending_buffer,
+                                             mesh.mesh_vertex_varying_buffer};
+                VkDeviceSize offsets[]        = {0, 0, 0};
+                m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(m_vulkan_rhi->m_current_command_buffer,
+                                                           0,
+                                                           (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+                                                           vertex_buffers,
+                                                           offsets);
+                m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
+                    m_vulkan_rhi->m_current_command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT16);
+
+                uint32_t drawcall_max_instance_count =
+                    (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
+                     sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances[0]));
+                uint32_t drawcall_count =
+                    roundUp(total_instance_count, drawcall_max_instance_count) / drawcall_max_instance_count;
+
+                for (uint32_t drawcall_index = 0; drawcall_index < drawcall_count; ++drawcall_index)
+                {
+                    uint32_t current_instance_count =
+                        ((total_instance_count - drawcall_max_instance_count * drawcall_index) <
+                         drawcall_max_instance_count) ?
+                            (total_instance_count - drawcall_max_instance_count * drawcall_index) :
+                            drawcall_max_instance_count;
+
+                    // per drawcall storage buffer
+                    uint32_t perdrawcall_dynamic_offset =
+                        roundUp(m_global_render_resource->_storage_buffer
+                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
+                                m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
+                    m_global_render_resource->_storage_buffer
+                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
+                        perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
+                    assert(m_global_render_resource->_storage_buffer
+                               ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
+                           (m_global_render_resource->_storage_buffer
+                                ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
+                            m_global_render_resource->_storage_buffer
+                                ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+
+                    MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
+                        (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
+                            reinterpret_cast<uintptr_t>(
+                                m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
+                            perdrawcall_dynamic_offset));
+                    for (uint32_t i = 0; i < current_instance_count; ++i)
+                    {
+                        const MeshNode& mesh_node = mesh_nodes[drawcall_max_instance_count * drawcall_index + i];
+                        perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix = *mesh_node.model_matrix;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
+                            mesh_node.enable_vertex_blending ? 1.0 : -1.0;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].joint_matrix_offset =
+                            mesh_node.joint_matrix_offset;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].material_index = mesh_node.material_index;
+                        perdrawcall_storage_buffer_object.mesh_instances[i].mesh_index     = mesh.bindless_index;
+                    }
+
+                    // the joint palette of this frame was written once and is shared by every pass
+                    uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                        m_global_render_resource->_storage_buffer.getJointPaletteDynamicOffset(
+                            m_vulkan_rhi->m_current_frame_index);
+
+                    // bind perdrawcall
+                    uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
+                                                   perdrawcall_dynamic_offset,
+                                                   per_drawcall_vertex_blending_dynamic_offset};
+                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
+                                                                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                                m_render_pipelines[pipeline_type].layout,
+                                                                0,
+                                                                1,
+                                                                &m_descriptor_infos[_mesh_global].descriptor_set,
+                                                                3,
+                                                                dynamic_offsets);
+
+                    m_vulkan_rhi->m_vk_cmd_draw_indexed(m_vulkan_rhi->m_current_command_buffer,
+                                                        mesh.mesh_index_count,
+                                                        current_instance_count,
+                                                        0,
+                                                        0,
+                                                        0);
+                }
+            }
+        }
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
+        }
+    }
+
     void MainCameraPass::drawSkybox()
     {
         uint32_t perframe_dynamic_offset =
@@ -2854,8 +2697,8 @@ namespace Piccolo
 
     void MainCameraPass::setupParticlePass()
     {
-        m_particle_pass->setDepthAndNormalImage(m_vulkan_rhi->m_depth_image,
-                                                m_framebuffer.attachments[_main_camera_pass_gbuffer_a].image);
+        m_particle_pass->setDepthAndNormalImageView(m_vulkan_rhi->m_depth_image_view,
+                                                    m_framebuffer.attachments[_main_camera_pass_gbuffer_a].view);
 
         m_particle_pass->setRenderPassHandle(m_framebuffer.render_pass);
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/render/render_graph.h"
 #include "runtime/function/render/render_pass.h"
 
 #include "runtime/function/render/passes/color_grading_pass.h"
@@ -28,6 +29,7 @@ namespace Piccolo
         // 5: axis layout
         // 6: billboard type particle layout
         // 7: gbuffer lighting
+        // 8: mesh bindless layout
         enum LayoutType : uint8_t
         {
             _per_mesh = 0,
@@ -37,6 +39,7 @@ namespace Piccolo
             _axis,
             _particle,
             _deferred_lighting,
+            _mesh_bindless,
             _layout_type_count
         };
 
@@ -75,8 +78,6 @@ namespace Piccolo
             ParticlePass& particle_pass,
             uint32_t          current_swapchain_image_index);
 
-        void copyNormalAndDepthImage();
-
         VkImageView m_point_light_shadow_color_image_view;
         VkImageView m_directional_light_shadow_color_image_view;
 
@@ -92,8 +93,11 @@ namespace Piccolo
 
         void setParticlePass(std::shared_ptr<ParticlePass> pass);
 
+        const RenderGraph& getRenderGraph() const { return m_render_graph; }
+
     private:
         void setupParticlePass();
+        void setupRenderGraph();
         void setupAttachments();
         void setupRenderPass();
         void setupDescriptorSetLayout();
@@ -111,6 +115,7 @@ namespace Piccolo
         void drawMeshGbuffer();
         void drawDeferredLighting();
         void drawMeshLighting();
+        void drawMeshBindless(RenderPipeLineType pipeline_type, const char* label_name);
         void drawSkybox();
         void drawAxis();
 
@@ -119,5 +124,6 @@ namespace Piccolo
     private:
         std::vector<VkFramebuffer> m_swapchain_framebuffers;
         std::shared_ptr<ParticlePass> m_particle_pass;
+        RenderGraph                   m_render_graph;
     };
 } // namespace Piccolo
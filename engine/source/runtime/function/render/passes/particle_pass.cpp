@@ -7,353 +7,38 @@
 #include "runtime/function/render/render_system.h"
 
 #include "core/base/macro.h"
+#include <algorithm>
+#include <cstddef>
 #include <fstream>
 
 #include "particle_emit_comp.h"
+#include "particle_initialize_comp.h"
 #include "particle_kickoff_comp.h"
 #include "particle_simulate_comp.h"
+#include "particle_sort_comp.h"
 #include <particlebillboard_frag.h>
 #include <particlebillboard_vert.h>
 
 namespace Piccolo
 {
-    void ParticleEmitterBufferBatch::freeUpBatch(VkDevice device)
-    {
-        vkFreeMemory(device, m_counter_host_memory, nullptr);
-        vkFreeMemory(device, m_position_host_memory, nullptr);
-        vkFreeMemory(device, m_position_device_memory, nullptr);
-        vkFreeMemory(device, m_counter_device_memory, nullptr);
-        vkFreeMemory(device, m_indirect_dispatch_argument_memory, nullptr);
-        vkFreeMemory(device, m_alive_list_memory, nullptr);
-        vkFreeMemory(device, m_alive_list_next_memory, nullptr);
-        vkFreeMemory(device, m_dead_list_memory, nullptr);
-        vkFreeMemory(device, m_particle_component_res_memory, nullptr);
-        vkFreeMemory(device, m_position_render_memory, nullptr);
-
-        vkDestroyBuffer(device, m_particle_storage_buffer, nullptr);
-        vkDestroyBuffer(device, m_position_render_buffer, nullptr);
-        vkDestroyBuffer(device, m_position_device_buffer, nullptr);
-        vkDestroyBuffer(device, m_position_host_buffer, nullptr);
-        vkDestroyBuffer(device, m_counter_device_buffer, nullptr);
-        vkDestroyBuffer(device, m_counter_host_buffer, nullptr);
-        vkDestroyBuffer(device, m_indirect_dispatch_argument_buffer, nullptr);
-        vkDestroyBuffer(device, m_alive_list_buffer, nullptr);
-        vkDestroyBuffer(device, m_alive_list_next_buffer, nullptr);
-        vkDestroyBuffer(device, m_dead_list_buffer, nullptr);
-        vkDestroyBuffer(device, m_particle_component_res_buffer, nullptr);
-    }
-
-    void ParticlePass::copyNormalAndDepthImage()
-    {
-        uint8_t index = (m_vulkan_rhi->m_current_frame_index + m_vulkan_rhi->s_max_frames_in_flight - 1) %
-                        m_vulkan_rhi->s_max_frames_in_flight;
-
-        if (VK_SUCCESS !=
-            vkWaitForFences(
-                m_vulkan_rhi->m_device, 1, &m_vulkan_rhi->m_is_frame_in_flight_fences[index], VK_TRUE, UINT64_MAX))
-            throw std::runtime_error("wait for fence");
-
-        VkCommandBufferBeginInfo command_buffer_begin_info {};
-        command_buffer_begin_info.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        command_buffer_begin_info.flags            = 0;
-        command_buffer_begin_info.pInheritanceInfo = nullptr;
-
-        VkResult res_begin_command_buffer =
-            m_vulkan_rhi->m_vk_begin_command_buffer(m_copy_command_buffer, &command_buffer_begin_info);
-        assert(VK_SUCCESS == res_begin_command_buffer);
-
-        if (m_vulkan_rhi->isDebugLabelEnabled())
-        {
-            VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
-                                               NULL,
-                                               "Copy Depth Image for Particle",
-                                               {1.0f, 1.0f, 1.0f, 1.0f}};
-            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_copy_command_buffer, &label_info);
-        }
-
-        // depth image
-        VkImageSubresourceRange subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1};
-        VkImageMemoryBarrier    imagememorybarrier {};
-        imagememorybarrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        imagememorybarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        imagememorybarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        imagememorybarrier.subresourceRange    = subresourceRange;
-        {
-            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
-            imagememorybarrier.newLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            imagememorybarrier.srcAccessMask = 0;
-            imagememorybarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            imagememorybarrier.image         = m_dst_depth_image;
-
-            vkCmdPipelineBarrier(m_copy_command_buffer,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &imagememorybarrier);
-
-            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
-            imagememorybarrier.newLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-            imagememorybarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-            imagememorybarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-            imagememorybarrier.image         = m_src_depth_image;
-
-            vkCmdPipelineBarrier(m_copy_command_buffer,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &imagememorybarrier);
-
-            VkImageCopy imagecopyRegion    = {};
-            imagecopyRegion.srcSubresource = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, 1};
-            imagecopyRegion.srcOffset      = {0, 0, 0};
-            imagecopyRegion.dstSubresource = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 0, 1};
-            imagecopyRegion.dstOffset      = {0, 0, 0};
-            imagecopyRegion.extent         = {
-                        m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height, 1};
-
-            vkCmdCopyImage(m_copy_command_buffer,
-                           m_src_depth_image,
-                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                           m_dst_depth_image,
-                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                           1,
-                           &imagecopyRegion);
-
-            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-            imagememorybarrier.newLayout     = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-            imagememorybarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            imagememorybarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
-
-            vkCmdPipelineBarrier(m_copy_command_buffer,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &imagememorybarrier);
-
-            imagememorybarrier.image         = m_dst_depth_image;
-            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            imagememorybarrier.newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imagememorybarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            imagememorybarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-            vkCmdPipelineBarrier(m_copy_command_buffer,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &imagememorybarrier);
-        }
-
-        if (m_vulkan_rhi->isDebugLabelEnabled())
-        {
-            // end depth image copy label
-            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_copy_command_buffer);
-        }
-
-        if (m_vulkan_rhi->isDebugLabelEnabled())
-        {
-            VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
-                                               NULL,
-                                               "Copy Normal Image for Particle",
-                                               {1.0f, 1.0f, 1.0f, 1.0f}};
-            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_copy_command_buffer, &label_info);
-        }
-
-        // color image
-        subresourceRange                    = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-        imagememorybarrier.subresourceRange = subresourceRange;
-        {
-            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
-            imagememorybarrier.newLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            imagememorybarrier.srcAccessMask = 0;
-            imagememorybarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            imagememorybarrier.image         = m_dst_normal_image;
-
-            vkCmdPipelineBarrier(m_copy_command_buffer,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &imagememorybarrier);
-
-            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_UNDEFINED;
-            imagememorybarrier.newLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-            imagememorybarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            imagememorybarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-            imagememorybarrier.image         = m_src_normal_image;
-
-            vkCmdPipelineBarrier(m_copy_command_buffer,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &imagememorybarrier);
-
-            VkImageCopy imagecopyRegion    = {};
-            imagecopyRegion.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
-            imagecopyRegion.srcOffset      = {0, 0, 0};
-            imagecopyRegion.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
-            imagecopyRegion.dstOffset      = {0, 0, 0};
-            imagecopyRegion.extent         = {
-                        m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height, 1};
-
-            vkCmdCopyImage(m_copy_command_buffer,
-                           m_src_normal_image,
-                           VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                           m_dst_normal_image,
-                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                           1,
-                           &imagecopyRegion);
-
-            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-            imagememorybarrier.newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            imagememorybarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            imagememorybarrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
-
-            vkCmdPipelineBarrier(m_copy_command_buffer,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &imagememorybarrier);
-
-            imagememorybarrier.image         = m_dst_normal_image;
-            imagememorybarrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            imagememorybarrier.newLayout     = VK_IMAGE_LAYOUT_GENERAL;
-            imagememorybarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            imagememorybarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-            vkCmdPipelineBarrier(m_copy_command_buffer,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &imagememorybarrier);
-        }
-
-        if (m_vulkan_rhi->isDebugLabelEnabled())
-        {
-            // end normal image copy label
-            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_copy_command_buffer);
-        }
-
-        VkResult res_end_command_buffer = m_vulkan_rhi->m_vk_end_command_buffer(m_copy_command_buffer);
-        assert(VK_SUCCESS == res_end_command_buffer);
-
-        VkResult res_reset_fences = m_vulkan_rhi->m_vk_reset_fences(
-            m_vulkan_rhi->m_device, 1, &m_vulkan_rhi->m_is_frame_in_flight_fences[index]);
-        assert(VK_SUCCESS == res_reset_fences);
-
-        VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        VkSubmitInfo         submit_info   = {};
-        submit_info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.waitSemaphoreCount     = 1;
-        submit_info.pWaitSemaphores        = &m_vulkan_rhi->m_image_available_for_texturescopy_semaphores[index];
-        submit_info.pWaitDstStageMask      = wait_stages;
-        submit_info.commandBufferCount     = 1;
-        submit_info.pCommandBuffers        = &m_copy_command_buffer;
-        submit_info.signalSemaphoreCount   = 0;
-        submit_info.pSignalSemaphores      = nullptr;
-        VkResult res_queue_submit          = vkQueueSubmit(
-            m_vulkan_rhi->m_graphics_queue, 1, &submit_info, m_vulkan_rhi->m_is_frame_in_flight_fences[index]);
-        assert(VK_SUCCESS == res_queue_submit);
-
-        vkQueueWaitIdle(m_vulkan_rhi->m_graphics_queue);
-    }
-
     void ParticlePass::updateAfterFramebufferRecreate()
     {
-        vkDestroyImage(m_vulkan_rhi->m_device, m_dst_depth_image, nullptr);
-        vkFreeMemory(m_vulkan_rhi->m_device, m_dst_depth_image_memory, nullptr);
-
-        VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
-                                m_vulkan_rhi->m_device,
-                                m_vulkan_rhi->m_swapchain_extent.width,
-                                m_vulkan_rhi->m_swapchain_extent.height,
-                                m_vulkan_rhi->m_depth_image_format,
-                                VK_IMAGE_TILING_OPTIMAL,
-                                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                m_dst_depth_image,
-                                m_dst_depth_image_memory,
-                                0,
-                                1,
-                                1);
-
-        vkDestroyImage(m_vulkan_rhi->m_device, m_dst_normal_image, nullptr);
-        vkFreeMemory(m_vulkan_rhi->m_device, m_dst_normal_image_memory, nullptr);
-
-        VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
-                                m_vulkan_rhi->m_device,
-                                m_vulkan_rhi->m_swapchain_extent.width,
-                                m_vulkan_rhi->m_swapchain_extent.height,
-                                VK_FORMAT_R8G8B8A8_UNORM,
-                                VK_IMAGE_TILING_OPTIMAL,
-                                VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                m_dst_normal_image,
-                                m_dst_normal_image_memory,
-                                0,
-                                1,
-                                1);
-
-        m_src_depth_image_view  = VulkanUtil::createImageView(m_vulkan_rhi->m_device,
-                                                             m_dst_depth_image,
-                                                             m_vulkan_rhi->m_depth_image_format,
-                                                             VK_IMAGE_ASPECT_DEPTH_BIT,
-                                                             VK_IMAGE_VIEW_TYPE_2D,
-                                                             1,
-                                                             1);
-        m_src_normal_image_view = VulkanUtil::createImageView(m_vulkan_rhi->m_device,
-                                                              m_dst_normal_image,
-                                                              VK_FORMAT_R8G8B8A8_UNORM,
-                                                              VK_IMAGE_ASPECT_COLOR_BIT,
-                                                              VK_IMAGE_VIEW_TYPE_2D,
-                                                              1,
-                                                              1);
+        // the new attachments are only written by the next frame, so this frame's simulation is skipped
+        m_scene_images_rendered = false;
 
         updateDescriptorSet();
     }
 
     void ParticlePass::draw()
     {
+        const std::vector<RenderParticleEmitterNode>& nodes = *m_visiable_nodes.p_particle_emitter_nodes;
         for (int i = 0; i < m_emitter_count; ++i)
         {
+            if (!nodes[i].visible)
+            {
+                continue;
+            }
+
             if (m_vulkan_rhi->isDebugLabelEnabled())
             {
                 VkDebugUtilsLabelEXT label_info = {
@@ -375,7 +60,11 @@ namespace Piccolo
                                                         0,
                                                         nullptr);
 
-            vkCmdDraw(m_render_command_buffer, 4, m_emitter_buffer_batches[i].m_num_particle, 0, 0);
+            vkCmdDrawIndirect(m_render_command_buffer,
+                              m_particle_pool_buffer,
+                              m_emitter_buffer_batches[i].m_indirect_draw_argument_offset,
+                              1,
+                              sizeof(VkDrawIndirectCommand));
 
             if (m_vulkan_rhi->isDebugLabelEnabled())
             {
@@ -414,49 +103,6 @@ namespace Piccolo
                                           m_piccolo_logo_texture_resource->m_pixels,
                                           m_piccolo_logo_texture_resource->m_format);
         }
-
-        VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
-                                m_vulkan_rhi->m_device,
-                                m_vulkan_rhi->m_swapchain_extent.width,
-                                m_vulkan_rhi->m_swapchain_extent.height,
-                                m_vulkan_rhi->m_depth_image_format,
-                                VK_IMAGE_TILING_OPTIMAL,
-                                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                m_dst_depth_image,
-                                m_dst_depth_image_memory,
-                                0,
-                                1,
-                                1);
-
-        VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
-                                m_vulkan_rhi->m_device,
-                                m_vulkan_rhi->m_swapchain_extent.width,
-                                m_vulkan_rhi->m_swapchain_extent.height,
-                                VK_FORMAT_R8G8B8A8_UNORM,
-                                VK_IMAGE_TILING_OPTIMAL,
-                                VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                m_dst_normal_image,
-                                m_dst_normal_image_memory,
-                                0,
-                                1,
-                                1);
-
-        m_src_depth_image_view  = VulkanUtil::createImageView(m_vulkan_rhi->m_device,
-                                                             m_dst_depth_image,
-                                                             m_vulkan_rhi->m_depth_image_format,
-                                                             VK_IMAGE_ASPECT_DEPTH_BIT,
-                                                             VK_IMAGE_VIEW_TYPE_2D,
-                                                             1,
-                                                             1);
-        m_src_normal_image_view = VulkanUtil::createImageView(m_vulkan_rhi->m_device,
-                                                              m_dst_normal_image,
-                                                              VK_FORMAT_R8G8B8A8_UNORM,
-                                                              VK_IMAGE_ASPECT_COLOR_BIT,
-                                                              VK_IMAGE_VIEW_TYPE_2D,
-                                                              1,
-                                                              1);
     }
 
     void ParticlePass::setupParticleDescriptorSet()
@@ -483,10 +129,11 @@ namespace Piccolo
             particlebillboard_perframe_storage_buffer_info.buffer                 = m_particle_billboard_uniform_buffer;
 
             VkDescriptorBufferInfo particlebillboard_perdrawcall_storage_buffer_info = {};
-            particlebillboard_perdrawcall_storage_buffer_info.offset                 = 0;
-            particlebillboard_perdrawcall_storage_buffer_info.range                  = VK_WHOLE_SIZE;
-            particlebillboard_perdrawcall_storage_buffer_info.buffer =
-                m_emitter_buffer_batches[eid].m_position_render_buffer;
+            particlebillboard_perdrawcall_storage_buffer_info.offset =
+                m_emitter_buffer_batches[eid].m_position_render_offset;
+            particlebillboard_perdrawcall_storage_buffer_info.range =
+                m_emitter_buffer_batches[eid].m_max_particles * sizeof(Particle);
+            particlebillboard_perdrawcall_storage_buffer_info.buffer = m_particle_pool_buffer;
 
             VkWriteDescriptorSet particlebillboard_descriptor_writes_info[3];
 
@@ -550,316 +197,218 @@ namespace Piccolo
 
     void ParticlePass::setEmitterCount(int count)
     {
-        for (int i = 0; i < m_emitter_buffer_batches.size(); ++i)
-        {
-            m_emitter_buffer_batches[i].freeUpBatch(m_vulkan_rhi->m_device);
-        }
+        // the previous emitters' ranges are reused, so nothing may still read them
+        vkDeviceWaitIdle(m_vulkan_rhi->m_device);
 
         m_emitter_count = count;
-        m_emitter_buffer_batches.resize(m_emitter_count);
+        m_emitter_buffer_batches.assign(m_emitter_count, ParticleEmitterBufferBatch {});
+        m_particle_pool_used = 0;
     }
 
-    void ParticlePass::createEmitter(int id, const ParticleEmitterDesc& desc)
+    void ParticlePass::createEmitter(int id, const ParticleEmitterDesc& desc, uint32_t max_particle_count)
     {
-        const VkDeviceSize counterBufferSize = sizeof(ParticleCounter);
-        ParticleCounter    counter;
-        counter.alive_count           = m_emitter_buffer_batches[id].m_num_particle;
-        counter.dead_count            = s_max_particles - m_emitter_buffer_batches[id].m_num_particle;
-        counter.emit_count            = 0;
-        counter.alive_count_after_sim = m_emitter_buffer_batches[id].m_num_particle;
+        ParticleEmitterBufferBatch& batch = m_emitter_buffer_batches[id];
+        batch.m_emitter_desc              = desc;
+        batch.m_max_particles             = max_particle_count;
+
+        // only ranges are reserved here, the pool is (re)allocated and initialized once in initializeEmitters
+        const VkDeviceSize particleBufferSize = max_particle_count * sizeof(Particle);
+        const VkDeviceSize listBufferSize     = max_particle_count * sizeof(uvec4);
+
+        batch.m_counter_offset                    = allocateFromParticlePool(sizeof(ParticleCounter));
+        batch.m_indirect_dispatch_argument_offset = allocateFromParticlePool(sizeof(IndirectArgumemt));
+        batch.m_indirect_draw_argument_offset     = allocateFromParticlePool(sizeof(VkDrawIndirectCommand));
+        batch.m_position_device_offset            = allocateFromParticlePool(particleBufferSize);
+        batch.m_position_render_offset            = allocateFromParticlePool(particleBufferSize);
+        batch.m_alive_list_offset                 = allocateFromParticlePool(listBufferSize);
+        batch.m_alive_list_next_offset            = allocateFromParticlePool(listBufferSize);
+        batch.m_dead_list_offset                  = allocateFromParticlePool(listBufferSize);
+
+        if (m_particle_manager->getGlobalParticleRes().m_enable_depth_sort)
+        {
+            // the bitonic sort runs over whole groups and a power of two of keys
+            batch.m_sort_key_count = s_sort_group_size;
+            while (batch.m_sort_key_count < max_particle_count)
+            {
+                batch.m_sort_key_count <<= 1;
+            }
+            batch.m_sort_key_offset = allocateFromParticlePool(batch.m_sort_key_count * sizeof(SortKey));
+        }
+
+        const VkDeviceSize emitterDescStride =
+            (sizeof(ParticleEmitterDesc) + m_storage_buffer_alignment - 1) & ~(m_storage_buffer_alignment - 1);
+        batch.m_emitter_desc_offset = id * emitterDescStride;
 
         if constexpr (s_verbose_particle_alive_info)
         {
-            LOG_INFO("Emitter {} info:", id);
-            LOG_INFO("Dead {}, Alive {}, After sim {}, Emit {}",
-                     counter.dead_count,
-                     counter.alive_count,
-                     counter.alive_count_after_sim,
-                     counter.emit_count);
+            LOG_INFO("Emitter {} budget {} particles", id, max_particle_count);
         }
+    }
+
+    VkDeviceSize ParticlePass::allocateFromParticlePool(VkDeviceSize size)
+    {
+        // the alignment is a power of two
+        VkDeviceSize offset =
+            (m_particle_pool_used + m_storage_buffer_alignment - 1) & ~(m_storage_buffer_alignment - 1);
+        m_particle_pool_used = offset + size;
+        return offset;
+    }
 
+    void ParticlePass::createParticlePool()
+    {
+        const VkDeviceSize emitterDescPoolSize =
+            m_emitter_count > 0 ? m_emitter_buffer_batches.back().m_emitter_desc_offset + sizeof(ParticleEmitterDesc) :
+                                  0;
+
+        // grow on demand, shrink when most of the pool is unused
+        bool fits = m_particle_pool_used <= m_particle_pool_size && m_particle_pool_used * 2 >= m_particle_pool_size &&
+                    emitterDescPoolSize <= m_emitter_desc_pool_size;
+        if (fits && m_particle_pool_buffer != VK_NULL_HANDLE)
         {
-            const VkDeviceSize      indirectArgumentSize = sizeof(IndirectArgumemt);
-            struct IndirectArgumemt indirectargument     = {};
-            indirectargument.alive_flap_bit              = 1;
-            VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
-                                                  m_vulkan_rhi->m_physical_device,
-                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                                                      VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
-                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                                  &m_emitter_buffer_batches[id].m_indirect_dispatch_argument_buffer,
-                                                  &m_emitter_buffer_batches[id].m_indirect_dispatch_argument_memory,
-                                                  indirectArgumentSize,
-                                                  &indirectargument,
-                                                  indirectArgumentSize);
-
-            const VkDeviceSize aliveListSize = 4 * sizeof(uint32_t) * s_max_particles;
-            std::vector<int>   aliveindices(s_max_particles * 4, 0);
-            for (int i = 0; i < s_max_particles; ++i)
-                aliveindices[i * 4] = i;
-            VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
-                                                  m_vulkan_rhi->m_physical_device,
-                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                                  &m_emitter_buffer_batches[id].m_alive_list_buffer,
-                                                  &m_emitter_buffer_batches[id].m_alive_list_memory,
-                                                  aliveListSize,
-                                                  aliveindices.data(),
-                                                  aliveListSize);
-
-            VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
-                                                  m_vulkan_rhi->m_physical_device,
-                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                                  &m_emitter_buffer_batches[id].m_alive_list_next_buffer,
-                                                  &m_emitter_buffer_batches[id].m_alive_list_next_memory,
-                                                  aliveListSize);
-
-            const VkDeviceSize   deadListSize = 4 * sizeof(uint32_t) * s_max_particles;
-            std::vector<int32_t> deadindices(s_max_particles * 4, 0);
-            for (int32_t i = 0; i < s_max_particles; ++i)
-                deadindices[i * 4] = s_max_particles - 1 - i;
-            VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
-                                                  m_vulkan_rhi->m_physical_device,
-                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                                  &m_emitter_buffer_batches[id].m_dead_list_buffer,
-                                                  &m_emitter_buffer_batches[id].m_dead_list_memory,
-                                                  deadListSize,
-                                                  deadindices.data(),
-                                                  deadListSize);
+            return;
         }
 
-        VkFence         fence;
-        ParticleCounter counterNext {};
+        destroyParticlePool();
+        if (m_emitter_count == 0)
         {
-
-            VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
-                                                  m_vulkan_rhi->m_physical_device,
-                                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                                  &m_emitter_buffer_batches[id].m_counter_host_buffer,
-                                                  &m_emitter_buffer_batches[id].m_counter_host_memory,
-                                                  counterBufferSize,
-                                                  &counter,
-                                                  sizeof(counter));
-
-            // Flush writes to host visible buffer
-            void* mapped;
-
-            vkMapMemory(m_vulkan_rhi->m_device,
-                        m_emitter_buffer_batches[id].m_counter_host_memory,
-                        0,
-                        VK_WHOLE_SIZE,
-                        0,
-                        &mapped);
-            VkMappedMemoryRange mappedRange {};
-            mappedRange.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-            mappedRange.memory = m_emitter_buffer_batches[id].m_counter_host_memory;
-            mappedRange.offset = 0;
-            mappedRange.size   = VK_WHOLE_SIZE;
-            vkFlushMappedMemoryRanges(m_vulkan_rhi->m_device, 1, &mappedRange);
-            vkUnmapMemory(m_vulkan_rhi->m_device, m_emitter_buffer_batches[id].m_counter_host_memory);
-
-            VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
-                                                  m_vulkan_rhi->m_physical_device,
-                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
-                                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                                  &m_emitter_buffer_batches[id].m_counter_device_buffer,
-                                                  &m_emitter_buffer_batches[id].m_counter_device_memory,
-                                                  counterBufferSize);
-
-            // Copy to staging buffer
-            VkCommandBufferAllocateInfo cmdBufAllocateInfo {};
-            cmdBufAllocateInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-            cmdBufAllocateInfo.commandPool        = m_vulkan_rhi->m_command_pool;
-            cmdBufAllocateInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            cmdBufAllocateInfo.commandBufferCount = 1;
-            VkCommandBuffer copyCmd;
-            if (VK_SUCCESS != vkAllocateCommandBuffers(m_vulkan_rhi->m_device, &cmdBufAllocateInfo, &copyCmd))
-            {
-                throw std::runtime_error("alloc command buffer");
-            }
-
-            VkCommandBufferBeginInfo cmdBufInfo {};
-            cmdBufInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            if (VK_SUCCESS != vkBeginCommandBuffer(copyCmd, &cmdBufInfo))
-            {
-                throw std::runtime_error("begin command buffer");
-            }
-
-            VkBufferCopy copyRegion = {};
-            copyRegion.size         = counterBufferSize;
-            vkCmdCopyBuffer(copyCmd,
-                            m_emitter_buffer_batches[id].m_counter_host_buffer,
-                            m_emitter_buffer_batches[id].m_counter_device_buffer,
-                            1,
-                            &copyRegion);
-            if (VK_SUCCESS != vkEndCommandBuffer(copyCmd))
-            {
-                throw std::runtime_error("buffer copy");
-            }
-
-            VkSubmitInfo submitInfo {};
-            submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers    = &copyCmd;
-            VkFenceCreateInfo fenceInfo {};
-            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-            fenceInfo.flags = 0;
-            if (VK_SUCCESS != vkCreateFence(m_vulkan_rhi->m_device, &fenceInfo, nullptr, &fence))
-            {
-                throw std::runtime_error("create fence");
-            }
-
-            // Submit to the queue
-            if (VK_SUCCESS != vkQueueSubmit(m_vulkan_rhi->m_compute_queue, 1, &submitInfo, fence))
-            {
-                throw std::runtime_error("queue submit");
-            }
-            if (VK_SUCCESS != vkWaitForFences(m_vulkan_rhi->m_device, 1, &fence, VK_TRUE, UINT64_MAX))
-            {
-                throw std::runtime_error("wait fence submit");
-            }
-
-            vkDestroyFence(m_vulkan_rhi->m_device, fence, nullptr);
-            vkFreeCommandBuffers(m_vulkan_rhi->m_device, m_vulkan_rhi->m_command_pool, 1, &copyCmd);
+            return;
         }
 
-        const VkDeviceSize staggingBuferSize        = s_max_particles * sizeof(Particle);
-        m_emitter_buffer_batches[id].m_emitter_desc = desc;
+        VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
+                                 m_vulkan_rhi->m_device,
+                                 m_particle_pool_used,
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                                     VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                 m_particle_pool_buffer,
+                                 m_particle_pool_memory);
+        m_particle_pool_size = m_particle_pool_used;
 
-        // fill in data
+        VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
+                                 m_vulkan_rhi->m_device,
+                                 emitterDescPoolSize,
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 m_emitter_desc_pool_buffer,
+                                 m_emitter_desc_pool_memory);
+        m_emitter_desc_pool_size = emitterDescPoolSize;
+        if (VK_SUCCESS != vkMapMemory(m_vulkan_rhi->m_device,
+                                      m_emitter_desc_pool_memory,
+                                      0,
+                                      VK_WHOLE_SIZE,
+                                      0,
+                                      &m_emitter_desc_pool_mapped))
         {
-            VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
-                                                  m_vulkan_rhi->m_physical_device,
-                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                                                      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                                  &m_emitter_buffer_batches[id].m_particle_component_res_buffer,
-                                                  &m_emitter_buffer_batches[id].m_particle_component_res_memory,
-                                                  sizeof(ParticleEmitterDesc),
-                                                  &m_emitter_buffer_batches[id].m_emitter_desc,
-                                                  sizeof(ParticleEmitterDesc));
-
-            if (VK_SUCCESS != vkMapMemory(m_vulkan_rhi->m_device,
-                                          m_emitter_buffer_batches[id].m_particle_component_res_memory,
-                                          0,
-                                          VK_WHOLE_SIZE,
-                                          0,
-                                          &m_emitter_buffer_batches[id].m_emitter_desc_mapped))
-            {
-                throw std::runtime_error("map emitter component res buffer");
-            }
+            throw std::runtime_error("map emitter component res buffer");
+        }
 
-            VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
-                                                  m_vulkan_rhi->m_physical_device,
-                                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                                  &m_emitter_buffer_batches[id].m_position_host_buffer,
-                                                  &m_emitter_buffer_batches[id].m_position_host_memory,
-                                                  staggingBuferSize);
+        VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
+                                 m_vulkan_rhi->m_device,
+                                 m_emitter_count * sizeof(ParticleCounter),
+                                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                 m_counter_host_buffer,
+                                 m_counter_host_memory);
+    }
 
-            // Flush writes to host visible buffer
-            void* mapped;
-            vkMapMemory(m_vulkan_rhi->m_device,
-                        m_emitter_buffer_batches[id].m_position_host_memory,
-                        0,
-                        VK_WHOLE_SIZE,
-                        0,
-                        &mapped);
-            VkMappedMemoryRange mappedRange {};
-            mappedRange.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-            mappedRange.memory = m_emitter_buffer_batches[id].m_position_host_memory;
-            mappedRange.offset = 0;
-            mappedRange.size   = VK_WHOLE_SIZE;
-            vkFlushMappedMemoryRanges(m_vulkan_rhi->m_device, 1, &mappedRange);
-            vkUnmapMemory(m_vulkan_rhi->m_device, m_emitter_buffer_batches[id].m_position_host_memory);
-
-            VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
-                                                  m_vulkan_rhi->m_physical_device,
-                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
-                                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                                  &m_emitter_buffer_batches[id].m_position_device_buffer,
-                                                  &m_emitter_buffer_batches[id].m_position_device_memory,
-                                                  staggingBuferSize);
-
-            VulkanUtil::createBufferAndInitialize(m_vulkan_rhi->m_device,
-                                                  m_vulkan_rhi->m_physical_device,
-                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                                                      VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
-                                                      VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                                  &m_emitter_buffer_batches[id].m_position_render_buffer,
-                                                  &m_emitter_buffer_batches[id].m_position_render_memory,
-                                                  staggingBuferSize);
-
-            // Copy to staging buffer
-            VkCommandBufferAllocateInfo cmdBufAllocateInfo {};
-            cmdBufAllocateInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-            cmdBufAllocateInfo.commandPool        = m_vulkan_rhi->m_command_pool;
-            cmdBufAllocateInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            cmdBufAllocateInfo.commandBufferCount = 1;
-            VkCommandBuffer copyCmd;
-            if (VK_SUCCESS != vkAllocateCommandBuffers(m_vulkan_rhi->m_device, &cmdBufAllocateInfo, &copyCmd))
-            {
-                throw std::runtime_error("alloc command buffer");
-            }
-            VkCommandBufferBeginInfo cmdBufInfo {};
-            cmdBufInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            if (VK_SUCCESS != vkBeginCommandBuffer(copyCmd, &cmdBufInfo))
-            {
-                throw std::runtime_error("begin command buffer");
-            }
+    void ParticlePass::destroyParticlePool()
+    {
+        if (m_particle_pool_buffer == VK_NULL_HANDLE)
+        {
+            return;
+        }
 
-            VkBufferCopy copyRegion = {};
-            copyRegion.size         = staggingBuferSize;
-            vkCmdCopyBuffer(copyCmd,
-                            m_emitter_buffer_batches[id].m_position_host_buffer,
-                            m_emitter_buffer_batches[id].m_position_device_buffer,
-                            1,
-                            &copyRegion);
-            if (VK_SUCCESS != vkEndCommandBuffer(copyCmd))
-            {
-                throw std::runtime_error("buffer copy");
-            }
+        vkUnmapMemory(m_vulkan_rhi->m_device, m_emitter_desc_pool_memory);
+
+        vkDestroyBuffer(m_vulkan_rhi->m_device, m_particle_pool_buffer, nullptr);
+        vkFreeMemory(m_vulkan_rhi->m_device, m_particle_pool_memory, nullptr);
+        vkDestroyBuffer(m_vulkan_rhi->m_device, m_emitter_desc_pool_buffer, nullptr);
+        vkFreeMemory(m_vulkan_rhi->m_device, m_emitter_desc_pool_memory, nullptr);
+        vkDestroyBuffer(m_vulkan_rhi->m_device, m_counter_host_buffer, nullptr);
+        vkFreeMemory(m_vulkan_rhi->m_device, m_counter_host_memory, nullptr);
+
+        m_particle_pool_buffer     = VK_NULL_HANDLE;
+        m_emitter_desc_pool_buffer = VK_NULL_HANDLE;
+        m_counter_host_buffer      = VK_NULL_HANDLE;
+        m_emitter_desc_pool_mapped = nullptr;
+        m_particle_pool_size       = 0;
+        m_emitter_desc_pool_size   = 0;
+    }
 
-            VkSubmitInfo submitInfo {};
-            submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            submitInfo.commandBufferCount = 1;
-            submitInfo.pCommandBuffers    = &copyCmd;
-            VkFenceCreateInfo fenceInfo {};
-            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-            fenceInfo.flags = 0;
-            if (VK_SUCCESS != vkCreateFence(m_vulkan_rhi->m_device, &fenceInfo, nullptr, &fence))
-            {
-                throw std::runtime_error("create fence");
-            }
+    void ParticlePass::initializeEmitterBuffers()
+    {
+        VkCommandBuffer command_buffer = m_vulkan_rhi->beginSingleTimeCommands();
 
-            // Submit to the queue
-            if (VK_SUCCESS != vkQueueSubmit(m_vulkan_rhi->m_compute_queue, 1, &submitInfo, fence))
-            {
-                throw std::runtime_error("queue submit");
-            }
-            if (VK_SUCCESS != vkWaitForFences(m_vulkan_rhi->m_device, 1, &fence, VK_TRUE, UINT64_MAX))
-            {
-                throw std::runtime_error("wait fence submit");
-            }
+        // the counters and arguments are tiny and written inline, the dead lists are filled by a compute shader
+        for (ParticleEmitterBufferBatch& batch : m_emitter_buffer_batches)
+        {
+            ParticleCounter counter {};
+            counter.dead_count = static_cast<int>(batch.m_max_particles);
+            vkCmdUpdateBuffer(
+                command_buffer, m_particle_pool_buffer, batch.m_counter_offset, sizeof(ParticleCounter), &counter);
+
+            IndirectArgumemt indirectargument {};
+            indirectargument.alive_flap_bit = 1;
+            vkCmdUpdateBuffer(command_buffer,
+                              m_particle_pool_buffer,
+                              batch.m_indirect_dispatch_argument_offset,
+                              sizeof(IndirectArgumemt),
+                              &indirectargument);
+
+            VkDrawIndirectCommand drawargument {};
+            drawargument.vertexCount = 4;
+            vkCmdUpdateBuffer(command_buffer,
+                              m_particle_pool_buffer,
+                              batch.m_indirect_draw_argument_offset,
+                              sizeof(VkDrawIndirectCommand),
+                              &drawargument);
+        }
 
-            vkDestroyFence(m_vulkan_rhi->m_device, fence, nullptr);
-            vkFreeCommandBuffers(m_vulkan_rhi->m_device, m_vulkan_rhi->m_command_pool, 1, &copyCmd);
+        VkMemoryBarrier memoryBarrier {};
+        memoryBarrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0,
+                             1,
+                             &memoryBarrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
+
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_initialize_pipeline);
+        for (int i = 0; i < m_emitter_count; ++i)
+        {
+            bindComputeDescriptorSets(command_buffer, i);
+            vkCmdDispatch(command_buffer, (m_emitter_buffer_batches[i].m_max_particles + 255) / 256, 1, 1);
         }
+
+        m_vulkan_rhi->endSingleTimeCommands(command_buffer);
     }
 
     void ParticlePass::initializeEmitters()
     {
+        createParticlePool();
+        if (m_emitter_count == 0)
+        {
+            return;
+        }
+
+        for (ParticleEmitterBufferBatch& batch : m_emitter_buffer_batches)
+        {
+            batch.m_emitter_desc_mapped =
+                static_cast<uint8_t*>(m_emitter_desc_pool_mapped) + batch.m_emitter_desc_offset;
+            memcpy(batch.m_emitter_desc_mapped, &batch.m_emitter_desc, sizeof(ParticleEmitterDesc));
+        }
+
         allocateDescriptorSet();
         updateDescriptorSet();
         setupParticleDescriptorSet();
+
+        initializeEmitterBuffers();
     }
 
     void ParticlePass::setupParticlePass()
@@ -877,14 +426,22 @@ namespace Piccolo
         if (VK_SUCCESS !=
             vkAllocateCommandBuffers(m_vulkan_rhi->m_device, &cmdBufAllocateInfo, &m_compute_command_buffer))
             throw std::runtime_error("alloc compute command buffer");
-        if (VK_SUCCESS != vkAllocateCommandBuffers(m_vulkan_rhi->m_device, &cmdBufAllocateInfo, &m_copy_command_buffer))
-            throw std::runtime_error("alloc copyt command buffer");
 
         VkFenceCreateInfo fenceCreateInfo {};
         fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceCreateInfo.flags = 0;
+        fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
         if (VK_SUCCESS != vkCreateFence(m_vulkan_rhi->m_device, &fenceCreateInfo, nullptr, &m_fence))
             throw std::runtime_error("create fence");
+
+        VkPhysicalDeviceProperties physicalDeviceProperties;
+        vkGetPhysicalDeviceProperties(m_vulkan_rhi->m_physical_device, &physicalDeviceProperties);
+        m_storage_buffer_alignment = physicalDeviceProperties.limits.minStorageBufferOffsetAlignment;
+
+        VkSemaphoreCreateInfo semaphoreCreateInfo {};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        if (VK_SUCCESS !=
+            vkCreateSemaphore(m_vulkan_rhi->m_device, &semaphoreCreateInfo, nullptr, &m_compute_finished_semaphore))
+            throw std::runtime_error("create semaphore");
     }
 
     void ParticlePass::initialize(const RenderPassInitInfo* init_info)
@@ -901,7 +458,7 @@ namespace Piccolo
 
         // compute descriptor sets
         {
-            VkDescriptorSetLayoutBinding particle_layout_bindings[11] = {};
+            VkDescriptorSetLayoutBinding particle_layout_bindings[12] = {};
             {
                 VkDescriptorSetLayoutBinding& uniform_layout_bingding = particle_layout_bindings[0];
                 uniform_layout_bingding.binding                       = 0;
@@ -990,6 +547,14 @@ namespace Piccolo
                 piccolo_texture_layout_binding.stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
             }
 
+            {
+                VkDescriptorSetLayoutBinding& sort_key_layout_binding = particle_layout_bindings[11];
+                sort_key_layout_binding.binding                       = 11;
+                sort_key_layout_binding.descriptorType                = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                sort_key_layout_binding.descriptorCount               = 1;
+                sort_key_layout_binding.stageFlags                    = VK_SHADER_STAGE_COMPUTE_BIT;
+            }
+
             VkDescriptorSetLayoutCreateInfo particle_descriptor_layout_create_info;
             particle_descriptor_layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
             particle_descriptor_layout_create_info.pNext = NULL;
@@ -1014,7 +579,8 @@ namespace Piccolo
             VkDescriptorSetLayoutBinding& gbuffer_normal_global_layout_input_attachment_binding =
                 scene_global_layout_bindings[0];
             gbuffer_normal_global_layout_input_attachment_binding.binding         = 0;
-            gbuffer_normal_global_layout_input_attachment_binding.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            gbuffer_normal_global_layout_input_attachment_binding.descriptorType =
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
             gbuffer_normal_global_layout_input_attachment_binding.descriptorCount = 1;
             gbuffer_normal_global_layout_input_attachment_binding.stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT;
 
@@ -1093,13 +659,22 @@ namespace Piccolo
 
         // compute pipeline
         {
-            VkDescriptorSetLayout      descriptorset_layouts[2] = {m_descriptor_infos[0].layout,
-                                                                   m_descriptor_infos[1].layout};
+            VkDescriptorSetLayout descriptorset_layouts[2] = {m_descriptor_infos[0].layout,
+                                                              m_descriptor_infos[1].layout};
+
+            // only the sort reads the push constants, sharing the layout keeps the bound sets compatible
+            VkPushConstantRange sort_push_constant_range {};
+            sort_push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            sort_push_constant_range.offset     = 0;
+            sort_push_constant_range.size       = sizeof(SortParameters);
+
             VkPipelineLayoutCreateInfo pipeline_layout_create_info {};
             pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
             pipeline_layout_create_info.setLayoutCount =
                 sizeof(descriptorset_layouts) / sizeof(descriptorset_layouts[0]);
-            pipeline_layout_create_info.pSetLayouts = descriptorset_layouts;
+            pipeline_layout_create_info.pSetLayouts            = descriptorset_layouts;
+            pipeline_layout_create_info.pushConstantRangeCount = 1;
+            pipeline_layout_create_info.pPushConstantRanges    = &sort_push_constant_range;
 
             if (vkCreatePipelineLayout(
                     m_vulkan_rhi->m_device, &pipeline_layout_create_info, nullptr, &m_render_pipelines[0].layout) !=
@@ -1108,14 +683,7 @@ namespace Piccolo
             LOG_INFO("compute pipe layout done");
         }
 
-        VkPipelineCache           pipelineCache;
-        VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
-        pipelineCacheCreateInfo.sType                     = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-        if (VK_SUCCESS !=
-            vkCreatePipelineCache(m_vulkan_rhi->m_device, &pipelineCacheCreateInfo, nullptr, &pipelineCache))
-        {
-            throw std::runtime_error("create particle cache");
-        }
+        VkPipelineCache pipelineCache = m_vulkan_rhi->m_pipeline_cache;
 
         struct SpecializationData
         {
@@ -1189,6 +757,37 @@ namespace Piccolo
             }
         }
 
+        {
+            shaderStage.module = VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, PARTICLE_INITIALIZE_COMP);
+            shaderStage.pSpecializationInfo = nullptr;
+            assert(shaderStage.module != VK_NULL_HANDLE);
+
+            computePipelineCreateInfo.stage = shaderStage;
+            if (VK_SUCCESS != vkCreateComputePipelines(m_vulkan_rhi->m_device,
+                                                       pipelineCache,
+                                                       1,
+                                                       &computePipelineCreateInfo,
+                                                       nullptr,
+                                                       &m_initialize_pipeline))
+            {
+                throw std::runtime_error("create particle initialize pipe");
+            }
+        }
+
+        {
+            shaderStage.module = VulkanUtil::createShaderModule(m_vulkan_rhi->m_device, PARTICLE_SORT_COMP);
+            shaderStage.pSpecializationInfo = nullptr;
+            assert(shaderStage.module != VK_NULL_HANDLE);
+
+            computePipelineCreateInfo.stage = shaderStage;
+            if (VK_SUCCESS !=
+                vkCreateComputePipelines(
+                    m_vulkan_rhi->m_device, pipelineCache, 1, &computePipelineCreateInfo, nullptr, &m_sort_pipeline))
+            {
+                throw std::runtime_error("create particle sort pipe");
+            }
+        }
+
         // particle billboard
         {
             VkDescriptorSetLayout      descriptorset_layouts[1] = {m_descriptor_infos[2].layout};
@@ -1317,7 +916,7 @@ namespace Piccolo
             pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
             if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
-                                          VK_NULL_HANDLE,
+                                          m_vulkan_rhi->m_pipeline_cache,
                                           1,
                                           &pipelineInfo,
                                           nullptr,
@@ -1378,8 +977,12 @@ namespace Piccolo
                     descriptorset.descriptorCount       = 1;
                 }
 
+                const ParticleEmitterBufferBatch& batch              = m_emitter_buffer_batches[eid];
+                const VkDeviceSize                particleBufferSize = batch.m_max_particles * sizeof(Particle);
+                const VkDeviceSize                listBufferSize     = batch.m_max_particles * sizeof(uvec4);
+
                 VkDescriptorBufferInfo positionBufferDescriptor = {
-                    m_emitter_buffer_batches[eid].m_position_device_buffer, 0, VK_WHOLE_SIZE};
+                    m_particle_pool_buffer, batch.m_position_device_offset, particleBufferSize};
                 {
                     VkWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[1];
                     descriptorset.sType                 = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1391,7 +994,7 @@ namespace Piccolo
                 }
 
                 VkDescriptorBufferInfo counterBufferDescriptor = {
-                    m_emitter_buffer_batches[eid].m_counter_device_buffer, 0, VK_WHOLE_SIZE};
+                    m_particle_pool_buffer, batch.m_counter_offset, sizeof(ParticleCounter)};
                 {
                     VkWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[2];
                     descriptorset.sType                 = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1403,7 +1006,7 @@ namespace Piccolo
                 }
 
                 VkDescriptorBufferInfo indirectArgumentBufferDescriptor = {
-                    m_emitter_buffer_batches[eid].m_indirect_dispatch_argument_buffer, 0, VK_WHOLE_SIZE};
+                    m_particle_pool_buffer, batch.m_indirect_dispatch_argument_offset, sizeof(IndirectArgumemt)};
                 {
                     VkWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[3];
                     descriptorset.sType                 = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1415,7 +1018,7 @@ namespace Piccolo
                 }
 
                 VkDescriptorBufferInfo aliveListBufferDescriptor = {
-                    m_emitter_buffer_batches[eid].m_alive_list_buffer, 0, VK_WHOLE_SIZE};
+                    m_particle_pool_buffer, batch.m_alive_list_offset, listBufferSize};
                 {
                     VkWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[4];
                     descriptorset.sType                 = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1427,7 +1030,7 @@ namespace Piccolo
                 }
 
                 VkDescriptorBufferInfo deadListBufferDescriptor = {
-                    m_emitter_buffer_batches[eid].m_dead_list_buffer, 0, VK_WHOLE_SIZE};
+                    m_particle_pool_buffer, batch.m_dead_list_offset, listBufferSize};
                 {
                     VkWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[5];
                     descriptorset.sType                 = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1439,7 +1042,7 @@ namespace Piccolo
                 }
 
                 VkDescriptorBufferInfo aliveListNextBufferDescriptor = {
-                    m_emitter_buffer_batches[eid].m_alive_list_next_buffer, 0, VK_WHOLE_SIZE};
+                    m_particle_pool_buffer, batch.m_alive_list_next_offset, listBufferSize};
                 {
                     VkWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[6];
                     descriptorset.sType                 = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1451,7 +1054,7 @@ namespace Piccolo
                 }
 
                 VkDescriptorBufferInfo particleComponentResBufferDescriptor = {
-                    m_emitter_buffer_batches[eid].m_particle_component_res_buffer, 0, VK_WHOLE_SIZE};
+                    m_emitter_desc_pool_buffer, batch.m_emitter_desc_offset, sizeof(ParticleEmitterDesc)};
                 {
                     VkWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[7];
                     descriptorset.sType                 = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1475,7 +1078,7 @@ namespace Piccolo
                 }
 
                 VkDescriptorBufferInfo positionRenderbufferDescriptor = {
-                    m_emitter_buffer_batches[eid].m_position_render_buffer, 0, VK_WHOLE_SIZE};
+                    m_particle_pool_buffer, batch.m_position_render_offset, particleBufferSize};
                 {
                     VkWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[9];
                     descriptorset.sType                 = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1522,6 +1125,20 @@ namespace Piccolo
                     descriptorset.descriptorCount       = 1;
                 }
 
+                VkDescriptorBufferInfo sortKeyBufferDescriptor = {
+                    m_particle_pool_buffer, batch.m_sort_key_offset, batch.m_sort_key_count * sizeof(SortKey)};
+                if (batch.m_sort_key_count > 0)
+                {
+                    VkWriteDescriptorSet descriptorset {};
+                    descriptorset.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    descriptorset.dstSet          = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                    descriptorset.dstBinding      = 11;
+                    descriptorset.pBufferInfo     = &sortKeyBufferDescriptor;
+                    descriptorset.descriptorCount = 1;
+                    computeWriteDescriptorSets.push_back(descriptorset);
+                }
+
                 vkUpdateDescriptorSets(m_vulkan_rhi->m_device,
                                        static_cast<uint32_t>(computeWriteDescriptorSets.size()),
                                        computeWriteDescriptorSets.data(),
@@ -1531,28 +1148,6 @@ namespace Piccolo
             {
                 VkWriteDescriptorSet descriptor_input_attachment_writes_info[2] = {{}, {}};
 
-                VkDescriptorImageInfo gbuffer_normal_descriptor_image_info = {};
-                gbuffer_normal_descriptor_image_info.sampler               = nullptr;
-                gbuffer_normal_descriptor_image_info.imageView             = m_src_normal_image_view;
-                gbuffer_normal_descriptor_image_info.imageLayout           = VK_IMAGE_LAYOUT_GENERAL;
-                {
-
-                    VkWriteDescriptorSet& gbuffer_normal_descriptor_input_attachment_write_info =
-                        descriptor_input_attachment_writes_info[0];
-                    gbuffer_normal_descriptor_input_attachment_write_info.sType =
-                        VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    gbuffer_normal_descriptor_input_attachment_write_info.pNext = NULL;
-                    gbuffer_normal_descriptor_input_attachment_write_info.dstSet =
-                        m_descriptor_infos[eid * 3 + 1].descriptor_set;
-                    gbuffer_normal_descriptor_input_attachment_write_info.dstBinding      = 0;
-                    gbuffer_normal_descriptor_input_attachment_write_info.dstArrayElement = 0;
-                    gbuffer_normal_descriptor_input_attachment_write_info.descriptorType =
-                        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-                    gbuffer_normal_descriptor_input_attachment_write_info.descriptorCount = 1;
-                    gbuffer_normal_descriptor_input_attachment_write_info.pImageInfo =
-                        &gbuffer_normal_descriptor_image_info;
-                }
-
                 VkSampler           sampler;
                 VkSamplerCreateInfo samplerCreateInfo {};
                 samplerCreateInfo.sType            = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -1574,18 +1169,41 @@ namespace Piccolo
                     throw std::runtime_error("create sampler error");
                 }
 
-                VkDescriptorImageInfo depth_descriptor_image_info = {};
-                depth_descriptor_image_info.sampler               = sampler;
-                depth_descriptor_image_info.imageView             = m_src_depth_image_view;
-                depth_descriptor_image_info.imageLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
+                // the main camera pass leaves both attachments in a read only layout at the end of the frame
+                VkDescriptorImageInfo gbuffer_normal_descriptor_image_info = {};
+                gbuffer_normal_descriptor_image_info.sampler               = sampler;
+                gbuffer_normal_descriptor_image_info.imageView             = m_scene_normal_image_view;
+                gbuffer_normal_descriptor_image_info.imageLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
                 {
-                    VkWriteDescriptorSet& depth_descriptor_input_attachment_write_info =
-                        descriptor_input_attachment_writes_info[1];
-                    depth_descriptor_input_attachment_write_info.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    depth_descriptor_input_attachment_write_info.pNext = NULL;
-                    depth_descriptor_input_attachment_write_info.dstSet =
-                        m_descriptor_infos[eid * 3 + 1].descriptor_set;
+
+                    VkWriteDescriptorSet& gbuffer_normal_descriptor_input_attachment_write_info =
+                        descriptor_input_attachment_writes_info[0];
+                    gbuffer_normal_descriptor_input_attachment_write_info.sType =
+                        VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    gbuffer_normal_descriptor_input_attachment_write_info.pNext = NULL;
+                    gbuffer_normal_descriptor_input_attachment_write_info.dstSet =
+                        m_descriptor_infos[eid * 3 + 1].descriptor_set;
+                    gbuffer_normal_descriptor_input_attachment_write_info.dstBinding      = 0;
+                    gbuffer_normal_descriptor_input_attachment_write_info.dstArrayElement = 0;
+                    gbuffer_normal_descriptor_input_attachment_write_info.descriptorType =
+                        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                    gbuffer_normal_descriptor_input_attachment_write_info.descriptorCount = 1;
+                    gbuffer_normal_descriptor_input_attachment_write_info.pImageInfo =
+                        &gbuffer_normal_descriptor_image_info;
+                }
+
+                VkDescriptorImageInfo depth_descriptor_image_info = {};
+                depth_descriptor_image_info.sampler               = sampler;
+                depth_descriptor_image_info.imageView             = m_scene_depth_image_view;
+                depth_descriptor_image_info.imageLayout           = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+
+                {
+                    VkWriteDescriptorSet& depth_descriptor_input_attachment_write_info =
+                        descriptor_input_attachment_writes_info[1];
+                    depth_descriptor_input_attachment_write_info.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                    depth_descriptor_input_attachment_write_info.pNext = NULL;
+                    depth_descriptor_input_attachment_write_info.dstSet =
+                        m_descriptor_infos[eid * 3 + 1].descriptor_set;
                     depth_descriptor_input_attachment_write_info.dstBinding      = 1;
                     depth_descriptor_input_attachment_write_info.dstArrayElement = 0;
                     depth_descriptor_input_attachment_write_info.descriptorType =
@@ -1606,372 +1224,387 @@ namespace Piccolo
 
     void ParticlePass::simulate()
     {
-        for (auto i : m_emitter_tick_indices)
+        // the collision samples the depth and normal attachments of the frame submitted just before, the
+        // semaphore is consumed every frame so that the frame can signal it again
+        uint8_t index = (m_vulkan_rhi->m_current_frame_index + m_vulkan_rhi->s_max_frames_in_flight - 1) %
+                        m_vulkan_rhi->s_max_frames_in_flight;
+        VkSemaphore          scene_semaphore  = m_vulkan_rhi->m_image_available_for_texturescopy_semaphores[index];
+        VkPipelineStageFlags scene_wait_stage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+        VkSubmitInfo computeSubmitInfo {};
+        computeSubmitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        computeSubmitInfo.waitSemaphoreCount = 1;
+        computeSubmitInfo.pWaitSemaphores    = &scene_semaphore;
+        computeSubmitInfo.pWaitDstStageMask  = &scene_wait_stage;
+
+        if (m_emitter_tick_indices.empty() || !m_scene_images_rendered)
         {
-            VkCommandBufferBeginInfo cmdBufInfo {};
-            cmdBufInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            m_scene_images_rendered = true;
 
-            // particle compute pass
-            if (VK_SUCCESS != vkBeginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
+            vkResetFences(m_vulkan_rhi->m_device, 1, &m_fence);
+            if (VK_SUCCESS != vkQueueSubmit(m_vulkan_rhi->m_compute_queue, 1, &computeSubmitInfo, m_fence))
             {
-                throw std::runtime_error("begin command buffer");
+                throw std::runtime_error("compute queue submit");
             }
 
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                VkDebugUtilsLabelEXT compute_label_info = {
-                    VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle compute", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &compute_label_info);
+            m_emitter_tick_indices.clear();
+            m_emitter_transform_indices.clear();
+            return;
+        }
 
-                VkDebugUtilsLabelEXT kickoff_label_info = {
-                    VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle Kickoff", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &kickoff_label_info);
-            }
+        VkCommandBufferBeginInfo cmdBufInfo {};
+        cmdBufInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        cmdBufInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
 
-            vkCmdBindPipeline(m_compute_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_kickoff_pipeline);
-            VkDescriptorSet descriptorsets[2] = {m_descriptor_infos[i * 3].descriptor_set,
-                                                 m_descriptor_infos[i * 3 + 1].descriptor_set};
-            vkCmdBindDescriptorSets(m_compute_command_buffer,
-                                    VK_PIPELINE_BIND_POINT_COMPUTE,
-                                    m_render_pipelines[0].layout,
-                                    0,
-                                    2,
-                                    descriptorsets,
-                                    0,
-                                    0);
-            vkCmdDispatch(m_compute_command_buffer, 1, 1, 1);
+        // the previous submission was waited for in preparePassData before the uniform buffers were updated
+        if (VK_SUCCESS != vkBeginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
+        {
+            throw std::runtime_error("begin command buffer");
+        }
 
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                // end particle kickoff label
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
-            }
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT compute_label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle compute", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &compute_label_info);
+        }
 
-            VkBufferMemoryBarrier bufferBarrier {};
-            bufferBarrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_counter_device_buffer;
-            bufferBarrier.size                = VK_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        // all emitters are simulated in one submission, each stage is dispatched for every emitter before the
+        // barrier so the emitters overlap on the gpu. the first barrier orders against the previous submission
+        VkMemoryBarrier memoryBarrier {};
+        memoryBarrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(m_compute_command_buffer,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0,
+                             1,
+                             &memoryBarrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
-                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &bufferBarrier,
-                                 0,
-                                 nullptr);
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT kickoff_label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle Kickoff", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &kickoff_label_info);
+        }
 
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer;
-            bufferBarrier.size                = VK_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        vkCmdBindPipeline(m_compute_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_kickoff_pipeline);
+        for (auto i : m_emitter_tick_indices)
+        {
+            bindComputeDescriptorSets(m_compute_command_buffer, i);
+            vkCmdDispatch(m_compute_command_buffer, 1, 1, 1);
+        }
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
-                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &bufferBarrier,
-                                 0,
-                                 nullptr);
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            // end particle kickoff label
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
+        }
 
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                VkDebugUtilsLabelEXT label_info = {
-                    VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle Emit", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
-            }
+        // the kickoff writes the counters and the indirect dispatch arguments
+        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memoryBarrier.dstAccessMask =
+            VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(m_compute_command_buffer,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0,
+                             1,
+                             &memoryBarrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
+
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle Emit", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
+        }
 
-            vkCmdBindPipeline(m_compute_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_emit_pipeline);
+        vkCmdBindPipeline(m_compute_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_emit_pipeline);
+        for (auto i : m_emitter_tick_indices)
+        {
+            bindComputeDescriptorSets(m_compute_command_buffer, i);
             vkCmdDispatchIndirect(m_compute_command_buffer,
-                                  m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
-                                  s_argument_offset_emit);
+                                  m_particle_pool_buffer,
+                                  m_emitter_buffer_batches[i].m_indirect_dispatch_argument_offset +
+                                      s_argument_offset_emit);
+        }
 
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                // end particle emit label
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
-            }
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            // end particle emit label
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
+        }
 
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_position_device_buffer;
-            bufferBarrier.size                = VK_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        // the emit writes the particles, the counters and the alive and dead lists
+        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(m_compute_command_buffer,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0,
+                             1,
+                             &memoryBarrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
-                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &bufferBarrier,
-                                 0,
-                                 nullptr);
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle Simulate", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
+        }
 
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_position_render_buffer;
-            bufferBarrier.size                = VK_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        vkCmdBindPipeline(m_compute_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_simulate_pipeline);
+        for (auto i : m_emitter_tick_indices)
+        {
+            bindComputeDescriptorSets(m_compute_command_buffer, i);
+            vkCmdDispatchIndirect(m_compute_command_buffer,
+                                  m_particle_pool_buffer,
+                                  m_emitter_buffer_batches[i].m_indirect_dispatch_argument_offset +
+                                      s_argument_offset_simulate);
+        }
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
-                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &bufferBarrier,
-                                 0,
-                                 nullptr);
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            // end particle simulate label
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
+        }
 
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_counter_device_buffer;
-            bufferBarrier.size                = VK_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        if (m_particle_manager->getGlobalParticleRes().m_enable_depth_sort)
+        {
+            sortParticles();
+        }
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
-                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &bufferBarrier,
-                                 0,
-                                 nullptr);
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
+                                               NULL,
+                                               "Copy Particle Counter Buffer",
+                                               {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
+        }
 
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_alive_list_buffer;
-            bufferBarrier.size                = VK_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        vkCmdPipelineBarrier(m_compute_command_buffer,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             0,
+                             1,
+                             &memoryBarrier,
+                             0,
+                             nullptr,
+                             0,
+                             nullptr);
+
+        // the alive count stays on the gpu as the instance count of the billboard draw
+        for (auto i : m_emitter_tick_indices)
+        {
+            const ParticleEmitterBufferBatch& batch = m_emitter_buffer_batches[i];
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
-                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &bufferBarrier,
-                                 0,
-                                 nullptr);
+            VkBufferCopy drawArgumentCopy {};
+            drawArgumentCopy.srcOffset = batch.m_counter_offset + offsetof(ParticleCounter, alive_count_after_sim);
+            drawArgumentCopy.dstOffset =
+                batch.m_indirect_draw_argument_offset + offsetof(VkDrawIndirectCommand, instanceCount);
+            drawArgumentCopy.size = sizeof(uint32_t);
+            vkCmdCopyBuffer(
+                m_compute_command_buffer, m_particle_pool_buffer, m_particle_pool_buffer, 1, &drawArgumentCopy);
 
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_dead_list_buffer;
-            bufferBarrier.size                = VK_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            if constexpr (s_verbose_particle_alive_info)
+            {
+                VkBufferCopy counterCopy {};
+                counterCopy.srcOffset = batch.m_counter_offset;
+                counterCopy.dstOffset = i * sizeof(ParticleCounter);
+                counterCopy.size      = sizeof(ParticleCounter);
+                vkCmdCopyBuffer(
+                    m_compute_command_buffer, m_particle_pool_buffer, m_counter_host_buffer, 1, &counterCopy);
+            }
+        }
 
+        if constexpr (s_verbose_particle_alive_info)
+        {
+            // Barrier to ensure that buffer copy is finished before host reading from it
+            memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            memoryBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
             vkCmdPipelineBarrier(m_compute_command_buffer,
-                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                 VK_PIPELINE_STAGE_HOST_BIT,
                                  0,
+                                 1,
+                                 &memoryBarrier,
                                  0,
                                  nullptr,
-                                 1,
-                                 &bufferBarrier,
                                  0,
                                  nullptr);
+        }
 
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_alive_list_next_buffer;
-            bufferBarrier.size                = VK_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            // end particle counter copy label
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
+            // end particle compute label
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
+        }
 
-            vkCmdPipelineBarrier(m_compute_command_buffer,
-                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &bufferBarrier,
-                                 0,
-                                 nullptr);
+        if (VK_SUCCESS != vkEndCommandBuffer(m_compute_command_buffer))
+        {
+            throw std::runtime_error("end command buffer");
+        }
 
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                VkDebugUtilsLabelEXT label_info = {
-                    VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle Simulate", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
-            }
+        // the next frame waits for the semaphore before drawing and before it overwrites the depth and normal
+        // attachments, the cpu does not wait here
+        vkResetFences(m_vulkan_rhi->m_device, 1, &m_fence);
+        computeSubmitInfo.commandBufferCount   = 1;
+        computeSubmitInfo.pCommandBuffers      = &m_compute_command_buffer;
+        computeSubmitInfo.signalSemaphoreCount = 1;
+        computeSubmitInfo.pSignalSemaphores    = &m_compute_finished_semaphore;
+        if (VK_SUCCESS != vkQueueSubmit(m_vulkan_rhi->m_compute_queue, 1, &computeSubmitInfo, m_fence))
+        {
+            throw std::runtime_error("compute queue submit");
+        }
+        m_vulkan_rhi->addRenderingWaitSemaphore(
+            m_compute_finished_semaphore,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
 
-            vkCmdBindPipeline(m_compute_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_simulate_pipeline);
-            vkCmdDispatchIndirect(m_compute_command_buffer,
-                                  m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
-                                  s_argument_offset_simulate);
+        if constexpr (s_verbose_particle_alive_info)
+        {
+            waitForSimulation();
 
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                // end particle simulate label
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
-            }
+            void* mapped;
+            vkMapMemory(m_vulkan_rhi->m_device, m_counter_host_memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+            VkMappedMemoryRange mappedRange {};
+            mappedRange.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            mappedRange.memory = m_counter_host_memory;
+            mappedRange.offset = 0;
+            mappedRange.size   = VK_WHOLE_SIZE;
+            vkInvalidateMappedMemoryRanges(m_vulkan_rhi->m_device, 1, &mappedRange);
 
-            if (VK_SUCCESS != vkEndCommandBuffer(m_compute_command_buffer))
+            for (auto i : m_emitter_tick_indices)
             {
-                throw std::runtime_error("end command buffer");
-            }
-            vkResetFences(m_vulkan_rhi->m_device, 1, &m_fence);
-            VkSubmitInfo computeSubmitInfo {};
-            computeSubmitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            computeSubmitInfo.pWaitDstStageMask  = 0;
-            computeSubmitInfo.commandBufferCount = 1;
-            computeSubmitInfo.pCommandBuffers    = &m_compute_command_buffer;
-            if (VK_SUCCESS != vkQueueSubmit(m_vulkan_rhi->m_compute_queue, 1, &computeSubmitInfo, m_fence))
-            {
-                throw std::runtime_error("compute queue submit");
-            }
+                ParticleCounter counterNext {};
+                memcpy(&counterNext, static_cast<uint8_t*>(mapped) + i * sizeof(ParticleCounter), sizeof(counterNext));
 
-            if (VK_SUCCESS != vkWaitForFences(m_vulkan_rhi->m_device, 1, &m_fence, VK_TRUE, UINT64_MAX))
-            {
-                throw std::runtime_error("wait for fence");
+                LOG_INFO("{} {} {} {}",
+                         counterNext.dead_count,
+                         counterNext.alive_count,
+                         counterNext.alive_count_after_sim,
+                         counterNext.emit_count);
             }
+            vkUnmapMemory(m_vulkan_rhi->m_device, m_counter_host_memory);
+        }
 
-            if (VK_SUCCESS != vkBeginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
-            {
-                throw std::runtime_error("begin command buffer");
-            }
+        m_emitter_tick_indices.clear();
+        m_emitter_transform_indices.clear();
+    }
 
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                VkDebugUtilsLabelEXT label_info = {VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
-                                                   NULL,
-                                                   "Copy Particle Counter Buffer",
-                                                   {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
-            }
+    void ParticlePass::bindComputeDescriptorSets(VkCommandBuffer command_buffer, uint32_t emitter_index)
+    {
+        VkDescriptorSet descriptorsets[2] = {m_descriptor_infos[emitter_index * 3].descriptor_set,
+                                             m_descriptor_infos[emitter_index * 3 + 1].descriptor_set};
+        vkCmdBindDescriptorSets(command_buffer,
+                                VK_PIPELINE_BIND_POINT_COMPUTE,
+                                m_render_pipelines[0].layout,
+                                0,
+                                2,
+                                descriptorsets,
+                                0,
+                                0);
+    }
+
+    void ParticlePass::sortParticles()
+    {
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            VkDebugUtilsLabelEXT label_info = {
+                VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Particle Sort", {1.0f, 1.0f, 1.0f, 1.0f}};
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_compute_command_buffer, &label_info);
+        }
 
-            // Barrier to ensure that shader writes are finished before buffer is read back from GPU
-            bufferBarrier.srcAccessMask       = VK_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_counter_device_buffer;
-            bufferBarrier.size                = VK_WHOLE_SIZE;
-            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        uint32_t max_sort_key_count = 0;
+        for (auto i : m_emitter_tick_indices)
+        {
+            max_sort_key_count = std::max(max_sort_key_count, m_emitter_buffer_batches[i].m_sort_key_count);
+        }
 
+        VkMemoryBarrier memoryBarrier {};
+        memoryBarrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+        // every step is recorded for all emitters with at least k keys, the steps depend on each other
+        auto dispatchStep = [&](uint32_t stage, uint32_t k, uint32_t j) {
             vkCmdPipelineBarrier(m_compute_command_buffer,
                                  VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 0,
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                                  0,
-                                 nullptr,
                                  1,
-                                 &bufferBarrier,
-                                 0,
-                                 nullptr);
-            // Read back to host visible buffer
-            VkBufferCopy copyRegion = {};
-            copyRegion.size         = sizeof(ParticleCounter);
-            vkCmdCopyBuffer(m_compute_command_buffer,
-                            m_emitter_buffer_batches[i].m_counter_device_buffer,
-                            m_emitter_buffer_batches[i].m_counter_host_buffer,
-                            1,
-                            &copyRegion);
-
-            // Barrier to ensure that buffer copy is finished before host reading from it
-            bufferBarrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = VK_ACCESS_HOST_READ_BIT;
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_counter_host_buffer;
-            bufferBarrier.size                = VK_WHOLE_SIZE;
-            bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-
-            vkCmdPipelineBarrier(m_compute_command_buffer,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 VK_PIPELINE_STAGE_HOST_BIT,
-                                 0,
+                                 &memoryBarrier,
                                  0,
                                  nullptr,
-                                 1,
-                                 &bufferBarrier,
                                  0,
                                  nullptr);
 
-            if (m_vulkan_rhi->isDebugLabelEnabled())
-            {
-                // end particle counter copy label
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
-                // end particle compute label
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
-            }
+            SortParameters parameters {stage, k, j};
+            vkCmdPushConstants(m_compute_command_buffer,
+                               m_render_pipelines[0].layout,
+                               VK_SHADER_STAGE_COMPUTE_BIT,
+                               0,
+                               sizeof(SortParameters),
+                               &parameters);
 
-            if (VK_SUCCESS != vkEndCommandBuffer(m_compute_command_buffer))
+            for (auto i : m_emitter_tick_indices)
             {
-                throw std::runtime_error("end command buffer");
+                const uint32_t sort_key_count = m_emitter_buffer_batches[i].m_sort_key_count;
+                if (sort_key_count == 0 || sort_key_count < k)
+                {
+                    continue;
+                }
+                bindComputeDescriptorSets(m_compute_command_buffer, i);
+                vkCmdDispatch(m_compute_command_buffer, sort_key_count / s_sort_group_size, 1, 1);
             }
+        };
 
-            // Submit compute work
-            vkResetFences(m_vulkan_rhi->m_device, 1, &m_fence);
-            computeSubmitInfo                        = {};
-            const VkPipelineStageFlags waitStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            computeSubmitInfo.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            computeSubmitInfo.pWaitDstStageMask      = &waitStageMask;
-            computeSubmitInfo.commandBufferCount     = 1;
-            computeSubmitInfo.pCommandBuffers        = &m_compute_command_buffer;
-            if (VK_SUCCESS != vkQueueSubmit(m_vulkan_rhi->m_compute_queue, 1, &computeSubmitInfo, m_fence))
-            {
-                throw std::runtime_error("compute queue submit");
-            }
+        vkCmdBindPipeline(m_compute_command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_sort_pipeline);
 
-            if (VK_SUCCESS != vkWaitForFences(m_vulkan_rhi->m_device, 1, &m_fence, VK_TRUE, UINT64_MAX))
+        // bitonic sort: each group sorts its own keys, then every merge of size k runs its long distance steps
+        // globally and finishes the steps below the group size in shared memory
+        dispatchStep(s_sort_stage_keys, 0, 0);
+        dispatchStep(s_sort_stage_local, 0, 0);
+        for (uint32_t k = s_sort_group_size << 1; k <= max_sort_key_count; k <<= 1)
+        {
+            for (uint32_t j = k >> 1; j >= s_sort_group_size; j >>= 1)
             {
-                throw std::runtime_error("wait for fence");
+                dispatchStep(s_sort_stage_global, k, j);
             }
+            dispatchStep(s_sort_stage_local, k, 0);
+        }
+        dispatchStep(s_sort_stage_gather, 0, 0);
 
-            vkQueueWaitIdle(m_vulkan_rhi->m_compute_queue);
-
-            // Make device writes visible to the host
-            void* mapped;
-            vkMapMemory(m_vulkan_rhi->m_device,
-                        m_emitter_buffer_batches[i].m_counter_host_memory,
-                        0,
-                        VK_WHOLE_SIZE,
-                        0,
-                        &mapped);
-            VkMappedMemoryRange mappedRange {};
-            mappedRange.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-            mappedRange.memory = m_emitter_buffer_batches[i].m_counter_host_memory;
-            mappedRange.offset = 0;
-            mappedRange.size   = VK_WHOLE_SIZE;
-            vkInvalidateMappedMemoryRanges(m_vulkan_rhi->m_device, 1, &mappedRange);
-
-            // Copy to output
-            ParticleCounter counterNext {};
-            memcpy(&counterNext, mapped, sizeof(ParticleCounter));
-            vkUnmapMemory(m_vulkan_rhi->m_device, m_emitter_buffer_batches[i].m_counter_host_memory);
+        if (m_vulkan_rhi->isDebugLabelEnabled())
+        {
+            // end particle sort label
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_compute_command_buffer);
+        }
+    }
 
-            if constexpr (s_verbose_particle_alive_info)
-                LOG_INFO("{} {} {} {}",
-                         counterNext.dead_count,
-                         counterNext.alive_count,
-                         counterNext.alive_count_after_sim,
-                         counterNext.emit_count);
-            m_emitter_buffer_batches[i].m_num_particle = counterNext.alive_count_after_sim;
+    void ParticlePass::waitForSimulation()
+    {
+        if (VK_SUCCESS != vkWaitForFences(m_vulkan_rhi->m_device, 1, &m_fence, VK_TRUE, UINT64_MAX))
+        {
+            throw std::runtime_error("wait for fence");
         }
-        m_emitter_tick_indices.clear();
-        m_emitter_transform_indices.clear();
     }
 
     void ParticlePass::prepareUniformBuffer()
@@ -2018,7 +1651,7 @@ namespace Piccolo
         float rnd1        = m_random_engine.uniformDistribution<float>(0, 1000) * 0.001f;
         float rnd2        = m_random_engine.uniformDistribution<float>(0, 1000) * 0.001f;
         m_ubo.pack        = Vector4 {rnd0, static_cast<float>(m_vulkan_rhi->m_current_frame_index), rnd1, rnd2};
-        m_ubo.xemit_count = 100000;
+        m_ubo.xemit_count = global_res.m_emit_count;
 
         m_viewport_params = m_vulkan_rhi->m_viewport;
         m_ubo.viewport.x  = m_viewport_params.x;
@@ -2062,6 +1695,55 @@ namespace Piccolo
         }
     }
 
+    void ParticlePass::updateEmitterLOD()
+    {
+        const GlobalParticleRes&                      global_res = m_particle_manager->getGlobalParticleRes();
+        const std::vector<RenderParticleEmitterNode>& nodes      = *m_visiable_nodes.p_particle_emitter_nodes;
+
+        // emitters off screen sleep or are simulated coarsely, the others spawn less and larger particles with
+        // growing distance to the camera
+        std::vector<ParticleEmitterID> tick_indices;
+        tick_indices.reserve(m_emitter_tick_indices.size());
+        for (ParticleEmitterID id : m_emitter_tick_indices)
+        {
+            ParticleEmitterBufferBatch&      batch = m_emitter_buffer_batches[id];
+            const RenderParticleEmitterNode& node  = nodes[id];
+
+            Vector4 lod_scale {1.0f, 1.0f, 1.0f, 0.0f};
+            if (node.visible)
+            {
+                batch.m_offscreen_frames = 0;
+            }
+            else
+            {
+                if (global_res.m_offscreen_tick_interval <= 0 ||
+                    ++batch.m_offscreen_frames < global_res.m_offscreen_tick_interval)
+                {
+                    continue;
+                }
+                lod_scale.z              = static_cast<float>(batch.m_offscreen_frames);
+                batch.m_offscreen_frames = 0;
+            }
+
+            float lod_range = global_res.m_lod_far_distance - global_res.m_lod_near_distance;
+            float lod_factor =
+                lod_range > 0.0f ?
+                    std::clamp((node.camera_distance - global_res.m_lod_near_distance) / lod_range, 0.0f, 1.0f) :
+                    (node.camera_distance > global_res.m_lod_near_distance ? 1.0f : 0.0f);
+            lod_scale.x = 1.0f + (global_res.m_lod_min_spawn_scale - 1.0f) * lod_factor;
+            lod_scale.y = 1.0f + (global_res.m_lod_max_size_scale - 1.0f) * lod_factor;
+
+            // only the lod is written, the rest of the desc holds the emit timer advanced by the gpu
+            batch.m_emitter_desc.m_lod_scale = lod_scale;
+            memcpy(static_cast<uint8_t*>(batch.m_emitter_desc_mapped) + offsetof(ParticleEmitterDesc, m_lod_scale),
+                   &lod_scale,
+                   sizeof(Vector4));
+
+            tick_indices.push_back(id);
+        }
+        m_emitter_tick_indices.swap(tick_indices);
+    }
+
     void ParticlePass::updateUniformBuffer()
     {
         std::random_device r;
@@ -2089,6 +1771,10 @@ namespace Piccolo
         const RenderResource* vulkan_resource = static_cast<const RenderResource*>(render_resource.get());
         if (vulkan_resource)
         {
+            // the uniform buffers are shared with the simulation submitted last frame, which has normally
+            // finished while the logic was ticking
+            waitForSimulation();
+
             m_particle_collision_perframe_storage_buffer_object =
                 vulkan_resource->m_particle_collision_perframe_storage_buffer_object;
             memcpy(m_scene_uniform_buffer_mapped,
@@ -2104,13 +1790,14 @@ namespace Piccolo
             m_viewport_params = m_vulkan_rhi->m_viewport;
             updateUniformBuffer();
             updateEmitterTransform();
+            updateEmitterLOD();
         }
     }
 
-    void ParticlePass::setDepthAndNormalImage(VkImage depth_image, VkImage normal_image)
+    void ParticlePass::setDepthAndNormalImageView(VkImageView depth_image_view, VkImageView normal_image_view)
     {
-        m_src_depth_image  = depth_image;
-        m_src_normal_image = normal_image;
+        m_scene_depth_image_view  = depth_image_view;
+        m_scene_normal_image_view = normal_image_view;
     }
 
     void ParticlePass::setRenderCommandBufferHandle(VkCommandBuffer command_buffer)
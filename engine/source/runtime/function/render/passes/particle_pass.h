@@ -12,38 +12,31 @@ namespace Piccolo
         std::shared_ptr<ParticleManager> m_particle_manager;
     };
 
+    // ranges of one emitter in the shared particle pool buffers, sized from the emitter's particle budget
     class ParticleEmitterBufferBatch
     {
     public:
-        VkBuffer m_particle_storage_buffer;
-        VkBuffer m_position_render_buffer;
-        VkBuffer m_position_device_buffer;
-        VkBuffer m_position_host_buffer;
-        VkBuffer m_counter_device_buffer;
-        VkBuffer m_counter_host_buffer;
-        VkBuffer m_indirect_dispatch_argument_buffer;
-        VkBuffer m_alive_list_buffer;
-        VkBuffer m_alive_list_next_buffer;
-        VkBuffer m_dead_list_buffer;
-        VkBuffer m_particle_component_res_buffer;
-
-        VkDeviceMemory m_counter_host_memory;
-        VkDeviceMemory m_position_host_memory;
-        VkDeviceMemory m_position_device_memory;
-        VkDeviceMemory m_counter_device_memory;
-        VkDeviceMemory m_indirect_dispatch_argument_memory;
-        VkDeviceMemory m_alive_list_memory;
-        VkDeviceMemory m_alive_list_next_memory;
-        VkDeviceMemory m_dead_list_memory;
-        VkDeviceMemory m_particle_component_res_memory;
-        VkDeviceMemory m_position_render_memory;
+        VkDeviceSize m_counter_offset {0};
+        VkDeviceSize m_indirect_dispatch_argument_offset {0};
+        VkDeviceSize m_indirect_draw_argument_offset {0};
+        VkDeviceSize m_position_device_offset {0};
+        VkDeviceSize m_position_render_offset {0};
+        VkDeviceSize m_alive_list_offset {0};
+        VkDeviceSize m_alive_list_next_offset {0};
+        VkDeviceSize m_dead_list_offset {0};
+        VkDeviceSize m_emitter_desc_offset {0};
+        VkDeviceSize m_sort_key_offset {0};
 
         void* m_emitter_desc_mapped {nullptr};
 
         ParticleEmitterDesc m_emitter_desc;
 
-        uint32_t m_num_particle {0};
-        void     freeUpBatch(VkDevice device);
+        uint32_t m_max_particles {0};
+        // power of two the bitonic sort runs over, 0 when sorting is disabled
+        uint32_t m_sort_key_count {0};
+
+        // frames since the emitter was last simulated while off screen
+        int m_offscreen_frames {0};
     };
 
     class ParticlePass : public RenderPass
@@ -57,9 +50,7 @@ namespace Piccolo
 
         void simulate();
 
-        void copyNormalAndDepthImage();
-
-        void setDepthAndNormalImage(VkImage depth_image, VkImage normal_image);
+        void setDepthAndNormalImageView(VkImageView depth_image_view, VkImageView normal_image_view);
 
         void setupParticlePass();
 
@@ -71,7 +62,7 @@ namespace Piccolo
 
         void setEmitterCount(int count);
 
-        void createEmitter(int id, const ParticleEmitterDesc& desc);
+        void createEmitter(int id, const ParticleEmitterDesc& desc, uint32_t max_particle_count);
 
         void initializeEmitters();
 
@@ -84,6 +75,8 @@ namespace Piccolo
 
         void updateEmitterTransform();
 
+        void updateEmitterLOD();
+
         void setupAttachments();
 
         void setupDescriptorSetLayout();
@@ -98,13 +91,28 @@ namespace Piccolo
 
         void setupParticleDescriptorSet();
 
+        VkDeviceSize allocateFromParticlePool(VkDeviceSize size);
+
+        void createParticlePool();
+
+        void destroyParticlePool();
+
+        void initializeEmitterBuffers();
+
+        void bindComputeDescriptorSets(VkCommandBuffer command_buffer, uint32_t emitter_index);
+
+        void sortParticles();
+
+        void waitForSimulation();
+
         VkPipeline m_kickoff_pipeline;
         VkPipeline m_emit_pipeline;
         VkPipeline m_simulate_pipeline;
+        VkPipeline m_initialize_pipeline;
+        VkPipeline m_sort_pipeline;
 
         VkCommandBuffer m_compute_command_buffer;
         VkCommandBuffer m_render_command_buffer;
-        VkCommandBuffer m_copy_command_buffer;
 
         VkBuffer m_scene_uniform_buffer;
         VkBuffer m_compute_uniform_buffer;
@@ -112,16 +120,15 @@ namespace Piccolo
 
         VkViewport m_viewport_params;
 
-        VkFence m_fence;
+        // signaled by the simulation of all emitters, waited for by the next frame's draw
+        VkFence     m_fence;
+        VkSemaphore m_compute_finished_semaphore;
 
-        VkImage        m_src_depth_image;
-        VkImage        m_dst_normal_image;
-        VkImage        m_src_normal_image;
-        VkImage        m_dst_depth_image;
-        VkImageView    m_src_depth_image_view;
-        VkImageView    m_src_normal_image_view;
-        VkDeviceMemory m_dst_normal_image_memory;
-        VkDeviceMemory m_dst_depth_image_memory;
+        // the main camera pass' depth and normal attachments, sampled in place by the collision
+        VkImageView m_scene_depth_image_view;
+        VkImageView m_scene_normal_image_view;
+        // cleared when the attachments are recreated, they hold no scene until the next frame is rendered
+        bool m_scene_images_rendered {true};
 
         /*
          * particle rendering
@@ -183,6 +190,26 @@ namespace Piccolo
             uvec4 emit_argument;
             uvec4 simulate_argument;
             int   alive_flap_bit;
+            int   padding[3]; // std140 struct size
+        };
+
+        // bitonic sort by view depth, see particle_sort.comp
+        static const uint32_t s_sort_group_size   = 256;
+        static const uint32_t s_sort_stage_keys   = 0;
+        static const uint32_t s_sort_stage_global = 1;
+        static const uint32_t s_sort_stage_local  = 2;
+        static const uint32_t s_sort_stage_gather = 3;
+        struct SortParameters
+        {
+            uint32_t stage;
+            uint32_t k;
+            uint32_t j;
+        };
+
+        struct SortKey
+        {
+            float    depth;
+            uint32_t index;
         };
 
         struct ParticleCounter
@@ -194,6 +221,20 @@ namespace Piccolo
         };
 
         std::vector<ParticleEmitterBufferBatch> m_emitter_buffer_batches;
+
+        // all emitters suballocate their counters, arguments, particles and lists from one device local pool,
+        // the emitter descs live in a host visible pool as they are updated every frame
+        VkBuffer       m_particle_pool_buffer {VK_NULL_HANDLE};
+        VkDeviceMemory m_particle_pool_memory {VK_NULL_HANDLE};
+        VkDeviceSize   m_particle_pool_size {0};
+        VkDeviceSize   m_particle_pool_used {0};
+        VkBuffer       m_emitter_desc_pool_buffer {VK_NULL_HANDLE};
+        VkDeviceMemory m_emitter_desc_pool_memory {VK_NULL_HANDLE};
+        VkDeviceSize   m_emitter_desc_pool_size {0};
+        void*          m_emitter_desc_pool_mapped {nullptr};
+        VkBuffer       m_counter_host_buffer {VK_NULL_HANDLE};
+        VkDeviceMemory m_counter_host_memory {VK_NULL_HANDLE};
+        VkDeviceSize   m_storage_buffer_alignment {1};
         std::shared_ptr<ParticleManager>        m_particle_manager;
 
         DefaultRNG m_random_engine;
@@ -9,9 +9,6 @@
 #include <mesh_inefficient_pick_frag.h>
 #include <mesh_inefficient_pick_vert.h>
 
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include <stb_image_write.h>
-
 #include <map>
 #include <stdexcept>
 
@@ -30,6 +27,7 @@ namespace Piccolo
         setupDescriptorSetLayout();
         setupPipelines();
         setupDescriptorSet();
+        setupReadbackBuffer();
     }
     void PickPass::postInitialize() {}
     void PickPass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource)
@@ -42,17 +40,56 @@ namespace Piccolo
             _mesh_inefficient_pick_perframe_storage_buffer_object.rt_width  = m_vulkan_rhi->m_swapchain_extent.width;
             _mesh_inefficient_pick_perframe_storage_buffer_object.rt_height = m_vulkan_rhi->m_swapchain_extent.height;
         }
+
+        // collect the picks whose frame already finished without waiting for the others
+        for (uint32_t i = 0; i < m_vulkan_rhi->s_max_frames_in_flight; ++i)
+        {
+            if (m_readback_callbacks[i] &&
+                vkGetFenceStatus(m_vulkan_rhi->m_device, m_vulkan_rhi->m_is_frame_in_flight_fences[i]) == VK_SUCCESS)
+            {
+                readbackPick(i);
+            }
+        }
+
+        std::vector<std::pair<PickCallback, uint32_t>> completed_picks;
+        completed_picks.swap(m_completed_picks);
+        for (auto& completed_pick : completed_picks)
+        {
+            completed_pick.first(completed_pick.second);
+        }
+    }
+    void PickPass::draw()
+    {
+        // the fence of this frame was waited for, so a pick recorded the last time it was in flight is complete
+        readbackPick(m_vulkan_rhi->m_current_frame_index);
+
+        if (!m_has_pending_pick)
+        {
+            return;
+        }
+        m_has_pending_pick = false;
+
+        if (m_pending_pick_x >= m_vulkan_rhi->m_swapchain_extent.width ||
+            m_pending_pick_y >= m_vulkan_rhi->m_swapchain_extent.height)
+        {
+            m_completed_picks.emplace_back(std::move(m_pending_pick_callback), 0);
+            return;
+        }
+
+        drawPick(m_pending_pick_x, m_pending_pick_y);
+        m_readback_callbacks[m_vulkan_rhi->m_current_frame_index] = std::move(m_pending_pick_callback);
     }
-    void PickPass::draw() {}
     void PickPass::setupAttachments()
     {
-        m_framebuffer.attachments.resize(1);
+        // only the picked pixel is rendered, so the attachments do not follow the swapchain size
+        m_framebuffer.attachments.resize(2);
         m_framebuffer.attachments[0].format = VK_FORMAT_R32_UINT;
+        m_framebuffer.attachments[1].format = m_vulkan_rhi->m_depth_image_format;
 
         VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
                                 m_vulkan_rhi->m_device,
-                                m_vulkan_rhi->m_swapchain_extent.width,
-                                m_vulkan_rhi->m_swapchain_extent.height,
+                                1,
+                                1,
                                 m_framebuffer.attachments[0].format,
                                 VK_IMAGE_TILING_OPTIMAL,
                                 VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
@@ -69,6 +106,27 @@ namespace Piccolo
                                                                         VK_IMAGE_VIEW_TYPE_2D,
                                                                         1,
                                                                         1);
+
+        VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
+                                m_vulkan_rhi->m_device,
+                                1,
+                                1,
+                                m_framebuffer.attachments[1].format,
+                                VK_IMAGE_TILING_OPTIMAL,
+                                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                m_framebuffer.attachments[1].image,
+                                m_framebuffer.attachments[1].mem,
+                                0,
+                                1,
+                                1);
+        m_framebuffer.attachments[1].view = VulkanUtil::createImageView(m_vulkan_rhi->m_device,
+                                                                        m_framebuffer.attachments[1].image,
+                                                                        m_framebuffer.attachments[1].format,
+                                                                        VK_IMAGE_ASPECT_DEPTH_BIT,
+                                                                        VK_IMAGE_VIEW_TYPE_2D,
+                                                                        1,
+                                                                        1);
     }
     void PickPass::setupRenderPass()
     {
@@ -79,11 +137,11 @@ namespace Piccolo
         color_attachment_description.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
         color_attachment_description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         color_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        color_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        color_attachment_description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
         color_attachment_description.finalLayout    = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
 
         VkAttachmentDescription depth_attachment_description {};
-        depth_attachment_description.format         = m_vulkan_rhi->m_depth_image_format;
+        depth_attachment_description.format         = m_framebuffer.attachments[1].format;
         depth_attachment_description.samples        = VK_SAMPLE_COUNT_1_BIT;
         depth_attachment_description.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
         depth_attachment_description.storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE;
@@ -108,14 +166,35 @@ namespace Piccolo
         subpass.pColorAttachments       = &color_attachment_reference;
         subpass.pDepthStencilAttachment = &depth_attachment_reference;
 
+        // the id is overwritten after the previous pick was copied out and copied out after it was written
+        VkSubpassDependency dependencies[2] = {};
+
+        VkSubpassDependency& previous_copy_dependency = dependencies[0];
+        previous_copy_dependency.srcSubpass           = VK_SUBPASS_EXTERNAL;
+        previous_copy_dependency.dstSubpass           = 0;
+        previous_copy_dependency.srcStageMask         = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        previous_copy_dependency.dstStageMask =
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        previous_copy_dependency.srcAccessMask = 0;
+        previous_copy_dependency.dstAccessMask =
+            VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        VkSubpassDependency& copy_dependency = dependencies[1];
+        copy_dependency.srcSubpass           = 0;
+        copy_dependency.dstSubpass           = VK_SUBPASS_EXTERNAL;
+        copy_dependency.srcStageMask         = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        copy_dependency.dstStageMask         = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        copy_dependency.srcAccessMask        = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        copy_dependency.dstAccessMask        = VK_ACCESS_TRANSFER_READ_BIT;
+
         VkRenderPassCreateInfo renderpass_create_info {};
         renderpass_create_info.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
         renderpass_create_info.attachmentCount = sizeof(attachments) / sizeof(attachments[0]);
         renderpass_create_info.pAttachments    = attachments;
         renderpass_create_info.subpassCount    = 1;
         renderpass_create_info.pSubpasses      = &subpass;
-        renderpass_create_info.dependencyCount = 0;
-        renderpass_create_info.pDependencies   = NULL;
+        renderpass_create_info.dependencyCount = sizeof(dependencies) / sizeof(dependencies[0]);
+        renderpass_create_info.pDependencies   = dependencies;
 
         if (vkCreateRenderPass(m_vulkan_rhi->m_device, &renderpass_create_info, nullptr, &m_framebuffer.render_pass) !=
             VK_SUCCESS)
@@ -125,15 +204,15 @@ namespace Piccolo
     }
     void PickPass::setupFramebuffer()
     {
-        VkImageView attachments[2] = {m_framebuffer.attachments[0].view, m_vulkan_rhi->m_depth_image_view};
+        VkImageView attachments[2] = {m_framebuffer.attachments[0].view, m_framebuffer.attachments[1].view};
 
         VkFramebufferCreateInfo framebuffer_create_info {};
         framebuffer_create_info.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         framebuffer_create_info.renderPass      = m_framebuffer.render_pass;
         framebuffer_create_info.attachmentCount = sizeof(attachments) / sizeof(attachments[0]);
         framebuffer_create_info.pAttachments    = attachments;
-        framebuffer_create_info.width           = m_vulkan_rhi->m_swapchain_extent.width;
-        framebuffer_create_info.height          = m_vulkan_rhi->m_swapchain_extent.height;
+        framebuffer_create_info.width           = 1;
+        framebuffer_create_info.height          = 1;
         framebuffer_create_info.layers          = 1;
 
         if (vkCreateFramebuffer(
@@ -324,9 +403,12 @@ namespace Piccolo
         pipelineInfo.basePipelineHandle  = VK_NULL_HANDLE;
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-        if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
-            VK_SUCCESS)
+        if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
+                                      m_vulkan_rhi->m_pipeline_cache,
+                                      1,
+                                      &pipelineInfo,
+                                      nullptr,
+                                      &m_render_pipelines[0].pipeline) != VK_SUCCESS)
         {
             throw std::runtime_error("create mesh inefficient pick graphics pipeline");
         }
@@ -372,9 +454,9 @@ namespace Piccolo
         VkDescriptorBufferInfo mesh_inefficient_pick_perdrawcall_vertex_blending_storage_buffer_info = {};
         mesh_inefficient_pick_perdrawcall_vertex_blending_storage_buffer_info.offset                 = 0;
         mesh_inefficient_pick_perdrawcall_vertex_blending_storage_buffer_info.range =
-            sizeof(MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject);
+            sizeof(MeshJointPaletteStorageBufferObject);
         mesh_inefficient_pick_perdrawcall_vertex_blending_storage_buffer_info.buffer =
-            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+            m_global_render_resource->_storage_buffer._joint_palette_buffer;
         assert(mesh_inefficient_pick_perdrawcall_vertex_blending_storage_buffer_info.range <
                m_global_render_resource->_storage_buffer._max_storage_buffer_range);
 
@@ -414,34 +496,58 @@ namespace Piccolo
                                0,
                                NULL);
     }
-    void PickPass::recreateFramebuffer()
+    void PickPass::setupReadbackBuffer()
     {
-        for (size_t i = 0; i < m_framebuffer.attachments.size(); i++)
-        {
-            vkDestroyImage(m_vulkan_rhi->m_device, m_framebuffer.attachments[i].image, nullptr);
-            vkDestroyImageView(m_vulkan_rhi->m_device, m_framebuffer.attachments[i].view, nullptr);
-            vkFreeMemory(m_vulkan_rhi->m_device, m_framebuffer.attachments[i].mem, nullptr);
-        }
-        vkDestroyFramebuffer(m_vulkan_rhi->m_device, m_framebuffer.framebuffer, nullptr);
-
-        setupAttachments();
-        setupFramebuffer();
+        // one id per frame in flight, persistently mapped
+        VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
+                                 m_vulkan_rhi->m_device,
+                                 sizeof(uint32_t) * m_vulkan_rhi->s_max_frames_in_flight,
+                                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 m_readback_buffer,
+                                 m_readback_buffer_memory);
+        vkMapMemory(m_vulkan_rhi->m_device,
+                    m_readback_buffer_memory,
+                    0,
+                    VK_WHOLE_SIZE,
+                    0,
+                    reinterpret_cast<void**>(&m_readback_data));
+
+        m_readback_callbacks.resize(m_vulkan_rhi->s_max_frames_in_flight);
     }
-    uint32_t PickPass::pick(const Vector2& picked_uv)
+    void PickPass::requestPick(const Vector2& picked_uv, PickCallback callback)
     {
         uint32_t pixel_x =
             static_cast<uint32_t>(picked_uv.x * m_vulkan_rhi->m_viewport.width + m_vulkan_rhi->m_viewport.x);
         uint32_t pixel_y =
             static_cast<uint32_t>(picked_uv.y * m_vulkan_rhi->m_viewport.height + m_vulkan_rhi->m_viewport.y);
-        uint32_t picked_pixel_index = m_vulkan_rhi->m_swapchain_extent.width * pixel_y + pixel_x;
         if (pixel_x >= m_vulkan_rhi->m_swapchain_extent.width || pixel_y >= m_vulkan_rhi->m_swapchain_extent.height)
-            return 0;
+        {
+            m_completed_picks.emplace_back(std::move(callback), 0);
+            return;
+        }
 
+        // a newer click replaces the one not yet recorded
+        m_has_pending_pick      = true;
+        m_pending_pick_x        = pixel_x;
+        m_pending_pick_y        = pixel_y;
+        m_pending_pick_callback = std::move(callback);
+    }
+    void PickPass::readbackPick(uint32_t frame_index)
+    {
+        if (m_readback_callbacks[frame_index])
+        {
+            m_completed_picks.emplace_back(std::move(m_readback_callbacks[frame_index]), m_readback_data[frame_index]);
+            m_readback_callbacks[frame_index] = nullptr;
+        }
+    }
+    void PickPass::drawPick(uint32_t pixel_x, uint32_t pixel_y)
+    {
         struct MeshNode
         {
             const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
+            uint32_t         joint_matrix_offset {0};
+            bool             enable_vertex_blending {false};
             uint32_t         node_id;
         };
 
@@ -458,101 +564,46 @@ namespace Piccolo
             temp.node_id      = node.node_id;
             if (node.ref_mesh->enable_vertex_blending)
             {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
+                temp.joint_matrix_offset    = node.joint_matrix_offset;
+                temp.enable_vertex_blending = node.joint_count > 0;
             }
 
             model_nodes.push_back(temp);
         }
 
-        // reset storage buffer offset
-        m_global_render_resource->_storage_buffer
-            ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index] =
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_begin[*m_vulkan_rhi->m_p_current_frame_index];
-
-        VkResult res_wait_for_fences =
-            vkWaitForFences(m_vulkan_rhi->m_device,
-                            1,
-                            &m_vulkan_rhi->m_is_frame_in_flight_fences[*m_vulkan_rhi->m_p_current_frame_index],
-                            VK_TRUE,
-                            UINT64_MAX);
-        assert(VK_SUCCESS == res_wait_for_fences);
-
-        VkResult res_reset_command_pool = m_vulkan_rhi->m_vk_reset_command_pool(
-            m_vulkan_rhi->m_device, m_vulkan_rhi->m_p_command_pools[*m_vulkan_rhi->m_p_current_frame_index], 0);
-        assert(VK_SUCCESS == res_reset_command_pool);
-
-        VkCommandBufferBeginInfo command_buffer_begin_info {};
-        command_buffer_begin_info.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        command_buffer_begin_info.flags            = 0;
-        command_buffer_begin_info.pInheritanceInfo = nullptr;
-
-        VkResult res_begin_command_buffer = m_vulkan_rhi->m_vk_begin_command_buffer(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], &command_buffer_begin_info);
-        assert(VK_SUCCESS == res_begin_command_buffer);
-
-        {
-            VkImageMemoryBarrier transfer_to_render_barrier {};
-            transfer_to_render_barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            transfer_to_render_barrier.pNext               = nullptr;
-            transfer_to_render_barrier.srcAccessMask       = 0;
-            transfer_to_render_barrier.dstAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-            transfer_to_render_barrier.oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
-            transfer_to_render_barrier.newLayout           = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-            transfer_to_render_barrier.srcQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
-            transfer_to_render_barrier.dstQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
-            transfer_to_render_barrier.image               = m_framebuffer.attachments[0].image;
-            transfer_to_render_barrier.subresourceRange    = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-            vkCmdPipelineBarrier(m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                 0,
-                                 0,
-                                 nullptr,
-                                 0,
-                                 nullptr,
-                                 1,
-                                 &transfer_to_render_barrier);
-        }
+        VkCommandBuffer command_buffer = m_vulkan_rhi->m_current_command_buffer;
 
-        m_vulkan_rhi->m_vk_cmd_set_viewport(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], 0, 1, &m_vulkan_rhi->m_viewport);
-        m_vulkan_rhi->m_vk_cmd_set_scissor(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], 0, 1, &m_vulkan_rhi->m_scissor);
+        // the viewport is shifted so that only the picked pixel lands in the 1x1 framebuffer
+        VkViewport viewport = m_vulkan_rhi->m_viewport;
+        viewport.x -= static_cast<float>(pixel_x);
+        viewport.y -= static_cast<float>(pixel_y);
+        VkRect2D scissor = {{0, 0}, {1, 1}};
 
         VkRenderPassBeginInfo renderpass_begin_info {};
         renderpass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
         renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
         renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
         renderpass_begin_info.renderArea.offset = {0, 0};
-        renderpass_begin_info.renderArea.extent = m_vulkan_rhi->m_swapchain_extent;
+        renderpass_begin_info.renderArea.extent = {1, 1};
 
         VkClearColorValue color_value         = {0, 0, 0, 0};
         VkClearValue      clearValues[2]      = {color_value, {1.0f, 0}};
         renderpass_begin_info.clearValueCount = 2;
         renderpass_begin_info.pClearValues    = clearValues;
 
-        m_vulkan_rhi->m_vk_cmd_begin_render_pass(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-            &renderpass_begin_info,
-            VK_SUBPASS_CONTENTS_INLINE); // no second buffer
+        m_vulkan_rhi->m_vk_cmd_begin_render_pass(command_buffer, &renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
             VkDebugUtilsLabelEXT label_info = {
                 VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Mesh Inefficient Pick", {1.0f, 1.0f, 1.0f, 1.0f}};
-            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(
-                m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], &label_info);
+            m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
         }
 
-        m_vulkan_rhi->m_vk_cmd_bind_pipeline(m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                                             VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                             m_render_pipelines[0].pipeline);
-        m_vulkan_rhi->m_vk_cmd_set_viewport(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], 0, 1, &m_vulkan_rhi->m_viewport);
-        m_vulkan_rhi->m_vk_cmd_set_scissor(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index], 0, 1, &m_vulkan_rhi->m_scissor);
+        m_vulkan_rhi->m_vk_cmd_bind_pipeline(
+            command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[0].pipeline);
+        m_vulkan_rhi->m_vk_cmd_set_viewport(command_buffer, 0, 1, &viewport);
+        m_vulkan_rhi->m_vk_cmd_set_scissor(command_buffer, 0, 1, &scissor);
 
         // perframe storage buffer
         uint32_t perframe_dynamic_offset =
@@ -590,29 +641,20 @@ namespace Piccolo
                 if (total_instance_count > 0)
                 {
                     // bind per mesh
-                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                        m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                        VK_PIPELINE_BIND_POINT_GRAPHICS,
-                        m_render_pipelines[0].layout,
-                        1,
-                        1,
-                        &mesh.mesh_vertex_blending_descriptor_set,
-                        0,
-                        NULL);
+                    m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
+                                                                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                                m_render_pipelines[0].layout,
+                                                                1,
+                                                                1,
+                                                                &mesh.mesh_vertex_blending_descriptor_set,
+                                                                0,
+                                                                NULL);
 
                     VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer};
                     VkDeviceSize offsets[]        = {0};
-                    m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(
-                        m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                        0,
-                        1,
-                        vertex_buffers,
-                        offsets);
+                    m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(command_buffer, 0, 1, vertex_buffers, offsets);
                     m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
-                        m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                        mesh.mesh_index_buffer,
-                        0,
-                        VK_INDEX_TYPE_UINT16);
+                        command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT16);
 
                     uint32_t drawcall_max_instance_count =
                         (sizeof(MeshInefficientPickPerdrawcallStorageBufferObject::model_matrices) /
@@ -650,76 +692,35 @@ namespace Piccolo
                                 perdrawcall_dynamic_offset));
                         for (uint32_t i = 0; i < current_instance_count; ++i)
                         {
-                            perdrawcall_storage_buffer_object.model_matrices[i] =
-                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                            perdrawcall_storage_buffer_object.node_ids[i] =
-                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].node_id;
+                            const MeshNode& mesh_node = mesh_nodes[drawcall_max_instance_count * drawcall_index + i];
+                            perdrawcall_storage_buffer_object.model_matrices[i] = *mesh_node.model_matrix;
+                            perdrawcall_storage_buffer_object.node_ids[i]       = mesh_node.node_id;
+                            perdrawcall_storage_buffer_object.enable_vertex_blendings[i] =
+                                mesh_node.enable_vertex_blending ? 1.0 : -1.0;
+                            perdrawcall_storage_buffer_object.joint_matrix_offsets[i] = mesh_node.joint_matrix_offset;
                         }
 
-                        // per drawcall vertex blending storage buffer
-                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                        if (mesh.enable_vertex_blending)
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[*m_vulkan_rhi->m_p_current_frame_index] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[*m_vulkan_rhi->m_p_current_frame_index] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[*m_vulkan_rhi->m_p_current_frame_index]));
-
-                            MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject&
-                                per_drawcall_vertex_blending_storage_buffer_object =
-                                    (*reinterpret_cast<
-                                        MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        per_drawcall_vertex_blending_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                for (uint32_t j = 0;
-                                     j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                     ++j)
-                                {
-                                    per_drawcall_vertex_blending_storage_buffer_object
-                                        .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                        mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices[j];
-                                }
-                            }
-                        }
-                        else
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset = 0;
-                        }
+                        // the joint palette of this frame was written once and is shared by every pass
+                        uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                            m_global_render_resource->_storage_buffer.getJointPaletteDynamicOffset(
+                                *m_vulkan_rhi->m_p_current_frame_index);
 
                         // bind perdrawcall
                         uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
                                                        perdrawcall_dynamic_offset,
                                                        per_drawcall_vertex_blending_dynamic_offset};
-                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                            VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            m_render_pipelines[0].layout,
-                            0,
-                            1,
-                            &m_descriptor_infos[0].descriptor_set,
-                            sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0]),
-                            dynamic_offsets);
+                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
+                                                                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                                    m_render_pipelines[0].layout,
+                                                                    0,
+                                                                    1,
+                                                                    &m_descriptor_infos[0].descriptor_set,
+                                                                    sizeof(dynamic_offsets) /
+                                                                        sizeof(dynamic_offsets[0]),
+                                                                    dynamic_offsets);
 
                         m_vulkan_rhi->m_vk_cmd_draw_indexed(
-                            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index],
-                            mesh.mesh_index_count,
-                            current_instance_count,
-                            0,
-                            0,
-                            0);
+                            command_buffer, mesh.mesh_index_count, current_instance_count, 0, 0, 0);
                     }
                 }
             }
@@ -727,57 +728,17 @@ namespace Piccolo
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
-            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(
-                m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index]);
+            m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
         }
 
         // end render pass
-        m_vulkan_rhi->m_vk_cmd_end_render_pass(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index]);
-
-        // end command buffer
-        VkResult res_end_command_buffer = m_vulkan_rhi->m_vk_end_command_buffer(
-            m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index]);
-        assert(VK_SUCCESS == res_end_command_buffer);
-
-        VkResult res_reset_fences = m_vulkan_rhi->m_vk_reset_fences(
-            m_vulkan_rhi->m_device,
-            1,
-            &m_vulkan_rhi->m_is_frame_in_flight_fences[*m_vulkan_rhi->m_p_current_frame_index]);
-        assert(VK_SUCCESS == res_reset_fences);
-
-        VkSubmitInfo submit_info         = {};
-        submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.waitSemaphoreCount   = 0;
-        submit_info.pWaitSemaphores      = NULL;
-        submit_info.pWaitDstStageMask    = 0;
-        submit_info.commandBufferCount   = 1;
-        submit_info.pCommandBuffers      = &m_vulkan_rhi->m_p_command_buffers[*m_vulkan_rhi->m_p_current_frame_index];
-        submit_info.signalSemaphoreCount = 0;
-        submit_info.pSignalSemaphores    = NULL;
-
-        VkResult res_queue_submit =
-            vkQueueSubmit(m_vulkan_rhi->m_graphics_queue,
-                          1,
-                          &submit_info,
-                          m_vulkan_rhi->m_is_frame_in_flight_fences[*m_vulkan_rhi->m_p_current_frame_index]);
-        assert(VK_SUCCESS == res_queue_submit);
-
-        auto new_index = (*m_vulkan_rhi->m_p_current_frame_index + 1) % m_vulkan_rhi->s_max_frames_in_flight;
-        *m_vulkan_rhi->m_p_current_frame_index = new_index;
-
-        // implicit host read barrier
-        res_wait_for_fences = m_vulkan_rhi->m_vk_wait_for_fences(m_vulkan_rhi->m_device,
-                                                                 m_vulkan_rhi->s_max_frames_in_flight,
-                                                                 m_vulkan_rhi->m_is_frame_in_flight_fences,
-                                                                 VK_TRUE,
-                                                                 UINT64_MAX);
-        assert(VK_SUCCESS == res_wait_for_fences);
-
-        auto command_buffer = m_vulkan_rhi->beginSingleTimeCommands();
+        m_vulkan_rhi->m_vk_cmd_end_render_pass(command_buffer);
+
+        // copy the id to the readback slot of this frame, it is read once the frame's fence signaled
+        uint32_t frame_index = m_vulkan_rhi->m_current_frame_index;
 
         VkBufferImageCopy region {};
-        region.bufferOffset                    = 0;
+        region.bufferOffset                    = sizeof(uint32_t) * frame_index;
         region.bufferRowLength                 = 0;
         region.bufferImageHeight               = 0;
         region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -785,76 +746,33 @@ namespace Piccolo
         region.imageSubresource.baseArrayLayer = 0;
         region.imageSubresource.layerCount     = 1;
         region.imageOffset                     = {0, 0, 0};
-        region.imageExtent = {m_vulkan_rhi->m_swapchain_extent.width, m_vulkan_rhi->m_swapchain_extent.height, 1};
-
-        uint32_t buffer_size = m_vulkan_rhi->m_swapchain_extent.width * m_vulkan_rhi->m_swapchain_extent.height * 4;
-        VkBuffer inefficient_staging_buffer;
-        VkDeviceMemory inefficient_staging_buffer_memory;
-        VulkanUtil::createBuffer(m_vulkan_rhi->m_physical_device,
-                                 m_vulkan_rhi->m_device,
-                                 buffer_size,
-                                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                 inefficient_staging_buffer,
-                                 inefficient_staging_buffer_memory);
-
-        VkImageMemoryBarrier copy_to_buffer_barrier {};
-        copy_to_buffer_barrier.sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-        copy_to_buffer_barrier.pNext               = nullptr;
-        copy_to_buffer_barrier.srcAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-        copy_to_buffer_barrier.dstAccessMask       = VK_ACCESS_TRANSFER_READ_BIT;
-        copy_to_buffer_barrier.oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        copy_to_buffer_barrier.newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-        copy_to_buffer_barrier.srcQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
-        copy_to_buffer_barrier.dstQueueFamilyIndex = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
-        copy_to_buffer_barrier.image               = m_framebuffer.attachments[0].image;
-        copy_to_buffer_barrier.subresourceRange    = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-        vkCmdPipelineBarrier(command_buffer,
-                             VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                             VK_PIPELINE_STAGE_TRANSFER_BIT,
-                             0,
-                             0,
-                             nullptr,
-                             0,
-                             nullptr,
-                             1,
-                             &copy_to_buffer_barrier);
+        region.imageExtent                     = {1, 1, 1};
 
         vkCmdCopyImageToBuffer(command_buffer,
                                m_framebuffer.attachments[0].image,
                                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                               inefficient_staging_buffer,
+                               m_readback_buffer,
                                1,
                                &region);
 
-        m_vulkan_rhi->endSingleTimeCommands(command_buffer);
-
-        uint32_t* data = nullptr;
-        vkMapMemory(m_vulkan_rhi->m_device, inefficient_staging_buffer_memory, 0, buffer_size, 0, (void**)&data);
-
-#if 0
-        auto                 w = _rhi->_swapchain_extent.width;
-        auto                 h = _rhi->_swapchain_extent.height;
-        std::vector<uint8_t> image_data(w * h * 4);
-        for (int i = 0; i < h; i++)
-        {
-            for (int j = 0; j < w; j++)
-            {
-                image_data[4 * (i * w + j) + 0] = data[i * w + j];
-                image_data[4 * (i * w + j) + 1] = 0;
-                image_data[4 * (i * w + j) + 2] = 0;
-                image_data[4 * (i * w + j) + 3] = 0xFF;
-            }
-        }
-        stbi_write_png("pick.png", w, h, 4, image_data.data(), w * 4);
-#endif
-
-        uint32_t node_id = data[picked_pixel_index];
-        vkUnmapMemory(m_vulkan_rhi->m_device, inefficient_staging_buffer_memory);
-
-        vkDestroyBuffer(m_vulkan_rhi->m_device, inefficient_staging_buffer, nullptr);
-        vkFreeMemory(m_vulkan_rhi->m_device, inefficient_staging_buffer_memory, nullptr);
-
-        return node_id;
+        VkBufferMemoryBarrier host_read_barrier {};
+        host_read_barrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        host_read_barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+        host_read_barrier.dstAccessMask       = VK_ACCESS_HOST_READ_BIT;
+        host_read_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        host_read_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        host_read_barrier.buffer              = m_readback_buffer;
+        host_read_barrier.offset              = region.bufferOffset;
+        host_read_barrier.size                = sizeof(uint32_t);
+        vkCmdPipelineBarrier(command_buffer,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_HOST_BIT,
+                             0,
+                             0,
+                             nullptr,
+                             1,
+                             &host_read_barrier,
+                             0,
+                             nullptr);
     }
 } // namespace Piccolo
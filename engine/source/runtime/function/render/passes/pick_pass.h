@@ -3,6 +3,10 @@
 #include "runtime/core/math/vector2.h"
 #include "runtime/function/render/render_pass.h"
 
+#include <functional>
+#include <utility>
+#include <vector>
+
 namespace Piccolo
 {
     class RenderResourceBase;
@@ -12,6 +16,9 @@ namespace Piccolo
         VkDescriptorSetLayout per_mesh_layout;
     };
 
+    // receives the node id under the picked pixel, 0 when nothing was hit
+    using PickCallback = std::function<void(uint32_t)>;
+
     class PickPass : public RenderPass
     {
     public:
@@ -20,8 +27,9 @@ namespace Piccolo
         void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
         void draw() override final;
 
-        uint32_t pick(const Vector2& picked_uv);
-        void     recreateFramebuffer();
+        // the id is rendered for the picked pixel only with the next frame and read back once that frame has
+        // finished, the callback runs in a later preparePassData so picking never waits for the gpu
+        void requestPick(const Vector2& picked_uv, PickCallback callback);
 
         MeshInefficientPickPerframeStorageBufferObject _mesh_inefficient_pick_perframe_storage_buffer_object;
 
@@ -32,6 +40,10 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
+        void setupReadbackBuffer();
+
+        void drawPick(uint32_t pixel_x, uint32_t pixel_y);
+        void readbackPick(uint32_t frame_index);
 
     private:
         VkImage        _object_id_image {VK_NULL_HANDLE};
@@ -39,5 +51,18 @@ namespace Piccolo
         VkImageView    _object_id_image_view {VK_NULL_HANDLE};
 
         VkDescriptorSetLayout _per_mesh_layout {VK_NULL_HANDLE};
+
+        bool         m_has_pending_pick {false};
+        uint32_t     m_pending_pick_x {0};
+        uint32_t     m_pending_pick_y {0};
+        PickCallback m_pending_pick_callback;
+
+        // one slot per frame in flight, written by the frame recorded with that index
+        VkBuffer                  m_readback_buffer {VK_NULL_HANDLE};
+        VkDeviceMemory            m_readback_buffer_memory {VK_NULL_HANDLE};
+        uint32_t*                 m_readback_data {nullptr};
+        std::vector<PickCallback> m_readback_callbacks;
+
+        std::vector<std::pair<PickCallback, uint32_t>> m_completed_picks;
     };
 } // namespace Piccolo
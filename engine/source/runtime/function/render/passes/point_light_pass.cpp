@@ -38,8 +38,23 @@ namespace Piccolo
                 vulkan_resource->m_mesh_point_light_shadow_perframe_storage_buffer_object;
         }
     }
+    void PointLightShadowPass::recordSecondaryCommandBuffer(uint32_t thread_index)
+    {
+        m_secondary_command_buffer = m_vulkan_rhi->beginSecondaryCommandBuffer(
+            thread_index, m_framebuffer.render_pass, 0, m_framebuffer.framebuffer);
+
+        drawModel(m_secondary_command_buffer);
+
+        m_vulkan_rhi->endSecondaryCommandBuffer(m_secondary_command_buffer);
+    }
     void PointLightShadowPass::draw()
     {
+        // every cached layer is still valid
+        if (m_mesh_point_light_shadow_perframe_storage_buffer_object.point_light_layer_mask == 0)
+        {
+            return;
+        }
+
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
             VkDebugUtilsLabelEXT label_info = {
@@ -47,7 +62,24 @@ namespace Piccolo
             m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
         }
 
-        drawModel();
+        VkRenderPassBeginInfo renderpass_begin_info {};
+        renderpass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
+        renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
+        renderpass_begin_info.renderArea.offset = {0, 0};
+        renderpass_begin_info.renderArea.extent = {s_point_light_shadow_map_dimension,
+                                                   s_point_light_shadow_map_dimension};
+
+        // the layers that are redrawn are cleared in drawModel
+        renderpass_begin_info.clearValueCount = 0;
+        renderpass_begin_info.pClearValues    = nullptr;
+
+        // the draws were recorded by recordSecondaryCommandBuffer, possibly on another thread
+        m_vulkan_rhi->m_vk_cmd_begin_render_pass(m_vulkan_rhi->m_current_command_buffer,
+                                                 &renderpass_begin_info,
+                                                 VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        m_vulkan_rhi->m_vk_cmd_execute_commands(m_vulkan_rhi->m_current_command_buffer, 1, &m_secondary_command_buffer);
+        m_vulkan_rhi->m_vk_cmd_end_render_pass(m_vulkan_rhi->m_current_command_buffer);
 
         if (m_vulkan_rhi->isDebugLabelEnabled())
         {
@@ -82,6 +114,15 @@ namespace Piccolo
                                                                         2 * s_max_point_light_count,
                                                                         1);
 
+        // the layers of the lights that did not change are loaded, so the cache lives in the sampled layout
+        VulkanUtil::transitionImageLayout(m_vulkan_rhi.get(),
+                                          m_framebuffer.attachments[0].image,
+                                          VK_IMAGE_LAYOUT_UNDEFINED,
+                                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                          2 * s_max_point_light_count,
+                                          1,
+                                          VK_IMAGE_ASPECT_COLOR_BIT);
+
         // depth
         m_framebuffer.attachments[1].format = m_vulkan_rhi->m_depth_image_format;
         VulkanUtil::createImage(m_vulkan_rhi->m_physical_device,
@@ -112,17 +153,17 @@ namespace Piccolo
         VkAttachmentDescription& point_light_shadow_color_attachment_description = attachments[0];
         point_light_shadow_color_attachment_description.format                   = m_framebuffer.attachments[0].format;
         point_light_shadow_color_attachment_description.samples                  = VK_SAMPLE_COUNT_1_BIT;
-        point_light_shadow_color_attachment_description.loadOp                   = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        point_light_shadow_color_attachment_description.loadOp                   = VK_ATTACHMENT_LOAD_OP_LOAD;
         point_light_shadow_color_attachment_description.storeOp                  = VK_ATTACHMENT_STORE_OP_STORE;
         point_light_shadow_color_attachment_description.stencilLoadOp            = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         point_light_shadow_color_attachment_description.stencilStoreOp           = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-        point_light_shadow_color_attachment_description.initialLayout            = VK_IMAGE_LAYOUT_UNDEFINED;
-        point_light_shadow_color_attachment_description.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        point_light_shadow_color_attachment_description.initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        point_light_shadow_color_attachment_description.finalLayout   = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
         VkAttachmentDescription& point_light_shadow_depth_attachment_description = attachments[1];
         point_light_shadow_depth_attachment_description.format                   = m_framebuffer.attachments[1].format;
         point_light_shadow_depth_attachment_description.samples                  = VK_SAMPLE_COUNT_1_BIT;
-        point_light_shadow_depth_attachment_description.loadOp                   = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        point_light_shadow_depth_attachment_description.loadOp                   = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         point_light_shadow_depth_attachment_description.storeOp                  = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         point_light_shadow_depth_attachment_description.stencilLoadOp            = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         point_light_shadow_depth_attachment_description.stencilStoreOp           = VK_ATTACHMENT_STORE_OP_DONT_CARE;
@@ -147,9 +188,22 @@ namespace Piccolo
         shadow_pass.pColorAttachments       = &shadow_pass_color_attachment_reference;
         shadow_pass.pDepthStencilAttachment = &shadow_pass_depth_attachment_reference;
 
-        VkSubpassDependency dependencies[1] = {};
-
-        VkSubpassDependency& lighting_pass_dependency = dependencies[0];
+        VkSubpassDependency dependencies[2] = {};
+
+        // the previous frame's lighting has finished reading the layers that are redrawn
+        VkSubpassDependency& previous_lighting_pass_dependency = dependencies[0];
+        previous_lighting_pass_dependency.srcSubpass           = VK_SUBPASS_EXTERNAL;
+        previous_lighting_pass_dependency.dstSubpass           = 0;
+        previous_lighting_pass_dependency.srcStageMask         = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        previous_lighting_pass_dependency.dstStageMask =
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        previous_lighting_pass_dependency.srcAccessMask = 0;
+        previous_lighting_pass_dependency.dstAccessMask =
+            VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+            VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        previous_lighting_pass_dependency.dependencyFlags = 0;
+
+        VkSubpassDependency& lighting_pass_dependency = dependencies[1];
         lighting_pass_dependency.srcSubpass           = 0;
         lighting_pass_dependency.dstSubpass           = VK_SUBPASS_EXTERNAL;
         lighting_pass_dependency.srcStageMask         = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
@@ -388,9 +442,12 @@ namespace Piccolo
         pipelineInfo.basePipelineHandle  = VK_NULL_HANDLE;
         pipelineInfo.pDynamicState       = &dynamic_state_create_info;
 
-        if (vkCreateGraphicsPipelines(
-                m_vulkan_rhi->m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_render_pipelines[0].pipeline) !=
-            VK_SUCCESS)
+        if (vkCreateGraphicsPipelines(m_vulkan_rhi->m_device,
+                                      m_vulkan_rhi->m_pipeline_cache,
+                                      1,
+                                      &pipelineInfo,
+                                      nullptr,
+                                      &m_render_pipelines[0].pipeline) != VK_SUCCESS)
         {
             throw std::runtime_error("create mesh point light shadow graphics pipeline");
         }
@@ -438,9 +495,9 @@ namespace Piccolo
         VkDescriptorBufferInfo mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info = {};
         mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.offset                 = 0;
         mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.range =
-            sizeof(MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject);
+            sizeof(MeshJointPaletteStorageBufferObject);
         mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.buffer =
-            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+            m_global_render_resource->_storage_buffer._joint_palette_buffer;
         assert(mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.range <
                m_global_render_resource->_storage_buffer._max_storage_buffer_range);
 
@@ -492,13 +549,19 @@ namespace Piccolo
                                0,
                                NULL);
     }
-    void PointLightShadowPass::drawModel()
+    void PointLightShadowPass::drawModel(VkCommandBuffer command_buffer)
     {
+        uint32_t layer_mask = m_mesh_point_light_shadow_perframe_storage_buffer_object.point_light_layer_mask;
+        if (layer_mask == 0)
+        {
+            return;
+        }
+
         struct MeshNode
         {
             const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
+            uint32_t         joint_matrix_offset {0};
+            bool             enable_vertex_blending {false};
         };
 
         std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> point_lights_mesh_drawcall_batch;
@@ -513,57 +576,58 @@ namespace Piccolo
             temp.model_matrix = node.model_matrix;
             if (node.enable_vertex_blending)
             {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
+                temp.joint_matrix_offset    = node.joint_matrix_offset;
+                temp.enable_vertex_blending = node.joint_count > 0;
             }
 
             mesh_nodes.push_back(temp);
         }
 
-        VkRenderPassBeginInfo renderpass_begin_info {};
-        renderpass_begin_info.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderpass_begin_info.renderPass        = m_framebuffer.render_pass;
-        renderpass_begin_info.framebuffer       = m_framebuffer.framebuffer;
-        renderpass_begin_info.renderArea.offset = {0, 0};
-        renderpass_begin_info.renderArea.extent = {s_point_light_shadow_map_dimension,
-                                                   s_point_light_shadow_map_dimension};
-
-        VkClearValue clear_values[2];
-        clear_values[0].color                 = {1.0f};
-        clear_values[1].depthStencil          = {1.0f, 0};
-        renderpass_begin_info.clearValueCount = (sizeof(clear_values) / sizeof(clear_values[0]));
-        renderpass_begin_info.pClearValues    = clear_values;
-
-        m_vulkan_rhi->m_vk_cmd_begin_render_pass(
-            m_vulkan_rhi->m_current_command_buffer, &renderpass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
-
         if (m_vulkan_rhi->isPointLightShadowEnabled())
         {
             if (m_vulkan_rhi->isDebugLabelEnabled())
             {
                 VkDebugUtilsLabelEXT label_info = {
                     VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT, NULL, "Mesh", {1.0f, 1.0f, 1.0f, 1.0f}};
-                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer, &label_info);
+                m_vulkan_rhi->m_vk_cmd_begin_debug_utils_label_ext(command_buffer, &label_info);
             }
 
-            m_vulkan_rhi->m_vk_cmd_bind_pipeline(m_vulkan_rhi->m_current_command_buffer,
+            m_vulkan_rhi->m_vk_cmd_bind_pipeline(command_buffer,
                                                  VK_PIPELINE_BIND_POINT_GRAPHICS,
                                                  m_render_pipelines[0].pipeline);
 
+            // the redrawn layers start empty, the others keep their cached shadow
+            VkClearAttachment clear_attachments[2] = {};
+            clear_attachments[0].aspectMask              = VK_IMAGE_ASPECT_COLOR_BIT;
+            clear_attachments[0].colorAttachment         = 0;
+            clear_attachments[0].clearValue.color        = {1.0f};
+            clear_attachments[1].aspectMask              = VK_IMAGE_ASPECT_DEPTH_BIT;
+            clear_attachments[1].clearValue.depthStencil = {1.0f, 0};
+
+            VkRect2D layer_rect = {{0, 0}, {s_point_light_shadow_map_dimension, s_point_light_shadow_map_dimension}};
+
+            std::vector<VkClearRect> clear_rects;
+            for (uint32_t layer_index = 0; layer_index < 2 * s_max_point_light_count; ++layer_index)
+            {
+                if ((layer_mask & (1u << layer_index)) != 0)
+                {
+                    VkClearRect clear_rect {};
+                    clear_rect.rect           = layer_rect;
+                    clear_rect.baseArrayLayer = layer_index;
+                    clear_rect.layerCount     = 1;
+                    clear_rects.push_back(clear_rect);
+                }
+            }
+            m_vulkan_rhi->m_vk_cmd_clear_attachments(command_buffer,
+                                                     sizeof(clear_attachments) / sizeof(clear_attachments[0]),
+                                                     clear_attachments,
+                                                     static_cast<uint32_t>(clear_rects.size()),
+                                                     clear_rects.data());
+
             // perframe storage buffer
             uint32_t perframe_dynamic_offset =
-                roundUp(m_global_render_resource->_storage_buffer
-                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-            m_global_render_resource->_storage_buffer
-                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                perframe_dynamic_offset + sizeof(MeshPerframeStorageBufferObject);
-            assert(m_global_render_resource->_storage_buffer
-                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                   (m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                    m_global_render_resource->_storage_buffer
-                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                m_global_render_resource->_storage_buffer.allocateFromRingBuffer(
+                    m_vulkan_rhi->m_current_frame_index, sizeof(MeshPerframeStorageBufferObject));
 
             MeshPointLightShadowPerframeStorageBufferObject& perframe_storage_buffer_object =
                 (*reinterpret_cast<MeshPointLightShadowPerframeStorageBufferObject*>(
@@ -588,7 +652,7 @@ namespace Piccolo
                     if (total_instance_count > 0)
                     {
                         // bind per mesh
-                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(m_vulkan_rhi->m_current_command_buffer,
+                        m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(command_buffer,
                                                                     VK_PIPELINE_BIND_POINT_GRAPHICS,
                                                                     m_render_pipelines[0].layout,
                                                                     1,
@@ -599,10 +663,9 @@ namespace Piccolo
 
                         VkBuffer     vertex_buffers[] = {mesh.mesh_vertex_position_buffer};
                         VkDeviceSize offsets[]        = {0};
-                        m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(
-                            m_vulkan_rhi->m_current_command_buffer, 0, 1, vertex_buffers, offsets);
+                        m_vulkan_rhi->m_vk_cmd_bind_vertex_buffers(command_buffer, 0, 1, vertex_buffers, offsets);
                         m_vulkan_rhi->m_vk_cmd_bind_index_buffer(
-                            m_vulkan_rhi->m_current_command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT16);
+                            command_buffer, mesh.mesh_index_buffer, 0, VK_INDEX_TYPE_UINT16);
 
                         uint32_t drawcall_max_instance_count =
                             (sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
@@ -620,18 +683,9 @@ namespace Piccolo
 
                             // perdrawcall storage buffer
                             uint32_t perdrawcall_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                perdrawcall_dynamic_offset + sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
+                                m_global_render_resource->_storage_buffer.allocateFromRingBuffer(
+                                    m_vulkan_rhi->m_current_frame_index,
+                                    sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject));
 
                             MeshPointLightShadowPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
                                 (*reinterpret_cast<MeshPointLightShadowPerdrawcallStorageBufferObject*>(
@@ -640,76 +694,27 @@ namespace Piccolo
                                     perdrawcall_dynamic_offset));
                             for (uint32_t i = 0; i < current_instance_count; ++i)
                             {
+                                const MeshNode& mesh_node =
+                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i];
                                 perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                    *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
+                                    *mesh_node.model_matrix;
                                 perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                                  -1.0;
+                                    mesh_node.enable_vertex_blending ? 1.0 : -1.0;
+                                perdrawcall_storage_buffer_object.mesh_instances[i].joint_matrix_offset =
+                                    mesh_node.joint_matrix_offset;
                             }
 
-                            // per drawcall vertex blending storage buffer
-                            uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                            bool     least_one_enable_vertex_blending = true;
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    least_one_enable_vertex_blending = false;
-                                    break;
-                                }
-                            }
-                            if (mesh.enable_vertex_blending)
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = roundUp(
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] =
-                                    per_drawcall_vertex_blending_dynamic_offset +
-                                    sizeof(MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject);
-                                assert(m_global_render_resource->_storage_buffer
-                                           ._global_upload_ringbuffers_end[m_vulkan_rhi->m_current_frame_index] <=
-                                       (m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_begin[m_vulkan_rhi->m_current_frame_index] +
-                                        m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_size[m_vulkan_rhi->m_current_frame_index]));
-
-                                MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject&
-                                    per_drawcall_vertex_blending_storage_buffer_object =
-                                        (*reinterpret_cast<
-                                            MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject*>(
-                                            reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                            ._global_upload_ringbuffer_memory_pointer) +
-                                            per_drawcall_vertex_blending_dynamic_offset));
-                                for (uint32_t i = 0; i < current_instance_count; ++i)
-                                {
-                                    if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                    {
-                                        for (uint32_t j = 0;
-                                             j <
-                                             mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                             ++j)
-                                        {
-                                            per_drawcall_vertex_blending_storage_buffer_object
-                                                .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                    .joint_matrices[j];
-                                        }
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = 0;
-                            }
+                            // the joint palette of this frame was written once and is shared by every pass
+                            uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                                m_global_render_resource->_storage_buffer.getJointPaletteDynamicOffset(
+                                    m_vulkan_rhi->m_current_frame_index);
 
                             // bind perdrawcall
                             uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
                                                            perdrawcall_dynamic_offset,
                                                            per_drawcall_vertex_blending_dynamic_offset};
                             m_vulkan_rhi->m_vk_cmd_bind_descriptor_sets(
-                                m_vulkan_rhi->m_current_command_buffer,
+                                command_buffer,
                                 VK_PIPELINE_BIND_POINT_GRAPHICS,
                                 m_render_pipelines[0].layout,
                                 0,
@@ -718,7 +723,7 @@ namespace Piccolo
                                 (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
                                 dynamic_offsets);
 
-                            m_vulkan_rhi->m_vk_cmd_draw_indexed(m_vulkan_rhi->m_current_command_buffer,
+                            m_vulkan_rhi->m_vk_cmd_draw_indexed(command_buffer,
                                                                 mesh.mesh_index_count,
                                                                 current_instance_count,
                                                                 0,
@@ -731,11 +736,9 @@ namespace Piccolo
 
             if (m_vulkan_rhi->isDebugLabelEnabled())
             {
-                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(m_vulkan_rhi->m_current_command_buffer);
+                m_vulkan_rhi->m_vk_cmd_end_debug_utils_label_ext(command_buffer);
             }
         }
-
-        m_vulkan_rhi->m_vk_cmd_end_render_pass(m_vulkan_rhi->m_current_command_buffer);
     }
 
 } // namespace Piccolo
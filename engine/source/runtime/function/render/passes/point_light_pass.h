@@ -14,6 +14,9 @@ namespace Piccolo
         void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
         void draw() override final;
 
+        // records the shadow casters into this frame's secondary command buffer of the given recording thread
+        void recordSecondaryCommandBuffer(uint32_t thread_index);
+
         void setPerMeshLayout(const VkDescriptorSetLayout& layout) { m_per_mesh_layout = layout; }
 
     private:
@@ -23,10 +26,11 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
-        void drawModel();
+        void drawModel(VkCommandBuffer command_buffer);
 
     private:
         VkDescriptorSetLayout                           m_per_mesh_layout;
+        VkCommandBuffer                                 m_secondary_command_buffer {VK_NULL_HANDLE};
         MeshPointLightShadowPerframeStorageBufferObject m_mesh_point_light_shadow_perframe_storage_buffer_object;
     };
 } // namespace Piccolo
@@ -17,7 +17,9 @@ namespace Piccolo
     {
         RenderPass::initialize(nullptr);
 
-        m_framebuffer.render_pass = static_cast<const UIPassInitInfo*>(init_info)->render_pass;
+        const UIPassInitInfo* _init_info = static_cast<const UIPassInitInfo*>(init_info);
+        m_framebuffer.render_pass        = _init_info->render_pass;
+        m_subpass_index                  = _init_info->subpass_index;
     }
 
     void UIPass::initializeUIRenderBackend(WindowUI* window_ui)
@@ -32,7 +34,7 @@ namespace Piccolo
         init_info.QueueFamily               = m_vulkan_rhi->m_queue_indices.m_graphics_family.value();
         init_info.Queue                     = m_vulkan_rhi->m_graphics_queue;
         init_info.DescriptorPool            = m_vulkan_rhi->m_descriptor_pool;
-        init_info.Subpass                   = _main_camera_subpass_ui;
+        init_info.Subpass                   = m_subpass_index;
 
         // may be different from the real swapchain image count
         // see ImGui_ImplVulkanH_GetMinImageCountFromPresentMode
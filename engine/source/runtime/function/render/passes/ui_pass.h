@@ -9,6 +9,7 @@ namespace Piccolo
     struct UIPassInitInfo : RenderPassInitInfo
     {
         VkRenderPass render_pass;
+        uint32_t     subpass_index {_main_camera_subpass_ui};
     };
 
     class UIPass : public RenderPass
@@ -23,5 +24,6 @@ namespace Piccolo
 
     private:
         WindowUI* m_window_ui;
+        uint32_t  m_subpass_index {_main_camera_subpass_ui};
     };
 } // namespace Piccolo
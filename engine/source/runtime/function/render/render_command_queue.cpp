@@ -0,0 +1,109 @@
+#include "runtime/function/render/render_command_queue.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace Piccolo
+{
+    static_assert((RenderCommandQueue::s_capacity & (RenderCommandQueue::s_capacity - 1)) == 0,
+                  "the capacity of the render command queue must be a power of two");
+
+    RenderCommandQueue::RenderCommandQueue() : m_cells(new Cell[s_capacity])
+    {
+        // a cell is free for the producer whose position equals its sequence
+        for (size_t i = 0; i < s_capacity; ++i)
+        {
+            m_cells[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    void RenderCommandQueue::push(RenderCommand&& command)
+    {
+        // once a command overflowed, the later ones have to follow it
+        if (!m_has_overflow.load(std::memory_order_acquire) && tryPushToRing(command))
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock_guard(m_overflow_mutex);
+        // every ring slot this producer claimed before lies below the current enqueue position
+        m_overflow_ring_position =
+            std::max(m_overflow_ring_position, m_enqueue_position.load(std::memory_order_relaxed));
+        m_overflow_commands.push_back(std::move(command));
+        m_has_overflow.store(true, std::memory_order_release);
+    }
+
+    bool RenderCommandQueue::tryPushToRing(RenderCommand& command)
+    {
+        size_t position = m_enqueue_position.load(std::memory_order_relaxed);
+        Cell*  cell     = nullptr;
+        while (true)
+        {
+            cell                = &m_cells[position & (s_capacity - 1)];
+            size_t   sequence   = cell->m_sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0)
+            {
+                if (m_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                // the consumer has not freed this cell yet, the ring is full
+                return false;
+            }
+            else
+            {
+                position = m_enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->m_command = std::move(command);
+        cell->m_sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool RenderCommandQueue::tryPop(RenderCommand& command)
+    {
+        // overflowed commands taken out before were published before anything that entered the ring since
+        if (m_draining_overflow_index < m_draining_overflow_commands.size())
+        {
+            command = std::move(m_draining_overflow_commands[m_draining_overflow_index++]);
+            return true;
+        }
+
+        Cell&    cell       = m_cells[m_dequeue_position & (s_capacity - 1)];
+        size_t   sequence   = cell.m_sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(m_dequeue_position + 1);
+        if (difference == 0)
+        {
+            command = std::move(cell.m_command);
+            cell.m_sequence.store(m_dequeue_position + s_capacity, std::memory_order_release);
+            ++m_dequeue_position;
+            return true;
+        }
+
+        if (!m_has_overflow.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        m_draining_overflow_commands.clear();
+        {
+            std::lock_guard<std::mutex> lock_guard(m_overflow_mutex);
+            // a slot claimed before the overflow may still be written, its command has to come first
+            if (m_dequeue_position < m_overflow_ring_position)
+            {
+                return false;
+            }
+            std::swap(m_draining_overflow_commands, m_overflow_commands);
+            m_has_overflow.store(false, std::memory_order_release);
+        }
+
+        m_draining_overflow_index = 1;
+        command                   = std::move(m_draining_overflow_commands[0]);
+        return true;
+    }
+} // namespace Piccolo
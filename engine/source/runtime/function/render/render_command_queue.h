@@ -0,0 +1,77 @@
+#pragma once
+
+#include "runtime/core/math/matrix4.h"
+#include "runtime/function/framework/object/object_id_allocator.h"
+#include "runtime/function/render/render_object.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Piccolo
+{
+    enum class RenderCommandType : uint8_t
+    {
+        AddGameObjectPart,
+        UpdateTransform,
+        UpdateSkeleton,
+        RemoveGameObject
+    };
+
+    // a compact update of one game object part, only adding a part carries its asset paths
+    struct RenderCommand
+    {
+        RenderCommandType m_type {RenderCommandType::UpdateTransform};
+        GObjectID         m_go_id {k_invalid_gobject_id};
+        uint32_t          m_part_index {0};
+
+        // UpdateTransform
+        Matrix4x4 m_transform_matrix {Matrix4x4::IDENTITY};
+        // UpdateSkeleton
+        std::vector<Matrix4x4> m_joint_matrices;
+        // AddGameObjectPart
+        std::unique_ptr<GameObjectPartDesc> m_part_desc;
+    };
+
+    // Bounded multi-producer single-consumer ring, any thread may publish while the render thread drains it
+    // without locks. When the ring is full the commands go to an overflow list behind a mutex until it is
+    // drained, which only happens once the ring slots claimed before are drained, so the commands of one producer
+    // always arrive in the order they were published.
+    class RenderCommandQueue
+    {
+    public:
+        static constexpr size_t s_capacity = 1 << 14;
+
+        RenderCommandQueue();
+
+        void push(RenderCommand&& command);
+
+        // render thread only
+        bool tryPop(RenderCommand& command);
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> m_sequence {0};
+            RenderCommand       m_command;
+        };
+
+        bool tryPushToRing(RenderCommand& command);
+
+        std::unique_ptr<Cell[]> m_cells;
+
+        alignas(64) std::atomic<size_t> m_enqueue_position {0};
+        alignas(64) size_t m_dequeue_position {0};
+
+        alignas(64) std::atomic<bool> m_has_overflow {false};
+        std::mutex                 m_overflow_mutex;
+        std::vector<RenderCommand> m_overflow_commands;
+        // the ring is drained up to here before the overflowed commands
+        size_t                     m_overflow_ring_position {0};
+        std::vector<RenderCommand> m_draining_overflow_commands;
+        size_t                     m_draining_overflow_index {0};
+    };
+} // namespace Piccolo
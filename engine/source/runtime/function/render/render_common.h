@@ -9,10 +9,23 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <array>
+#include <vector>
+
 namespace Piccolo
 {
-    static const uint32_t s_point_light_shadow_map_dimension       = 2048;
-    static const uint32_t s_directional_light_shadow_map_dimension = 4096;
+    static const uint32_t s_point_light_shadow_map_dimension    = 2048;
+    static const uint32_t s_directional_light_cascade_count     = 4;
+    static const uint32_t s_directional_light_cascade_dimension = 2048;
+    // the directional light shadow map is an atlas with one column per cascade, the static casters are cached in
+    // the first row and the dynamic casters are drawn into the second
+    static const uint32_t s_directional_light_shadow_map_width =
+        s_directional_light_cascade_count * s_directional_light_cascade_dimension;
+    static const uint32_t s_directional_light_shadow_map_height = 2 * s_directional_light_cascade_dimension;
+    // blend of the logarithmic and the uniform cascade split, 1 is fully logarithmic
+    static const float s_directional_light_cascade_split_lambda = 0.75f;
+    // entities whose transform did not change for this many frames are cached as static shadow casters
+    static const uint32_t s_static_shadow_caster_frame_count = 60;
 
     // TODO: 64 may not be the best
     static uint32_t const s_mesh_per_drawcall_max_instance_count = 64;
@@ -20,6 +33,19 @@ namespace Piccolo
     static uint32_t const s_max_point_light_count                = 15;
     // should sync the macros in "shader_include/constants.h"
 
+    // capacity of the joint palette shared by all animated entities in one frame
+    static uint32_t const s_mesh_joint_palette_max_matrix_count =
+        s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count;
+
+    // dirty point light shadow layers redrawn per frame, every light owns two layers
+    static uint32_t const s_point_light_shadow_layer_budget = 8;
+    static_assert(2 * s_max_point_light_count <= 32, "the point light shadow layers are tracked in a 32 bit mask");
+
+    // capacities of the descriptor arrays used by the bindless mesh pipelines
+    static uint32_t const s_bindless_max_material_count             = 1024;
+    static uint32_t const s_bindless_max_vertex_blending_mesh_count = 1024;
+    static uint32_t const s_bindless_material_texture_count         = 5;
+
     struct VulkanSceneDirectionalLight
     {
         Vector3 direction;
@@ -49,15 +75,15 @@ namespace Piccolo
         uint32_t                    _padding_point_light_num_3;
         VulkanScenePointLight       scene_point_lights[s_max_point_light_count];
         VulkanSceneDirectionalLight scene_directional_light;
-        Matrix4x4                   directional_light_proj_view;
+        Matrix4x4                   directional_light_proj_view[s_directional_light_cascade_count];
     };
 
     struct VulkanMeshInstance
     {
         float     enable_vertex_blending;
-        float     _padding_enable_vertex_blending_1;
-        float     _padding_enable_vertex_blending_2;
-        float     _padding_enable_vertex_blending_3;
+        uint32_t  material_index; // only used by the bindless pipelines
+        uint32_t  mesh_index;     // only used by the bindless pipelines
+        uint32_t  joint_matrix_offset;
         Matrix4x4 model_matrix;
     };
 
@@ -66,9 +92,10 @@ namespace Piccolo
         VulkanMeshInstance mesh_instances[s_mesh_per_drawcall_max_instance_count];
     };
 
-    struct MeshPerdrawcallVertexBlendingStorageBufferObject
+    // the joint matrices of every animated entity in one frame, indexed by VulkanMeshInstance::joint_matrix_offset
+    struct MeshJointPaletteStorageBufferObject
     {
-        Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count];
+        Matrix4x4 joint_matrices[s_mesh_joint_palette_max_matrix_count];
     };
 
     struct MeshPerMaterialUniformBufferObject
@@ -85,10 +112,30 @@ namespace Piccolo
         uint32_t is_double_sided = 0;
     };
 
+    // std430 element of the bindless material storage buffer, textures are at
+    // [index * s_bindless_material_texture_count, (index + 1) * s_bindless_material_texture_count)
+    struct VulkanBindlessMaterial
+    {
+        Vector4 baseColorFactor {0.0f, 0.0f, 0.0f, 0.0f};
+
+        float metallicFactor    = 0.0f;
+        float roughnessFactor   = 0.0f;
+        float normalScale       = 0.0f;
+        float occlusionStrength = 0.0f;
+
+        Vector3  emissiveFactor  = {0.0f, 0.0f, 0.0f};
+        uint32_t is_blend        = 0;
+        uint32_t is_double_sided = 0;
+        uint32_t _padding_is_double_sided_1;
+        uint32_t _padding_is_double_sided_2;
+        uint32_t _padding_is_double_sided_3;
+    };
+
     struct MeshPointLightShadowPerframeStorageBufferObject
     {
         uint32_t point_light_num;
-        uint32_t _padding_point_light_num_1;
+        // bit 2 * i + side is set for the layers redrawn this frame
+        uint32_t point_light_layer_mask;
         uint32_t _padding_point_light_num_2;
         uint32_t _padding_point_light_num_3;
         Vector4  point_lights_position_and_radius[s_max_point_light_count];
@@ -99,11 +146,6 @@ namespace Piccolo
         VulkanMeshInstance mesh_instances[s_mesh_per_drawcall_max_instance_count];
     };
 
-    struct MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject
-    {
-        Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count];
-    };
-
     struct MeshDirectionalLightShadowPerframeStorageBufferObject
     {
         Matrix4x4 light_proj_view;
@@ -114,11 +156,6 @@ namespace Piccolo
         VulkanMeshInstance mesh_instances[s_mesh_per_drawcall_max_instance_count];
     };
 
-    struct MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject
-    {
-        Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count];
-    };
-
     struct AxisStorageBufferObject
     {
         Matrix4x4 model_matrix  = Matrix4x4::IDENTITY;
@@ -164,11 +201,7 @@ namespace Piccolo
         Matrix4x4 model_matrices[s_mesh_per_drawcall_max_instance_count];
         uint32_t  node_ids[s_mesh_per_drawcall_max_instance_count];
         float     enable_vertex_blendings[s_mesh_per_drawcall_max_instance_count];
-    };
-
-    struct MeshInefficientPickPerdrawcallVertexBlendingStorageBufferObject
-    {
-        Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count];
+        uint32_t  joint_matrix_offsets[s_mesh_per_drawcall_max_instance_count];
     };
 
     // mesh
@@ -189,6 +222,9 @@ namespace Piccolo
 
         VkDescriptorSet mesh_vertex_blending_descriptor_set;
 
+        // slot of the joint binding buffer in the bindless descriptor set
+        uint32_t bindless_index {0};
+
         VkBuffer      mesh_vertex_varying_buffer;
         VmaAllocation mesh_vertex_varying_buffer_allocation;
 
@@ -225,13 +261,16 @@ namespace Piccolo
         VmaAllocation material_uniform_buffer_allocation;
 
         VkDescriptorSet material_descriptor_set;
+
+        // slot of the factors and textures in the bindless descriptor set
+        uint32_t bindless_index {0};
     };
 
     // nodes
     struct RenderMeshNode
     {
         const Matrix4x4*   model_matrix {nullptr};
-        const Matrix4x4*   joint_matrices {nullptr};
+        uint32_t           joint_matrix_offset {0};
         uint32_t           joint_count {0};
         VulkanMesh*        ref_mesh {nullptr};
         VulkanPBRMaterial* ref_material {nullptr};
@@ -239,6 +278,18 @@ namespace Piccolo
         bool               enable_vertex_blending {false};
     };
 
+    struct RenderDirectionalLightCascade
+    {
+        Matrix4x4 proj_view {Matrix4x4::IDENTITY};
+
+        // set when the cached static casters have to be redrawn, cleared by the shadow pass
+        bool                        static_dirty {true};
+        std::vector<RenderMeshNode> static_mesh_nodes;
+        std::vector<RenderMeshNode> dynamic_mesh_nodes;
+    };
+
+    using RenderDirectionalLightCascades = std::array<RenderDirectionalLightCascade, s_directional_light_cascade_count>;
+
     struct RenderAxisNode
     {
         Matrix4x4   model_matrix {Matrix4x4::IDENTITY};
@@ -247,6 +298,15 @@ namespace Piccolo
         bool        enable_vertex_blending {false};
     };
 
+    struct RenderParticleEmitterNode
+    {
+        // sphere around the emitter that holds all of its particles
+        Vector3 bounds_center {Vector3::ZERO};
+        float   bounds_radius {0.0f};
+        bool    visible {true};
+        float   camera_distance {0.0f};
+    };
+
     struct TextureDataToUpdate
     {
         void*                base_color_image_pixels;
@@ -20,6 +20,11 @@ namespace Piccolo
         std::vector<Matrix4x4> m_joint_matrices;
         AxisAlignedBox         m_bounding_box;
 
+        // where the joint matrices are in the joint palette of the current frame, the range always lies inside the
+        // palette, RenderResource::updateJointPalette leaves no count to the entities that did not fit
+        uint32_t m_joint_palette_offset {0};
+        uint32_t m_joint_palette_count {0};
+
         // material
         size_t  m_material_asset_id {0};
         bool    m_blend {false};
@@ -30,5 +35,8 @@ namespace Piccolo
         float   m_normal_scale {1.0f};
         float   m_occlusion_strength {1.0f};
         Vector3 m_emissive_factor {0.0f, 0.0f, 0.0f};
+
+        // render scene frame the entity was last added or updated in, long unchanged entities are static shadow casters
+        uint32_t m_last_change_frame {0};
     };
 } // namespace Piccolo
@@ -0,0 +1,503 @@
+#include "runtime/function/render/render_graph.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Piccolo
+{
+    void RenderGraph::clear()
+    {
+        m_resources.clear();
+        m_passes.clear();
+
+        m_subpass_indices.clear();
+        m_subpass_passes.clear();
+        m_resource_segments.clear();
+        m_attachment_indices.clear();
+        m_attachment_owners.clear();
+        m_attachment_descriptions.clear();
+        m_subpass_references.clear();
+        m_dependencies.clear();
+    }
+
+    void RenderGraph::addResource(uint32_t resource, const RenderGraphResourceDesc& desc)
+    {
+        if (resource >= m_resources.size())
+        {
+            m_resources.resize(resource + 1);
+        }
+        m_resources[resource] = desc;
+    }
+
+    void RenderGraph::addPass(uint32_t pass, const RenderGraphPassDesc& desc)
+    {
+        if (pass >= m_passes.size())
+        {
+            m_passes.resize(pass + 1);
+        }
+        m_passes[pass] = desc;
+    }
+
+    void RenderGraph::compile()
+    {
+        cullPasses();
+        buildSegments();
+        assignAttachments();
+        buildSubpasses();
+        buildDependencies();
+    }
+
+    VkRenderPass RenderGraph::createRenderPass(VkDevice device) const
+    {
+        std::vector<VkSubpassDescription> subpasses(m_subpass_references.size());
+        for (size_t subpass_index = 0; subpass_index < subpasses.size(); ++subpass_index)
+        {
+            const SubpassReferences& references = m_subpass_references[subpass_index];
+            VkSubpassDescription&    subpass    = subpasses[subpass_index];
+
+            subpass.pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+            subpass.inputAttachmentCount    = static_cast<uint32_t>(references.inputs.size());
+            subpass.pInputAttachments       = references.inputs.empty() ? NULL : references.inputs.data();
+            subpass.colorAttachmentCount    = static_cast<uint32_t>(references.colors.size());
+            subpass.pColorAttachments       = references.colors.empty() ? NULL : references.colors.data();
+            subpass.pDepthStencilAttachment = references.depth.attachment == VK_ATTACHMENT_UNUSED ?
+                                                  NULL :
+                                                  &references.depth;
+            subpass.preserveAttachmentCount = static_cast<uint32_t>(references.preserves.size());
+            subpass.pPreserveAttachments    = references.preserves.empty() ? NULL : references.preserves.data();
+        }
+
+        VkRenderPassCreateInfo renderpass_create_info {};
+        renderpass_create_info.sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+        renderpass_create_info.attachmentCount = static_cast<uint32_t>(m_attachment_descriptions.size());
+        renderpass_create_info.pAttachments    = m_attachment_descriptions.data();
+        renderpass_create_info.subpassCount    = static_cast<uint32_t>(subpasses.size());
+        renderpass_create_info.pSubpasses      = subpasses.data();
+        renderpass_create_info.dependencyCount = static_cast<uint32_t>(m_dependencies.size());
+        renderpass_create_info.pDependencies   = m_dependencies.data();
+
+        VkRenderPass render_pass;
+        if (vkCreateRenderPass(device, &renderpass_create_info, nullptr, &render_pass) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create render pass");
+        }
+        return render_pass;
+    }
+
+    uint32_t RenderGraph::getAliasedResource(uint32_t resource) const
+    {
+        uint32_t attachment = m_attachment_indices[resource];
+        return attachment == s_culled ? s_culled : m_attachment_owners[attachment];
+    }
+
+    VkImageUsageFlags RenderGraph::getAttachmentUsage(uint32_t attachment) const
+    {
+        VkImageUsageFlags usage         = 0;
+        bool              all_transient = true;
+        for (size_t resource = 0; resource < m_resources.size(); ++resource)
+        {
+            if (m_attachment_indices[resource] == attachment)
+            {
+                usage |= m_resources[resource].usage;
+                all_transient &= (m_resources[resource].usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0;
+            }
+        }
+
+        // transient images may only be used as attachments
+        VkImageUsageFlags attachment_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                             VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                             VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT |
+                                             VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        if (!all_transient || (usage & ~attachment_usage) != 0)
+        {
+            usage &= ~VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        }
+        return usage;
+    }
+
+    std::vector<VkClearValue> RenderGraph::getClearValues() const
+    {
+        std::vector<VkClearValue> clear_values(m_attachment_owners.size());
+        std::vector<uint32_t>     first_uses(m_attachment_owners.size(), s_culled);
+        for (size_t resource = 0; resource < m_resources.size(); ++resource)
+        {
+            uint32_t attachment = m_attachment_indices[resource];
+            if (attachment != s_culled && m_resource_segments[resource].front().begin < first_uses[attachment])
+            {
+                first_uses[attachment]   = m_resource_segments[resource].front().begin;
+                clear_values[attachment] = m_resources[resource].clear_value;
+            }
+        }
+        return clear_values;
+    }
+
+    void RenderGraph::cullPasses()
+    {
+        // walk backwards from the persistent resources, a pass survives if something downstream reads its output
+        std::vector<bool> needed(m_resources.size(), false);
+        for (size_t resource = 0; resource < m_resources.size(); ++resource)
+        {
+            needed[resource] = m_resources[resource].persistent;
+        }
+
+        std::vector<bool> kept(m_passes.size(), false);
+        for (size_t pass = m_passes.size(); pass-- > 0;)
+        {
+            const RenderGraphPassDesc& desc = m_passes[pass];
+            if (!desc.enabled)
+            {
+                continue;
+            }
+
+            bool is_needed = desc.depth != UINT32_MAX && needed[desc.depth];
+            for (uint32_t color : desc.colors)
+            {
+                is_needed |= needed[color];
+            }
+            if (!is_needed)
+            {
+                continue;
+            }
+
+            kept[pass] = true;
+            for (uint32_t input : desc.inputs)
+            {
+                needed[input] = true;
+            }
+        }
+
+        m_subpass_indices.assign(m_passes.size(), s_culled);
+        m_subpass_passes.clear();
+        for (size_t pass = 0; pass < m_passes.size(); ++pass)
+        {
+            if (kept[pass])
+            {
+                m_subpass_indices[pass] = static_cast<uint32_t>(m_subpass_passes.size());
+                m_subpass_passes.push_back(static_cast<uint32_t>(pass));
+            }
+        }
+    }
+
+    void RenderGraph::buildSegments()
+    {
+        m_resource_segments.assign(m_resources.size(), {});
+
+        std::vector<bool> last_access_is_read(m_resources.size(), false);
+        for (uint32_t subpass = 0; subpass < m_subpass_passes.size(); ++subpass)
+        {
+            const RenderGraphPassDesc& desc = m_passes[m_subpass_passes[subpass]];
+
+            auto access = [&](uint32_t resource, bool is_read, bool is_write) {
+                std::vector<Segment>& segments = m_resource_segments[resource];
+                if (segments.empty() || (is_write && !is_read && last_access_is_read[resource]))
+                {
+                    segments.push_back({subpass, subpass});
+                }
+                else
+                {
+                    segments.back().end = subpass;
+                }
+                last_access_is_read[resource] = is_read;
+            };
+
+            for (uint32_t input : desc.inputs)
+            {
+                access(input, true, false);
+            }
+            for (uint32_t color : desc.colors)
+            {
+                access(color, false, true);
+            }
+            if (desc.depth != UINT32_MAX)
+            {
+                // depth testing reads the attachment as well
+                access(desc.depth, true, true);
+            }
+        }
+    }
+
+    void RenderGraph::assignAttachments()
+    {
+        m_attachment_indices.assign(m_resources.size(), s_culled);
+        m_attachment_owners.clear();
+
+        for (uint32_t resource = 0; resource < m_resources.size(); ++resource)
+        {
+            if (m_resource_segments[resource].empty())
+            {
+                continue;
+            }
+
+            uint32_t attachment = s_culled;
+            if (!m_resources[resource].persistent)
+            {
+                for (uint32_t candidate = 0; candidate < m_attachment_owners.size(); ++candidate)
+                {
+                    if (isAliasable(resource, candidate))
+                    {
+                        attachment = candidate;
+                        break;
+                    }
+                }
+            }
+
+            if (attachment == s_culled)
+            {
+                attachment = static_cast<uint32_t>(m_attachment_owners.size());
+                m_attachment_owners.push_back(resource);
+            }
+            m_attachment_indices[resource] = attachment;
+        }
+    }
+
+    bool RenderGraph::isAliasable(uint32_t resource, uint32_t attachment) const
+    {
+        const RenderGraphResourceDesc& owner = m_resources[m_attachment_owners[attachment]];
+        if (owner.persistent || owner.format != m_resources[resource].format)
+        {
+            return false;
+        }
+
+        for (size_t other = 0; other < m_resources.size(); ++other)
+        {
+            if (m_attachment_indices[other] != attachment)
+            {
+                continue;
+            }
+
+            for (const Segment& other_segment : m_resource_segments[other])
+            {
+                for (const Segment& segment : m_resource_segments[resource])
+                {
+                    if (other_segment.begin <= segment.end && segment.begin <= other_segment.end)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    void RenderGraph::buildSubpasses()
+    {
+        m_subpass_references.assign(m_subpass_passes.size(), {});
+
+        std::vector<VkImageLayout> last_layouts(m_attachment_owners.size(), VK_IMAGE_LAYOUT_UNDEFINED);
+        std::vector<bool>          first_use_is_write(m_attachment_owners.size(), false);
+        std::vector<bool>          is_used(m_attachment_owners.size(), false);
+
+        for (uint32_t subpass = 0; subpass < m_subpass_passes.size(); ++subpass)
+        {
+            const RenderGraphPassDesc& desc       = m_passes[m_subpass_passes[subpass]];
+            SubpassReferences&         references = m_subpass_references[subpass];
+            std::vector<bool>          is_referenced(m_attachment_owners.size(), false);
+
+            auto reference = [&](uint32_t resource, VkImageLayout layout, bool is_write) {
+                uint32_t attachment = m_attachment_indices[resource];
+                if (!is_used[attachment])
+                {
+                    is_used[attachment]            = true;
+                    first_use_is_write[attachment] = is_write;
+                }
+                last_layouts[attachment]  = layout;
+                is_referenced[attachment] = true;
+                return VkAttachmentReference {attachment, layout};
+            };
+
+            for (uint32_t input : desc.inputs)
+            {
+                references.inputs.push_back(reference(input, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, false));
+            }
+            for (uint32_t color : desc.colors)
+            {
+                references.colors.push_back(reference(color, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, true));
+            }
+            if (desc.depth != UINT32_MAX)
+            {
+                references.depth = reference(desc.depth, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, true);
+            }
+
+            // keep the contents of attachments that are alive across this subpass but not touched by it
+            for (uint32_t resource = 0; resource < m_resources.size(); ++resource)
+            {
+                uint32_t attachment = m_attachment_indices[resource];
+                if (attachment == s_culled || is_referenced[attachment])
+                {
+                    continue;
+                }
+                for (const Segment& segment : m_resource_segments[resource])
+                {
+                    if (segment.begin < subpass && subpass < segment.end)
+                    {
+                        references.preserves.push_back(attachment);
+                    }
+                }
+            }
+        }
+
+        m_attachment_descriptions.assign(m_attachment_owners.size(), {});
+        for (uint32_t attachment = 0; attachment < m_attachment_owners.size(); ++attachment)
+        {
+            const RenderGraphResourceDesc& owner       = m_resources[m_attachment_owners[attachment]];
+            VkAttachmentDescription&       description = m_attachment_descriptions[attachment];
+
+            description.format         = owner.format;
+            description.samples        = VK_SAMPLE_COUNT_1_BIT;
+            description.loadOp         = first_use_is_write[attachment] ? VK_ATTACHMENT_LOAD_OP_CLEAR :
+                                                                          VK_ATTACHMENT_LOAD_OP_LOAD;
+            description.storeOp = owner.persistent ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            description.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            description.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
+            description.finalLayout    = owner.persistent ? owner.final_layout : last_layouts[attachment];
+        }
+    }
+
+    void RenderGraph::buildDependencies()
+    {
+        struct Read
+        {
+            uint32_t             subpass;
+            VkPipelineStageFlags stage;
+            bool                 by_region;
+        };
+
+        m_dependencies.clear();
+
+        for (uint32_t subpass = 0; subpass < m_subpass_passes.size(); ++subpass)
+        {
+            if (m_passes[m_subpass_passes[subpass]].sample_external)
+            {
+                addDependency(VK_SUBPASS_EXTERNAL,
+                              subpass,
+                              VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                              VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                              VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                              VK_ACCESS_SHADER_READ_BIT,
+                              false);
+            }
+        }
+
+        for (uint32_t attachment = 0; attachment < m_attachment_owners.size(); ++attachment)
+        {
+            bool                 is_depth     = isDepthFormat(m_resources[m_attachment_owners[attachment]].format);
+            VkPipelineStageFlags write_stage  = is_depth ? (VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                                           VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT) :
+                                                           VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            VkAccessFlags        write_access = is_depth ? (VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                                                           VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT) :
+                                                           (VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
+                                                           VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+
+            uint32_t          last_write = s_culled;
+            std::vector<Read> reads_since_write;
+
+            for (uint32_t subpass = 0; subpass < m_subpass_passes.size(); ++subpass)
+            {
+                const RenderGraphPassDesc& desc = m_passes[m_subpass_passes[subpass]];
+
+                bool is_read  = false;
+                bool is_write = false;
+                for (uint32_t input : desc.inputs)
+                {
+                    is_read |= m_attachment_indices[input] == attachment;
+                }
+                for (uint32_t color : desc.colors)
+                {
+                    is_write |= m_attachment_indices[color] == attachment;
+                }
+                if (desc.depth != UINT32_MAX)
+                {
+                    is_write |= m_attachment_indices[desc.depth] == attachment;
+                }
+
+                if (is_read && last_write != s_culled)
+                {
+                    VkAccessFlags read_access = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+                    if (desc.sample_inputs)
+                    {
+                        read_access |= VK_ACCESS_SHADER_READ_BIT;
+                    }
+                    addDependency(last_write,
+                                  subpass,
+                                  write_stage,
+                                  VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                  write_access,
+                                  read_access,
+                                  !desc.sample_inputs);
+                }
+
+                if (is_write)
+                {
+                    if (last_write != s_culled)
+                    {
+                        addDependency(last_write, subpass, write_stage, write_stage, write_access, write_access, true);
+                    }
+                    for (const Read& read : reads_since_write)
+                    {
+                        addDependency(read.subpass, subpass, read.stage, write_stage, 0, write_access, read.by_region);
+                    }
+
+                    last_write = subpass;
+                    reads_since_write.clear();
+                }
+                else if (is_read)
+                {
+                    reads_since_write.push_back({subpass, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, !desc.sample_inputs});
+                }
+            }
+        }
+    }
+
+    void RenderGraph::addDependency(uint32_t             src_subpass,
+                                    uint32_t             dst_subpass,
+                                    VkPipelineStageFlags src_stage,
+                                    VkPipelineStageFlags dst_stage,
+                                    VkAccessFlags        src_access,
+                                    VkAccessFlags        dst_access,
+                                    bool                 by_region)
+    {
+        if (src_subpass == dst_subpass)
+        {
+            return;
+        }
+
+        auto iter = std::find_if(m_dependencies.begin(), m_dependencies.end(), [&](const VkSubpassDependency& dep) {
+            return dep.srcSubpass == src_subpass && dep.dstSubpass == dst_subpass;
+        });
+        if (iter == m_dependencies.end())
+        {
+            VkSubpassDependency dependency {};
+            dependency.srcSubpass      = src_subpass;
+            dependency.dstSubpass      = dst_subpass;
+            dependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+            iter                       = m_dependencies.insert(m_dependencies.end(), dependency);
+        }
+
+        iter->srcStageMask |= src_stage;
+        iter->dstStageMask |= dst_stage;
+        iter->srcAccessMask |= src_access;
+        iter->dstAccessMask |= dst_access;
+        if (!by_region)
+        {
+            iter->dependencyFlags &= ~VK_DEPENDENCY_BY_REGION_BIT;
+        }
+    }
+
+    bool RenderGraph::isDepthFormat(VkFormat format) const
+    {
+        switch (format)
+        {
+            case VK_FORMAT_D16_UNORM:
+            case VK_FORMAT_X8_D24_UNORM_PACK32:
+            case VK_FORMAT_D32_SFLOAT:
+            case VK_FORMAT_D16_UNORM_S8_UINT:
+            case VK_FORMAT_D24_UNORM_S8_UINT:
+            case VK_FORMAT_D32_SFLOAT_S8_UINT:
+                return true;
+            default:
+                return false;
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    struct RenderGraphResourceDesc
+    {
+        VkFormat          format {VK_FORMAT_UNDEFINED};
+        VkImageUsageFlags usage {0};
+        VkClearValue      clear_value {};
+
+        // persistent resources are stored at the end of the render pass and never aliased,
+        // everything else is transient and may share an attachment with a resource of the same format
+        bool          persistent {false};
+        VkImageLayout final_layout {VK_IMAGE_LAYOUT_UNDEFINED};
+    };
+
+    struct RenderGraphPassDesc
+    {
+        std::vector<uint32_t> inputs;
+        std::vector<uint32_t> colors;
+        uint32_t              depth {UINT32_MAX};
+
+        // inputs are also sampled at neighbouring pixels (e.g. fxaa), so the dependency can not be by region
+        bool sample_inputs {false};
+        // samples images written before the render pass, e.g. the shadow maps
+        bool sample_external {false};
+        bool enabled {true};
+    };
+
+    // Declarative description of a render pass made of subpasses. compile() culls the subpasses whose
+    // output is never consumed, aliases transient attachments with disjoint lifetimes and derives the
+    // load/store ops, layouts, preserved attachments and subpass dependencies.
+    // A color write following a read of the same resource starts a new version of it, so such a writer
+    // must not depend on the previous contents.
+    class RenderGraph
+    {
+    public:
+        static uint32_t const s_culled {UINT32_MAX};
+
+        void clear();
+
+        // resources and passes are identified by the caller's enums, passes execute in id order
+        void addResource(uint32_t resource, const RenderGraphResourceDesc& desc);
+        void addPass(uint32_t pass, const RenderGraphPassDesc& desc);
+
+        void compile();
+
+        VkRenderPass createRenderPass(VkDevice device) const;
+
+        bool     isPassCulled(uint32_t pass) const { return getSubpassIndex(pass) == s_culled; }
+        uint32_t getSubpassIndex(uint32_t pass) const { return m_subpass_indices[pass]; }
+        uint32_t getAttachmentIndex(uint32_t resource) const { return m_attachment_indices[resource]; }
+        uint32_t getAttachmentCount() const { return static_cast<uint32_t>(m_attachment_owners.size()); }
+
+        // the resource that owns the memory of the attachment this resource is aliased to
+        uint32_t getAliasedResource(uint32_t resource) const;
+
+        const RenderGraphResourceDesc& getResourceDesc(uint32_t resource) const { return m_resources[resource]; }
+        VkImageUsageFlags              getAttachmentUsage(uint32_t attachment) const;
+        std::vector<VkClearValue>      getClearValues() const;
+
+    private:
+        struct Segment
+        {
+            uint32_t begin;
+            uint32_t end;
+        };
+
+        struct SubpassReferences
+        {
+            std::vector<VkAttachmentReference> inputs;
+            std::vector<VkAttachmentReference> colors;
+            VkAttachmentReference              depth {VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED};
+            std::vector<uint32_t>              preserves;
+        };
+
+        void cullPasses();
+        void buildSegments();
+        void assignAttachments();
+        void buildSubpasses();
+        void buildDependencies();
+        void addDependency(uint32_t             src_subpass,
+                           uint32_t             dst_subpass,
+                           VkPipelineStageFlags src_stage,
+                           VkPipelineStageFlags dst_stage,
+                           VkAccessFlags        src_access,
+                           VkAccessFlags        dst_access,
+                           bool                 by_region);
+
+        bool isDepthFormat(VkFormat format) const;
+        bool isAliasable(uint32_t resource, uint32_t attachment) const;
+
+        std::vector<RenderGraphResourceDesc> m_resources;
+        std::vector<RenderGraphPassDesc>     m_passes;
+
+        // compiled
+        std::vector<uint32_t>                m_subpass_indices;
+        std::vector<uint32_t>                m_subpass_passes;
+        std::vector<std::vector<Segment>>    m_resource_segments;
+        std::vector<uint32_t>                m_attachment_indices;
+        std::vector<uint32_t>                m_attachment_owners;
+        std::vector<VkAttachmentDescription> m_attachment_descriptions;
+        std::vector<SubpassReferences>       m_subpass_references;
+        std::vector<VkSubpassDependency>     m_dependencies;
+    };
+} // namespace Piccolo
@@ -259,51 +259,13 @@ namespace Piccolo
         return true;
     }
 
-    Matrix4x4 CalculateDirectionalLightCamera(RenderScene& scene, RenderCamera& camera)
+    std::array<Matrix4x4, s_directional_light_cascade_count> CalculateDirectionalLightCascades(RenderScene&  scene,
+                                                                                             RenderCamera& camera)
     {
-        Matrix4x4 proj_view_matrix;
-        {
-            Matrix4x4 view_matrix = camera.getViewMatrix();
-            Matrix4x4 proj_matrix = camera.getPersProjMatrix();
-            proj_view_matrix      = proj_matrix * view_matrix;
-        }
-
-        BoundingBox frustum_bounding_box;
-        // CascadedShadowMaps11 / CreateFrustumPointsFromCascadeInterval
-        {
-            Vector3 const g_frustum_points_ndc_space[8] = {Vector3(-1.0f, -1.0f, 1.0f),
-                                                             Vector3(1.0f, -1.0f, 1.0f),
-                                                             Vector3(1.0f, 1.0f, 1.0f),
-                                                             Vector3(-1.0f, 1.0f, 1.0f),
-                                                             Vector3(-1.0f, -1.0f, 0.0f),
-                                                             Vector3(1.0f, -1.0f, 0.0f),
-                                                             Vector3(1.0f, 1.0f, 0.0f),
-                                                             Vector3(-1.0f, 1.0f, 0.0f)};
-
-            Matrix4x4 inverse_proj_view_matrix = proj_view_matrix.inverse();
-
-            frustum_bounding_box.min_bound = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
-            frustum_bounding_box.max_bound = Vector3(FLT_MIN, FLT_MIN, FLT_MIN);
-
-            size_t const CORNER_COUNT = 8;
-            for (size_t i = 0; i < CORNER_COUNT; ++i)
-            {
-                Vector4 frustum_point_with_w = inverse_proj_view_matrix * Vector4(g_frustum_points_ndc_space[i].x,
-                                                                                      g_frustum_points_ndc_space[i].y,
-                                                                                      g_frustum_points_ndc_space[i].z,
-                                                                                      1.0);
-                Vector3   frustum_point        = Vector3(frustum_point_with_w.x / frustum_point_with_w.w,
-                                                frustum_point_with_w.y / frustum_point_with_w.w,
-                                                frustum_point_with_w.z / frustum_point_with_w.w);
-
-                frustum_bounding_box.merge(frustum_point);
-            }
-        }
-
         BoundingBox scene_bounding_box;
         {
             scene_bounding_box.min_bound = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
-            scene_bounding_box.max_bound = Vector3(FLT_MIN, FLT_MIN, FLT_MIN);
+            scene_bounding_box.max_bound = Vector3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
 
             for (const RenderEntity& entity : scene.m_render_entities)
             {
@@ -315,36 +277,81 @@ namespace Piccolo
                 scene_bounding_box.merge(mesh_bounding_box_world);
             }
         }
+        bool const has_scene_bounds = !scene.m_render_entities.empty();
 
-        // CascadedShadowMaps11 / ComputeNearAndFar
-        Matrix4x4 light_view;
-        Matrix4x4 light_proj;
+        // the light view has no translation, so the texel grid stays fixed in world space
+        Vector3 light_direction = scene.m_directional_light.m_direction.normalisedCopy();
+        Vector3 light_up =
+            std::fabs(light_direction.z) > 0.99f ? Vector3(0.0f, 1.0f, 0.0f) : Vector3(0.0f, 0.0f, 1.0f);
+        Matrix4x4 light_view = Math::makeLookAtMatrix(Vector3::ZERO, -light_direction, light_up);
+
+        BoundingBox scene_bounding_box_light_view;
+        if (has_scene_bounds)
         {
-            Vector3 box_center((frustum_bounding_box.max_bound.x + frustum_bounding_box.min_bound.x) * 0.5,
-                                 (frustum_bounding_box.max_bound.y + frustum_bounding_box.min_bound.y) * 0.5,
-                                 (frustum_bounding_box.max_bound.z + frustum_bounding_box.min_bound.z));
-            Vector3 box_extents((frustum_bounding_box.max_bound.x - frustum_bounding_box.min_bound.x) * 0.5,
-                                  (frustum_bounding_box.max_bound.y - frustum_bounding_box.min_bound.y) * 0.5,
-                                  (frustum_bounding_box.max_bound.z - frustum_bounding_box.min_bound.z) * 0.5);
-
-            Vector3 eye =
-                box_center + scene.m_directional_light.m_direction * box_extents.length();
-            Vector3 center = box_center;
-            light_view       = Math::makeLookAtMatrix(eye, center, Vector3(0.0, 0.0, 1.0));
-
-            BoundingBox frustum_bounding_box_light_view = BoundingBoxTransform(frustum_bounding_box, light_view);
-            BoundingBox scene_bounding_box_light_view   = BoundingBoxTransform(scene_bounding_box, light_view);
-            light_proj = Math::makeOrthographicProjectionMatrix(
-                std::max(frustum_bounding_box_light_view.min_bound.x, scene_bounding_box_light_view.min_bound.x),
-                std::min(frustum_bounding_box_light_view.max_bound.x, scene_bounding_box_light_view.max_bound.x),
-                std::max(frustum_bounding_box_light_view.min_bound.y, scene_bounding_box_light_view.min_bound.y),
-                std::min(frustum_bounding_box_light_view.max_bound.y, scene_bounding_box_light_view.max_bound.y),
-                -scene_bounding_box_light_view.max_bound
-                     .z, // the objects which are nearer than the frustum bounding box may caster shadow as well
-                -std::max(frustum_bounding_box_light_view.min_bound.z, scene_bounding_box_light_view.min_bound.z));
+            scene_bounding_box_light_view = BoundingBoxTransform(scene_bounding_box, light_view);
+        }
+
+        // nothing beyond the scene receives a shadow
+        float near_z = camera.m_znear;
+        float far_z  = camera.m_zfar;
+        if (has_scene_bounds)
+        {
+            Vector3 scene_center = (scene_bounding_box.max_bound + scene_bounding_box.min_bound) * 0.5f;
+            float   scene_radius = (scene_bounding_box.max_bound - scene_bounding_box.min_bound).length() * 0.5f;
+            far_z = std::min(far_z, std::max(near_z * 2.0f, camera.position().distance(scene_center) + scene_radius));
+        }
+
+        Vector2 fov           = camera.getFOV();
+        float   tan_half_fovx = Math::tan(Math::degreesToRadians(fov.x) * 0.5f);
+        float   tan_half_fovy = Math::tan(Math::degreesToRadians(fov.y) * 0.5f);
+
+        std::array<Matrix4x4, s_directional_light_cascade_count> light_proj_views;
+
+        float split_near = near_z;
+        for (uint32_t cascade_index = 0; cascade_index < s_directional_light_cascade_count; ++cascade_index)
+        {
+            // practical split scheme, a blend of the logarithmic and the uniform split
+            float ratio     = static_cast<float>(cascade_index + 1) / s_directional_light_cascade_count;
+            float split_far = s_directional_light_cascade_split_lambda * near_z * std::pow(far_z / near_z, ratio) +
+                              (1.0f - s_directional_light_cascade_split_lambda) * (near_z + (far_z - near_z) * ratio);
+
+            // the bounding sphere of the slice does not change with the camera rotation,
+            // its radius is rounded up so that the texel size stays the same while the far plane drifts
+            float   center_distance = (split_near + split_far) * 0.5f;
+            Vector3 center          = camera.position() + camera.forward() * center_distance;
+            Vector3 near_corner(split_near * tan_half_fovx, split_near * tan_half_fovy, center_distance - split_near);
+            Vector3 far_corner(split_far * tan_half_fovx, split_far * tan_half_fovy, split_far - center_distance);
+            float   radius = std::ceil(std::max(near_corner.length(), far_corner.length()));
+
+            // move the projection by whole texels only, so static shadow edges do not shimmer
+            float   texel_size        = 2.0f * radius / s_directional_light_cascade_dimension;
+            Vector4 center_light_view = light_view * Vector4(center.x, center.y, center.z, 1.0f);
+            float   center_x          = std::floor(center_light_view.x / texel_size) * texel_size;
+            float   center_y          = std::floor(center_light_view.y / texel_size) * texel_size;
+
+            // the light looks down -z, casters between the light and the slice are kept
+            float depth_near = -center_light_view.z - radius;
+            float depth_far  = -center_light_view.z + radius;
+            if (has_scene_bounds)
+            {
+                depth_near = std::min(depth_near, -scene_bounding_box_light_view.max_bound.z);
+                depth_far  = std::min(depth_far, -scene_bounding_box_light_view.min_bound.z);
+            }
+            depth_near = std::floor(depth_near);
+            depth_far  = std::max(std::ceil(depth_far), depth_near + 1.0f);
+
+            // the projection maps [near, far] to [-1, 1], pulling the near plane back lands it in [0, 1]
+            Matrix4x4 light_proj = Math::makeOrthographicProjectionMatrix(center_x - radius,
+                                                                          center_x + radius,
+                                                                          center_y - radius,
+                                                                          center_y + radius,
+                                                                          2.0f * depth_near - depth_far,
+                                                                          depth_far);
+
+            light_proj_views[cascade_index] = light_proj * light_view;
+            split_near                      = split_far;
         }
 
-        Matrix4x4 light_proj_view = (light_proj * light_view);
-        return light_proj_view;
+        return light_proj_views;
     }
 } // namespace Piccolo
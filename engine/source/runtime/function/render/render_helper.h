@@ -3,6 +3,10 @@
 #include "runtime/core/math/vector3.h"
 #include "runtime/core/math/vector4.h"
 
+#include "runtime/function/render/render_common.h"
+
+#include <array>
+
 namespace Piccolo
 {
     class RenderScene;
@@ -81,5 +85,7 @@ namespace Piccolo
 
     bool BoxIntersectsWithSphere(BoundingBox const& b, BoundingSphere const& s);
 
-    Matrix4x4 CalculateDirectionalLightCamera(RenderScene& scene, RenderCamera& camera);
+    // one texel snapped light projection per slice of the camera frustum, see render_common.h for the atlas layout
+    std::array<Matrix4x4, s_directional_light_cascade_count> CalculateDirectionalLightCascades(RenderScene&  scene,
+                                                                                             RenderCamera& camera);
 } // namespace Piccolo
@@ -44,10 +44,11 @@ namespace Piccolo
 
     struct VisiableNodes
     {
-        std::vector<RenderMeshNode>*              p_directional_light_visible_mesh_nodes {nullptr};
-        std::vector<RenderMeshNode>*              p_point_lights_visible_mesh_nodes {nullptr};
-        std::vector<RenderMeshNode>*              p_main_camera_visible_mesh_nodes {nullptr};
-        RenderAxisNode*                           p_axis_node {nullptr};
+        RenderDirectionalLightCascades*         p_directional_light_cascades {nullptr};
+        std::vector<RenderMeshNode>*            p_point_lights_visible_mesh_nodes {nullptr};
+        std::vector<RenderMeshNode>*            p_main_camera_visible_mesh_nodes {nullptr};
+        RenderAxisNode*                         p_axis_node {nullptr};
+        std::vector<RenderParticleEmitterNode>* p_particle_emitter_nodes {nullptr};
     };
 
     class RenderPass : public RenderPassBase
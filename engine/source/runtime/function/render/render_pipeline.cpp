@@ -13,8 +13,24 @@
 
 #include "runtime/core/base/macro.h"
 
+#include <cassert>
+
 namespace Piccolo
 {
+    RenderPipeline::~RenderPipeline()
+    {
+        {
+            std::lock_guard<std::mutex> lock_guard(m_recording_mutex);
+            m_is_recording_stopped = true;
+        }
+        m_recording_condition.notify_all();
+
+        for (std::thread& recording_worker : m_recording_workers)
+        {
+            recording_worker.join();
+        }
+    }
+
     void RenderPipeline::initialize(RenderPipelineInitInfo init_info)
     {
         m_point_light_shadow_pass = std::make_shared<PointLightShadowPass>();
@@ -87,12 +103,16 @@ namespace Piccolo
             _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_backup_buffer_even];
         m_color_grading_pass->initialize(&color_grading_init_info);
 
+        const RenderGraph& main_camera_render_graph = main_camera_pass->getRenderGraph();
+
         UIPassInitInfo ui_init_info;
-        ui_init_info.render_pass = _main_camera_pass->getRenderPass();
+        ui_init_info.render_pass   = _main_camera_pass->getRenderPass();
+        ui_init_info.subpass_index = main_camera_render_graph.getSubpassIndex(_main_camera_subpass_ui);
         m_ui_pass->initialize(&ui_init_info);
 
         CombineUIPassInitInfo combine_ui_init_info;
-        combine_ui_init_info.render_pass = _main_camera_pass->getRenderPass();
+        combine_ui_init_info.render_pass   = _main_camera_pass->getRenderPass();
+        combine_ui_init_info.subpass_index = main_camera_render_graph.getSubpassIndex(_main_camera_subpass_combine_ui);
         combine_ui_init_info.scene_input_attachment =
             _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_backup_buffer_odd];
         combine_ui_init_info.ui_input_attachment =
@@ -103,12 +123,22 @@ namespace Piccolo
         pick_init_info.per_mesh_layout = descriptor_layouts[MainCameraPass::LayoutType::_per_mesh];
         m_pick_pass->initialize(&pick_init_info);
 
-        FXAAPassInitInfo fxaa_init_info;
-        fxaa_init_info.render_pass = _main_camera_pass->getRenderPass();
-        fxaa_init_info.input_attachment =
-            _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_post_process_buffer_odd];
-        m_fxaa_pass->initialize(&fxaa_init_info);
+        // the render graph culls the fxaa subpass when it is disabled
+        if (!main_camera_render_graph.isPassCulled(_main_camera_subpass_fxaa))
+        {
+            FXAAPassInitInfo fxaa_init_info;
+            fxaa_init_info.render_pass   = _main_camera_pass->getRenderPass();
+            fxaa_init_info.subpass_index = main_camera_render_graph.getSubpassIndex(_main_camera_subpass_fxaa);
+            fxaa_init_info.input_attachment =
+                _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_post_process_buffer_odd];
+            m_fxaa_pass->initialize(&fxaa_init_info);
+        }
 
+        // the render thread records with the first thread index
+        for (uint32_t thread_index = 1; thread_index < VulkanRHI::s_max_recording_threads; ++thread_index)
+        {
+            m_recording_workers.emplace_back(&RenderPipeline::runRecordingWorker, this, thread_index);
+        }
     }
 
     void RenderPipeline::forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource)
@@ -129,9 +159,7 @@ namespace Piccolo
             return;
         }
 
-        static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get())->draw();
-
-        static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get())->draw();
+        drawShadowPasses();
 
         ColorGradingPass& color_grading_pass = *(static_cast<ColorGradingPass*>(m_color_grading_pass.get()));
         FXAAPass&         fxaa_pass          = *(static_cast<FXAAPass*>(m_fxaa_pass.get()));
@@ -139,6 +167,7 @@ namespace Piccolo
         UIPass&           ui_pass            = *(static_cast<UIPass*>(m_ui_pass.get()));
         CombineUIPass&    combine_ui_pass    = *(static_cast<CombineUIPass*>(m_combine_ui_pass.get()));
         ParticlePass&     particle_pass      = *(static_cast<ParticlePass*>(m_particle_pass.get()));
+        PickPass&         pick_pass          = *(static_cast<PickPass*>(m_pick_pass.get()));
 
         static_cast<ParticlePass*>(m_particle_pass.get())
             ->setRenderCommandBufferHandle(
@@ -153,8 +182,9 @@ namespace Piccolo
                           particle_pass,
                           vulkan_rhi->m_current_swapchain_image_index);
 
+        pick_pass.draw();
+
         vulkan_rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
-        static_cast<ParticlePass*>(m_particle_pass.get())->copyNormalAndDepthImage();
         static_cast<ParticlePass*>(m_particle_pass.get())->simulate();
     }
 
@@ -176,9 +206,7 @@ namespace Piccolo
             return;
         }
 
-        static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get())->draw();
-
-        static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get())->draw();
+        drawShadowPasses();
 
         ColorGradingPass& color_grading_pass = *(static_cast<ColorGradingPass*>(m_color_grading_pass.get()));
         FXAAPass&         fxaa_pass          = *(static_cast<FXAAPass*>(m_fxaa_pass.get()));
@@ -186,6 +214,7 @@ namespace Piccolo
         UIPass&           ui_pass            = *(static_cast<UIPass*>(m_ui_pass.get()));
         CombineUIPass&    combine_ui_pass    = *(static_cast<CombineUIPass*>(m_combine_ui_pass.get()));
         ParticlePass&     particle_pass      = *(static_cast<ParticlePass*>(m_particle_pass.get()));
+        PickPass&         pick_pass          = *(static_cast<PickPass*>(m_pick_pass.get()));
 
         static_cast<ParticlePass*>(m_particle_pass.get())
             ->setRenderCommandBufferHandle(
@@ -200,11 +229,118 @@ namespace Piccolo
                    particle_pass,
                    vulkan_rhi->m_current_swapchain_image_index);
 
+        pick_pass.draw();
+
         vulkan_rhi->submitRendering(std::bind(&RenderPipeline::passUpdateAfterRecreateSwapchain, this));
-        static_cast<ParticlePass*>(m_particle_pass.get())->copyNormalAndDepthImage();
         static_cast<ParticlePass*>(m_particle_pass.get())->simulate();
     }
 
+    void RenderPipeline::drawShadowPasses()
+    {
+        DirectionalLightShadowPass& directional_light_pass =
+            *(static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get()));
+        PointLightShadowPass& point_light_shadow_pass =
+            *(static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get()));
+
+        recordSecondaryCommandBuffers({[&directional_light_pass](uint32_t thread_index) {
+                                           directional_light_pass.recordSecondaryCommandBuffer(thread_index);
+                                       },
+                                       [&point_light_shadow_pass](uint32_t thread_index) {
+                                           point_light_shadow_pass.recordSecondaryCommandBuffer(thread_index);
+                                       }});
+
+        directional_light_pass.draw();
+
+        point_light_shadow_pass.draw();
+    }
+
+    void RenderPipeline::recordSecondaryCommandBuffers(const std::vector<std::function<void(uint32_t)>>& recording_jobs)
+    {
+        assert(!recording_jobs.empty() && recording_jobs.size() <= VulkanRHI::s_max_recording_threads);
+
+        {
+            std::lock_guard<std::mutex> lock_guard(m_recording_mutex);
+            m_recording_jobs          = &recording_jobs;
+            m_pending_recording_count = recording_jobs.size() - 1;
+            m_recording_exception     = nullptr;
+            ++m_recording_frame;
+        }
+        m_recording_condition.notify_all();
+
+        std::exception_ptr recording_exception;
+        try
+        {
+            recording_jobs[0](0);
+        }
+        catch (...)
+        {
+            recording_exception = std::current_exception();
+        }
+
+        // the jobs may reference the caller's stack, so the workers are always waited for
+        {
+            std::unique_lock<std::mutex> lock(m_recording_mutex);
+            m_recorded_condition.wait(lock, [this]() { return m_pending_recording_count == 0; });
+            m_recording_jobs = nullptr;
+            if (!recording_exception)
+            {
+                recording_exception = m_recording_exception;
+            }
+        }
+
+        if (recording_exception)
+        {
+            std::rethrow_exception(recording_exception);
+        }
+    }
+
+    void RenderPipeline::runRecordingWorker(uint32_t thread_index)
+    {
+        size_t recorded_frame = 0;
+        while (true)
+        {
+            std::function<void(uint32_t)> recording_job;
+            {
+                std::unique_lock<std::mutex> lock(m_recording_mutex);
+                m_recording_condition.wait(lock, [this, recorded_frame]() {
+                    return m_is_recording_stopped || m_recording_frame != recorded_frame;
+                });
+                if (m_is_recording_stopped)
+                {
+                    return;
+                }
+
+                // a worker without a job may only wake up after the frame has been recorded
+                recorded_frame = m_recording_frame;
+                if (m_recording_jobs == nullptr || thread_index >= m_recording_jobs->size())
+                {
+                    continue;
+                }
+                recording_job = (*m_recording_jobs)[thread_index];
+            }
+
+            std::exception_ptr recording_exception;
+            try
+            {
+                recording_job(thread_index);
+            }
+            catch (...)
+            {
+                recording_exception = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock_guard(m_recording_mutex);
+                if (recording_exception && !m_recording_exception)
+                {
+                    m_recording_exception = recording_exception;
+                }
+                --m_pending_recording_count;
+            }
+            m_recorded_condition.notify_one();
+        }
+    }
+
     void RenderPipeline::passUpdateAfterRecreateSwapchain()
     {
         MainCameraPass&   main_camera_pass   = *(static_cast<MainCameraPass*>(m_main_camera_pass.get()));
@@ -212,7 +348,6 @@ namespace Piccolo
         FXAAPass&         fxaa_pass          = *(static_cast<FXAAPass*>(m_fxaa_pass.get()));
         ToneMappingPass&  tone_mapping_pass  = *(static_cast<ToneMappingPass*>(m_tone_mapping_pass.get()));
         CombineUIPass&    combine_ui_pass    = *(static_cast<CombineUIPass*>(m_combine_ui_pass.get()));
-        PickPass&         pick_pass          = *(static_cast<PickPass*>(m_pick_pass.get()));
         ParticlePass&     particle_pass      = *(static_cast<ParticlePass*>(m_particle_pass.get()));
 
         main_camera_pass.updateAfterFramebufferRecreate();
@@ -220,18 +355,20 @@ namespace Piccolo
             main_camera_pass.getFramebufferImageViews()[_main_camera_pass_backup_buffer_odd]);
         color_grading_pass.updateAfterFramebufferRecreate(
             main_camera_pass.getFramebufferImageViews()[_main_camera_pass_backup_buffer_even]);
-        fxaa_pass.updateAfterFramebufferRecreate(
-            main_camera_pass.getFramebufferImageViews()[_main_camera_pass_post_process_buffer_odd]);
+        if (!main_camera_pass.getRenderGraph().isPassCulled(_main_camera_subpass_fxaa))
+        {
+            fxaa_pass.updateAfterFramebufferRecreate(
+                main_camera_pass.getFramebufferImageViews()[_main_camera_pass_post_process_buffer_odd]);
+        }
         combine_ui_pass.updateAfterFramebufferRecreate(
             main_camera_pass.getFramebufferImageViews()[_main_camera_pass_backup_buffer_odd],
             main_camera_pass.getFramebufferImageViews()[_main_camera_pass_backup_buffer_even]);
-        pick_pass.recreateFramebuffer();
         particle_pass.updateAfterFramebufferRecreate();
     }
-    uint32_t RenderPipeline::getGuidOfPickedMesh(const Vector2& picked_uv)
+    void RenderPipeline::requestGuidOfPickedMesh(const Vector2& picked_uv, std::function<void(uint32_t)> callback)
     {
         PickPass& pick_pass = *(static_cast<PickPass*>(m_pick_pass.get()));
-        return pick_pass.pick(picked_uv);
+        pick_pass.requestPick(picked_uv, std::move(callback));
     }
 
     void RenderPipeline::setAxisVisibleState(bool state)
@@ -2,11 +2,20 @@
 
 #include "runtime/function/render/render_pipeline_base.h"
 
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace Piccolo
 {
     class RenderPipeline : public RenderPipelineBase
     {
     public:
+        virtual ~RenderPipeline() override;
+
         virtual void initialize(RenderPipelineInitInfo init_info) override final;
 
         virtual void forwardRender(std::shared_ptr<RHI>                rhi,
@@ -17,10 +26,31 @@ namespace Piccolo
 
         void passUpdateAfterRecreateSwapchain();
 
-        virtual uint32_t getGuidOfPickedMesh(const Vector2& picked_uv) override final;
+        virtual void requestGuidOfPickedMesh(const Vector2&                picked_uv,
+                                             std::function<void(uint32_t)> callback) override final;
 
         void setAxisVisibleState(bool state);
 
         void setSelectedAxis(size_t selected_axis);
+
+    private:
+        // records one job per recording thread into that thread's secondary command buffer, the render thread takes
+        // the first job and the recording workers the others, returns once all of them are recorded
+        void recordSecondaryCommandBuffers(const std::vector<std::function<void(uint32_t)>>& recording_jobs);
+        void runRecordingWorker(uint32_t thread_index);
+
+        // the shadow passes are independent, they are recorded in parallel and executed in order
+        void drawShadowPasses();
+
+        // persistent, so that no thread is created per frame
+        std::vector<std::thread>                          m_recording_workers;
+        std::mutex                                        m_recording_mutex;
+        std::condition_variable                           m_recording_condition;
+        std::condition_variable                           m_recorded_condition;
+        const std::vector<std::function<void(uint32_t)>>* m_recording_jobs {nullptr};
+        size_t                                            m_recording_frame {0};
+        size_t                                            m_pending_recording_count {0};
+        std::exception_ptr                                m_recording_exception;
+        bool                                              m_is_recording_stopped {false};
     };
 } // namespace Piccolo
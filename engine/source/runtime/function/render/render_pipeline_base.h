@@ -3,6 +3,7 @@
 #include "runtime/core/math/vector2.h"
 #include "runtime/function/render/render_pass_base.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -31,8 +32,8 @@ namespace Piccolo
         virtual void forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource);
         virtual void deferredRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource);
 
-        void             initializeUIRenderBackend(WindowUI* window_ui);
-        virtual uint32_t getGuidOfPickedMesh(const Vector2& picked_uv) = 0;
+        void         initializeUIRenderBackend(WindowUI* window_ui);
+        virtual void requestGuidOfPickedMesh(const Vector2& picked_uv, std::function<void(uint32_t)> callback) = 0;
 
     protected:
         std::shared_ptr<RHI> m_rhi;
@@ -10,10 +10,18 @@
 
 #include "runtime/core/base/macro.h"
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace Piccolo
 {
+    static VkDeviceSize getAllocationSize(VmaAllocator allocator, VmaAllocation allocation)
+    {
+        VmaAllocationInfo allocation_info {};
+        vmaGetAllocationInfo(allocator, allocation, &allocation_info);
+        return allocation_info.size;
+    }
+
     void RenderResource::uploadGlobalRenderResource(std::shared_ptr<RHI> rhi, LevelResourceDesc level_resource_desc)
     {
         // create and map global storage buffer
@@ -330,6 +338,24 @@ namespace Piccolo
                                now_mesh);
             }
 
+            if (now_mesh.enable_vertex_blending && rhi->isBindlessEnabled())
+            {
+                updateBindlessMesh(rhi, now_mesh);
+            }
+
+            VmaAllocator             allocator = static_cast<VulkanRHI*>(rhi.get())->m_assets_allocator;
+            VulkanResourceResidency& residency = m_mesh_residency[assetid];
+            residency.last_used_frame          = m_current_frame;
+            residency.size = getAllocationSize(allocator, now_mesh.mesh_vertex_position_buffer_allocation) +
+                             getAllocationSize(allocator, now_mesh.mesh_vertex_varying_enable_blending_buffer_allocation) +
+                             getAllocationSize(allocator, now_mesh.mesh_vertex_varying_buffer_allocation) +
+                             getAllocationSize(allocator, now_mesh.mesh_index_buffer_allocation);
+            if (now_mesh.enable_vertex_blending)
+            {
+                residency.size += getAllocationSize(allocator, now_mesh.mesh_vertex_joint_binding_buffer_allocation);
+            }
+            m_resident_size += residency.size;
+
             return now_mesh;
         }
     }
@@ -604,6 +630,28 @@ namespace Piccolo
 
             vkUpdateDescriptorSets(vulkan_context->m_device, 6, mesh_descriptor_writes_info, 0, nullptr);
 
+            if (vulkan_context->isBindlessEnabled())
+            {
+                VkDescriptorImageInfo texture_image_infos[s_bindless_material_texture_count] = {
+                    base_color_image_info,
+                    metallic_roughness_image_info,
+                    normal_roughness_image_info,
+                    occlusion_image_info,
+                    emissive_image_info};
+                updateBindlessMaterial(rhi, entity, texture_image_infos, now_material);
+            }
+
+            VmaAllocator             allocator = vulkan_context->m_assets_allocator;
+            VulkanResourceResidency& residency = m_material_residency[assetid];
+            residency.last_used_frame          = m_current_frame;
+            residency.size = getAllocationSize(allocator, now_material.material_uniform_buffer_allocation) +
+                             getAllocationSize(allocator, now_material.base_color_image_allocation) +
+                             getAllocationSize(allocator, now_material.metallic_roughness_image_allocation) +
+                             getAllocationSize(allocator, now_material.normal_image_allocation) +
+                             getAllocationSize(allocator, now_material.occlusion_image_allocation) +
+                             getAllocationSize(allocator, now_material.emissive_image_allocation);
+            m_resident_size += residency.size;
+
             return now_material;
         }
     }
@@ -1143,6 +1191,7 @@ namespace Piccolo
         auto it = m_vulkan_meshes.find(assetid);
         if (it != m_vulkan_meshes.end())
         {
+            m_mesh_residency[assetid].last_used_frame = m_current_frame;
             return it->second;
         }
         else
@@ -1158,6 +1207,7 @@ namespace Piccolo
         auto it = m_vulkan_pbr_materials.find(assetid);
         if (it != m_vulkan_pbr_materials.end())
         {
+            m_material_residency[assetid].last_used_frame = m_current_frame;
             return it->second;
         }
         else
@@ -1166,12 +1216,432 @@ namespace Piccolo
         }
     }
 
+    void RenderResource::retainRenderEntityResource(const RenderEntity& render_entity)
+    {
+        auto mesh_it = m_mesh_residency.find(render_entity.m_mesh_asset_id);
+        if (mesh_it != m_mesh_residency.end())
+        {
+            ++mesh_it->second.ref_count;
+        }
+
+        auto material_it = m_material_residency.find(render_entity.m_material_asset_id);
+        if (material_it != m_material_residency.end())
+        {
+            ++material_it->second.ref_count;
+        }
+    }
+
+    void RenderResource::releaseRenderEntityResource(const RenderEntity& render_entity)
+    {
+        auto mesh_it = m_mesh_residency.find(render_entity.m_mesh_asset_id);
+        if (mesh_it != m_mesh_residency.end() && mesh_it->second.ref_count > 0)
+        {
+            --mesh_it->second.ref_count;
+            mesh_it->second.last_used_frame = m_current_frame;
+        }
+
+        auto material_it = m_material_residency.find(render_entity.m_material_asset_id);
+        if (material_it != m_material_residency.end() && material_it->second.ref_count > 0)
+        {
+            --material_it->second.ref_count;
+            material_it->second.last_used_frame = m_current_frame;
+        }
+    }
+
+    void RenderResource::updateResourceResidency(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderScene> render_scene)
+    {
+        ++m_current_frame;
+
+        destroyRetiredResources(rhi);
+        evictUnreferencedResources(render_scene);
+    }
+
+    void RenderResource::evictUnreferencedResources(std::shared_ptr<RenderScene> render_scene)
+    {
+        if (m_resource_budget_size == 0 || m_resident_size <= m_resource_budget_size)
+        {
+            return;
+        }
+
+        // least recently used first, meshes and materials share the same budget
+        struct EvictionCandidate
+        {
+            uint64_t last_used_frame;
+            size_t   asset_id;
+            bool     is_mesh;
+
+            bool operator<(const EvictionCandidate& rhs) const { return last_used_frame < rhs.last_used_frame; }
+        };
+
+        std::vector<EvictionCandidate> candidates;
+        for (const auto& residency : m_mesh_residency)
+        {
+            if (residency.second.ref_count == 0)
+            {
+                candidates.push_back({residency.second.last_used_frame, residency.first, true});
+            }
+        }
+        for (const auto& residency : m_material_residency)
+        {
+            if (residency.second.ref_count == 0)
+            {
+                candidates.push_back({residency.second.last_used_frame, residency.first, false});
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (const EvictionCandidate& candidate : candidates)
+        {
+            if (m_resident_size <= m_resource_budget_size)
+            {
+                break;
+            }
+
+            // free the asset guid so that the source will be loaded again the next time it is referenced
+            if (candidate.is_mesh)
+            {
+                auto mesh_it = m_vulkan_meshes.find(candidate.asset_id);
+                m_retired_meshes.emplace_back(m_current_frame, mesh_it->second);
+                m_vulkan_meshes.erase(mesh_it);
+
+                m_resident_size -= m_mesh_residency[candidate.asset_id].size;
+                m_mesh_residency.erase(candidate.asset_id);
+                render_scene->getMeshAssetIdAllocator().freeGuid(candidate.asset_id);
+            }
+            else
+            {
+                auto material_it = m_vulkan_pbr_materials.find(candidate.asset_id);
+                m_retired_materials.emplace_back(m_current_frame, material_it->second);
+                m_vulkan_pbr_materials.erase(material_it);
+
+                m_resident_size -= m_material_residency[candidate.asset_id].size;
+                m_material_residency.erase(candidate.asset_id);
+                render_scene->getMaterialAssetdAllocator().freeGuid(candidate.asset_id);
+            }
+        }
+    }
+
+    void RenderResource::destroyRetiredResources(std::shared_ptr<RHI> rhi)
+    {
+        // a resource retired in frame N may still be referenced by the command buffers of the previous frames in
+        // flight, whose fences have all been waited once s_max_frames_in_flight more frames have begun
+        const uint64_t frames_in_flight = static_cast<VulkanRHI*>(rhi.get())->s_max_frames_in_flight;
+
+        while (!m_retired_meshes.empty() && m_retired_meshes.front().first + frames_in_flight <= m_current_frame)
+        {
+            destroyVulkanMesh(rhi, m_retired_meshes.front().second);
+            m_retired_meshes.pop_front();
+        }
+
+        while (!m_retired_materials.empty() &&
+               m_retired_materials.front().first + frames_in_flight <= m_current_frame)
+        {
+            destroyVulkanMaterial(rhi, m_retired_materials.front().second);
+            m_retired_materials.pop_front();
+        }
+    }
+
+    void RenderResource::destroyVulkanMesh(std::shared_ptr<RHI> rhi, VulkanMesh& mesh)
+    {
+        VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
+
+        vmaDestroyBuffer(vulkan_context->m_assets_allocator,
+                         mesh.mesh_vertex_position_buffer,
+                         mesh.mesh_vertex_position_buffer_allocation);
+        vmaDestroyBuffer(vulkan_context->m_assets_allocator,
+                         mesh.mesh_vertex_varying_enable_blending_buffer,
+                         mesh.mesh_vertex_varying_enable_blending_buffer_allocation);
+        vmaDestroyBuffer(vulkan_context->m_assets_allocator,
+                         mesh.mesh_vertex_varying_buffer,
+                         mesh.mesh_vertex_varying_buffer_allocation);
+        vmaDestroyBuffer(
+            vulkan_context->m_assets_allocator, mesh.mesh_index_buffer, mesh.mesh_index_buffer_allocation);
+        if (mesh.enable_vertex_blending)
+        {
+            vmaDestroyBuffer(vulkan_context->m_assets_allocator,
+                             mesh.mesh_vertex_joint_binding_buffer,
+                             mesh.mesh_vertex_joint_binding_buffer_allocation);
+        }
+
+        vkFreeDescriptorSets(
+            vulkan_context->m_device, vulkan_context->m_descriptor_pool, 1, &mesh.mesh_vertex_blending_descriptor_set);
+
+        if (mesh.enable_vertex_blending && vulkan_context->isBindlessEnabled())
+        {
+            m_global_render_resource._bindless_resource._free_mesh_indices.push_back(mesh.bindless_index);
+        }
+    }
+
+    void RenderResource::destroyVulkanMaterial(std::shared_ptr<RHI> rhi, VulkanPBRMaterial& material)
+    {
+        VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
+
+        vkDestroyImageView(vulkan_context->m_device, material.base_color_image_view, nullptr);
+        vmaDestroyImage(vulkan_context->m_assets_allocator,
+                        material.base_color_texture_image,
+                        material.base_color_image_allocation);
+
+        vkDestroyImageView(vulkan_context->m_device, material.metallic_roughness_image_view, nullptr);
+        vmaDestroyImage(vulkan_context->m_assets_allocator,
+                        material.metallic_roughness_texture_image,
+                        material.metallic_roughness_image_allocation);
+
+        vkDestroyImageView(vulkan_context->m_device, material.normal_image_view, nullptr);
+        vmaDestroyImage(
+            vulkan_context->m_assets_allocator, material.normal_texture_image, material.normal_image_allocation);
+
+        vkDestroyImageView(vulkan_context->m_device, material.occlusion_image_view, nullptr);
+        vmaDestroyImage(vulkan_context->m_assets_allocator,
+                        material.occlusion_texture_image,
+                        material.occlusion_image_allocation);
+
+        vkDestroyImageView(vulkan_context->m_device, material.emissive_image_view, nullptr);
+        vmaDestroyImage(
+            vulkan_context->m_assets_allocator, material.emissive_texture_image, material.emissive_image_allocation);
+
+        vmaDestroyBuffer(vulkan_context->m_assets_allocator,
+                         material.material_uniform_buffer,
+                         material.material_uniform_buffer_allocation);
+
+        vkFreeDescriptorSets(
+            vulkan_context->m_device, vulkan_context->m_descriptor_pool, 1, &material.material_descriptor_set);
+
+        if (vulkan_context->isBindlessEnabled())
+        {
+            m_global_render_resource._bindless_resource._free_material_indices.push_back(material.bindless_index);
+        }
+    }
+
+    void RenderResource::createBindlessResource(std::shared_ptr<RHI> rhi)
+    {
+        VulkanRHI*        vulkan_context    = static_cast<VulkanRHI*>(rhi.get());
+        BindlessResource& bindless_resource = m_global_render_resource._bindless_resource;
+
+        VkDescriptorPoolSize pool_sizes[2];
+        pool_sizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        pool_sizes[0].descriptorCount = 1 + s_bindless_max_vertex_blending_mesh_count;
+        pool_sizes[1].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        pool_sizes[1].descriptorCount = s_bindless_material_texture_count * s_bindless_max_material_count;
+
+        VkDescriptorPoolCreateInfo pool_info {};
+        pool_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.poolSizeCount = sizeof(pool_sizes) / sizeof(pool_sizes[0]);
+        pool_info.pPoolSizes    = pool_sizes;
+        pool_info.maxSets       = 1;
+
+        if (vkCreateDescriptorPool(
+                vulkan_context->m_device, &pool_info, nullptr, &bindless_resource._descriptor_pool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("create bindless descriptor pool");
+        }
+
+        VkDescriptorSetAllocateInfo bindless_descriptor_set_alloc_info;
+        bindless_descriptor_set_alloc_info.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        bindless_descriptor_set_alloc_info.pNext              = NULL;
+        bindless_descriptor_set_alloc_info.descriptorPool     = bindless_resource._descriptor_pool;
+        bindless_descriptor_set_alloc_info.descriptorSetCount = 1;
+        bindless_descriptor_set_alloc_info.pSetLayouts        = m_bindless_descriptor_set_layout;
+
+        if (VK_SUCCESS != vkAllocateDescriptorSets(vulkan_context->m_device,
+                                                   &bindless_descriptor_set_alloc_info,
+                                                   &bindless_resource._descriptor_set))
+        {
+            throw std::runtime_error("allocate bindless descriptor set");
+        }
+
+        // the material factors are written by the host once when the material is created
+        VkBufferCreateInfo buffer_create_info = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+        buffer_create_info.size               = sizeof(VulkanBindlessMaterial) * s_bindless_max_material_count;
+        buffer_create_info.usage              = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+
+        VmaAllocationCreateInfo allocation_create_info = {};
+        allocation_create_info.usage                   = VMA_MEMORY_USAGE_CPU_TO_GPU;
+        allocation_create_info.flags                   = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo allocation_info = {};
+        if (VK_SUCCESS != vmaCreateBuffer(vulkan_context->m_assets_allocator,
+                                          &buffer_create_info,
+                                          &allocation_create_info,
+                                          &bindless_resource._material_storage_buffer,
+                                          &bindless_resource._material_storage_buffer_allocation,
+                                          &allocation_info))
+        {
+            throw std::runtime_error("create bindless material storage buffer");
+        }
+        bindless_resource._material_storage_buffer_memory_pointer = allocation_info.pMappedData;
+
+        VkDescriptorBufferInfo material_storage_buffer_info = {};
+        material_storage_buffer_info.offset                 = 0;
+        material_storage_buffer_info.range                  = VK_WHOLE_SIZE;
+        material_storage_buffer_info.buffer                 = bindless_resource._material_storage_buffer;
+
+        VkWriteDescriptorSet material_storage_buffer_write_info = {};
+        material_storage_buffer_write_info.sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        material_storage_buffer_write_info.pNext                = NULL;
+        material_storage_buffer_write_info.dstSet               = bindless_resource._descriptor_set;
+        material_storage_buffer_write_info.dstBinding           = 0;
+        material_storage_buffer_write_info.dstArrayElement      = 0;
+        material_storage_buffer_write_info.descriptorType       = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        material_storage_buffer_write_info.descriptorCount      = 1;
+        material_storage_buffer_write_info.pBufferInfo          = &material_storage_buffer_info;
+
+        vkUpdateDescriptorSets(vulkan_context->m_device, 1, &material_storage_buffer_write_info, 0, NULL);
+
+        // hand out the lowest slots first
+        for (uint32_t i = s_bindless_max_material_count; i > 0; --i)
+        {
+            bindless_resource._free_material_indices.push_back(i - 1);
+        }
+        for (uint32_t i = s_bindless_max_vertex_blending_mesh_count; i > 0; --i)
+        {
+            bindless_resource._free_mesh_indices.push_back(i - 1);
+        }
+    }
+
+    void RenderResource::updateBindlessMesh(std::shared_ptr<RHI> rhi, VulkanMesh& mesh)
+    {
+        VulkanRHI*        vulkan_context    = static_cast<VulkanRHI*>(rhi.get());
+        BindlessResource& bindless_resource = m_global_render_resource._bindless_resource;
+
+        if (bindless_resource._free_mesh_indices.empty())
+        {
+            throw std::runtime_error("bindless joint binding slots exhausted");
+        }
+        mesh.bindless_index = bindless_resource._free_mesh_indices.back();
+        bindless_resource._free_mesh_indices.pop_back();
+
+        VkDescriptorBufferInfo joint_binding_storage_buffer_info = {};
+        joint_binding_storage_buffer_info.offset                 = 0;
+        joint_binding_storage_buffer_info.range                  = VK_WHOLE_SIZE;
+        joint_binding_storage_buffer_info.buffer                 = mesh.mesh_vertex_joint_binding_buffer;
+
+        // the slot is unused by the frames in flight, see VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT
+        VkWriteDescriptorSet joint_binding_storage_buffer_write_info = {};
+        joint_binding_storage_buffer_write_info.sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        joint_binding_storage_buffer_write_info.pNext                = NULL;
+        joint_binding_storage_buffer_write_info.dstSet               = bindless_resource._descriptor_set;
+        joint_binding_storage_buffer_write_info.dstBinding           = 2;
+        joint_binding_storage_buffer_write_info.dstArrayElement      = mesh.bindless_index;
+        joint_binding_storage_buffer_write_info.descriptorType       = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        joint_binding_storage_buffer_write_info.descriptorCount      = 1;
+        joint_binding_storage_buffer_write_info.pBufferInfo          = &joint_binding_storage_buffer_info;
+
+        vkUpdateDescriptorSets(vulkan_context->m_device, 1, &joint_binding_storage_buffer_write_info, 0, NULL);
+    }
+
+    void RenderResource::updateBindlessMaterial(std::shared_ptr<RHI>         rhi,
+                                                const RenderEntity&          entity,
+                                                const VkDescriptorImageInfo* texture_image_infos,
+                                                VulkanPBRMaterial&           material)
+    {
+        VulkanRHI*        vulkan_context    = static_cast<VulkanRHI*>(rhi.get());
+        BindlessResource& bindless_resource = m_global_render_resource._bindless_resource;
+
+        if (bindless_resource._free_material_indices.empty())
+        {
+            throw std::runtime_error("bindless material slots exhausted");
+        }
+        material.bindless_index = bindless_resource._free_material_indices.back();
+        bindless_resource._free_material_indices.pop_back();
+
+        VulkanBindlessMaterial& bindless_material =
+            static_cast<VulkanBindlessMaterial*>(bindless_resource._material_storage_buffer_memory_pointer)
+                [material.bindless_index];
+        bindless_material.is_blend          = entity.m_blend;
+        bindless_material.is_double_sided   = entity.m_double_sided;
+        bindless_material.baseColorFactor   = entity.m_base_color_factor;
+        bindless_material.metallicFactor    = entity.m_metallic_factor;
+        bindless_material.roughnessFactor   = entity.m_roughness_factor;
+        bindless_material.normalScale       = entity.m_normal_scale;
+        bindless_material.occlusionStrength = entity.m_occlusion_strength;
+        bindless_material.emissiveFactor    = entity.m_emissive_factor;
+
+        vmaFlushAllocation(vulkan_context->m_assets_allocator,
+                           bindless_resource._material_storage_buffer_allocation,
+                           sizeof(VulkanBindlessMaterial) * material.bindless_index,
+                           sizeof(VulkanBindlessMaterial));
+
+        // the textures of a material occupy consecutive elements of the texture array
+        VkWriteDescriptorSet texture_write_info = {};
+        texture_write_info.sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        texture_write_info.pNext                = NULL;
+        texture_write_info.dstSet               = bindless_resource._descriptor_set;
+        texture_write_info.dstBinding           = 1;
+        texture_write_info.dstArrayElement      = s_bindless_material_texture_count * material.bindless_index;
+        texture_write_info.descriptorType       = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        texture_write_info.descriptorCount      = s_bindless_material_texture_count;
+        texture_write_info.pImageInfo           = texture_image_infos;
+
+        vkUpdateDescriptorSets(vulkan_context->m_device, 1, &texture_write_info, 0, NULL);
+    }
+
     void RenderResource::resetRingBufferOffset(uint8_t current_frame_index)
     {
         m_global_render_resource._storage_buffer._global_upload_ringbuffers_end[current_frame_index] =
             m_global_render_resource._storage_buffer._global_upload_ringbuffers_begin[current_frame_index];
     }
 
+    uint32_t StorageBuffer::allocateFromRingBuffer(uint8_t current_frame_index, uint32_t size)
+    {
+        std::lock_guard<std::mutex> lock(_global_upload_ringbuffer_mutex);
+
+        uint32_t dynamic_offset =
+            roundUp(_global_upload_ringbuffers_end[current_frame_index], _min_storage_buffer_offset_alignment);
+        _global_upload_ringbuffers_end[current_frame_index] = dynamic_offset + size;
+        assert(_global_upload_ringbuffers_end[current_frame_index] <=
+               (_global_upload_ringbuffers_begin[current_frame_index] +
+                _global_upload_ringbuffers_size[current_frame_index]));
+
+        return dynamic_offset;
+    }
+
+    uint32_t StorageBuffer::getJointPaletteDynamicOffset(uint8_t current_frame_index) const
+    {
+        return _joint_palette_frame_size * current_frame_index;
+    }
+
+    void RenderResource::updateJointPalette(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderScene> render_scene)
+    {
+        VulkanRHI*     vulkan_context = static_cast<VulkanRHI*>(rhi.get());
+        StorageBuffer& storage_buffer = m_global_render_resource._storage_buffer;
+
+        // the region of this frame may still be read by the frame submitted s_max_frames_in_flight ago
+        vulkan_context->waitForFences();
+
+        Matrix4x4* joint_palette = reinterpret_cast<Matrix4x4*>(
+            reinterpret_cast<uintptr_t>(storage_buffer._joint_palette_buffer_memory_pointer) +
+            storage_buffer.getJointPaletteDynamicOffset(vulkan_context->m_current_frame_index));
+
+        uint32_t joint_matrix_count = 0;
+        bool     is_palette_full    = false;
+        for (RenderEntity& entity : render_scene->m_render_entities)
+        {
+            uint32_t entity_joint_count   = static_cast<uint32_t>(entity.m_joint_matrices.size());
+            entity.m_joint_palette_offset = joint_matrix_count;
+            entity.m_joint_palette_count  = 0;
+            if (entity_joint_count == 0)
+            {
+                continue;
+            }
+            if (joint_matrix_count + entity_joint_count > s_mesh_joint_palette_max_matrix_count)
+            {
+                is_palette_full = true;
+                continue;
+            }
+
+            std::copy(
+                entity.m_joint_matrices.begin(), entity.m_joint_matrices.end(), joint_palette + joint_matrix_count);
+            entity.m_joint_palette_count = entity_joint_count;
+            joint_matrix_count += entity_joint_count;
+        }
+
+        if (is_palette_full && !m_is_joint_palette_full)
+        {
+            LOG_WARN("the joint palette is full, the remaining animated entities are drawn in bind pose");
+        }
+        m_is_joint_palette_full = is_palette_full;
+    }
+
     void RenderResource::createAndMapStorageBuffer(std::shared_ptr<RHI> rhi)
     {
         VulkanRHI*     raw_rhi          = static_cast<VulkanRHI*>(rhi.get());
@@ -1211,6 +1681,18 @@ namespace Piccolo
                 (global_storage_buffer_size * i) / frames_in_flight;
         }
 
+        // joint palette
+        _storage_buffer._joint_palette_frame_size =
+            roundUp(static_cast<uint32_t>(sizeof(MeshJointPaletteStorageBufferObject)),
+                    _storage_buffer._min_storage_buffer_offset_alignment);
+        VulkanUtil::createBuffer(raw_rhi->m_physical_device,
+                                 raw_rhi->m_device,
+                                 _storage_buffer._joint_palette_frame_size * frames_in_flight,
+                                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                 _storage_buffer._joint_palette_buffer,
+                                 _storage_buffer._joint_palette_buffer_memory);
+
         // axis
         VulkanUtil::createBuffer(raw_rhi->m_physical_device,
                                  raw_rhi->m_device,
@@ -1237,6 +1719,13 @@ namespace Piccolo
                     0,
                     &_storage_buffer._global_upload_ringbuffer_memory_pointer);
 
+        vkMapMemory(raw_rhi->m_device,
+                    _storage_buffer._joint_palette_buffer_memory,
+                    0,
+                    VK_WHOLE_SIZE,
+                    0,
+                    &_storage_buffer._joint_palette_buffer_memory_pointer);
+
         vkMapMemory(raw_rhi->m_device,
                     _storage_buffer._axis_inefficient_storage_buffer_memory,
                     0,
@@ -11,7 +11,9 @@
 
 #include <array>
 #include <cstdint>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <vector>
 
 namespace Piccolo
@@ -84,20 +86,53 @@ namespace Piccolo
         std::vector<uint32_t> _global_upload_ringbuffers_end;
         std::vector<uint32_t> _global_upload_ringbuffers_size;
 
+        // passes recorded on worker threads share the ring, so they go through this locked bump allocation
+        std::mutex _global_upload_ringbuffer_mutex;
+        uint32_t   allocateFromRingBuffer(uint8_t current_frame_index, uint32_t size);
+
         VkBuffer       _global_null_descriptor_storage_buffer;
         VkDeviceMemory _global_null_descriptor_storage_buffer_memory;
 
+        // joint palette, one region of _joint_palette_frame_size per frame in flight
+        VkBuffer       _joint_palette_buffer;
+        VkDeviceMemory _joint_palette_buffer_memory;
+        void*          _joint_palette_buffer_memory_pointer;
+        uint32_t       _joint_palette_frame_size {0};
+        uint32_t       getJointPaletteDynamicOffset(uint8_t current_frame_index) const;
+
         // axis
         VkBuffer       _axis_inefficient_storage_buffer;
         VkDeviceMemory _axis_inefficient_storage_buffer_memory;
         void*          _axis_inefficient_storage_buffer_memory_pointer;
     };
 
+    struct BindlessResource
+    {
+        VkDescriptorPool _descriptor_pool {VK_NULL_HANDLE};
+        VkDescriptorSet  _descriptor_set {VK_NULL_HANDLE};
+
+        VkBuffer      _material_storage_buffer {VK_NULL_HANDLE};
+        VmaAllocation _material_storage_buffer_allocation;
+        void*         _material_storage_buffer_memory_pointer {nullptr};
+
+        // unused slots of the material array and the joint binding buffer array
+        std::vector<uint32_t> _free_material_indices;
+        std::vector<uint32_t> _free_mesh_indices;
+    };
+
+    struct VulkanResourceResidency
+    {
+        uint32_t     ref_count {0};
+        uint64_t     last_used_frame {0};
+        VkDeviceSize size {0};
+    };
+
     struct GlobalRenderResource
     {
         IBLResource          _ibl_resource;
         ColorGradingResource _color_grading_resource;
         StorageBuffer        _storage_buffer;
+        BindlessResource     _bindless_resource;
     };
 
     class RenderResource : public RenderResourceBase
@@ -122,6 +157,21 @@ namespace Piccolo
         virtual void updatePerFrameBuffer(std::shared_ptr<RenderScene>  render_scene,
                                           std::shared_ptr<RenderCamera> camera) override final;
 
+        virtual void retainRenderEntityResource(const RenderEntity& render_entity) override final;
+        virtual void releaseRenderEntityResource(const RenderEntity& render_entity) override final;
+
+        virtual void updateResourceResidency(std::shared_ptr<RHI>         rhi,
+                                             std::shared_ptr<RenderScene> render_scene) override final;
+
+        // unreferenced mesh and material are kept cached until the budget is exceeded, 0 means no limit
+        void setResourceBudget(VkDeviceSize budget_size) { m_resource_budget_size = budget_size; }
+
+        // global texture array and material storage buffer indexed by the bindless mesh pipelines
+        void createBindlessResource(std::shared_ptr<RHI> rhi);
+
+        // writes the joint matrices of every animated entity once per frame, all passes index the same palette
+        void updateJointPalette(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderScene> render_scene);
+
         VulkanMesh& getEntityMesh(RenderEntity entity);
 
         VulkanPBRMaterial& getEntityMaterial(RenderEntity entity);
@@ -134,8 +184,6 @@ namespace Piccolo
         // storage buffer objects
         MeshPerframeStorageBufferObject                 m_mesh_perframe_storage_buffer_object;
         MeshPointLightShadowPerframeStorageBufferObject m_mesh_point_light_shadow_perframe_storage_buffer_object;
-        MeshDirectionalLightShadowPerframeStorageBufferObject
-                                                       m_mesh_directional_light_shadow_perframe_storage_buffer_object;
         AxisStorageBufferObject                        m_axis_storage_buffer_object;
         MeshInefficientPickPerframeStorageBufferObject m_mesh_inefficient_pick_perframe_storage_buffer_object;
         ParticleBillboardPerframeStorageBufferObject   m_particlebillboard_perframe_storage_buffer_object;
@@ -145,11 +193,39 @@ namespace Piccolo
         std::map<size_t, VulkanMesh>        m_vulkan_meshes;
         std::map<size_t, VulkanPBRMaterial> m_vulkan_pbr_materials;
 
+        // residency of cached mesh and material
+        std::map<size_t, VulkanResourceResidency> m_mesh_residency;
+        std::map<size_t, VulkanResourceResidency> m_material_residency;
+
         // descriptor set layout in main camera pass will be used when uploading resource
         const VkDescriptorSetLayout* m_mesh_descriptor_set_layout {nullptr};
         const VkDescriptorSetLayout* m_material_descriptor_set_layout {nullptr};
+        const VkDescriptorSetLayout* m_bindless_descriptor_set_layout {nullptr};
 
     private:
+        // the frame counter advances once per updateResourceResidency
+        uint64_t     m_current_frame {0};
+        VkDeviceSize m_resident_size {0};
+        VkDeviceSize m_resource_budget_size {0};
+
+        // warn once when the joint palette starts to overflow
+        bool m_is_joint_palette_full {false};
+
+        // released resources wait here until the frames that may still use them are finished
+        std::deque<std::pair<uint64_t, VulkanMesh>>        m_retired_meshes;
+        std::deque<std::pair<uint64_t, VulkanPBRMaterial>> m_retired_materials;
+
+        void evictUnreferencedResources(std::shared_ptr<RenderScene> render_scene);
+        void destroyRetiredResources(std::shared_ptr<RHI> rhi);
+        void destroyVulkanMesh(std::shared_ptr<RHI> rhi, VulkanMesh& mesh);
+        void destroyVulkanMaterial(std::shared_ptr<RHI> rhi, VulkanPBRMaterial& material);
+
+        void updateBindlessMesh(std::shared_ptr<RHI> rhi, VulkanMesh& mesh);
+        void updateBindlessMaterial(std::shared_ptr<RHI>         rhi,
+                                    const RenderEntity&          entity,
+                                    const VkDescriptorImageInfo* texture_image_infos,
+                                    VulkanPBRMaterial&           material);
+
         void createAndMapStorageBuffer(std::shared_ptr<RHI> rhi);
         void createIBLSamplers(std::shared_ptr<RHI> rhi);
         void createIBLTextures(std::shared_ptr<RHI>                        rhi,
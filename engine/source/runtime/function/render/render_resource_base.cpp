@@ -16,20 +16,118 @@
 
 #include <algorithm>
 #include <filesystem>
+#include <fstream>
+#include <initializer_list>
 #include <vector>
 
 namespace Piccolo
 {
+    // "PCKT" and "PCKM" in a little endian file
+    static constexpr uint32_t k_cooked_texture_magic = 0x544B4350;
+    static constexpr uint32_t k_cooked_mesh_magic    = 0x4D4B4350;
+
+    struct CookedTextureHeader
+    {
+        uint32_t magic {k_cooked_texture_magic};
+        uint32_t width {0};
+        uint32_t height {0};
+        uint32_t format {0};
+        uint64_t pixel_size {0};
+    };
+
+    struct CookedMeshHeader
+    {
+        uint32_t magic {k_cooked_mesh_magic};
+        uint32_t vertex_count {0};
+        uint32_t index_count {0};
+        float    min_corner[3] {};
+        float    max_corner[3] {};
+    };
+
+    static uint64_t getPixelSize(const TextureData& texture)
+    {
+        switch (texture.m_format)
+        {
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_R8G8B8A8_UNORM:
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_R8G8B8A8_SRGB:
+                return 4ull * texture.m_width * texture.m_height;
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_R32G32_FLOAT:
+                return 8ull * texture.m_width * texture.m_height;
+            case PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_R32G32B32A32_FLOAT:
+                return 16ull * texture.m_width * texture.m_height;
+            default:
+                return 0;
+        }
+    }
+
+    static bool writeCookedFile(const std::filesystem::path&                            cooked_file,
+                                std::initializer_list<std::pair<const void*, uint64_t>> blocks)
+    {
+        std::ofstream file(cooked_file, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            LOG_ERROR("open file {} failed!", cooked_file.generic_string());
+            return false;
+        }
+
+        for (const auto& block : blocks)
+        {
+            file.write(static_cast<const char*>(block.first), static_cast<std::streamsize>(block.second));
+        }
+        file.flush();
+        return static_cast<bool>(file);
+    }
+
     std::shared_ptr<TextureData> RenderResourceBase::loadTextureHDR(std::string file, int desired_channels)
     {
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
         ASSERT(asset_manager);
 
+        // the cooker decodes with the default channel count
+        if (desired_channels == 4)
+        {
+            std::filesystem::path cooked_path = asset_manager->getCookedAssetPath(file, CookedAssetKind::texture_hdr);
+            if (!cooked_path.empty())
+            {
+                std::shared_ptr<TextureData> texture = loadCookedTexture(cooked_path);
+                if (texture)
+                {
+                    return texture;
+                }
+            }
+        }
+
+        return decodeTextureHDR(asset_manager->getFullPath(file), desired_channels);
+    }
+
+    std::shared_ptr<TextureData> RenderResourceBase::loadTexture(std::string file, bool is_srgb)
+    {
+        std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+        ASSERT(asset_manager);
+
+        std::filesystem::path cooked_path = asset_manager->getCookedAssetPath(file, CookedAssetKind::texture);
+        if (!cooked_path.empty())
+        {
+            // the same pixels serve both color spaces
+            std::shared_ptr<TextureData> texture = loadCookedTexture(cooked_path);
+            if (texture)
+            {
+                texture->m_format = (is_srgb) ? PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_R8G8B8A8_SRGB :
+                                                PICCOLO_PIXEL_FORMAT::PICCOLO_PIXEL_FORMAT_R8G8B8A8_UNORM;
+                return texture;
+            }
+        }
+
+        return decodeTexture(asset_manager->getFullPath(file), is_srgb);
+    }
+
+    std::shared_ptr<TextureData> RenderResourceBase::decodeTextureHDR(const std::filesystem::path& file,
+                                                                      int                          desired_channels)
+    {
         std::shared_ptr<TextureData> texture = std::make_shared<TextureData>();
 
         int iw, ih, n;
-        texture->m_pixels =
-            stbi_loadf(asset_manager->getFullPath(file).generic_string().c_str(), &iw, &ih, &n, desired_channels);
+        texture->m_pixels = stbi_loadf(file.generic_string().c_str(), &iw, &ih, &n, desired_channels);
 
         if (!texture->m_pixels)
             return nullptr;
@@ -57,15 +155,12 @@ namespace Piccolo
         return texture;
     }
 
-    std::shared_ptr<TextureData> RenderResourceBase::loadTexture(std::string file, bool is_srgb)
+    std::shared_ptr<TextureData> RenderResourceBase::decodeTexture(const std::filesystem::path& file, bool is_srgb)
     {
-        std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
-        ASSERT(asset_manager);
-
         std::shared_ptr<TextureData> texture = std::make_shared<TextureData>();
 
         int iw, ih, n;
-        texture->m_pixels = stbi_load(asset_manager->getFullPath(file).generic_string().c_str(), &iw, &ih, &n, 4);
+        texture->m_pixels = stbi_load(file.generic_string().c_str(), &iw, &ih, &n, 4);
 
         if (!texture->m_pixels)
             return nullptr;
@@ -82,6 +177,119 @@ namespace Piccolo
         return texture;
     }
 
+    bool RenderResourceBase::saveCookedTexture(const TextureData& texture, const std::filesystem::path& cooked_file)
+    {
+        CookedTextureHeader header;
+        header.width      = texture.m_width;
+        header.height     = texture.m_height;
+        header.format     = static_cast<uint32_t>(texture.m_format);
+        header.pixel_size = getPixelSize(texture);
+        if (header.pixel_size == 0 || texture.m_pixels == nullptr)
+        {
+            return false;
+        }
+
+        return writeCookedFile(cooked_file, {{&header, sizeof(header)}, {texture.m_pixels, header.pixel_size}});
+    }
+
+    std::shared_ptr<TextureData> RenderResourceBase::loadCookedTexture(const std::filesystem::path& cooked_file)
+    {
+        std::ifstream file(cooked_file, std::ios::binary);
+        if (!file)
+        {
+            return nullptr;
+        }
+
+        CookedTextureHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != k_cooked_texture_magic)
+        {
+            return nullptr;
+        }
+
+        std::shared_ptr<TextureData> texture = std::make_shared<TextureData>();
+        texture->m_width        = header.width;
+        texture->m_height       = header.height;
+        texture->m_format       = static_cast<PICCOLO_PIXEL_FORMAT>(header.format);
+        texture->m_depth        = 1;
+        texture->m_array_layers = 1;
+        texture->m_mip_levels   = 1;
+        texture->m_type         = PICCOLO_IMAGE_TYPE::PICCOLO_IMAGE_TYPE_2D;
+        if (header.pixel_size != getPixelSize(*texture))
+        {
+            return nullptr;
+        }
+
+        // read straight into the buffer the texture frees
+        texture->m_pixels = malloc(static_cast<size_t>(header.pixel_size));
+        if (!texture->m_pixels ||
+            !file.read(static_cast<char*>(texture->m_pixels), static_cast<std::streamsize>(header.pixel_size)))
+        {
+            return nullptr;
+        }
+        return texture;
+    }
+
+    bool RenderResourceBase::saveCookedStaticMesh(const StaticMeshData&        mesh_data,
+                                                  const AxisAlignedBox&        bounding_box,
+                                                  const std::filesystem::path& cooked_file)
+    {
+        const BufferData& vertex_buffer = *mesh_data.m_vertex_buffer;
+        const BufferData& index_buffer  = *mesh_data.m_index_buffer;
+
+        CookedMeshHeader header;
+        header.vertex_count  = static_cast<uint32_t>(vertex_buffer.m_size / sizeof(MeshVertexDataDefinition));
+        header.index_count   = static_cast<uint32_t>(index_buffer.m_size / sizeof(uint16_t));
+        header.min_corner[0] = bounding_box.getMinCorner().x;
+        header.min_corner[1] = bounding_box.getMinCorner().y;
+        header.min_corner[2] = bounding_box.getMinCorner().z;
+        header.max_corner[0] = bounding_box.getMaxCorner().x;
+        header.max_corner[1] = bounding_box.getMaxCorner().y;
+        header.max_corner[2] = bounding_box.getMaxCorner().z;
+
+        return writeCookedFile(cooked_file,
+                               {{&header, sizeof(header)},
+                                {vertex_buffer.m_data, vertex_buffer.m_size},
+                                {index_buffer.m_data, index_buffer.m_size}});
+    }
+
+    bool RenderResourceBase::loadCookedStaticMesh(const std::filesystem::path& cooked_file,
+                                                  StaticMeshData&              mesh_data,
+                                                  AxisAlignedBox&              bounding_box)
+    {
+        std::ifstream file(cooked_file, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+
+        CookedMeshHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != k_cooked_mesh_magic)
+        {
+            return false;
+        }
+
+        std::shared_ptr<BufferData> vertex_buffer =
+            std::make_shared<BufferData>(header.vertex_count * sizeof(MeshVertexDataDefinition));
+        std::shared_ptr<BufferData> index_buffer =
+            std::make_shared<BufferData>(header.index_count * sizeof(uint16_t));
+        const std::streamsize vertex_size = static_cast<std::streamsize>(vertex_buffer->m_size);
+        const std::streamsize index_size  = static_cast<std::streamsize>(index_buffer->m_size);
+        if (!file.read(static_cast<char*>(vertex_buffer->m_data), vertex_size) ||
+            !file.read(static_cast<char*>(index_buffer->m_data), index_size))
+        {
+            return false;
+        }
+
+        mesh_data.m_vertex_buffer = vertex_buffer;
+        mesh_data.m_index_buffer  = index_buffer;
+        if (header.vertex_count > 0)
+        {
+            bounding_box.merge(Vector3(header.min_corner[0], header.min_corner[1], header.min_corner[2]));
+            bounding_box.merge(Vector3(header.max_corner[0], header.max_corner[1], header.max_corner[2]));
+        }
+        return true;
+    }
+
     RenderMeshData RenderResourceBase::loadMeshData(const MeshSourceDesc& source, AxisAlignedBox& bounding_box)
     {
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
@@ -91,7 +299,12 @@ namespace Piccolo
 
         if (std::filesystem::path(source.m_mesh_file).extension() == ".obj")
         {
-            ret.m_static_mesh_data = loadStaticMesh(source.m_mesh_file, bounding_box);
+            std::filesystem::path cooked_path =
+                asset_manager->getCookedAssetPath(source.m_mesh_file, CookedAssetKind::static_mesh);
+            if (cooked_path.empty() || !loadCookedStaticMesh(cooked_path, ret.m_static_mesh_data, bounding_box))
+            {
+                ret.m_static_mesh_data = decodeStaticMesh(source.m_mesh_file, bounding_box);
+            }
         }
         else if (std::filesystem::path(source.m_mesh_file).extension() == ".json")
         {
@@ -173,7 +386,7 @@ namespace Piccolo
         return AxisAlignedBox();
     }
 
-    StaticMeshData RenderResourceBase::loadStaticMesh(std::string filename, AxisAlignedBox& bounding_box)
+    StaticMeshData RenderResourceBase::decodeStaticMesh(const std::string& filename, AxisAlignedBox& bounding_box)
     {
         StaticMeshData mesh_data;
 
@@ -4,6 +4,7 @@
 #include "runtime/function/render/render_swap_context.h"
 #include "runtime/function/render/render_type.h"
 
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -37,16 +38,38 @@ namespace Piccolo
         virtual void updatePerFrameBuffer(std::shared_ptr<RenderScene>  render_scene,
                                           std::shared_ptr<RenderCamera> camera) = 0;
 
-        // TODO: data caching
+        // residency of the mesh and material referenced by a render entity
+        virtual void retainRenderEntityResource(const RenderEntity& render_entity)  = 0;
+        virtual void releaseRenderEntityResource(const RenderEntity& render_entity) = 0;
+
+        // destroy retired resources and evict unreferenced ones to stay within the budget
+        virtual void updateResourceResidency(std::shared_ptr<RHI>         rhi,
+                                             std::shared_ptr<RenderScene> render_scene) = 0;
+
+        // cooked artifacts are loaded instead of the sources while they are up to date
         std::shared_ptr<TextureData> loadTextureHDR(std::string file, int desired_channels = 4);
         std::shared_ptr<TextureData> loadTexture(std::string file, bool is_srgb = false);
         RenderMeshData               loadMeshData(const MeshSourceDesc& source, AxisAlignedBox& bounding_box);
         RenderMaterialData           loadMaterialData(const MaterialSourceDesc& source);
         AxisAlignedBox               getCachedBoudingBox(const MeshSourceDesc& source) const;
 
-    private:
-        StaticMeshData loadStaticMesh(std::string mesh_file, AxisAlignedBox& bounding_box);
+        // decoding of the sources, shared with the asset cooker
+        static std::shared_ptr<TextureData> decodeTextureHDR(const std::filesystem::path& file, int desired_channels);
+        static std::shared_ptr<TextureData> decodeTexture(const std::filesystem::path& file, bool is_srgb);
+        static StaticMeshData               decodeStaticMesh(const std::string& filename, AxisAlignedBox& bounding_box);
 
+        // the cooked formats are the decoded buffers, read back without any conversion
+        static std::shared_ptr<TextureData> loadCookedTexture(const std::filesystem::path& cooked_file);
+
+        static bool saveCookedTexture(const TextureData& texture, const std::filesystem::path& cooked_file);
+        static bool saveCookedStaticMesh(const StaticMeshData&        mesh_data,
+                                         const AxisAlignedBox&        bounding_box,
+                                         const std::filesystem::path& cooked_file);
+        static bool loadCookedStaticMesh(const std::filesystem::path& cooked_file,
+                                         StaticMeshData&              mesh_data,
+                                         AxisAlignedBox&              bounding_box);
+
+    private:
         std::unordered_map<MeshSourceDesc, AxisAlignedBox> m_bounding_box_cache_map;
     };
 } // namespace Piccolo
@@ -3,6 +3,8 @@
 #include "runtime/function/render/render_pass.h"
 #include "runtime/function/render/render_resource.h"
 
+#include <algorithm>
+
 namespace Piccolo
 {
     void RenderScene::updateVisibleObjects(std::shared_ptr<RenderResource> render_resource,
@@ -12,15 +14,48 @@ namespace Piccolo
         updateVisibleObjectsPointLight(render_resource);
         updateVisibleObjectsMainCamera(render_resource, camera);
         updateVisibleObjectsAxis(render_resource);
-        updateVisibleObjectsParticle(render_resource);
+        updateVisibleObjectsParticle(camera);
+
+        // entities changed by the next swap data belong to the next frame
+        ++m_frame_index;
     }
 
     void RenderScene::setVisibleNodesReference()
     {
-        RenderPass::m_visiable_nodes.p_directional_light_visible_mesh_nodes = &m_directional_light_visible_mesh_nodes;
-        RenderPass::m_visiable_nodes.p_point_lights_visible_mesh_nodes      = &m_point_lights_visible_mesh_nodes;
-        RenderPass::m_visiable_nodes.p_main_camera_visible_mesh_nodes       = &m_main_camera_visible_mesh_nodes;
-        RenderPass::m_visiable_nodes.p_axis_node                            = &m_axis_node;
+        RenderPass::m_visiable_nodes.p_directional_light_cascades      = &m_directional_light_cascades;
+        RenderPass::m_visiable_nodes.p_point_lights_visible_mesh_nodes = &m_point_lights_visible_mesh_nodes;
+        RenderPass::m_visiable_nodes.p_main_camera_visible_mesh_nodes  = &m_main_camera_visible_mesh_nodes;
+        RenderPass::m_visiable_nodes.p_axis_node                       = &m_axis_node;
+        RenderPass::m_visiable_nodes.p_particle_emitter_nodes          = &m_particle_emitter_nodes;
+    }
+
+    bool RenderScene::isStaticShadowCaster(const RenderEntity& entity) const
+    {
+        return m_frame_index - entity.m_last_change_frame >= s_static_shadow_caster_frame_count;
+    }
+
+    void RenderScene::invalidateShadowCaster(const RenderEntity& entity)
+    {
+        if (isStaticShadowCaster(entity))
+        {
+            m_static_shadow_casters_dirty = true;
+        }
+
+        BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
+                                             entity.m_bounding_box.getMaxCorner()};
+        BoundingBox mesh_bounding_box_world = BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix);
+        for (uint32_t i = 0; i < m_point_light_shadow_source_count; ++i)
+        {
+            BoundingSphere point_light_bounding_sphere;
+            point_light_bounding_sphere.m_center = Vector3(m_point_light_shadow_sources[i].x,
+                                                           m_point_light_shadow_sources[i].y,
+                                                           m_point_light_shadow_sources[i].z);
+            point_light_bounding_sphere.m_radius = m_point_light_shadow_sources[i].w;
+            if (BoxIntersectsWithSphere(mesh_bounding_box_world, point_light_bounding_sphere))
+            {
+                m_point_light_shadow_dirty_layers |= 3u << (2 * i);
+            }
+        }
     }
 
     GuidAllocator<GameObjectPartId>& RenderScene::getInstanceIdAllocator() { return m_instance_id_allocator; }
@@ -34,7 +69,10 @@ namespace Piccolo
 
     void RenderScene::addInstanceIdToMap(uint32_t instance_id, GObjectID go_id)
     {
-        m_mesh_object_id_map[instance_id] = go_id;
+        if (m_mesh_object_id_map.emplace(instance_id, go_id).second)
+        {
+            m_object_instance_ids_map[go_id].push_back(instance_id);
+        }
     }
 
     GObjectID RenderScene::getGObjectIDByMeshID(uint32_t mesh_id) const
@@ -47,73 +85,156 @@ namespace Piccolo
         return GObjectID();
     }
 
-    void RenderScene::deleteEntityByGObjectID(GObjectID go_id)
+    void RenderScene::addRenderEntity(const RenderEntity& entity)
+    {
+        m_render_entity_indices[entity.m_instance_id] = m_render_entities.size();
+        m_render_entities.push_back(entity);
+    }
+
+    RenderEntity* RenderScene::findRenderEntity(const GameObjectPartId& part_id)
     {
-        for (auto it = m_mesh_object_id_map.begin(); it != m_mesh_object_id_map.end(); it++)
+        size_t find_guid;
+        if (!m_instance_id_allocator.getElementGuid(part_id, find_guid))
         {
-            if (it->second == go_id)
-            {
-                m_mesh_object_id_map.erase(it);
-                break;
-            }
+            return nullptr;
+        }
+
+        auto find_it = m_render_entity_indices.find(static_cast<uint32_t>(find_guid));
+        if (find_it == m_render_entity_indices.end())
+        {
+            return nullptr;
         }
+        return &m_render_entities[find_it->second];
+    }
 
-        GameObjectPartId part_id = {go_id, 0};
-        size_t           find_guid;
-        if (m_instance_id_allocator.getElementGuid(part_id, find_guid))
+    void RenderScene::deleteEntityByGObjectID(std::shared_ptr<RenderResource> render_resource, GObjectID go_id)
+    {
+        // every part of the object has its own instance id
+        auto instance_ids_iter = m_object_instance_ids_map.find(go_id);
+        if (instance_ids_iter == m_object_instance_ids_map.end())
         {
-            for (auto it = m_render_entities.begin(); it != m_render_entities.end(); it++)
+            return;
+        }
+        std::vector<uint32_t> instance_ids = std::move(instance_ids_iter->second);
+        m_object_instance_ids_map.erase(instance_ids_iter);
+
+        for (uint32_t instance_id : instance_ids)
+        {
+            m_mesh_object_id_map.erase(instance_id);
+            m_instance_id_allocator.freeGuid(instance_id);
+
+            auto index_iter = m_render_entity_indices.find(instance_id);
+            if (index_iter == m_render_entity_indices.end())
             {
-                if (it->m_instance_id == find_guid)
-                {
-                    m_render_entities.erase(it);
-                    break;
-                }
+                continue;
             }
+
+            size_t        entity_index = index_iter->second;
+            RenderEntity& entity       = m_render_entities[entity_index];
+            invalidateShadowCaster(entity);
+            render_resource->releaseRenderEntityResource(entity);
+
+            // the last entity takes the place of the removed one
+            m_render_entity_indices.erase(index_iter);
+            if (entity_index + 1 != m_render_entities.size())
+            {
+                RenderEntity& moved_entity                          = m_render_entities[entity_index];
+                moved_entity                                        = std::move(m_render_entities.back());
+                m_render_entity_indices[moved_entity.m_instance_id] = entity_index;
+            }
+            m_render_entities.pop_back();
         }
     }
 
-    void RenderScene::clearForLevelReloading()
+    void RenderScene::clearForLevelReloading(std::shared_ptr<RenderResource> render_resource)
     {
+        for (const RenderEntity& entity : m_render_entities)
+        {
+            render_resource->releaseRenderEntityResource(entity);
+        }
+
         m_instance_id_allocator.clear();
         m_mesh_object_id_map.clear();
+        m_object_instance_ids_map.clear();
         m_render_entities.clear();
+        m_render_entity_indices.clear();
+
+        m_static_shadow_casters_dirty     = true;
+        m_point_light_shadow_source_count = 0;
+        m_point_light_shadow_dirty_layers = 0;
     }
 
     void RenderScene::updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
                                                            std::shared_ptr<RenderCamera>   camera)
     {
-        Matrix4x4 directional_light_proj_view = CalculateDirectionalLightCamera(*this, *camera);
+        std::array<Matrix4x4, s_directional_light_cascade_count> cascade_proj_views =
+            CalculateDirectionalLightCascades(*this, *camera);
+
+        // an entity that has just become static moves from the dynamic to the cached row
+        for (const RenderEntity& entity : m_render_entities)
+        {
+            if (m_frame_index - entity.m_last_change_frame == s_static_shadow_caster_frame_count)
+            {
+                m_static_shadow_casters_dirty = true;
+                break;
+            }
+        }
 
-        render_resource->m_mesh_perframe_storage_buffer_object.directional_light_proj_view =
-            directional_light_proj_view;
-        render_resource->m_mesh_directional_light_shadow_perframe_storage_buffer_object.light_proj_view =
-            directional_light_proj_view;
+        std::array<ClusterFrustum, s_directional_light_cascade_count> cascade_frustums;
+        for (uint32_t cascade_index = 0; cascade_index < s_directional_light_cascade_count; ++cascade_index)
+        {
+            RenderDirectionalLightCascade& cascade = m_directional_light_cascades[cascade_index];
 
-        m_directional_light_visible_mesh_nodes.clear();
+            // the projections are texel snapped, so they only change when the cascade really moves
+            if (m_static_shadow_casters_dirty || cascade.proj_view != cascade_proj_views[cascade_index])
+            {
+                cascade.static_dirty = true;
+            }
+            cascade.proj_view = cascade_proj_views[cascade_index];
+            cascade.static_mesh_nodes.clear();
+            cascade.dynamic_mesh_nodes.clear();
 
-        ClusterFrustum frustum =
-            CreateClusterFrustumFromMatrix(directional_light_proj_view, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+            render_resource->m_mesh_perframe_storage_buffer_object.directional_light_proj_view[cascade_index] =
+                cascade.proj_view;
+
+            cascade_frustums[cascade_index] =
+                CreateClusterFrustumFromMatrix(cascade.proj_view, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+        }
+        m_static_shadow_casters_dirty = false;
 
         for (const RenderEntity& entity : m_render_entities)
         {
             BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
                                                  entity.m_bounding_box.getMaxCorner()};
+            BoundingBox mesh_bounding_box_world = BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix);
+
+            bool is_static = isStaticShadowCaster(entity);
 
-            if (TiledFrustumIntersectBox(frustum, BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix)))
+            for (uint32_t cascade_index = 0; cascade_index < s_directional_light_cascade_count; ++cascade_index)
             {
-                m_directional_light_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_directional_light_visible_mesh_nodes.back();
+                RenderDirectionalLightCascade& cascade = m_directional_light_cascades[cascade_index];
 
-                temp_node.model_matrix = &entity.m_model_matrix;
+                // static casters are only needed by the cascades whose cache is redrawn
+                if (is_static && !cascade.static_dirty)
+                {
+                    continue;
+                }
 
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
+                if (!TiledFrustumIntersectBox(cascade_frustums[cascade_index], mesh_bounding_box_world))
                 {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
+                    continue;
                 }
-                temp_node.node_id = entity.m_instance_id;
+
+                std::vector<RenderMeshNode>& mesh_nodes =
+                    is_static ? cascade.static_mesh_nodes : cascade.dynamic_mesh_nodes;
+                mesh_nodes.emplace_back();
+                RenderMeshNode& temp_node = mesh_nodes.back();
+
+                temp_node.model_matrix = &entity.m_model_matrix;
+
+                temp_node.joint_matrix_offset = entity.m_joint_palette_offset;
+                temp_node.joint_count         = entity.m_joint_palette_count;
+                temp_node.node_id             = entity.m_instance_id;
 
                 VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
                 temp_node.ref_mesh               = &mesh_asset;
@@ -132,24 +253,84 @@ namespace Piccolo
         std::vector<BoundingSphere> point_lights_bounding_spheres;
         uint32_t                    point_light_num = static_cast<uint32_t>(m_point_light_list.m_lights.size());
         point_lights_bounding_spheres.resize(point_light_num);
-        for (size_t i = 0; i < point_light_num; i++)
+
+        // lights that were moved or resized redraw both of their layers, new lights are drawn right away
+        uint32_t new_point_light_layers = 0;
+        for (uint32_t i = 0; i < point_light_num; i++)
         {
             point_lights_bounding_spheres[i].m_center = m_point_light_list.m_lights[i].m_position;
             point_lights_bounding_spheres[i].m_radius = m_point_light_list.m_lights[i].calculateRadius();
+
+            Vector4 point_light_source(point_lights_bounding_spheres[i].m_center,
+                                       point_lights_bounding_spheres[i].m_radius);
+            if (i >= m_point_light_shadow_source_count)
+            {
+                new_point_light_layers |= 3u << (2 * i);
+            }
+            else if (point_light_source != m_point_light_shadow_sources[i])
+            {
+                m_point_light_shadow_dirty_layers |= 3u << (2 * i);
+            }
+            m_point_light_shadow_sources[i] = point_light_source;
         }
+        m_point_light_shadow_source_count = point_light_num;
 
+        std::vector<BoundingBox> mesh_bounding_boxes_world;
+        mesh_bounding_boxes_world.reserve(m_render_entities.size());
         for (const RenderEntity& entity : m_render_entities)
         {
             BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
                                                  entity.m_bounding_box.getMaxCorner()};
+            mesh_bounding_boxes_world.push_back(BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix));
+
+            // casters added or moved this frame, their previous placement was invalidated by the swap data
+            if (entity.m_last_change_frame != m_frame_index)
+            {
+                continue;
+            }
+            for (uint32_t i = 0; i < point_light_num; i++)
+            {
+                if (BoxIntersectsWithSphere(mesh_bounding_boxes_world.back(), point_lights_bounding_spheres[i]))
+                {
+                    m_point_light_shadow_dirty_layers |= 3u << (2 * i);
+                }
+            }
+        }
+
+        uint32_t point_light_layers = (point_light_num == 0) ? 0 : ((2u << (2 * point_light_num - 1)) - 1);
+        m_point_light_shadow_dirty_layers &= point_light_layers & ~new_point_light_layers;
 
-            bool intersect_with_point_lights = true;
-            for (size_t i = 0; i < point_light_num; i++)
+        // the dirty lights share the per frame budget in round robin order, so none of them starves
+        uint32_t refresh_layers = new_point_light_layers;
+        uint32_t layer_budget   = s_point_light_shadow_layer_budget;
+        for (uint32_t n = 0; n < point_light_num && layer_budget >= 2; n++)
+        {
+            uint32_t i = (m_point_light_shadow_refresh_cursor + n) % point_light_num;
+            if ((m_point_light_shadow_dirty_layers & (3u << (2 * i))) == 0)
             {
-                if (!BoxIntersectsWithSphere(BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix),
-                                             point_lights_bounding_spheres[i]))
+                continue;
+            }
+            refresh_layers |= 3u << (2 * i);
+            layer_budget -= 2;
+            m_point_light_shadow_refresh_cursor = i + 1;
+        }
+        m_point_light_shadow_dirty_layers &= ~refresh_layers;
+
+        render_resource->m_mesh_point_light_shadow_perframe_storage_buffer_object.point_light_layer_mask =
+            refresh_layers;
+
+        for (size_t entity_index = 0; entity_index < m_render_entities.size(); entity_index++)
+        {
+            const RenderEntity& entity = m_render_entities[entity_index];
+
+            // only the casters of the lights that are redrawn this frame are needed
+            bool intersect_with_point_lights = false;
+            for (uint32_t i = 0; i < point_light_num; i++)
+            {
+                if ((refresh_layers & (3u << (2 * i))) != 0 &&
+                    BoxIntersectsWithSphere(mesh_bounding_boxes_world[entity_index], point_lights_bounding_spheres[i]))
                 {
-                    intersect_with_point_lights = false;
+                    intersect_with_point_lights = true;
                     break;
                 }
             }
@@ -161,13 +342,9 @@ namespace Piccolo
 
                 temp_node.model_matrix = &entity.m_model_matrix;
 
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
-                {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
-                }
-                temp_node.node_id = entity.m_instance_id;
+                temp_node.joint_matrix_offset = entity.m_joint_palette_offset;
+                temp_node.joint_count         = entity.m_joint_palette_count;
+                temp_node.node_id             = entity.m_instance_id;
 
                 VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
                 temp_node.ref_mesh               = &mesh_asset;
@@ -201,13 +378,9 @@ namespace Piccolo
                 RenderMeshNode& temp_node = m_main_camera_visible_mesh_nodes.back();
                 temp_node.model_matrix    = &entity.m_model_matrix;
 
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
-                {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
-                }
-                temp_node.node_id = entity.m_instance_id;
+                temp_node.joint_matrix_offset = entity.m_joint_palette_offset;
+                temp_node.joint_count         = entity.m_joint_palette_count;
+                temp_node.node_id             = entity.m_instance_id;
 
                 VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
                 temp_node.ref_mesh               = &mesh_asset;
@@ -234,8 +407,22 @@ namespace Piccolo
         }
     }
 
-    void RenderScene::updateVisibleObjectsParticle(std::shared_ptr<RenderResource> render_resource)
+    void RenderScene::updateVisibleObjectsParticle(std::shared_ptr<RenderCamera> camera)
     {
-        // TODO
+        Matrix4x4 view_matrix      = camera->getViewMatrix();
+        Matrix4x4 proj_matrix      = camera->getPersProjMatrix();
+        Matrix4x4 proj_view_matrix = proj_matrix * view_matrix;
+
+        ClusterFrustum f = CreateClusterFrustumFromMatrix(proj_view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+
+        Vector3 camera_position = camera->position();
+        for (RenderParticleEmitterNode& node : m_particle_emitter_nodes)
+        {
+            Vector3     extent(node.bounds_radius, node.bounds_radius, node.bounds_radius);
+            BoundingBox bounding_box {node.bounds_center - extent, node.bounds_center + extent};
+
+            node.visible         = TiledFrustumIntersectBox(f, bounding_box);
+            node.camera_distance = std::max(camera_position.distance(node.bounds_center) - node.bounds_radius, 0.0f);
+        }
     }
 } // namespace Piccolo
@@ -8,7 +8,9 @@
 #include "runtime/function/render/render_guid_allocator.h"
 #include "runtime/function/render/render_object.h"
 
+#include <array>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace Piccolo
@@ -24,17 +26,32 @@ namespace Piccolo
         PDirectionalLight m_directional_light;
         PointLightList    m_point_light_list;
 
-        // render entities
+        // render entities, add them with addRenderEntity to keep them findable by instance id
         std::vector<RenderEntity> m_render_entities;
 
         // axis, for editor
         std::optional<RenderEntity> m_render_axis;
 
         // visible objects (updated per frame)
-        std::vector<RenderMeshNode> m_directional_light_visible_mesh_nodes;
-        std::vector<RenderMeshNode> m_point_lights_visible_mesh_nodes;
-        std::vector<RenderMeshNode> m_main_camera_visible_mesh_nodes;
-        RenderAxisNode              m_axis_node;
+        RenderDirectionalLightCascades m_directional_light_cascades;
+        std::vector<RenderMeshNode>    m_point_lights_visible_mesh_nodes;
+        std::vector<RenderMeshNode>    m_main_camera_visible_mesh_nodes;
+        RenderAxisNode                 m_axis_node;
+
+        // counts the visibility updates, entities record the frame they last changed in
+        uint32_t m_frame_index {0};
+        // set when a static shadow caster is updated or removed, the cached cascades are redrawn then
+        bool m_static_shadow_casters_dirty {true};
+
+        // the point light shadow layers are kept until their light or a caster in its range changes,
+        // the dirty ones are redrawn in round robin order within s_point_light_shadow_layer_budget
+        std::array<Vector4, s_max_point_light_count> m_point_light_shadow_sources;
+        uint32_t                                     m_point_light_shadow_source_count {0};
+        uint32_t                                     m_point_light_shadow_dirty_layers {0};
+        uint32_t                                     m_point_light_shadow_refresh_cursor {0};
+
+        // particle emitters indexed by emitter id, the bounds are set from the swap data
+        std::vector<RenderParticleEmitterNode> m_particle_emitter_nodes;
 
         // update visible objects in each frame
         void updateVisibleObjects(std::shared_ptr<RenderResource> render_resource,
@@ -43,15 +60,24 @@ namespace Piccolo
         // set visible nodes ptr in render pass
         void setVisibleNodesReference();
 
+        bool isStaticShadowCaster(const RenderEntity& entity) const;
+
+        // the shadows cached at the entity's current placement are stale, call before it is changed or removed
+        void invalidateShadowCaster(const RenderEntity& entity);
+
         GuidAllocator<GameObjectPartId>&   getInstanceIdAllocator();
         GuidAllocator<MeshSourceDesc>&     getMeshAssetIdAllocator();
         GuidAllocator<MaterialSourceDesc>& getMaterialAssetdAllocator();
 
         void      addInstanceIdToMap(uint32_t instance_id, GObjectID go_id);
         GObjectID getGObjectIDByMeshID(uint32_t mesh_id) const;
-        void      deleteEntityByGObjectID(GObjectID go_id);
+        void      deleteEntityByGObjectID(std::shared_ptr<RenderResource> render_resource, GObjectID go_id);
+
+        void addRenderEntity(const RenderEntity& entity);
+        // nullptr if the part was never added or has been removed
+        RenderEntity* findRenderEntity(const GameObjectPartId& part_id);
 
-        void clearForLevelReloading();
+        void clearForLevelReloading(std::shared_ptr<RenderResource> render_resource);
 
     private:
         GuidAllocator<GameObjectPartId>   m_instance_id_allocator;
@@ -59,6 +85,10 @@ namespace Piccolo
         GuidAllocator<MaterialSourceDesc> m_material_asset_id_allocator;
 
         std::unordered_map<uint32_t, GObjectID> m_mesh_object_id_map;
+        // the reverse of m_mesh_object_id_map, the instance ids of every part of an object
+        std::unordered_map<GObjectID, std::vector<uint32_t>> m_object_instance_ids_map;
+        // instance id to the index in m_render_entities, so per frame updates write the entity directly
+        std::unordered_map<uint32_t, size_t> m_render_entity_indices;
 
         void updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
                                                   std::shared_ptr<RenderCamera>   camera);
@@ -66,6 +96,6 @@ namespace Piccolo
         void updateVisibleObjectsMainCamera(std::shared_ptr<RenderResource> render_resource,
                                             std::shared_ptr<RenderCamera>   camera);
         void updateVisibleObjectsAxis(std::shared_ptr<RenderResource> render_resource);
-        void updateVisibleObjectsParticle(std::shared_ptr<RenderResource> render_resource);
+        void updateVisibleObjectsParticle(std::shared_ptr<RenderCamera> camera);
     };
 } // namespace Piccolo
@@ -12,7 +12,12 @@ namespace Piccolo
 
     void GameObjectResourceDesc::pop() { m_game_object_descs.pop_front(); }
 
-    void ParticleSubmitRequest::add(ParticleEmitterDesc& desc) { m_emitter_descs.push_back(desc); }
+    void ParticleSubmitRequest::add(ParticleEmitterDesc& desc, uint32_t max_particle_count, float bounds_radius)
+    {
+        m_emitter_descs.push_back(desc);
+        m_emitter_max_particle_counts.push_back(max_particle_count);
+        m_emitter_bounds_radii.push_back(bounds_radius);
+    }
 
     unsigned int ParticleSubmitRequest::getEmitterCount() const { return m_emitter_descs.size(); }
 
@@ -21,6 +26,16 @@ namespace Piccolo
         return m_emitter_descs[index];
     }
 
+    uint32_t ParticleSubmitRequest::getEmitterMaxParticleCount(unsigned int index) const
+    {
+        return m_emitter_max_particle_counts[index];
+    }
+
+    float ParticleSubmitRequest::getEmitterBoundsRadius(unsigned int index) const
+    {
+        return m_emitter_bounds_radii[index];
+    }
+
     void EmitterTransformRequest::add(ParticleEmitterTransformDesc& desc) { m_transform_descs.push_back(desc); }
 
     unsigned int EmitterTransformRequest::getEmitterCount() const { return m_transform_descs.size(); }
@@ -125,16 +140,18 @@ namespace Piccolo
         }
     }
 
-    void RenderSwapData::addNewParticleEmitter(ParticleEmitterDesc& desc)
+    void RenderSwapData::addNewParticleEmitter(ParticleEmitterDesc& desc,
+                                               uint32_t             max_particle_count,
+                                               float                bounds_radius)
     {
         if (m_particle_submit_request.has_value())
         {
-            m_particle_submit_request->add(desc);
+            m_particle_submit_request->add(desc, max_particle_count, bounds_radius);
         }
         else
         {
             ParticleSubmitRequest request;
-            request.add(desc);
+            request.add(desc, max_particle_count, bounds_radius);
             m_particle_submit_request = request;
         }
     }
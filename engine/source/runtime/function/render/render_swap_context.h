@@ -3,6 +3,7 @@
 #include "runtime/function/particle/emitter_id_allocator.h"
 #include "runtime/function/particle/particle_desc.h"
 #include "runtime/function/render/render_camera.h"
+#include "runtime/function/render/render_command_queue.h"
 #include "runtime/function/render/render_object.h"
 
 #include "runtime/resource/res_type/global/global_particle.h"
@@ -55,12 +56,18 @@ namespace Piccolo
     struct ParticleSubmitRequest
     {
         std::vector<ParticleEmitterDesc> m_emitter_descs;
+        std::vector<uint32_t>            m_emitter_max_particle_counts;
+        std::vector<float>               m_emitter_bounds_radii;
 
-        void add(ParticleEmitterDesc& desc);
+        void add(ParticleEmitterDesc& desc, uint32_t max_particle_count, float bounds_radius);
 
         unsigned int getEmitterCount() const;
 
         const ParticleEmitterDesc& getEmitterDesc(unsigned int index);
+
+        uint32_t getEmitterMaxParticleCount(unsigned int index) const;
+
+        float getEmitterBoundsRadius(unsigned int index) const;
     };
 
     struct EmitterTickRequest
@@ -94,7 +101,7 @@ namespace Piccolo
         void addDirtyGameObject(GameObjectDesc&& desc);
         void addDeleteGameObject(GameObjectDesc&& desc);
 
-        void addNewParticleEmitter(ParticleEmitterDesc& desc);
+        void addNewParticleEmitter(ParticleEmitterDesc& desc, uint32_t max_particle_count, float bounds_radius);
         void addTickParticleEmitter(ParticleEmitterID id);
         void updateParticleTransform(ParticleEmitterTransformDesc& desc);
     };
@@ -120,11 +127,16 @@ namespace Piccolo
         void            resetEmitterTickSwapData();
         void            resetEmitterTransformSwapData();
 
+        // game object updates published from any thread, drained by the render system every frame
+        RenderCommandQueue& getCommandQueue() { return m_command_queue; }
+
     private:
         uint8_t        m_logic_swap_data_index {LogicSwapDataType};
         uint8_t        m_render_swap_data_index {RenderSwapDataType};
         RenderSwapData m_swap_data[SwapDataTypeCount];
 
+        RenderCommandQueue m_command_queue;
+
         bool isReadyToSwap() const;
         void swap();
     };
@@ -29,18 +29,20 @@ namespace Piccolo
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
         ASSERT(asset_manager);
 
+        // global rendering resource
+        GlobalRenderingRes global_rendering_res;
+        const std::string& global_rendering_res_url = config_manager->getGlobalRenderingResUrl();
+        asset_manager->loadAsset(global_rendering_res_url, global_rendering_res);
+
         // render context initialize
         RHIInitInfo rhi_init_info;
-        rhi_init_info.window_system = init_info.window_system;
+        rhi_init_info.window_system       = init_info.window_system;
+        rhi_init_info.enable_bindless     = global_rendering_res.m_enable_bindless;
+        rhi_init_info.pipeline_cache_path = config_manager->getRootFolder() / "pipeline_cache.bin";
 
         m_rhi = std::make_shared<VulkanRHI>();
         m_rhi->initialize(rhi_init_info);
 
-        // global rendering resource
-        GlobalRenderingRes global_rendering_res;
-        const std::string& global_rendering_res_url = config_manager->getGlobalRenderingResUrl();
-        asset_manager->loadAsset(global_rendering_res_url, global_rendering_res);
-
         // upload ibl, color grading textures
         LevelResourceDesc level_resource_desc;
         level_resource_desc.m_ibl_resource_desc.m_skybox_irradiance_map = global_rendering_res.m_skybox_irradiance_map;
@@ -51,6 +53,9 @@ namespace Piccolo
 
         m_render_resource = std::make_shared<RenderResource>();
         m_render_resource->uploadGlobalRenderResource(m_rhi, level_resource_desc);
+        std::static_pointer_cast<RenderResource>(m_render_resource)
+            ->setResourceBudget(static_cast<VkDeviceSize>(global_rendering_res.m_gpu_resource_budget_mb) * 1024 *
+                                1024);
 
         // setup render camera
         const CameraPose& camera_pose = global_rendering_res.m_camera_config.m_pose;
@@ -87,6 +92,14 @@ namespace Piccolo
             &static_cast<RenderPass*>(m_render_pipeline->m_main_camera_pass.get())
                  ->m_descriptor_infos[MainCameraPass::LayoutType::_mesh_per_material]
                  .layout;
+        if (m_rhi->isBindlessEnabled())
+        {
+            std::static_pointer_cast<RenderResource>(m_render_resource)->m_bindless_descriptor_set_layout =
+                &static_cast<RenderPass*>(m_render_pipeline->m_main_camera_pass.get())
+                     ->m_descriptor_infos[MainCameraPass::LayoutType::_mesh_bindless]
+                     .layout;
+            std::static_pointer_cast<RenderResource>(m_render_resource)->createBindlessResource(m_rhi);
+        }
     }
 
     void RenderSystem::tick()
@@ -94,12 +107,18 @@ namespace Piccolo
         // process swap data between logic and render contexts
         processSwapData();
 
+        // release mesh and material no longer in use
+        m_render_resource->updateResourceResidency(m_rhi, m_render_scene);
+
         // prepare render command context
         m_rhi->prepareContext();
 
         // update per-frame buffer
         m_render_resource->updatePerFrameBuffer(m_render_scene, m_render_camera);
 
+        // upload the skinning palettes of this frame
+        std::static_pointer_cast<RenderResource>(m_render_resource)->updateJointPalette(m_rhi, m_render_scene);
+
         // update per-frame visible objects
         m_render_scene->updateVisibleObjects(std::static_pointer_cast<RenderResource>(m_render_resource),
                                              m_render_camera);
@@ -149,9 +168,9 @@ namespace Piccolo
         return {x, y, width, height};
     }
 
-    uint32_t RenderSystem::getGuidOfPickedMesh(const Vector2& picked_uv)
+    void RenderSystem::requestGuidOfPickedMesh(const Vector2& picked_uv, std::function<void(uint32_t)> callback)
     {
-        return m_render_pipeline->getGuidOfPickedMesh(picked_uv);
+        m_render_pipeline->requestGuidOfPickedMesh(picked_uv, std::move(callback));
     }
 
     GObjectID RenderSystem::getGObjectIDByMeshID(uint32_t mesh_id) const
@@ -164,6 +183,9 @@ namespace Piccolo
         for (int i = 0; i < axis_entities.size(); i++)
         {
             m_render_resource->uploadGameObjectRenderResource(m_rhi, axis_entities[i], mesh_datas[i]);
+
+            // axis is not a render entity of the scene, keep its mesh resident
+            m_render_resource->retainRenderEntityResource(axis_entities[i]);
         }
     }
 
@@ -198,7 +220,7 @@ namespace Piccolo
 
     void RenderSystem::clearForLevelReloading()
     {
-        m_render_scene->clearForLevelReloading();
+        m_render_scene->clearForLevelReloading(std::static_pointer_cast<RenderResource>(m_render_resource));
 
         ParticleSubmitRequest request;
 
@@ -215,126 +237,174 @@ namespace Piccolo
         m_render_pipeline->initializeUIRenderBackend(window_ui);
     }
 
-    void RenderSystem::processSwapData()
+    void RenderSystem::updateRenderEntity(GObjectID                 go_id,
+                                          size_t                    part_index,
+                                          const GameObjectPartDesc& game_object_part)
     {
-        RenderSwapData& swap_data = m_swap_context.getRenderSwapData();
-
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
         ASSERT(asset_manager);
 
-        // TODO: update global resources if needed
-        if (swap_data.m_level_resource_desc.has_value())
+        GameObjectPartId part_id = {go_id, part_index};
+
+        bool is_entity_in_scene = m_render_scene->getInstanceIdAllocator().hasElement(part_id);
+
+        RenderEntity render_entity;
+        render_entity.m_instance_id =
+            static_cast<uint32_t>(m_render_scene->getInstanceIdAllocator().allocGuid(part_id));
+        render_entity.m_model_matrix = game_object_part.m_transform_desc.m_transform_matrix;
+
+        m_render_scene->addInstanceIdToMap(render_entity.m_instance_id, go_id);
+
+        // mesh properties
+        MeshSourceDesc mesh_source    = {game_object_part.m_mesh_desc.m_mesh_file};
+        bool           is_mesh_loaded = m_render_scene->getMeshAssetIdAllocator().hasElement(mesh_source);
+
+        RenderMeshData mesh_data;
+        if (!is_mesh_loaded)
         {
-            m_render_resource->uploadGlobalRenderResource(m_rhi, *swap_data.m_level_resource_desc);
+            mesh_data = m_render_resource->loadMeshData(mesh_source, render_entity.m_bounding_box);
+        }
+        else
+        {
+            render_entity.m_bounding_box = m_render_resource->getCachedBoudingBox(mesh_source);
+        }
 
-            // reset level resource swap data to a clean state
-            m_swap_context.resetLevelRsourceSwapData();
+        render_entity.m_mesh_asset_id = m_render_scene->getMeshAssetIdAllocator().allocGuid(mesh_source);
+        render_entity.m_enable_vertex_blending =
+            game_object_part.m_skeleton_animation_result.m_transforms.size() > 1; // take care
+        render_entity.m_joint_matrices.resize(game_object_part.m_skeleton_animation_result.m_transforms.size());
+        for (size_t i = 0; i < game_object_part.m_skeleton_animation_result.m_transforms.size(); ++i)
+        {
+            render_entity.m_joint_matrices[i] = game_object_part.m_skeleton_animation_result.m_transforms[i].m_matrix;
         }
 
-        // update game object if needed
-        if (swap_data.m_game_object_resource_desc.has_value())
+        // material properties
+        MaterialSourceDesc material_source;
+        if (game_object_part.m_material_desc.m_with_texture)
         {
-            while (!swap_data.m_game_object_resource_desc->isEmpty())
-            {
-                GameObjectDesc gobject = swap_data.m_game_object_resource_desc->getNextProcessObject();
+            material_source = {game_object_part.m_material_desc.m_base_color_texture_file,
+                               game_object_part.m_material_desc.m_metallic_roughness_texture_file,
+                               game_object_part.m_material_desc.m_normal_texture_file,
+                               game_object_part.m_material_desc.m_occlusion_texture_file,
+                               game_object_part.m_material_desc.m_emissive_texture_file};
+        }
+        else
+        {
+            // TODO: move to default material definition json file
+            material_source = {asset_manager->getFullPath("asset/texture/default/albedo.jpg").generic_string(),
+                               asset_manager->getFullPath("asset/texture/default/mr.jpg").generic_string(),
+                               asset_manager->getFullPath("asset/texture/default/normal.jpg").generic_string(),
+                               "",
+                               ""};
+        }
+        bool is_material_loaded = m_render_scene->getMaterialAssetdAllocator().hasElement(material_source);
 
-                for (size_t part_index = 0; part_index < gobject.getObjectParts().size(); part_index++)
-                {
-                    const auto&      game_object_part = gobject.getObjectParts()[part_index];
-                    GameObjectPartId part_id          = {gobject.getId(), part_index};
+        RenderMaterialData material_data;
+        if (!is_material_loaded)
+        {
+            material_data = m_render_resource->loadMaterialData(material_source);
+        }
 
-                    bool is_entity_in_scene = m_render_scene->getInstanceIdAllocator().hasElement(part_id);
+        render_entity.m_material_asset_id = m_render_scene->getMaterialAssetdAllocator().allocGuid(material_source);
 
-                    RenderEntity render_entity;
-                    render_entity.m_instance_id =
-                        static_cast<uint32_t>(m_render_scene->getInstanceIdAllocator().allocGuid(part_id));
-                    render_entity.m_model_matrix = game_object_part.m_transform_desc.m_transform_matrix;
+        // create game object on the graphics api side
+        if (!is_mesh_loaded)
+        {
+            m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, mesh_data);
+        }
 
-                    m_render_scene->addInstanceIdToMap(render_entity.m_instance_id, gobject.getId());
+        if (!is_material_loaded)
+        {
+            m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, material_data);
+        }
 
-                    // mesh properties
-                    MeshSourceDesc mesh_source    = {game_object_part.m_mesh_desc.m_mesh_file};
-                    bool           is_mesh_loaded = m_render_scene->getMeshAssetIdAllocator().hasElement(mesh_source);
+        // a changed entity casts a dynamic shadow until it stays unchanged long enough
+        render_entity.m_last_change_frame = m_render_scene->m_frame_index;
 
-                    RenderMeshData mesh_data;
-                    if (!is_mesh_loaded)
-                    {
-                        mesh_data = m_render_resource->loadMeshData(mesh_source, render_entity.m_bounding_box);
-                    }
-                    else
-                    {
-                        render_entity.m_bounding_box = m_render_resource->getCachedBoudingBox(mesh_source);
-                    }
+        // add object to render scene if needed
+        if (!is_entity_in_scene)
+        {
+            m_render_resource->retainRenderEntityResource(render_entity);
+            m_render_scene->addRenderEntity(render_entity);
+        }
+        else
+        {
+            RenderEntity* entity = m_render_scene->findRenderEntity(part_id);
+            if (entity != nullptr)
+            {
+                m_render_scene->invalidateShadowCaster(*entity);
+                m_render_resource->retainRenderEntityResource(render_entity);
+                m_render_resource->releaseRenderEntityResource(*entity);
+                *entity = render_entity;
+            }
+        }
+    }
 
-                    render_entity.m_mesh_asset_id = m_render_scene->getMeshAssetIdAllocator().allocGuid(mesh_source);
-                    render_entity.m_enable_vertex_blending =
-                        game_object_part.m_skeleton_animation_result.m_transforms.size() > 1; // take care
-                    render_entity.m_joint_matrices.resize(
-                        game_object_part.m_skeleton_animation_result.m_transforms.size());
-                    for (size_t i = 0; i < game_object_part.m_skeleton_animation_result.m_transforms.size(); ++i)
+    void RenderSystem::processRenderCommands()
+    {
+        RenderCommandQueue& command_queue = m_swap_context.getCommandQueue();
+
+        RenderCommand command;
+        while (command_queue.tryPop(command))
+        {
+            switch (command.m_type)
+            {
+                case RenderCommandType::AddGameObjectPart:
+                    updateRenderEntity(command.m_go_id, command.m_part_index, *command.m_part_desc);
+                    break;
+                case RenderCommandType::UpdateTransform:
+                case RenderCommandType::UpdateSkeleton:
+                {
+                    RenderEntity* entity = m_render_scene->findRenderEntity({command.m_go_id, command.m_part_index});
+                    if (entity == nullptr)
                     {
-                        render_entity.m_joint_matrices[i] =
-                            game_object_part.m_skeleton_animation_result.m_transforms[i].m_matrix;
+                        break;
                     }
 
-                    // material properties
-                    MaterialSourceDesc material_source;
-                    if (game_object_part.m_material_desc.m_with_texture)
+                    m_render_scene->invalidateShadowCaster(*entity);
+                    if (command.m_type == RenderCommandType::UpdateTransform)
                     {
-                        material_source = {game_object_part.m_material_desc.m_base_color_texture_file,
-                                           game_object_part.m_material_desc.m_metallic_roughness_texture_file,
-                                           game_object_part.m_material_desc.m_normal_texture_file,
-                                           game_object_part.m_material_desc.m_occlusion_texture_file,
-                                           game_object_part.m_material_desc.m_emissive_texture_file};
+                        entity->m_model_matrix = command.m_transform_matrix;
                     }
                     else
                     {
-                        // TODO: move to default material definition json file
-                        material_source = {
-                            asset_manager->getFullPath("asset/texture/default/albedo.jpg").generic_string(),
-                            asset_manager->getFullPath("asset/texture/default/mr.jpg").generic_string(),
-                            asset_manager->getFullPath("asset/texture/default/normal.jpg").generic_string(),
-                            "",
-                            ""};
+                        entity->m_enable_vertex_blending = command.m_joint_matrices.size() > 1; // take care
+                        entity->m_joint_matrices         = std::move(command.m_joint_matrices);
                     }
-                    bool is_material_loaded = m_render_scene->getMaterialAssetdAllocator().hasElement(material_source);
+                    entity->m_last_change_frame = m_render_scene->m_frame_index;
+                    break;
+                }
+                case RenderCommandType::RemoveGameObject:
+                    m_render_scene->deleteEntityByGObjectID(std::static_pointer_cast<RenderResource>(m_render_resource),
+                                                            command.m_go_id);
+                    break;
+            }
+        }
+    }
 
-                    RenderMaterialData material_data;
-                    if (!is_material_loaded)
-                    {
-                        material_data = m_render_resource->loadMaterialData(material_source);
-                    }
+    void RenderSystem::processSwapData()
+    {
+        RenderSwapData& swap_data = m_swap_context.getRenderSwapData();
 
-                    render_entity.m_material_asset_id =
-                        m_render_scene->getMaterialAssetdAllocator().allocGuid(material_source);
+        // TODO: update global resources if needed
+        if (swap_data.m_level_resource_desc.has_value())
+        {
+            m_render_resource->uploadGlobalRenderResource(m_rhi, *swap_data.m_level_resource_desc);
 
-                    // create game object on the graphics api side
-                    if (!is_mesh_loaded)
-                    {
-                        m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, mesh_data);
-                    }
+            // reset level resource swap data to a clean state
+            m_swap_context.resetLevelRsourceSwapData();
+        }
 
-                    if (!is_material_loaded)
-                    {
-                        m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, material_data);
-                    }
+        // update game object if needed
+        if (swap_data.m_game_object_resource_desc.has_value())
+        {
+            while (!swap_data.m_game_object_resource_desc->isEmpty())
+            {
+                GameObjectDesc gobject = swap_data.m_game_object_resource_desc->getNextProcessObject();
 
-                    // add object to render scene if needed
-                    if (!is_entity_in_scene)
-                    {
-                        m_render_scene->m_render_entities.push_back(render_entity);
-                    }
-                    else
-                    {
-                        for (auto& entity : m_render_scene->m_render_entities)
-                        {
-                            if (entity.m_instance_id == render_entity.m_instance_id)
-                            {
-                                entity = render_entity;
-                                break;
-                            }
-                        }
-                    }
+                for (size_t part_index = 0; part_index < gobject.getObjectParts().size(); part_index++)
+                {
+                    updateRenderEntity(gobject.getId(), part_index, gobject.getObjectParts()[part_index]);
                 }
                 // after finished processing, pop this game object
                 swap_data.m_game_object_resource_desc->pop();
@@ -350,13 +420,17 @@ namespace Piccolo
             while (!swap_data.m_game_object_to_delete->isEmpty())
             {
                 GameObjectDesc gobject = swap_data.m_game_object_to_delete->getNextProcessObject();
-                m_render_scene->deleteEntityByGObjectID(gobject.getId());
+                m_render_scene->deleteEntityByGObjectID(std::static_pointer_cast<RenderResource>(m_render_resource),
+                                                        gobject.getId());
                 swap_data.m_game_object_to_delete->pop();
             }
 
             m_swap_context.resetGameObjectToDelete();
         }
 
+        // game object updates published since the last frame, possibly from several threads
+        processRenderCommands();
+
         // process camera swap data
         if (swap_data.m_camera_swap_data.has_value())
         {
@@ -385,11 +459,17 @@ namespace Piccolo
 
             int emitter_count = swap_data.m_particle_submit_request->getEmitterCount();
             particle_pass->setEmitterCount(emitter_count);
+            m_render_scene->m_particle_emitter_nodes.assign(emitter_count, RenderParticleEmitterNode {});
 
             for (int index = 0; index < emitter_count; ++index)
             {
                 const ParticleEmitterDesc& desc = swap_data.m_particle_submit_request->getEmitterDesc(index);
-                particle_pass->createEmitter(index, desc);
+                particle_pass->createEmitter(
+                    index, desc, swap_data.m_particle_submit_request->getEmitterMaxParticleCount(index));
+
+                RenderParticleEmitterNode& node = m_render_scene->m_particle_emitter_nodes[index];
+                node.bounds_center              = Vector3(desc.m_position.x, desc.m_position.y, desc.m_position.z);
+                node.bounds_radius              = swap_data.m_particle_submit_request->getEmitterBoundsRadius(index);
             }
 
             particle_pass->initializeEmitters();
@@ -405,6 +485,14 @@ namespace Piccolo
 
         if (swap_data.m_emitter_transform_request.has_value())
         {
+            for (const ParticleEmitterTransformDesc& transform_desc :
+                 swap_data.m_emitter_transform_request->m_transform_descs)
+            {
+                const Vector4& position = transform_desc.m_position;
+                m_render_scene->m_particle_emitter_nodes[transform_desc.m_id].bounds_center =
+                    Vector3(position.x, position.y, position.z);
+            }
+
             std::static_pointer_cast<ParticlePass>(m_render_pipeline->m_particle_pass)
                 ->setTransformIndices(swap_data.m_emitter_transform_request->m_transform_descs);
             m_swap_context.resetEmitterTransformSwapData();
@@ -6,6 +6,7 @@
 #include "runtime/function/render/render_type.h"
 
 #include <array>
+#include <functional>
 #include <memory>
 #include <optional>
 
@@ -48,7 +49,7 @@ namespace Piccolo
         void      setRenderPipelineType(RENDER_PIPELINE_TYPE pipeline_type);
         void      initializeUIRenderBackend(WindowUI* window_ui);
         void      updateEngineContentViewport(float offset_x, float offset_y, float width, float height);
-        uint32_t  getGuidOfPickedMesh(const Vector2& picked_uv);
+        void      requestGuidOfPickedMesh(const Vector2& picked_uv, std::function<void(uint32_t)> callback);
         GObjectID getGObjectIDByMeshID(uint32_t mesh_id) const;
 
         EngineContentViewport getEngineContentViewport() const;
@@ -73,5 +74,7 @@ namespace Piccolo
         std::shared_ptr<RenderPipelineBase> m_render_pipeline;
 
         void processSwapData();
+        void processRenderCommands();
+        void updateRenderEntity(GObjectID go_id, size_t part_index, const GameObjectPartDesc& game_object_part);
     };
 } // namespace Piccolo
@@ -3,6 +3,7 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#include <filesystem>
 #include <memory>
 
 namespace Piccolo
@@ -12,6 +13,8 @@ namespace Piccolo
     struct RHIInitInfo
     {
         std::shared_ptr<WindowSystem> window_system;
+        bool                          enable_bindless {false};
+        std::filesystem::path         pipeline_cache_path;
     };
 
     class RHI
@@ -24,11 +27,13 @@ namespace Piccolo
         bool         isValidationLayerEnabled() const { return m_enable_validation_Layers; }
         bool         isDebugLabelEnabled() const { return m_enable_debug_utils_label; }
         bool         isPointLightShadowEnabled() const { return m_enable_point_light_shadow; }
+        bool         isBindlessEnabled() const { return m_enable_bindless; }
 
     protected:
         bool m_enable_validation_Layers {true};
         bool m_enable_debug_utils_label {true};
         bool m_enable_point_light_shadow {true};
+        bool m_enable_bindless {false};
 
         // used in descriptor pool creation
         uint32_t m_max_vertex_blending_mesh_count {256};
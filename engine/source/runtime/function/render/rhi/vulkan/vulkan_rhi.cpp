@@ -3,6 +3,8 @@
 
 #include "runtime/function/render/window_system.h"
 
+#include "runtime/core/base/macro.h"
+
 #include <algorithm>
 #include <cassert>
 
@@ -68,6 +70,7 @@
 #endif
 
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <set>
 #include <stdexcept>
@@ -78,6 +81,7 @@ namespace Piccolo
     VulkanRHI::~VulkanRHI()
     {
         // TODO
+        savePipelineCache();
     }
 
     void VulkanRHI::initialize(RHIInitInfo init_info)
@@ -103,6 +107,11 @@ namespace Piccolo
         m_enable_point_light_shadow = true;
 #endif
 
+        // downgraded in createLogicalDevice if the device can not index descriptors
+        m_enable_bindless = init_info.enable_bindless;
+
+        m_pipeline_cache_path = init_info.pipeline_cache_path;
+
 #if defined(__GNUC__)
         // https://gcc.gnu.org/onlinedocs/cpp/Common-Predefined-Macros.html
 #if defined(__linux__)
@@ -151,6 +160,8 @@ namespace Piccolo
         createFramebufferImageAndView();
 
         createAssetAllocator();
+
+        createPipelineCache();
     }
 
     void VulkanRHI::prepareContext()
@@ -186,6 +197,48 @@ namespace Piccolo
         {
             throw std::runtime_error("failed to synchronize");
         }
+
+        for (uint32_t thread_index = 0; thread_index < s_max_recording_threads; ++thread_index)
+        {
+            res_reset_command_pool =
+                m_vk_reset_command_pool(m_device, m_recording_command_pools[m_current_frame_index][thread_index], 0);
+            if (VK_SUCCESS != res_reset_command_pool)
+            {
+                throw std::runtime_error("failed to synchronize");
+            }
+        }
+    }
+
+    VkCommandBuffer VulkanRHI::beginSecondaryCommandBuffer(uint32_t      thread_index,
+                                                           VkRenderPass  render_pass,
+                                                           uint32_t      subpass,
+                                                           VkFramebuffer framebuffer)
+    {
+        assert(thread_index < s_max_recording_threads);
+        VkCommandBuffer command_buffer = m_secondary_command_buffers[m_current_frame_index][thread_index];
+
+        VkCommandBufferInheritanceInfo inheritance_info {};
+        inheritance_info.sType       = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance_info.renderPass  = render_pass;
+        inheritance_info.subpass     = subpass;
+        inheritance_info.framebuffer = framebuffer;
+
+        VkCommandBufferBeginInfo command_buffer_begin_info {};
+        command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        command_buffer_begin_info.flags =
+            VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        command_buffer_begin_info.pInheritanceInfo = &inheritance_info;
+
+        VkResult res_begin_command_buffer = m_vk_begin_command_buffer(command_buffer, &command_buffer_begin_info);
+        assert(VK_SUCCESS == res_begin_command_buffer);
+
+        return command_buffer;
+    }
+
+    void VulkanRHI::endSecondaryCommandBuffer(VkCommandBuffer command_buffer)
+    {
+        VkResult res_end_command_buffer = m_vk_end_command_buffer(command_buffer);
+        assert(VK_SUCCESS == res_end_command_buffer);
     }
 
     bool VulkanRHI::prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain)
@@ -258,17 +311,20 @@ namespace Piccolo
 
         VkSemaphore semaphores[2] = {m_image_available_for_texturescopy_semaphores[m_current_frame_index],
                                      m_image_finished_for_presentation_semaphores[m_current_frame_index]};
+
+        m_rendering_wait_semaphores.push_back(m_image_available_for_render_semaphores[m_current_frame_index]);
+        m_rendering_wait_stages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
         // submit command buffer
-        VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        VkSubmitInfo         submit_info   = {};
-        submit_info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.waitSemaphoreCount     = 1;
-        submit_info.pWaitSemaphores        = &m_image_available_for_render_semaphores[m_current_frame_index];
-        submit_info.pWaitDstStageMask      = wait_stages;
-        submit_info.commandBufferCount     = 1;
-        submit_info.pCommandBuffers        = &m_command_buffers[m_current_frame_index];
-        submit_info.signalSemaphoreCount   = 2;
-        submit_info.pSignalSemaphores      = semaphores;
+        VkSubmitInfo submit_info         = {};
+        submit_info.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.waitSemaphoreCount   = static_cast<uint32_t>(m_rendering_wait_semaphores.size());
+        submit_info.pWaitSemaphores      = m_rendering_wait_semaphores.data();
+        submit_info.pWaitDstStageMask    = m_rendering_wait_stages.data();
+        submit_info.commandBufferCount   = 1;
+        submit_info.pCommandBuffers      = &m_command_buffers[m_current_frame_index];
+        submit_info.signalSemaphoreCount = 2;
+        submit_info.pSignalSemaphores    = semaphores;
 
         VkResult res_reset_fences = m_vk_reset_fences(m_device, 1, &m_is_frame_in_flight_fences[m_current_frame_index]);
         assert(VK_SUCCESS == res_reset_fences);
@@ -277,6 +333,9 @@ namespace Piccolo
             vkQueueSubmit(m_graphics_queue, 1, &submit_info, m_is_frame_in_flight_fences[m_current_frame_index]);
         assert(VK_SUCCESS == res_queue_submit);
 
+        m_rendering_wait_semaphores.clear();
+        m_rendering_wait_stages.clear();
+
         // present swapchain
         VkPresentInfoKHR present_info   = {};
         present_info.sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -300,6 +359,12 @@ namespace Piccolo
         m_current_frame_index = (m_current_frame_index + 1) % s_max_frames_in_flight;
     }
 
+    void VulkanRHI::addRenderingWaitSemaphore(VkSemaphore semaphore, VkPipelineStageFlags wait_stage)
+    {
+        m_rendering_wait_semaphores.push_back(semaphore);
+        m_rendering_wait_stages.push_back(wait_stage);
+    }
+
     VkCommandBuffer VulkanRHI::beginSingleTimeCommands()
     {
         VkCommandBufferAllocateInfo allocInfo {};
@@ -381,6 +446,12 @@ namespace Piccolo
 
 #if defined(__MACH__)
         extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+#else
+        // query descriptor indexing features
+        if (m_enable_bindless)
+        {
+            extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+        }
 #endif
 
         return extensions;
@@ -582,9 +653,32 @@ namespace Piccolo
             physical_device_features.geometryShader = VK_TRUE;
         }
 
+        // support bindless descriptor indexing
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptor_indexing_features {};
+        descriptor_indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        if (m_enable_bindless && !checkBindlessSupport(m_physical_device))
+        {
+            LOG_WARN("descriptor indexing is not fully supported by the device, bindless is disabled");
+            m_enable_bindless = false;
+        }
+        if (m_enable_bindless)
+        {
+            // the skinned bindless mesh indexes the joint binding buffers by mesh
+            physical_device_features.shaderStorageBufferArrayDynamicIndexing = VK_TRUE;
+
+            m_device_extensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+            m_device_extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+
+            descriptor_indexing_features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+            descriptor_indexing_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+            descriptor_indexing_features.descriptorBindingPartiallyBound           = VK_TRUE;
+            descriptor_indexing_features.runtimeDescriptorArray                    = VK_TRUE;
+        }
+
         // device create info
         VkDeviceCreateInfo device_create_info {};
         device_create_info.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        device_create_info.pNext                   = m_enable_bindless ? &descriptor_indexing_features : nullptr;
         device_create_info.pQueueCreateInfos       = queue_create_infos.data();
         device_create_info.queueCreateInfoCount    = static_cast<uint32_t>(queue_create_infos.size());
         device_create_info.pEnabledFeatures        = &physical_device_features;
@@ -621,6 +715,7 @@ namespace Piccolo
             (PFN_vkCmdBindDescriptorSets)vkGetDeviceProcAddr(m_device, "vkCmdBindDescriptorSets");
         m_vk_cmd_draw_indexed      = (PFN_vkCmdDrawIndexed)vkGetDeviceProcAddr(m_device, "vkCmdDrawIndexed");
         m_vk_cmd_clear_attachments = (PFN_vkCmdClearAttachments)vkGetDeviceProcAddr(m_device, "vkCmdClearAttachments");
+        m_vk_cmd_execute_commands  = (PFN_vkCmdExecuteCommands)vkGetDeviceProcAddr(m_device, "vkCmdExecuteCommands");
 
         m_depth_image_format = findDepthFormat();
     }
@@ -655,6 +750,15 @@ namespace Piccolo
                 {
                     throw std::runtime_error("vk create command pool");
                 }
+
+                for (uint32_t j = 0; j < s_max_recording_threads; ++j)
+                {
+                    if (vkCreateCommandPool(
+                            m_device, &command_pool_create_info, NULL, &m_recording_command_pools[i][j]) != VK_SUCCESS)
+                    {
+                        throw std::runtime_error("vk create command pool");
+                    }
+                }
             }
         }
     }
@@ -675,6 +779,26 @@ namespace Piccolo
                 throw std::runtime_error("vk allocate command buffers");
             }
         }
+
+        VkCommandBufferAllocateInfo secondary_command_buffer_allocate_info {};
+        secondary_command_buffer_allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        secondary_command_buffer_allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        secondary_command_buffer_allocate_info.commandBufferCount = 1U;
+
+        for (uint32_t i = 0; i < s_max_frames_in_flight; ++i)
+        {
+            for (uint32_t j = 0; j < s_max_recording_threads; ++j)
+            {
+                secondary_command_buffer_allocate_info.commandPool = m_recording_command_pools[i][j];
+
+                if (vkAllocateCommandBuffers(m_device,
+                                             &secondary_command_buffer_allocate_info,
+                                             &m_secondary_command_buffers[i][j]) != VK_SUCCESS)
+                {
+                    throw std::runtime_error("vk allocate command buffers");
+                }
+            }
+        }
     }
 
     void VulkanRHI::createDescriptorPool()
@@ -703,7 +827,8 @@ namespace Piccolo
         pool_info.pPoolSizes    = pool_sizes;
         pool_info.maxSets       = 1 + 1 + 1 + m_max_material_count + m_max_vertex_blending_mesh_count + 1 +
                             1; // +skybox + axis descriptor set
-        pool_info.flags = 0U;
+        // mesh and material descriptor sets are freed when the resources are evicted
+        pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 
         if (vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_descriptor_pool) != VK_SUCCESS)
         {
@@ -749,7 +874,7 @@ namespace Piccolo
                                 m_depth_image_format,
                                 VK_IMAGE_TILING_OPTIMAL,
                                 VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
-                                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                    VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                                 m_depth_image,
                                 m_depth_image_memory,
@@ -794,6 +919,87 @@ namespace Piccolo
         vmaCreateAllocator(&allocatorCreateInfo, &m_assets_allocator);
     }
 
+    void VulkanRHI::createPipelineCache()
+    {
+        // the cache blob starts with VkPipelineCacheHeaderVersionOne, a blob written by another
+        // device or driver is discarded rather than handed to the driver
+        std::vector<char> cache_data;
+        if (!m_pipeline_cache_path.empty())
+        {
+            std::ifstream cache_file(m_pipeline_cache_path, std::ios::binary | std::ios::ate);
+            if (cache_file.is_open())
+            {
+                cache_data.resize(static_cast<size_t>(cache_file.tellg()));
+                cache_file.seekg(0);
+                cache_file.read(cache_data.data(), cache_data.size());
+            }
+        }
+
+        if (!cache_data.empty())
+        {
+            VkPhysicalDeviceProperties physical_device_properties;
+            vkGetPhysicalDeviceProperties(m_physical_device, &physical_device_properties);
+
+            VkPipelineCacheHeaderVersionOne cache_header {};
+            if (cache_data.size() < sizeof(cache_header))
+            {
+                cache_data.clear();
+            }
+            else
+            {
+                memcpy(&cache_header, cache_data.data(), sizeof(cache_header));
+                bool is_same_driver = memcmp(cache_header.pipelineCacheUUID,
+                                             physical_device_properties.pipelineCacheUUID,
+                                             VK_UUID_SIZE) == 0;
+                if (cache_header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+                    cache_header.vendorID != physical_device_properties.vendorID ||
+                    cache_header.deviceID != physical_device_properties.deviceID || !is_same_driver)
+                {
+                    LOG_INFO("pipeline cache was created by another device or driver, rebuilding it");
+                    cache_data.clear();
+                }
+            }
+        }
+
+        VkPipelineCacheCreateInfo pipeline_cache_create_info {};
+        pipeline_cache_create_info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        pipeline_cache_create_info.initialDataSize = cache_data.size();
+        pipeline_cache_create_info.pInitialData    = cache_data.empty() ? nullptr : cache_data.data();
+
+        if (vkCreatePipelineCache(m_device, &pipeline_cache_create_info, nullptr, &m_pipeline_cache) != VK_SUCCESS)
+        {
+            throw std::runtime_error("vk create pipeline cache");
+        }
+    }
+
+    void VulkanRHI::savePipelineCache()
+    {
+        if (m_pipeline_cache == VK_NULL_HANDLE || m_pipeline_cache_path.empty())
+        {
+            return;
+        }
+
+        size_t cache_size = 0;
+        if (vkGetPipelineCacheData(m_device, m_pipeline_cache, &cache_size, nullptr) != VK_SUCCESS || cache_size == 0)
+        {
+            return;
+        }
+
+        std::vector<char> cache_data(cache_size);
+        if (vkGetPipelineCacheData(m_device, m_pipeline_cache, &cache_size, cache_data.data()) != VK_SUCCESS)
+        {
+            return;
+        }
+
+        std::ofstream cache_file(m_pipeline_cache_path, std::ios::binary | std::ios::trunc);
+        if (!cache_file.is_open())
+        {
+            LOG_WARN("failed to save pipeline cache to {}", m_pipeline_cache_path.generic_string());
+            return;
+        }
+        cache_file.write(cache_data.data(), cache_size);
+    }
+
     void VulkanRHI::createSwapchain()
     {
         // query all supports of this physical device
@@ -1010,6 +1216,47 @@ namespace Piccolo
         return true;
     }
 
+    bool VulkanRHI::checkBindlessSupport(VkPhysicalDevice physical_device)
+    {
+        uint32_t extension_count;
+        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, nullptr);
+
+        std::vector<VkExtensionProperties> available_extensions(extension_count);
+        vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &extension_count, available_extensions.data());
+
+        std::set<std::string> required_extensions = {VK_KHR_MAINTENANCE3_EXTENSION_NAME,
+                                                     VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME};
+        for (const auto& extension : available_extensions)
+        {
+            required_extensions.erase(extension.extensionName);
+        }
+        if (!required_extensions.empty())
+        {
+            return false;
+        }
+
+        auto get_physical_device_features2 = (PFN_vkGetPhysicalDeviceFeatures2KHR)vkGetInstanceProcAddr(
+            m_instance, "vkGetPhysicalDeviceFeatures2KHR");
+        if (get_physical_device_features2 == nullptr)
+        {
+            return false;
+        }
+
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptor_indexing_features {};
+        descriptor_indexing_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+        VkPhysicalDeviceFeatures2KHR physical_device_features {};
+        physical_device_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        physical_device_features.pNext = &descriptor_indexing_features;
+        get_physical_device_features2(physical_device, &physical_device_features);
+
+        return physical_device_features.features.shaderStorageBufferArrayDynamicIndexing &&
+               descriptor_indexing_features.shaderSampledImageArrayNonUniformIndexing &&
+               descriptor_indexing_features.descriptorBindingUpdateUnusedWhilePending &&
+               descriptor_indexing_features.descriptorBindingPartiallyBound &&
+               descriptor_indexing_features.runtimeDescriptorArray;
+    }
+
     Piccolo::SwapChainSupportDetails VulkanRHI::querySwapChainSupport(VkPhysicalDevice physical_device)
     {
         SwapChainSupportDetails details_result;
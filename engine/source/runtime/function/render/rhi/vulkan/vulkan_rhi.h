@@ -42,6 +42,13 @@ namespace Piccolo
         VkCommandBuffer beginSingleTimeCommands();
         void            endSingleTimeCommands(VkCommandBuffer command_buffer);
 
+        // secondary command buffers, one per recording thread and frame, continuing the given subpass
+        VkCommandBuffer beginSecondaryCommandBuffer(uint32_t      thread_index,
+                                                    VkRenderPass  render_pass,
+                                                    uint32_t      subpass,
+                                                    VkFramebuffer framebuffer);
+        void            endSecondaryCommandBuffer(VkCommandBuffer command_buffer);
+
         // swapchain
         void createSwapchain();
         void clearSwapchain();
@@ -62,6 +69,9 @@ namespace Piccolo
         bool prepareBeforePass(std::function<void()> passUpdateAfterRecreateSwapchain);
         void submitRendering(std::function<void()> passUpdateAfterRecreateSwapchain);
 
+        // makes the next submitRendering wait for work submitted to another queue, e.g. the particle simulation
+        void addRenderingWaitSemaphore(VkSemaphore semaphore, VkPipelineStageFlags wait_stage);
+
     private:
         void createInstance();
         void initializeDebugMessenger();
@@ -73,6 +83,8 @@ namespace Piccolo
         void createDescriptorPool();
         void createSyncPrimitives();
         void createAssetAllocator();
+        void createPipelineCache();
+        void savePipelineCache();
 
         bool                     checkValidationLayerSupport();
         std::vector<const char*> getRequiredExtensions();
@@ -89,6 +101,7 @@ namespace Piccolo
         QueueFamilyIndices      findQueueFamilies(VkPhysicalDevice physical_device);
         bool                    checkDeviceExtensionSupport(VkPhysicalDevice physical_device);
         bool                    isDeviceSuitable(VkPhysicalDevice physical_device);
+        bool                    checkBindlessSupport(VkPhysicalDevice physical_device);
         SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice physical_device);
 
         VkFormat findDepthFormat();
@@ -115,6 +128,9 @@ namespace Piccolo
         VkQueue            m_compute_queue {VK_NULL_HANDLE};
         VkCommandPool      m_command_pool {VK_NULL_HANDLE};
 
+        // shared by all passes, persisted to m_pipeline_cache_path
+        VkPipelineCache m_pipeline_cache {VK_NULL_HANDLE};
+
         VkSwapchainKHR           m_swapchain {VK_NULL_HANDLE};
         VkFormat                 m_swapchain_image_format {VK_FORMAT_UNDEFINED};
         VkExtent2D               m_swapchain_extent;
@@ -147,6 +163,7 @@ namespace Piccolo
         PFN_vkCmdBindDescriptorSets m_vk_cmd_bind_descriptor_sets;
         PFN_vkCmdDrawIndexed        m_vk_cmd_draw_indexed;
         PFN_vkCmdClearAttachments   m_vk_cmd_clear_attachments;
+        PFN_vkCmdExecuteCommands    m_vk_cmd_execute_commands;
 
         // global descriptor pool
         VkDescriptorPool m_descriptor_pool;
@@ -161,6 +178,11 @@ namespace Piccolo
         VkSemaphore          m_image_finished_for_presentation_semaphores[s_max_frames_in_flight];
         VkFence              m_is_frame_in_flight_fences[s_max_frames_in_flight];
 
+        // a command pool is externally synchronized, so every recording thread owns one per frame
+        static uint8_t const s_max_recording_threads {2};
+        VkCommandPool        m_recording_command_pools[s_max_frames_in_flight][s_max_recording_threads];
+        VkCommandBuffer      m_secondary_command_buffers[s_max_frames_in_flight][s_max_recording_threads];
+
         // TODO: set
         VkCommandBuffer  m_current_command_buffer;
         uint8_t*         m_p_current_frame_index {nullptr};
@@ -172,6 +194,9 @@ namespace Piccolo
         uint32_t m_current_swapchain_image_index;
 
     private:
+        std::vector<VkSemaphore>          m_rendering_wait_semaphores;
+        std::vector<VkPipelineStageFlags> m_rendering_wait_stages;
+
         const std::vector<char const*> m_validation_layers {"VK_LAYER_KHRONOS_validation"};
         uint32_t                       m_vulkan_api_version {VK_API_VERSION_1_0};
 
@@ -183,5 +208,7 @@ namespace Piccolo
         };
 
         VkDebugUtilsMessengerEXT m_debug_messenger {VK_NULL_HANDLE};
+
+        std::filesystem::path m_pipeline_cache_path;
     };
 } // namespace Piccolo
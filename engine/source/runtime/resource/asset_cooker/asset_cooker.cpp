@@ -0,0 +1,464 @@
+#include "runtime/resource/asset_cooker/asset_cooker.h"
+
+#include "runtime/core/base/macro.h"
+
+#include "runtime/resource/asset_manager/asset_manager.h"
+#include "runtime/resource/config_manager/config_manager.h"
+#include "runtime/resource/res_type/common/level.h"
+#include "runtime/resource/res_type/common/world.h"
+#include "runtime/resource/res_type/data/material.h"
+#include "runtime/resource/res_type/global/global_particle.h"
+#include "runtime/resource/res_type/global/global_rendering.h"
+
+#include "runtime/function/framework/component/mesh/mesh_component.h"
+#include "runtime/function/global/global_context.h"
+#include "runtime/function/render/render_resource_base.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <future>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Piccolo
+{
+    using JsonCookFunction =
+        bool (*)(const std::string&, const std::string&, PBinaryWriter&, std::vector<CookedAssetId>&);
+
+    static void addDependency(std::vector<CookedAssetId>& dependencies,
+                              const std::string&          url,
+                              CookedAssetKind             kind,
+                              const std::string&          type_name = "")
+    {
+        if (url.empty())
+        {
+            return;
+        }
+        dependencies.push_back({g_runtime_global_context.m_asset_manager->getAssetUrl(url), kind, type_name});
+    }
+
+    static void collectDependencies(const std::vector<Reflection::ReflectionPtr<Component>>& components,
+                                    std::vector<CookedAssetId>&                              dependencies)
+    {
+        for (const Reflection::ReflectionPtr<Component>& component : components)
+        {
+            if (!component || component.getTypeName() != "MeshComponent")
+            {
+                continue;
+            }
+
+            const MeshComponent* mesh_component = static_cast<const MeshComponent*>(component.getPtr());
+            for (const SubMeshRes& sub_mesh : mesh_component->getMeshRes().m_sub_meshes)
+            {
+                addDependency(dependencies, sub_mesh.m_obj_file_ref, CookedAssetKind::static_mesh);
+                addDependency(dependencies, sub_mesh.m_material, CookedAssetKind::json, "MaterialRes");
+            }
+        }
+    }
+
+    static void collectDependencies(const ObjectInstanceRes& object, std::vector<CookedAssetId>& dependencies)
+    {
+        addDependency(dependencies, object.m_definition, CookedAssetKind::json, "ObjectDefinitionRes");
+        collectDependencies(object.m_instanced_components, dependencies);
+    }
+
+    static void collectDependencies(const ObjectDefinitionRes& definition, std::vector<CookedAssetId>& dependencies)
+    {
+        collectDependencies(definition.m_components, dependencies);
+    }
+
+    static void collectDependencies(const LevelCellObjectsRes& cell_objects, std::vector<CookedAssetId>& dependencies)
+    {
+        for (const ObjectInstanceRes& object : cell_objects.m_objects)
+        {
+            collectDependencies(object, dependencies);
+        }
+    }
+
+    static void collectDependencies(const LevelRes& level, std::vector<CookedAssetId>& dependencies)
+    {
+        for (const ObjectInstanceRes& object : level.m_objects)
+        {
+            collectDependencies(object, dependencies);
+        }
+        for (const LevelCellRes& cell : level.m_cells)
+        {
+            addDependency(dependencies, cell.m_objects_url, CookedAssetKind::json, "LevelCellObjectsRes");
+        }
+    }
+
+    static void collectDependencies(const WorldRes& world, std::vector<CookedAssetId>& dependencies)
+    {
+        for (const std::string& level_url : world.m_level_urls)
+        {
+            addDependency(dependencies, level_url, CookedAssetKind::json, "LevelRes");
+        }
+        addDependency(dependencies, world.m_default_level_url, CookedAssetKind::json, "LevelRes");
+    }
+
+    static void collectDependencies(const MaterialRes& material, std::vector<CookedAssetId>& dependencies)
+    {
+        addDependency(dependencies, material.m_base_colour_texture_file, CookedAssetKind::texture);
+        addDependency(dependencies, material.m_metallic_roughness_texture_file, CookedAssetKind::texture);
+        addDependency(dependencies, material.m_normal_texture_file, CookedAssetKind::texture);
+        addDependency(dependencies, material.m_occlusion_texture_file, CookedAssetKind::texture);
+        addDependency(dependencies, material.m_emissive_texture_file, CookedAssetKind::texture);
+    }
+
+    static void collectDependencies(const GlobalRenderingRes& rendering, std::vector<CookedAssetId>& dependencies)
+    {
+        const SkyBoxIrradianceMap& irradiance_map = rendering.m_skybox_irradiance_map;
+        const SkyBoxSpecularMap&   specular_map   = rendering.m_skybox_specular_map;
+        for (const std::string* map : {&irradiance_map.m_negative_x_map,
+                                       &irradiance_map.m_positive_x_map,
+                                       &irradiance_map.m_negative_y_map,
+                                       &irradiance_map.m_positive_y_map,
+                                       &irradiance_map.m_negative_z_map,
+                                       &irradiance_map.m_positive_z_map,
+                                       &specular_map.m_negative_x_map,
+                                       &specular_map.m_positive_x_map,
+                                       &specular_map.m_negative_y_map,
+                                       &specular_map.m_positive_y_map,
+                                       &specular_map.m_negative_z_map,
+                                       &specular_map.m_positive_z_map,
+                                       &rendering.m_brdf_map})
+        {
+            addDependency(dependencies, *map, CookedAssetKind::texture_hdr);
+        }
+        addDependency(dependencies, rendering.m_color_grading_map, CookedAssetKind::texture);
+    }
+
+    static void collectDependencies(const GlobalParticleRes& particle, std::vector<CookedAssetId>& dependencies)
+    {
+        addDependency(dependencies, particle.m_particle_billboard_texture_path, CookedAssetKind::texture_hdr);
+        addDependency(dependencies, particle.m_piccolo_logo_texture_path, CookedAssetKind::texture);
+    }
+
+    // the cooked json is the binary asset AssetManager::loadBinaryAsset reads
+    template<typename AssetType>
+    static bool cookJsonAsset(const std::string&          asset_url,
+                              const std::string&          asset_json_text,
+                              PBinaryWriter&              writer,
+                              std::vector<CookedAssetId>& out_dependencies)
+    {
+        AssetType         asset;
+        PJsonStreamReader reader(asset_json_text);
+        PJsonStreamSerializer::read(reader, asset);
+        if (!reader.isValid())
+        {
+            LOG_ERROR("parse json file {} failed at offset {}!", asset_url, reader.getOffset());
+            return false;
+        }
+
+        collectDependencies(asset, out_dependencies);
+
+        PBinaryHeader header;
+        header.schema_hash = k_binary_schema_hash;
+        writer.writeValue(header);
+        PBinarySerializer::write(writer, asset);
+        return true;
+    }
+
+    static JsonCookFunction getJsonCookFunction(const std::string& type_name)
+    {
+        static const std::unordered_map<std::string, JsonCookFunction> json_cook_functions {
+            {"WorldRes", &cookJsonAsset<WorldRes>},
+            {"LevelRes", &cookJsonAsset<LevelRes>},
+            {"LevelCellObjectsRes", &cookJsonAsset<LevelCellObjectsRes>},
+            {"ObjectDefinitionRes", &cookJsonAsset<ObjectDefinitionRes>},
+            {"MaterialRes", &cookJsonAsset<MaterialRes>},
+            {"GlobalRenderingRes", &cookJsonAsset<GlobalRenderingRes>},
+            {"GlobalParticleRes", &cookJsonAsset<GlobalParticleRes>}};
+
+        auto iter = json_cook_functions.find(type_name);
+        return iter == json_cook_functions.end() ? nullptr : iter->second;
+    }
+
+    bool AssetCooker::cook()
+    {
+        std::shared_ptr<ConfigManager> config_manager = g_runtime_global_context.m_config_manager;
+        ASSERT(config_manager);
+
+        m_cooked_folder = config_manager->getCookedFolder();
+        if (m_cooked_folder.empty())
+        {
+            LOG_ERROR("no cooked folder is configured");
+            return false;
+        }
+
+        std::error_code error_code;
+        std::filesystem::create_directories(m_cooked_folder, error_code);
+        if (error_code)
+        {
+            LOG_ERROR("create cooked folder {} failed!", m_cooked_folder.generic_string());
+            return false;
+        }
+
+        const std::filesystem::path index_file = m_cooked_folder / CookedAssetIndex::s_index_file_name;
+        CookedAssetIndex            previous_index;
+        previous_index.load(index_file);
+
+        CookedAssetIndex index;
+        size_t           cooked_count     = 0;
+        size_t           up_to_date_count = 0;
+        size_t           missing_count    = 0;
+        size_t           failed_count     = 0;
+
+        // the graph is walked breadth first, each wave of newly reached assets is cooked in parallel
+        std::set<std::pair<std::string, CookedAssetKind>> visited_assets;
+        std::vector<CookedAssetId>                        reached_assets = getRootAssets();
+        while (!reached_assets.empty())
+        {
+            std::vector<CookedAssetId> assets;
+            for (CookedAssetId& asset : reached_assets)
+            {
+                if (visited_assets.emplace(asset.m_url, asset.m_kind).second)
+                {
+                    assets.push_back(std::move(asset));
+                }
+            }
+            reached_assets.clear();
+            if (assets.empty())
+            {
+                break;
+            }
+
+            std::vector<CookResult> results(assets.size());
+            std::atomic<size_t>     next_asset_index {0};
+
+            auto cook_assets = [&]() {
+                for (size_t index = next_asset_index++; index < assets.size(); index = next_asset_index++)
+                {
+                    results[index] = cookAsset(assets[index], previous_index);
+                }
+            };
+
+            const size_t hardware_thread_count = std::max(1u, std::thread::hardware_concurrency());
+            const size_t worker_count          = std::min(hardware_thread_count, assets.size()) - 1;
+
+            std::vector<std::future<void>> cooking_workers;
+            for (size_t worker_index = 0; worker_index < worker_count; ++worker_index)
+            {
+                cooking_workers.push_back(std::async(std::launch::async, cook_assets));
+            }
+            cook_assets();
+            for (std::future<void>& cooking_worker : cooking_workers)
+            {
+                cooking_worker.get();
+            }
+
+            for (CookResult& result : results)
+            {
+                if (result.m_is_missing)
+                {
+                    ++missing_count;
+                    continue;
+                }
+                if (result.m_is_failed)
+                {
+                    ++failed_count;
+                    continue;
+                }
+
+                result.m_is_cooked ? ++cooked_count : ++up_to_date_count;
+                reached_assets.insert(reached_assets.end(),
+                                      result.m_entry.m_dependencies.begin(),
+                                      result.m_entry.m_dependencies.end());
+                index.add(std::move(result.m_entry));
+            }
+        }
+
+        removeUnusedArtifacts(index);
+        if (!index.save(index_file))
+        {
+            LOG_ERROR("write cooked asset index {} failed!", index_file.generic_string());
+            return false;
+        }
+
+        LOG_INFO("cooked {} assets, {} up to date, {} missing, {} failed",
+                 cooked_count,
+                 up_to_date_count,
+                 missing_count,
+                 failed_count);
+        return failed_count == 0;
+    }
+
+    std::vector<CookedAssetId> AssetCooker::getRootAssets() const
+    {
+        std::shared_ptr<ConfigManager> config_manager = g_runtime_global_context.m_config_manager;
+
+        std::vector<CookedAssetId> root_assets;
+        addDependency(root_assets, config_manager->getDefaultWorldUrl(), CookedAssetKind::json, "WorldRes");
+        addDependency(
+            root_assets, config_manager->getGlobalRenderingResUrl(), CookedAssetKind::json, "GlobalRenderingRes");
+        addDependency(
+            root_assets, config_manager->getGlobalParticleResUrl(), CookedAssetKind::json, "GlobalParticleRes");
+
+        // the material of the meshes without one, see RenderSystem::processSwapData
+        addDependency(root_assets, "asset/texture/default/albedo.jpg", CookedAssetKind::texture);
+        addDependency(root_assets, "asset/texture/default/mr.jpg", CookedAssetKind::texture);
+        addDependency(root_assets, "asset/texture/default/normal.jpg", CookedAssetKind::texture);
+        return root_assets;
+    }
+
+    AssetCooker::CookResult AssetCooker::cookAsset(const CookedAssetId&    id,
+                                                   const CookedAssetIndex& previous_index) const
+    {
+        std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+        ASSERT(asset_manager);
+
+        const std::filesystem::path source_file = asset_manager->getFullPath(id.m_url);
+
+        CookResult        result;
+        CookedAssetEntry& entry = result.m_entry;
+        entry.m_id              = id;
+        if (!CookedAssetIndex::getSourceStamp(source_file, entry.m_source_size, entry.m_source_write_time))
+        {
+            // the runtime falls back for missing assets as well, e.g. to the default textures
+            LOG_WARN("asset {} does not exist, skipped", id.m_url);
+            result.m_is_missing = true;
+            return result;
+        }
+
+        // an unchanged source whose artifact is still there only needs its recorded dependencies
+        const CookedAssetEntry* previous_entry = previous_index.find(id.m_url, id.m_kind);
+        if (previous_entry != nullptr && previous_entry->m_id.m_type_name == id.m_type_name &&
+            previous_entry->m_artifact_key == CookedAssetIndex::getArtifactKey(id, previous_entry->m_content_hash) &&
+            CookedAssetIndex::isSourceUnchanged(*previous_entry, source_file) &&
+            std::filesystem::exists(m_cooked_folder / CookedAssetIndex::getArtifactFileName(*previous_entry)))
+        {
+            entry.m_content_hash = previous_entry->m_content_hash;
+            entry.m_artifact_key = previous_entry->m_artifact_key;
+            entry.m_dependencies = previous_entry->m_dependencies;
+            return result;
+        }
+
+        if (!CookedAssetIndex::hashFile(source_file, entry.m_content_hash))
+        {
+            LOG_ERROR("read asset {} failed!", id.m_url);
+            result.m_is_failed = true;
+            return result;
+        }
+        entry.m_artifact_key = CookedAssetIndex::getArtifactKey(id, entry.m_content_hash);
+
+        const std::filesystem::path artifact_file = m_cooked_folder / CookedAssetIndex::getArtifactFileName(entry);
+        if (!cookArtifact(id, source_file, artifact_file, entry.m_dependencies))
+        {
+            LOG_ERROR("cook asset {} failed!", id.m_url);
+            result.m_is_failed = true;
+            return result;
+        }
+
+        LOG_INFO("cooked asset {}", id.m_url);
+        result.m_is_cooked = true;
+        return result;
+    }
+
+    bool AssetCooker::cookArtifact(const CookedAssetId&         id,
+                                   const std::filesystem::path& source_file,
+                                   const std::filesystem::path& artifact_file,
+                                   std::vector<CookedAssetId>&  out_dependencies) const
+    {
+        // sources with the same content share the artifact, so each of them writes its own temporary file
+        std::filesystem::path temporary_file = artifact_file;
+        temporary_file += "." + std::to_string(std::hash<std::string> {}(id.m_url)) + ".tmp";
+
+        bool is_written = false;
+        switch (id.m_kind)
+        {
+            case CookedAssetKind::json:
+            {
+                JsonCookFunction cook_function = getJsonCookFunction(id.m_type_name);
+                if (cook_function == nullptr)
+                {
+                    LOG_ERROR("json assets of type {} can not be cooked", id.m_type_name);
+                    return false;
+                }
+
+                std::ifstream asset_json_file(source_file);
+                if (!asset_json_file)
+                {
+                    return false;
+                }
+                std::stringstream buffer;
+                buffer << asset_json_file.rdbuf();
+
+                PBinaryWriter writer;
+                if (!cook_function(id.m_url, buffer.str(), writer, out_dependencies))
+                {
+                    return false;
+                }
+
+                std::ofstream               binary_file(temporary_file, std::ios::binary | std::ios::trunc);
+                const std::vector<uint8_t>& binary = writer.getBuffer();
+                binary_file.write(reinterpret_cast<const char*>(binary.data()),
+                                  static_cast<std::streamsize>(binary.size()));
+                binary_file.flush();
+                is_written = static_cast<bool>(binary_file);
+                break;
+            }
+            case CookedAssetKind::texture:
+            {
+                std::shared_ptr<TextureData> texture = RenderResourceBase::decodeTexture(source_file, false);
+                is_written = texture && RenderResourceBase::saveCookedTexture(*texture, temporary_file);
+                break;
+            }
+            case CookedAssetKind::texture_hdr:
+            {
+                std::shared_ptr<TextureData> texture = RenderResourceBase::decodeTextureHDR(source_file, 4);
+                is_written = texture && RenderResourceBase::saveCookedTexture(*texture, temporary_file);
+                break;
+            }
+            case CookedAssetKind::static_mesh:
+            {
+                AxisAlignedBox bounding_box;
+                StaticMeshData mesh_data =
+                    RenderResourceBase::decodeStaticMesh(source_file.generic_string(), bounding_box);
+                is_written = RenderResourceBase::saveCookedStaticMesh(mesh_data, bounding_box, temporary_file);
+                break;
+            }
+            default:
+                break;
+        }
+
+        std::error_code error_code;
+        if (is_written)
+        {
+            std::filesystem::rename(temporary_file, artifact_file, error_code);
+            if (!error_code)
+            {
+                return true;
+            }
+        }
+        std::filesystem::remove(temporary_file, error_code);
+        return false;
+    }
+
+    void AssetCooker::removeUnusedArtifacts(const CookedAssetIndex& index) const
+    {
+        std::unordered_set<std::string> used_artifacts;
+        for (const auto& iter : index.getEntries())
+        {
+            used_artifacts.insert(CookedAssetIndex::getArtifactFileName(iter.second));
+        }
+
+        // only files the cooker writes are touched, whatever else is in the folder is left alone
+        static const std::unordered_set<std::string> artifact_extensions {".bin", ".texture", ".mesh", ".tmp"};
+
+        std::error_code error_code;
+        for (const auto& directory_entry : std::filesystem::directory_iterator(m_cooked_folder, error_code))
+        {
+            const std::filesystem::path& artifact_file = directory_entry.path();
+            if (directory_entry.is_regular_file() && artifact_extensions.count(artifact_file.extension().string()) &&
+                !used_artifacts.count(artifact_file.filename().string()))
+            {
+                std::error_code remove_error_code;
+                std::filesystem::remove(artifact_file, remove_error_code);
+            }
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "runtime/resource/asset_manager/cooked_asset_index.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Piccolo
+{
+    // cooks the assets reachable from the default world and the global resources into the cooked folder, each
+    // artifact is named after the content it was cooked from, so only edited sources are cooked again
+    class AssetCooker
+    {
+    public:
+        // needs the config and asset managers of the global context, returns false if any asset failed to cook,
+        // missing assets are skipped with a warning
+        bool cook();
+
+    private:
+        struct CookResult
+        {
+            CookedAssetEntry m_entry;
+            bool             m_is_cooked {false};
+            bool             m_is_missing {false};
+            bool             m_is_failed {false};
+        };
+
+        std::vector<CookedAssetId> getRootAssets() const;
+
+        CookResult cookAsset(const CookedAssetId& id, const CookedAssetIndex& previous_index) const;
+        bool       cookArtifact(const CookedAssetId&         id,
+                                const std::filesystem::path& source_file,
+                                const std::filesystem::path& artifact_file,
+                                std::vector<CookedAssetId>&  out_dependencies) const;
+
+        // removes the artifacts of deleted and edited sources
+        void removeUnusedArtifacts(const CookedAssetIndex& index) const;
+
+        std::filesystem::path m_cooked_folder;
+    };
+} // namespace Piccolo
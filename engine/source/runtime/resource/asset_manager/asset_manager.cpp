@@ -12,4 +12,133 @@ namespace Piccolo
     {
         return std::filesystem::absolute(g_runtime_global_context.m_config_manager->getRootFolder() / relative_path);
     }
+
+    void AssetManager::releaseUnusedAssets()
+    {
+        std::lock_guard<std::mutex> lock_guard(m_shared_asset_mutex);
+        for (auto iter = m_shared_assets.begin(); iter != m_shared_assets.end();)
+        {
+            // an asset still being loaded is about to be handed out
+            const bool is_loaded =
+                iter->second.m_asset.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            if (is_loaded && iter->second.m_asset.get().use_count() <= 1)
+            {
+                iter = m_shared_assets.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+    }
+
+    std::string AssetManager::getSharedAssetKey(const std::string& asset_url) const
+    {
+        return getFullPath(asset_url).lexically_normal().generic_string();
+    }
+
+    std::filesystem::path AssetManager::getBinaryPath(const std::string& relative_path) const
+    {
+        return getFullPath(relative_path).replace_extension(".bin");
+    }
+
+    std::filesystem::path AssetManager::getCookedAssetPath(const std::string& asset_url, CookedAssetKind kind) const
+    {
+        const std::filesystem::path& cooked_folder = g_runtime_global_context.m_config_manager->getCookedFolder();
+        if (cooked_folder.empty())
+        {
+            return std::filesystem::path();
+        }
+
+        std::call_once(m_cooked_asset_index_flag, [this, &cooked_folder]() {
+            m_cooked_asset_index.load(cooked_folder / CookedAssetIndex::s_index_file_name);
+        });
+
+        const CookedAssetEntry* entry = m_cooked_asset_index.find(getAssetUrl(asset_url), kind);
+        if (entry == nullptr ||
+            entry->m_artifact_key != CookedAssetIndex::getArtifactKey(entry->m_id, entry->m_content_hash))
+        {
+            return std::filesystem::path();
+        }
+
+        // an asset edited after cooking is loaded from its source until it is cooked again
+        if (!CookedAssetIndex::isSourceUnchanged(*entry, getFullPath(asset_url)))
+        {
+            return std::filesystem::path();
+        }
+
+        return std::filesystem::absolute(cooked_folder / CookedAssetIndex::getArtifactFileName(*entry));
+    }
+
+    std::string AssetManager::getAssetUrl(const std::string& asset_path) const
+    {
+        std::filesystem::path full_path   = getFullPath(asset_path).lexically_normal();
+        std::filesystem::path root_folder =
+            std::filesystem::absolute(g_runtime_global_context.m_config_manager->getRootFolder()).lexically_normal();
+
+        std::filesystem::path relative_path = full_path.lexically_relative(root_folder);
+        if (relative_path.empty() || *relative_path.begin() == "..")
+        {
+            return full_path.generic_string();
+        }
+        return relative_path.generic_string();
+    }
+
+    bool AssetManager::readBinaryAssetFile(const std::string& asset_url, std::vector<uint8_t>& out_binary) const
+    {
+        // a cooked artifact is preferred over the sidecar, it is checked against the content of the json
+        std::filesystem::path cooked_path = getCookedAssetPath(asset_url, CookedAssetKind::json);
+        if (!cooked_path.empty() && readFile(cooked_path, out_binary))
+        {
+            return true;
+        }
+
+        std::filesystem::path asset_path  = getFullPath(asset_url);
+        std::filesystem::path binary_path = getBinaryPath(asset_url);
+
+        std::error_code error_code;
+        auto            binary_write_time = std::filesystem::last_write_time(binary_path, error_code);
+        if (error_code)
+        {
+            return false;
+        }
+
+        // an edited json wins over a stale binary
+        auto asset_write_time = std::filesystem::last_write_time(asset_path, error_code);
+        if (!error_code && asset_write_time > binary_write_time)
+        {
+            return false;
+        }
+
+        return readFile(binary_path, out_binary);
+    }
+
+    bool AssetManager::readFile(const std::filesystem::path& file_path, std::vector<uint8_t>& out_binary) const
+    {
+        std::ifstream binary_file(file_path, std::ios::binary | std::ios::ate);
+        if (!binary_file)
+        {
+            return false;
+        }
+
+        std::streamsize size = binary_file.tellg();
+        binary_file.seekg(0, std::ios::beg);
+        out_binary.resize(static_cast<size_t>(size));
+        return static_cast<bool>(binary_file.read(reinterpret_cast<char*>(out_binary.data()), size));
+    }
+
+    bool AssetManager::writeBinaryAssetFile(const std::string& asset_url, const std::vector<uint8_t>& binary) const
+    {
+        std::filesystem::path binary_path = getBinaryPath(asset_url);
+        std::ofstream         binary_file(binary_path, std::ios::binary | std::ios::trunc);
+        if (!binary_file)
+        {
+            LOG_ERROR("open file {} failed!", binary_path.generic_string());
+            return false;
+        }
+
+        binary_file.write(reinterpret_cast<const char*>(binary.data()), static_cast<std::streamsize>(binary.size()));
+        binary_file.flush();
+        return static_cast<bool>(binary_file);
+    }
 } // namespace Piccolo
\ No newline at end of file
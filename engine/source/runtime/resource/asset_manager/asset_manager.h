@@ -1,13 +1,22 @@
 #pragma once
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/meta/serializer/binary_serializer.h"
+#include "runtime/core/meta/serializer/json_stream_reader.h"
 #include "runtime/core/meta/serializer/serializer.h"
+#include "runtime/resource/asset_manager/cooked_asset_index.h"
 
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
 
 #include "_generated/serializer/all_serializer.h"
 
@@ -19,6 +28,12 @@ namespace Piccolo
         template<typename AssetType>
         bool loadAsset(const std::string& asset_url, AssetType& out_asset) const
         {
+            // an up to date binary sidecar skips the json parsing
+            if (loadBinaryAsset(asset_url, out_asset))
+            {
+                return true;
+            }
+
             // read json file to string
             std::filesystem::path asset_path = getFullPath(asset_url);
             std::ifstream asset_json_file(asset_path);
@@ -32,16 +47,14 @@ namespace Piccolo
             buffer << asset_json_file.rdbuf();
             std::string asset_json_text(buffer.str());
 
-            // parse to json object and read to runtime res object
-            std::string error;
-            auto&&      asset_json = PJson::parse(asset_json_text, error);
-            if (!error.empty())
+            // read straight into the runtime res object without building a json dom
+            PJsonStreamReader reader(asset_json_text);
+            PJsonStreamSerializer::read(reader, out_asset);
+            if (!reader.isValid())
             {
-                LOG_ERROR("parse json file {} failed!", asset_url);
+                LOG_ERROR("parse json file {} failed at offset {}!", asset_url, reader.getOffset());
                 return false;
             }
-
-            PSerializer::read(asset_json, out_asset);
             return true;
         }
 
@@ -66,7 +79,147 @@ namespace Piccolo
             return true;
         }
 
+        template<typename AssetType>
+        bool loadBinaryAsset(const std::string& asset_url, AssetType& out_asset) const
+        {
+            std::vector<uint8_t> asset_binary;
+            if (!readBinaryAssetFile(asset_url, asset_binary))
+            {
+                return false;
+            }
+
+            PBinaryReader reader(asset_binary.data(), asset_binary.size());
+            PBinaryHeader header = reader.readValue<PBinaryHeader>();
+            if (!reader.isValid() || header.magic != k_binary_magic || header.version != k_binary_format_version ||
+                header.schema_hash != k_binary_schema_hash)
+            {
+                LOG_WARN("binary asset of {} is outdated, loading json instead", asset_url);
+                return false;
+            }
+
+            // read into a temporary so that a truncated file leaves the output untouched
+            AssetType asset;
+            PBinarySerializer::read(reader, asset);
+            if (!reader.isValid() || !reader.isAtEnd())
+            {
+                LOG_WARN("binary asset of {} is corrupted, loading json instead", asset_url);
+                return false;
+            }
+
+            out_asset = std::move(asset);
+            return true;
+        }
+
+        // writes the binary sidecar next to the json asset, loadAsset picks it up while it is newer than the json
+        template<typename AssetType>
+        bool saveBinaryAsset(const AssetType& out_asset, const std::string& asset_url) const
+        {
+            PBinaryHeader header;
+            header.schema_hash = k_binary_schema_hash;
+
+            PBinaryWriter writer;
+            writer.writeValue(header);
+            PBinarySerializer::write(writer, out_asset);
+            return writeBinaryAssetFile(asset_url, writer.getBuffer());
+        }
+
+        // parses a file once and shares the result read only with every caller, a failed load returns nullptr to the
+        // callers waiting for it and is tried again by the next one
+        template<typename AssetType>
+        std::shared_ptr<const AssetType> loadSharedAsset(const std::string& asset_url)
+        {
+            const std::string asset_key = getSharedAssetKey(asset_url);
+
+            std::promise<std::shared_ptr<const void>>       load_promise;
+            std::shared_future<std::shared_ptr<const void>> load_future;
+            bool                                            is_loading_here = false;
+            {
+                std::lock_guard<std::mutex> lock_guard(m_shared_asset_mutex);
+
+                auto iter = m_shared_assets.find(asset_key);
+                if (iter == m_shared_assets.end())
+                {
+                    load_future = load_promise.get_future().share();
+                    m_shared_assets.emplace(asset_key, SharedAsset {std::type_index(typeid(AssetType)), load_future});
+                    is_loading_here = true;
+                }
+                else if (iter->second.m_type != std::type_index(typeid(AssetType)))
+                {
+                    LOG_ERROR("asset {} is already shared as another type", asset_url);
+                    return nullptr;
+                }
+                else
+                {
+                    load_future = iter->second.m_asset;
+                }
+            }
+
+            // concurrent callers of the same file wait for this load instead of parsing it again
+            if (is_loading_here)
+            {
+                std::shared_ptr<AssetType> asset;
+                try
+                {
+                    asset = std::make_shared<AssetType>();
+                    if (!loadAsset(asset_url, *asset))
+                    {
+                        asset.reset();
+                    }
+                }
+                catch (const std::exception& exception)
+                {
+                    LOG_ERROR("load asset {} failed: {}", asset_url, exception.what());
+                    asset.reset();
+                }
+                catch (...)
+                {
+                    LOG_ERROR("load asset {} failed", asset_url);
+                    asset.reset();
+                }
+
+                // a failed load is not kept, the next request tries the file again
+                if (!asset)
+                {
+                    std::lock_guard<std::mutex> lock_guard(m_shared_asset_mutex);
+                    m_shared_assets.erase(asset_key);
+                }
+                // the waiters get nullptr instead of a broken promise
+                load_promise.set_value(asset);
+            }
+
+            return std::static_pointer_cast<const AssetType>(load_future.get());
+        }
+
+        // drops the shared assets nobody holds anymore, so that edited files are parsed again on the next load
+        void releaseUnusedAssets();
+
         std::filesystem::path getFullPath(const std::string& relative_path) const;
+        std::filesystem::path getBinaryPath(const std::string& relative_path) const;
+
+        // the artifact the asset cooker made of a still unchanged source, empty if the source has to be loaded
+        std::filesystem::path getCookedAssetPath(const std::string& asset_url, CookedAssetKind kind) const;
+        // the url of a file below the root folder as the cooked asset index records it
+        std::string getAssetUrl(const std::string& asset_path) const;
+
+    private:
+        struct SharedAsset
+        {
+            std::type_index                                 m_type;
+            std::shared_future<std::shared_ptr<const void>> m_asset;
+        };
+
+        bool readBinaryAssetFile(const std::string& asset_url, std::vector<uint8_t>& out_binary) const;
+        bool readFile(const std::filesystem::path& file_path, std::vector<uint8_t>& out_binary) const;
+        bool writeBinaryAssetFile(const std::string& asset_url, const std::vector<uint8_t>& binary) const;
+
+        // different spellings of the same file share one entry
+        std::string getSharedAssetKey(const std::string& asset_url) const;
+
+        std::mutex                                   m_shared_asset_mutex;
+        std::unordered_map<std::string, SharedAsset> m_shared_assets;
 
+        // read on the first lookup, the cooker does not run while the engine does
+        mutable std::once_flag   m_cooked_asset_index_flag;
+        mutable CookedAssetIndex m_cooked_asset_index;
     };
 } // namespace Piccolo
@@ -0,0 +1,236 @@
+#include "runtime/resource/asset_manager/cooked_asset_index.h"
+
+#include "runtime/core/meta/serializer/binary_serializer.h"
+
+#include "_generated/serializer/all_serializer.h"
+
+#include <cstdio>
+#include <fstream>
+
+namespace Piccolo
+{
+    // "PCKI" in a little endian file
+    static constexpr uint32_t k_cooked_index_magic = 0x494B4350;
+    // bump whenever a cooked format changes, every artifact is cooked again then
+    static constexpr uint32_t k_cooked_asset_version = 1;
+
+    static constexpr uint64_t k_fnv_offset_basis = 14695981039346656037ull;
+    static constexpr uint64_t k_fnv_prime        = 1099511628211ull;
+
+    static uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= k_fnv_prime;
+        }
+        return hash;
+    }
+
+    static void writeId(PBinaryWriter& writer, const CookedAssetId& id)
+    {
+        writer.writeString(id.m_url);
+        writer.writeValue(static_cast<uint32_t>(id.m_kind));
+        writer.writeString(id.m_type_name);
+    }
+
+    static CookedAssetId readId(PBinaryReader& reader)
+    {
+        CookedAssetId id;
+        id.m_url       = std::string(reader.readStringView());
+        id.m_kind      = static_cast<CookedAssetKind>(reader.readValue<uint32_t>());
+        id.m_type_name = std::string(reader.readStringView());
+        return id;
+    }
+
+    bool CookedAssetIndex::load(const std::filesystem::path& index_file)
+    {
+        m_entries.clear();
+
+        std::ifstream file(index_file, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return false;
+        }
+
+        std::vector<uint8_t> buffer(static_cast<size_t>(file.tellg()));
+        file.seekg(0, std::ios::beg);
+        if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size())))
+        {
+            return false;
+        }
+
+        PBinaryReader reader(buffer.data(), buffer.size());
+        if (reader.readValue<uint32_t>() != k_cooked_index_magic ||
+            reader.readValue<uint32_t>() != k_cooked_asset_version)
+        {
+            return false;
+        }
+
+        std::vector<CookedAssetEntry> entries(reader.readSize());
+        for (CookedAssetEntry& entry : entries)
+        {
+            entry.m_id                = readId(reader);
+            entry.m_source_size       = reader.readValue<uint64_t>();
+            entry.m_source_write_time = reader.readValue<int64_t>();
+            entry.m_content_hash      = reader.readValue<uint64_t>();
+            entry.m_artifact_key      = reader.readValue<uint64_t>();
+            entry.m_dependencies.resize(reader.readSize());
+            for (CookedAssetId& dependency : entry.m_dependencies)
+            {
+                dependency = readId(reader);
+            }
+        }
+
+        if (!reader.isValid() || !reader.isAtEnd())
+        {
+            return false;
+        }
+
+        for (CookedAssetEntry& entry : entries)
+        {
+            add(std::move(entry));
+        }
+        return true;
+    }
+
+    bool CookedAssetIndex::save(const std::filesystem::path& index_file) const
+    {
+        PBinaryWriter writer;
+        writer.writeValue(k_cooked_index_magic);
+        writer.writeValue(k_cooked_asset_version);
+        writer.writeSize(m_entries.size());
+        for (const auto& iter : m_entries)
+        {
+            const CookedAssetEntry& entry = iter.second;
+            writeId(writer, entry.m_id);
+            writer.writeValue(entry.m_source_size);
+            writer.writeValue(entry.m_source_write_time);
+            writer.writeValue(entry.m_content_hash);
+            writer.writeValue(entry.m_artifact_key);
+            writer.writeSize(entry.m_dependencies.size());
+            for (const CookedAssetId& dependency : entry.m_dependencies)
+            {
+                writeId(writer, dependency);
+            }
+        }
+
+        // a runtime starting meanwhile must never see half an index
+        std::filesystem::path temporary_file = index_file;
+        temporary_file += ".tmp";
+        {
+            std::ofstream file(temporary_file, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                return false;
+            }
+            const std::vector<uint8_t>& buffer = writer.getBuffer();
+            file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+            if (!file.flush())
+            {
+                return false;
+            }
+        }
+
+        std::error_code error_code;
+        std::filesystem::rename(temporary_file, index_file, error_code);
+        return !error_code;
+    }
+
+    const CookedAssetEntry* CookedAssetIndex::find(const std::string& url, CookedAssetKind kind) const
+    {
+        auto iter = m_entries.find(std::make_pair(url, kind));
+        return iter == m_entries.end() ? nullptr : &iter->second;
+    }
+
+    void CookedAssetIndex::add(CookedAssetEntry entry)
+    {
+        auto key       = std::make_pair(entry.m_id.m_url, entry.m_id.m_kind);
+        m_entries[key] = std::move(entry);
+    }
+
+    bool CookedAssetIndex::isSourceUnchanged(const CookedAssetEntry& entry, const std::filesystem::path& source_file)
+    {
+        uint64_t size       = 0;
+        int64_t  write_time = 0;
+        if (!getSourceStamp(source_file, size, write_time) || size != entry.m_source_size)
+        {
+            return false;
+        }
+        if (write_time == entry.m_source_write_time)
+        {
+            return true;
+        }
+
+        // copying the assets updates the write times, hashing is still much cheaper than decoding
+        uint64_t content_hash = 0;
+        return hashFile(source_file, content_hash) && content_hash == entry.m_content_hash;
+    }
+
+    bool CookedAssetIndex::getSourceStamp(const std::filesystem::path& source_file, uint64_t& size, int64_t& write_time)
+    {
+        std::error_code error_code;
+        size = static_cast<uint64_t>(std::filesystem::file_size(source_file, error_code));
+        if (error_code)
+        {
+            return false;
+        }
+        write_time = static_cast<int64_t>(
+            std::filesystem::last_write_time(source_file, error_code).time_since_epoch().count());
+        return !error_code;
+    }
+
+    bool CookedAssetIndex::hashFile(const std::filesystem::path& file, uint64_t& out_hash)
+    {
+        std::ifstream source(file, std::ios::binary);
+        if (!source)
+        {
+            return false;
+        }
+
+        uint64_t hash = k_fnv_offset_basis;
+        char     buffer[64 * 1024];
+        while (source)
+        {
+            source.read(buffer, sizeof(buffer));
+            hash = hashBytes(hash, buffer, static_cast<size_t>(source.gcount()));
+        }
+
+        out_hash = hash;
+        return source.eof();
+    }
+
+    uint64_t CookedAssetIndex::getArtifactKey(const CookedAssetId& id, uint64_t content_hash)
+    {
+        const uint32_t kind = static_cast<uint32_t>(id.m_kind);
+
+        uint64_t key = hashBytes(k_fnv_offset_basis, &content_hash, sizeof(content_hash));
+        key          = hashBytes(key, &k_cooked_asset_version, sizeof(k_cooked_asset_version));
+        key          = hashBytes(key, &kind, sizeof(kind));
+        key          = hashBytes(key, id.m_type_name.data(), id.m_type_name.size());
+        if (id.m_kind == CookedAssetKind::json)
+        {
+            // the binary layout follows the reflected classes
+            key = hashBytes(key, &k_binary_schema_hash, sizeof(k_binary_schema_hash));
+        }
+        return key;
+    }
+
+    std::string CookedAssetIndex::getArtifactFileName(const CookedAssetEntry& entry)
+    {
+        char key_text[17];
+        std::snprintf(key_text, sizeof(key_text), "%016llx", static_cast<unsigned long long>(entry.m_artifact_key));
+
+        switch (entry.m_id.m_kind)
+        {
+            case CookedAssetKind::texture:
+            case CookedAssetKind::texture_hdr:
+                return std::string(key_text) + ".texture";
+            case CookedAssetKind::static_mesh:
+                return std::string(key_text) + ".mesh";
+            default:
+                return std::string(key_text) + ".bin";
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Piccolo
+{
+    // the runtime format an asset source is cooked into
+    enum class CookedAssetKind : uint32_t
+    {
+        json,
+        texture,
+        texture_hdr,
+        static_mesh
+    };
+
+    struct CookedAssetId
+    {
+        // relative to the root folder, with forward slashes
+        std::string     m_url;
+        CookedAssetKind m_kind {CookedAssetKind::json};
+        // the reflected class a json asset is read as, empty for the other kinds
+        std::string m_type_name;
+    };
+
+    struct CookedAssetEntry
+    {
+        CookedAssetId m_id;
+
+        // size and write time of the source when it was cooked, a copied source is recognized by its content hash
+        uint64_t m_source_size {0};
+        int64_t  m_source_write_time {0};
+        uint64_t m_content_hash {0};
+        // content hash combined with everything else the artifact depends on, names the artifact file
+        uint64_t m_artifact_key {0};
+
+        // the assets this one references, e.g. the meshes and materials of an object definition
+        std::vector<CookedAssetId> m_dependencies;
+    };
+
+    // records which source was cooked into which artifact of the cooked folder, written by the asset cooker and read
+    // by the asset manager
+    class CookedAssetIndex
+    {
+    public:
+        // a missing or outdated index leaves it empty, the sources are loaded then
+        bool load(const std::filesystem::path& index_file);
+        bool save(const std::filesystem::path& index_file) const;
+
+        const CookedAssetEntry* find(const std::string& url, CookedAssetKind kind) const;
+        void                    add(CookedAssetEntry entry);
+
+        const std::map<std::pair<std::string, CookedAssetKind>, CookedAssetEntry>& getEntries() const
+        {
+            return m_entries;
+        }
+
+        // true while the source still has the content the artifact was cooked from
+        static bool isSourceUnchanged(const CookedAssetEntry& entry, const std::filesystem::path& source_file);
+
+        static bool     getSourceStamp(const std::filesystem::path& source_file, uint64_t& size, int64_t& write_time);
+        static bool     hashFile(const std::filesystem::path& file, uint64_t& out_hash);
+        static uint64_t getArtifactKey(const CookedAssetId& id, uint64_t content_hash);
+        static std::string getArtifactFileName(const CookedAssetEntry& entry);
+
+        static constexpr const char* s_index_file_name {"cooked_assets.index"};
+
+    private:
+        std::map<std::pair<std::string, CookedAssetKind>, CookedAssetEntry> m_entries;
+    };
+} // namespace Piccolo
@@ -32,6 +32,10 @@ namespace Piccolo
                 {
                     m_schema_folder = m_root_folder / value;
                 }
+                else if (name == "CookedFolder")
+                {
+                    m_cooked_folder = m_root_folder / value;
+                }
                 else if (name == "DefaultWorld")
                 {
                     m_default_world_url = value;
@@ -72,6 +76,8 @@ namespace Piccolo
 
     const std::filesystem::path& ConfigManager::getSchemaFolder() const { return m_schema_folder; }
 
+    const std::filesystem::path& ConfigManager::getCookedFolder() const { return m_cooked_folder; }
+
     const std::filesystem::path& ConfigManager::getEditorBigIconPath() const { return m_editor_big_icon_path; }
 
     const std::filesystem::path& ConfigManager::getEditorSmallIconPath() const { return m_editor_small_icon_path; }
@@ -14,6 +14,7 @@ namespace Piccolo
         const std::filesystem::path& getRootFolder() const;
         const std::filesystem::path& getAssetFolder() const;
         const std::filesystem::path& getSchemaFolder() const;
+        const std::filesystem::path& getCookedFolder() const;
         const std::filesystem::path& getEditorBigIconPath() const;
         const std::filesystem::path& getEditorSmallIconPath() const;
         const std::filesystem::path& getEditorFontPath() const;
@@ -30,6 +31,7 @@ namespace Piccolo
         std::filesystem::path m_root_folder;
         std::filesystem::path m_asset_folder;
         std::filesystem::path m_schema_folder;
+        std::filesystem::path m_cooked_folder;
         std::filesystem::path m_editor_big_icon_path;
         std::filesystem::path m_editor_small_icon_path;
         std::filesystem::path m_editor_font_path;
@@ -7,6 +7,27 @@
 
 namespace Piccolo
 {
+    REFLECTION_TYPE(LevelCellObjectsRes)
+    CLASS(LevelCellObjectsRes, Fields)
+    {
+        REFLECTION_BODY(LevelCellObjectsRes);
+
+    public:
+        std::vector<ObjectInstanceRes> m_objects;
+    };
+
+    REFLECTION_TYPE(LevelCellRes)
+    CLASS(LevelCellRes, Fields)
+    {
+        REFLECTION_BODY(LevelCellRes);
+
+    public:
+        // url of the LevelCellObjectsRes holding the objects inside the bounds
+        std::string m_objects_url;
+        Vector3     m_bounding_box_min;
+        Vector3     m_bounding_box_max;
+    };
+
     REFLECTION_TYPE(LevelRes)
     CLASS(LevelRes, Fields)
     {
@@ -17,5 +38,10 @@ namespace Piccolo
         std::string m_character_name;
 
         std::vector<ObjectInstanceRes> m_objects;
+
+        // cells are streamed in and out around the active character, the objects above always stay loaded
+        std::vector<LevelCellRes> m_cells;
+        float                     m_cell_stream_in_distance {64.f};
+        float                     m_cell_stream_out_distance {96.f};
     };
 } // namespace Piccolo
\ No newline at end of file
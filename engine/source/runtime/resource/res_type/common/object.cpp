@@ -0,0 +1,36 @@
+#include "runtime/resource/res_type/common/object.h"
+
+#include "runtime/function/framework/component/component.h"
+
+#include <utility>
+
+namespace Piccolo
+{
+    ObjectDefinitionRes::ObjectDefinitionRes(ObjectDefinitionRes&& res) noexcept :
+        m_components(std::move(res.m_components))
+    {
+        res.m_components.clear();
+    }
+
+    ObjectDefinitionRes& ObjectDefinitionRes::operator=(ObjectDefinitionRes&& res) noexcept
+    {
+        if (this != &res)
+        {
+            releaseComponents();
+            m_components = std::move(res.m_components);
+            res.m_components.clear();
+        }
+        return *this;
+    }
+
+    ObjectDefinitionRes::~ObjectDefinitionRes() { releaseComponents(); }
+
+    void ObjectDefinitionRes::releaseComponents()
+    {
+        for (auto& component : m_components)
+        {
+            PICCOLO_REFLECTION_DELETE(component);
+        }
+        m_components.clear();
+    }
+} // namespace Piccolo
@@ -26,6 +26,17 @@ namespace Piccolo
 
     public:
         std::vector<Reflection::ReflectionPtr<Component>> m_components;
+
+        // the shared definition owns its components, objects only get clones of them
+        ObjectDefinitionRes() = default;
+        ObjectDefinitionRes(const ObjectDefinitionRes&) = delete;
+        ObjectDefinitionRes(ObjectDefinitionRes&& res) noexcept;
+        ObjectDefinitionRes& operator=(const ObjectDefinitionRes&) = delete;
+        ObjectDefinitionRes& operator=(ObjectDefinitionRes&& res) noexcept;
+        ~ObjectDefinitionRes();
+
+    private:
+        void releaseComponents();
     };
 
     REFLECTION_TYPE(ObjectInstanceRes)
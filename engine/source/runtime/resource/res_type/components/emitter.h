@@ -20,5 +20,10 @@ namespace Piccolo
         int        m_emitter_type;
         Vector2    m_life;  // life base & variance
         Vector4    m_color; // color rgba
+
+        // particle budget of the emitter, 0 derives it from the global emit count and the particle life
+        int m_max_particle_count {0};
+        // radius around the emitter that holds all of its particles, 0 derives it from the motion and the life
+        float m_bounds_radius {0.0f};
     };
 } // namespace Piccolo
\ No newline at end of file
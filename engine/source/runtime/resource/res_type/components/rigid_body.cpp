@@ -7,15 +7,49 @@ namespace Piccolo
     RigidBodyShape::RigidBodyShape(const RigidBodyShape& res) :
         m_local_transform(res.m_local_transform)
     {
-        if (res.m_geometry.getTypeName() == "Box")
+        copyGeometry(res);
+    }
+
+    RigidBodyShape& RigidBodyShape::operator=(const RigidBodyShape& res)
+    {
+        if (this != &res)
+        {
+            // a shallow copy would free the same pooled geometry twice
+            PICCOLO_REFLECTION_DELETE(m_geometry);
+            m_type            = RigidBodyShapeType::invalid;
+            m_local_transform = res.m_local_transform;
+            copyGeometry(res);
+        }
+        return *this;
+    }
+
+    void RigidBodyShape::copyGeometry(const RigidBodyShape& res)
+    {
+        if (!res.m_geometry)
+        {
+            return;
+        }
+
+        const std::string type_name = res.m_geometry.getTypeName();
+        void*             geometry  = Reflection::getMostDerivedAddress(res.m_geometry.getPtr());
+        m_geometry                  = Reflection::ReflectionPtr<Geometry>(
+            type_name, static_cast<Geometry*>(Reflection::TypeMeta::cloneByName(type_name, geometry).m_instance));
+        if (!m_geometry)
         {
-            m_type     = RigidBodyShapeType::box;
-            m_geometry = PICCOLO_REFLECTION_NEW(Box);
-            PICCOLO_REFLECTION_DEEP_COPY(Box, m_geometry, res.m_geometry);
+            LOG_ERROR("Not supported shape type {}!", type_name);
+            return;
         }
-        else
+
+        // the shapes read from a definition only know the type of their geometry
+        m_type = res.m_type;
+        if (m_type == RigidBodyShapeType::invalid)
         {
-            LOG_ERROR("Not supported shape type!");
+            if (type_name == "Box")
+                m_type = RigidBodyShapeType::box;
+            else if (type_name == "Sphere")
+                m_type = RigidBodyShapeType::sphere;
+            else if (type_name == "Capsule")
+                m_type = RigidBodyShapeType::capsule;
         }
     }
 
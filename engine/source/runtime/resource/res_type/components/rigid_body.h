@@ -33,8 +33,12 @@ namespace Piccolo
 
         RigidBodyShape() = default;
         RigidBodyShape(const RigidBodyShape& res);
+        RigidBodyShape& operator=(const RigidBodyShape& res);
 
         ~RigidBodyShape();
+
+    private:
+        void copyGeometry(const RigidBodyShape& res);
     };
 
     REFLECTION_TYPE(RigidBodyComponentRes)
@@ -21,5 +21,17 @@ namespace Piccolo
         Vector3     m_gravity;
         std::string m_particle_billboard_texture_path;
         std::string m_piccolo_logo_texture_path;
+        // sorts the particles back to front on the gpu before they are drawn
+        bool m_enable_depth_sort {false};
+
+        // emitters outside the view frustum are only simulated every offscreen_tick_interval frames with a
+        // correspondingly longer step, 0 puts them to sleep until they are visible again
+        int m_offscreen_tick_interval {0};
+        // between the lod distances the spawn rate falls to lod_min_spawn_scale and the particles grow to
+        // lod_max_size_scale, so distant effects keep their coverage with fewer particles
+        float m_lod_near_distance {20.0f};
+        float m_lod_far_distance {200.0f};
+        float m_lod_min_spawn_scale {0.25f};
+        float m_lod_max_size_scale {2.0f};
     };
 } // namespace Piccolo
\ No newline at end of file
@@ -53,6 +53,8 @@ namespace Piccolo
 
     public:
         bool                m_enable_fxaa {false};
+        bool                m_enable_bindless {false};
+        int                 m_gpu_resource_budget_mb {0};
         SkyBoxIrradianceMap m_skybox_irradiance_map;
         SkyBoxSpecularMap   m_skybox_specular_map;
         std::string         m_brdf_map;